@@ -270,7 +270,7 @@ SongResource * XNewSongPtr( SongType songType,
     switch (songType)
     {
         case SONG_TYPE_SMS:
-            songSMS = (SongResource_SMS *)XNewPtr((int32_t)sizeof(SongResource_SMS));
+            songSMS = (SongResource_SMS *)XNewTaggedPtr((int32_t)sizeof(SongResource_SMS), X_MEMORY_SONGS);
             if (songSMS)
             {
                 songSMS->songType = SONG_TYPE_SMS;
@@ -288,7 +288,7 @@ SongResource * XNewSongPtr( SongType songType,
             song = (SongResource *)songSMS;
             break;
         case SONG_TYPE_RMF:
-            songRMF = (SongResource_RMF *)XNewPtr((int32_t)sizeof(SongResource_RMF) - sizeof(int16_t));
+            songRMF = (SongResource_RMF *)XNewTaggedPtr((int32_t)sizeof(SongResource_RMF) - sizeof(int16_t), X_MEMORY_SONGS);
             if (songRMF)
             {
                 songRMF->songType = SONG_TYPE_RMF;
@@ -303,7 +303,7 @@ SongResource * XNewSongPtr( SongType songType,
             song = (SongResource *)songRMF;
             break;
         case SONG_TYPE_RMF_LINEAR:
-            songRMF2 = (SongResource_RMF_Linear *)XNewPtr((int32_t)sizeof(SongResource_RMF_Linear) - sizeof(int16_t));
+            songRMF2 = (SongResource_RMF_Linear *)XNewTaggedPtr((int32_t)sizeof(SongResource_RMF_Linear) - sizeof(int16_t), X_MEMORY_SONGS);
             if (songRMF2)
             {
                 songRMF2->songType = SONG_TYPE_RMF_LINEAR;
@@ -656,7 +656,7 @@ static SongResource_RMF * PV_AddRMFSongResource(SongResource *theSong, SongResou
         if (PV_ValidResourceForSongType(resourceType, SONG_TYPE_RMF))
         {
             size = XGetPtrSize(theSong);
-            newSong = (SongResource_RMF *)XNewPtr((int32_t)(size + sizeof(SongResourceType) + resourceLength));
+            newSong = (SongResource_RMF *)XNewTaggedPtr((int32_t)(size + sizeof(SongResourceType) + resourceLength), X_MEMORY_SONGS);
             if (newSong)
             {
                 XBlockMove(theSong, newSong, size);
@@ -698,7 +698,7 @@ static SongResource_RMF * PV_DeleteRMFSongResource(SongResource *theSong, SongRe
                 size = (int32_t)(XGetPtrSize(theSong) - sizeof(SongResourceType) - resourceLength);
                 if (size > 0)
                 {
-                    newSong = (SongResource_RMF *)XNewPtr(size);
+                    newSong = (SongResource_RMF *)XNewTaggedPtr(size, X_MEMORY_SONGS);
                     if (newSong)
                     {
                         offsetStart = pBlock - (char *)theSong;
@@ -759,7 +759,7 @@ SongResource * XChangeSongResource(SongResource *theSong, int32_t songSize, Song
                             XBlockMove(pResource, name4, resourceLength);
                             goto changeSMSresource;
             changeSMSresource:
-                            newSong = (SongResource *)XNewPtr(songSize + resourceLength);
+                            newSong = (SongResource *)XNewTaggedPtr(songSize + resourceLength, X_MEMORY_SONGS);
                             songSMS = (SongResource_SMS *)newSong;
                             if (newSong)
                             {
@@ -1960,7 +1960,7 @@ XPTR XGetMidiData(XLongResourceID theID, int32_t *pReturnedSize, XResourceType *
     if (theData)
     {
         // since this is encrypted, make a new copy and decrypt
-        pData = XNewPtr(midiSize);
+        pData = XNewTaggedPtr(midiSize, X_MEMORY_SONGS);
         if (pData)
         {
             XBlockMove(theData, pData, midiSize);
@@ -1991,7 +1991,7 @@ XPTR XGetMidiData(XLongResourceID theID, int32_t *pReturnedSize, XResourceType *
         if (theData)
         {
             // since this is encrypted, make a new copy and decrypt
-            pData = XNewPtr(midiSize);
+            pData = XNewTaggedPtr(midiSize, X_MEMORY_SONGS);
             if (pData)
             {
                 XBlockMove(theData, pData, midiSize);
@@ -2043,6 +2043,7 @@ XPTR XGetMidiData(XLongResourceID theID, int32_t *pReturnedSize, XResourceType *
     {
         *pType = type;
     }
+    XSetPtrTag(theData, X_MEMORY_SONGS);    // belongs to the song from here on
     return theData;
 }
 
@@ -2079,6 +2080,7 @@ XPTR XGetRawSoundResourceByID(XLongResourceID theID, XResourceType *pReturnedTyp
     {
         *pReturnedType = type;
     }
+    XSetPtrTag(theData, X_MEMORY_SAMPLES);
     return theData;
 }
 
@@ -2097,7 +2099,7 @@ XPTR XGetSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize)
         {
             size = (uint32_t)*pReturnedSize;
             thePreSound = theData;
-            theData = XNewPtr((int32_t)size);
+            theData = XNewTaggedPtr((int32_t)size, X_MEMORY_SAMPLES);
             if (theData)
             {
                 XBlockMove(thePreSound, theData, (int32_t)size);
@@ -2120,6 +2122,249 @@ XPTR XGetSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize)
             *pReturnedSize = XGetPtrSize(theData);
         }
     }
+    XSetPtrTag(theData, X_MEMORY_SAMPLES);  // belongs to the sample cache from here on
+    return theData;
+}
+
+XPTR XGetMappedSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize)
+{
+    return XGetMappedFileSoundResourceByID(XFindSoundResourceFile(theID), theID, pReturnedSize);
+}
+
+XPTR XGetFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize)
+{
+    XPTR    thePreSound, theData;
+    uint32_t   size;
+
+    theData = XGetAndDetachFileResource(fileRef, ID_CSND, theID, pReturnedSize);
+    if (theData == NULL)
+    {
+        theData = XGetAndDetachFileResource(fileRef, ID_ESND, theID, pReturnedSize);
+        if (theData)
+        {
+            size = (uint32_t)*pReturnedSize;
+            thePreSound = theData;
+            theData = XNewTaggedPtr((int32_t)size, X_MEMORY_SAMPLES);
+            if (theData)
+            {
+                XBlockMove(thePreSound, theData, (int32_t)size);
+                XDecryptData(theData, size);
+            }
+            XDisposePtr(thePreSound);
+        }
+        if (theData == NULL)
+        {
+            theData = XGetAndDetachFileResource(fileRef, ID_SND, theID, pReturnedSize);
+        }
+    }
+    else
+    {
+        thePreSound = theData;
+        theData = XDecompressPtr(thePreSound, (uint32_t)*pReturnedSize, FALSE);
+        XDisposePtr(thePreSound);
+        if (theData)
+        {
+            *pReturnedSize = XGetPtrSize(theData);
+        }
+    }
+    XSetPtrTag(theData, X_MEMORY_SAMPLES);
+    return theData;
+}
+
+XPTR XGetMappedFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize)
+{
+    XPTR    theData;
+
+    theData = NULL;
+    // XGetSoundResourceByID prefers these, and they always have to be decoded into a copy
+    if (fileRef &&
+        (XExistsFileResource(fileRef, ID_CSND, theID) == FALSE) &&
+        (XExistsFileResource(fileRef, ID_ESND, theID) == FALSE))
+    {
+        theData = XGetMappedFileResource(fileRef, ID_SND, theID, pReturnedSize);
+        if (theData && (XIsSndUsableInPlace(theData) == FALSE))
+        {
+            XReleaseMappedPtr(theData);
+            theData = NULL;
+        }
+    }
+    return theData;
+}
+
+// Add a sound to a snapshot, padding its name so the samples start 8 byte aligned in the file
+static XERR PV_AddSnapshotSound(XFILE snapshotFile, XLongResourceID theID, XPTR pSnd)
+{
+    char        name[8];
+    int32_t     sampleStart;
+
+    // an entry is next, type, ID, the pascal name and the length, then the data, which
+    // starts with the header made by XCreateRawSoundObject
+    sampleStart = XFileGetLength(snapshotFile) + (int32_t)(sizeof(int32_t) * 4) + 1 + XRAW_SOUND_HEADER_SIZE;
+    name[0] = (char)((8 - (sampleStart & 7)) & 7);
+    XSetMemory(name + 1, 7, ' ');
+    return XAddFileResource(snapshotFile, ID_SND, theID, name, pSnd, XGetPtrSize(pSnd));
+}
+
+XERR XCreateSoundSnapshot(XFILE bankFile, XFILE snapshotFile, char const* key)
+{
+    static XResourceType const  types[] = { ID_CSND, ID_SND };
+    XSnapshotHeader             stamp;
+    SampleDataInfo              info;
+    XPTR                        theData, thePreSound, pSamples, pRaw;
+    XLongResourceID             theID;
+    int32_t                     size, count, index, keyLength;
+    XERR                        err;
+    int                         type;
+
+    if ((bankFile == NULL) || (snapshotFile == NULL) || (key == NULL))
+    {
+        return -1;
+    }
+    err = 0;
+    for (type = 0; (type < (int)(sizeof(types) / sizeof(types[0]))) && (err == 0); type++)
+    {
+        count = XCountFileResourcesOfType(bankFile, types[type]);
+        for (index = 0; (index < count) && (err == 0); index++)
+        {
+            theData = XGetIndexedFileResource(bankFile, types[type], &theID, index, NULL, &size);
+            if (theData == NULL)
+            {
+                continue;
+            }
+            if (types[type] == ID_CSND)
+            {
+                thePreSound = theData;
+                theData = XDecompressPtr(thePreSound, (uint32_t)size, FALSE);
+                XDisposePtr(thePreSound);
+            }
+            // a csnd or esnd of the same ID is played instead, and encrypted samples stay
+            // encrypted on disk. Raw samples that play in place already gain nothing.
+            else if (XExistsFileResource(bankFile, ID_CSND, theID) ||
+                     XExistsFileResource(bankFile, ID_ESND, theID) ||
+                     XIsSndUsableInPlace(theData))
+            {
+                XDisposePtr(theData);
+                theData = NULL;
+            }
+            if (theData)
+            {
+                pSamples = XGetSamplePtrFromSnd(theData, &info);
+                if (pSamples)
+                {
+                    pRaw = XCreateRawSoundObject(&info, pSamples);
+                    if (pRaw)
+                    {
+                        err = PV_AddSnapshotSound(snapshotFile, theID, pRaw);
+                        XDisposePtr(pRaw);
+                    }
+                    else
+                    {
+                        err = -2;
+                    }
+                }
+                if (info.pMasterPtr != theData)
+                {
+                    XDisposePtr(info.pMasterPtr);
+                }
+                XDisposePtr(theData);
+            }
+        }
+    }
+    if (err == 0)
+    {
+        // stamp it last, so a snapshot that didn't get finished is never used
+        XSetMemory(&stamp, (int32_t)sizeof(XSnapshotHeader), 0);
+        XPutLong(&stamp.version, XSNAPSHOT_VERSION);
+        XPutLong(&stamp.wordOrder, X_WORD_ORDER);
+        keyLength = XStrLen(key);
+        if (keyLength > XSNAPSHOT_KEY_LENGTH)
+        {
+            keyLength = XSNAPSHOT_KEY_LENGTH;
+        }
+        XBlockMove(key, stamp.key, keyLength);
+        err = XAddFileResource(snapshotFile, ID_SNAP, 0, NULL, &stamp, (int32_t)sizeof(XSnapshotHeader));
+    }
+    return err;
+}
+
+XBOOL XIsSoundSnapshotCurrent(XFILE snapshotFile, char const* key)
+{
+    XSnapshotHeader     *pStamp;
+    char                expected[XSNAPSHOT_KEY_LENGTH];
+    int32_t             size, keyLength, count;
+    XBOOL               current;
+
+    current = FALSE;
+    if (snapshotFile && key)
+    {
+        pStamp = (XSnapshotHeader *)XGetFileResource(snapshotFile, ID_SNAP, 0, NULL, &size);
+        if (pStamp)
+        {
+            if ((size == (int32_t)sizeof(XSnapshotHeader)) &&
+                (XGetLong(&pStamp->version) == XSNAPSHOT_VERSION) &&
+                (XGetLong(&pStamp->wordOrder) == X_WORD_ORDER))
+            {
+                XSetMemory(expected, XSNAPSHOT_KEY_LENGTH, 0);
+                keyLength = XStrLen(key);
+                if (keyLength > XSNAPSHOT_KEY_LENGTH)
+                {
+                    keyLength = XSNAPSHOT_KEY_LENGTH;
+                }
+                XBlockMove(key, expected, keyLength);
+                current = TRUE;
+                for (count = 0; count < XSNAPSHOT_KEY_LENGTH; count++)
+                {
+                    if (expected[count] != pStamp->key[count])
+                    {
+                        current = FALSE;
+                        break;
+                    }
+                }
+            }
+            XDisposePtr(pStamp);
+        }
+    }
+    return current;
+}
+
+// Same search order as XGetSoundResourceByID
+XFILE XFindSoundResourceFile(XLongResourceID theID)
+{
+    XFILE   owner;
+
+    owner = XFindResourceFile(ID_CSND, theID);
+    if (owner == NULL)
+    {
+        owner = XFindResourceFile(ID_ESND, theID);
+        if (owner == NULL)
+        {
+            owner = XFindResourceFile(ID_SND, theID);
+        }
+    }
+    return owner;
+}
+
+XPTR XGetSnapshotSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize)
+{
+    return XGetSnapshotFileSoundResourceByID(XFindSoundResourceFile(theID), theID, pReturnedSize);
+}
+
+XPTR XGetSnapshotFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize)
+{
+    XFILE   snapshot;
+    XPTR    theData;
+
+    theData = NULL;
+    snapshot = XFileGetSnapshot(fileRef);
+    if (snapshot)
+    {
+        theData = XGetMappedFileResource(snapshot, ID_SND, theID, pReturnedSize);
+        if (theData == NULL)
+        {
+            theData = XGetFileResource(snapshot, ID_SND, theID, NULL, pReturnedSize);
+            XSetPtrTag(theData, X_MEMORY_SAMPLES);
+        }
+    }
     return theData;
 }
 
@@ -2145,7 +2390,7 @@ XPTR XGetSoundResourceByName(void *cName, int32_t *pReturnedSize)
             {
                 // since this is encrypted, make a new copy and decrypt
                 thePreSound = theData;
-                theData = XNewPtr(*pReturnedSize);
+                theData = XNewTaggedPtr(*pReturnedSize, X_MEMORY_SAMPLES);
                 if (theData)
                 {
                     XBlockMove(thePreSound, theData, *pReturnedSize);
@@ -2162,6 +2407,7 @@ XPTR XGetSoundResourceByName(void *cName, int32_t *pReturnedSize)
         XDisposePtr(thePreSound);
         *pReturnedSize = XGetPtrSize(theData);
     }
+    XSetPtrTag(theData, X_MEMORY_SAMPLES);
     return theData;
 }
 #endif
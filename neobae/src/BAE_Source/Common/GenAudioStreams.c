@@ -314,6 +314,7 @@ struct GM_AudioStreamFileInfo
 
     XPTR                    pBlockBuffer;           // used for decompression
     uint32_t           blockSize;              // used for decompression
+    GM_StreamReadAhead      *pReadAhead;            // NULL unless decoded ahead. See GM_SetStreamReadAhead
 };
 typedef struct GM_AudioStreamFileInfo GM_AudioStreamFileInfo;
 
@@ -534,7 +535,7 @@ static STREAM_REFERENCE PV_GetEmptyAudioStream(void)
     STREAM_REFERENCE    ref;
 
     ref = DEAD_STREAM;
-    pStream = (GM_AudioStream *)XNewPtr((int32_t)sizeof(GM_AudioStream));
+    pStream = (GM_AudioStream *)XNewTaggedPtr((int32_t)sizeof(GM_AudioStream), X_MEMORY_STREAMS);
     if (pStream)
     {
         pStream->userReference = NULL;
@@ -1006,6 +1007,536 @@ OPErr GM_AudioStreamError(STREAM_REFERENCE reference)
     return theErr;
 }
 
+#if USE_HIGHLEVEL_FILE_API
+// Stream read ahead. A file stream set up while the stream decoder runs gets a ring of
+// decoded frames, which the decoder thread keeps filled so STREAM_GET_DATA only copies.
+// The decoder appends at readOffset + filled and STREAM_GET_DATA takes from readOffset.
+// countLock is only held to move those, so the mixer never waits on a decode. decodeLock
+// is held by whoever is using the file and its decoder state: the decoder thread, a seek,
+// or STREAM_GET_DATA itself while the ring isn't attached to a running decoder.
+#define MAX_STREAM_READ_AHEAD           10000   // milliseconds
+#define STREAM_READ_AHEAD_PRIME         2       // chunks decoded in line as a stream starts
+
+struct GM_StreamReadAhead
+{
+    GM_StreamReadAhead      *pNext;             // next on GM_StreamDecoder::pStreams
+    GM_AudioStreamFileInfo  *pInfo;
+    BAE_Mutex               countLock;          // guards everything from pDecoder to missingFrames
+    BAE_Mutex               decodeLock;         // guards the file, its decoder and decodePosition
+
+    GM_StreamDecoder        *pDecoder;          // set while attached
+    XBOOL                   attached;           // on the decoder's list, otherwise filled in line
+    uint32_t                readOffset;         // in bytes
+    uint32_t                filled;             // bytes decoded and not yet taken
+    uint32_t                generation;         // bumped when a seek throws the ring away
+    uint32_t                loopsAhead;         // times the decoder went back to the start before the stream did
+    XBOOL                   stalled;            // last decode added nothing. Wait for the next take
+    XBOOL                   ended;              // nothing more until a seek. decodeErr says why
+    OPErr                   decodeErr;
+    uint32_t                underruns;          // takes that came up short
+    uint32_t                missingFrames;      // frames they went without
+
+    XBYTE                   *pRing;
+    uint32_t                ringSize;           // in bytes, a whole number of chunks
+    XBYTE                   *pChunk;            // decoded into first. Some decoders only write whole blocks
+    uint32_t                chunkSize;          // in bytes, one stream buffer
+    uint32_t                decodePosition;     // like filePlaybackPosition, for the decoder
+    int16_t                 blockAlign;
+    char                    channelSize;
+    char                    dataBitSize;
+};
+
+// clear transient decoder data after going back to the start of the file
+static void PV_ClearFileStreamState(GM_AudioStreamFileInfo *pASInfo)
+{
+    switch (pASInfo->fileType)
+    {
+#if USE_MPEG_DECODER != 0
+        case FILE_MPEG_TYPE:
+            // do nothing, because in this case pBlockBuffer is our mpeg stream
+            break;
+#endif
+        default:
+            XSetMemory(pASInfo->pBlockBuffer, pASInfo->blockSize, 0);
+            break;
+    }
+}
+
+static void PV_FreeReadAhead(GM_StreamReadAhead *pRA)
+{
+    if (pRA->countLock)
+    {
+        BAE_DestroyMutex(pRA->countLock);
+    }
+    if (pRA->decodeLock)
+    {
+        BAE_DestroyMutex(pRA->decodeLock);
+    }
+    XDisposePtr((XPTR)pRA->pRing);
+    XDisposePtr((XPTR)pRA->pChunk);
+    XDisposePtr((XPTR)pRA);
+}
+
+// Called from STREAM_CREATE. Returns NULL if the stream decoder isn't running, or there
+// isn't memory for the ring, and the stream decodes in line.
+static GM_StreamReadAhead * PV_NewReadAhead(GM_AudioStreamFileInfo *pASInfo, GM_StreamData *pAS)
+{
+    GM_StreamReadAhead  *pRA;
+    uint32_t            frames;
+
+    if ((MusicGlobals == NULL) || (MusicGlobals->pStreamDecoder == NULL) || (MusicGlobals->streamReadAhead == 0))
+    {
+        return NULL;
+    }
+    pRA = (GM_StreamReadAhead *)XNewTaggedPtr((int32_t)sizeof(GM_StreamReadAhead), X_MEMORY_STREAMS);
+    if (pRA)
+    {
+        pRA->pInfo = pASInfo;
+        pRA->blockAlign = (int16_t)PV_GetSampleSizeInBytes(pAS);
+        pRA->channelSize = pAS->channelSize;
+        pRA->dataBitSize = pAS->dataBitSize;
+        pRA->decodePosition = pASInfo->filePlaybackPosition;
+
+        // never less than two stream buffers, so a whole one can always be waiting
+        frames = (MusicGlobals->streamReadAhead * XFIXED_TO_UNSIGNED_LONG(pAS->sampleRate)) / 1000;
+        frames = (frames + pAS->dataLength - 1) / pAS->dataLength;
+        if (frames < 2)
+        {
+            frames = 2;
+        }
+        pRA->chunkSize = pAS->dataLength * pRA->blockAlign;
+        pRA->ringSize = frames * pRA->chunkSize;
+        pRA->pRing = (XBYTE *)XNewTaggedPtr((int32_t)pRA->ringSize, X_MEMORY_STREAMS);
+        pRA->pChunk = (XBYTE *)XNewTaggedPtr((int32_t)pRA->chunkSize, X_MEMORY_STREAMS);
+        if ((pRA->pRing == NULL) || (pRA->pChunk == NULL) ||
+            (BAE_NewMutex(&pRA->countLock, "bae", "ring", __LINE__) == 0) ||
+            (BAE_NewMutex(&pRA->decodeLock, "bae", "rdec", __LINE__) == 0))
+        {
+            PV_FreeReadAhead(pRA);
+            pRA = NULL;
+        }
+    }
+    return pRA;
+}
+
+// Decode the next chunk into the ring, if it has room for a whole one. Like STREAM_GET_DATA,
+// it trims what's decoded past fileEndPosition, and goes back to the start of a looping
+// file. Returns FALSE if nothing changed. Called with decodeLock held.
+static XBOOL PV_FillReadAhead(GM_StreamReadAhead *pRA)
+{
+    GM_AudioStreamFileInfo  *pASInfo;
+    uint32_t                writeOffset, space, first, outputBufferSize, fileSize;
+    XBOOL                   idle, looped, ended, progressed;
+    OPErr                   err;
+
+    pASInfo = pRA->pInfo;
+    BAE_AcquireMutex(pRA->countLock);
+    idle = (pRA->ended || pRA->stalled);
+    writeOffset = (pRA->readOffset + pRA->filled) % pRA->ringSize;
+    space = pRA->ringSize - pRA->filled;
+    BAE_ReleaseMutex(pRA->countLock);
+
+    if (idle || (space < pRA->chunkSize))
+    {
+        return FALSE;
+    }
+    err = GM_ReadAndDecodeFileStream(pASInfo->fileOpenRef,
+                                        pASInfo->fileType,
+                                        pASInfo->formatType,
+                                        pASInfo->pBlockBuffer,
+                                        pASInfo->blockSize,
+                                        (XPTR)pRA->pChunk,
+                                        pRA->chunkSize / pRA->blockAlign,
+                                        pRA->channelSize,
+                                        pRA->dataBitSize,
+                                        &outputBufferSize,
+                                        &fileSize);
+    pRA->decodePosition += outputBufferSize;
+    looped = FALSE;
+    ended = FALSE;
+    if (pRA->decodePosition >= pASInfo->fileEndPosition)
+    {
+        fileSize = pRA->decodePosition - pASInfo->fileEndPosition;
+        outputBufferSize = (fileSize > outputBufferSize) ? 0 : outputBufferSize - fileSize;
+        pRA->decodePosition = pASInfo->fileEndPosition;
+        if (pASInfo->loopFile)
+        {
+            pRA->decodePosition = pASInfo->fileStartPosition;
+            err = GM_RepositionFileStream(pASInfo->fileOpenRef,
+                                            pASInfo->fileType,
+                                            pASInfo->formatType,
+                                            pASInfo->pBlockBuffer,
+                                            pASInfo->blockSize,
+                                            pRA->channelSize,
+                                            pRA->dataBitSize,
+                                            0,
+                                            pASInfo->fileStartPosition,
+                                            &pRA->decodePosition);
+            PV_ClearFileStreamState(pASInfo);
+            looped = TRUE;
+            ended = (err != NO_ERR);
+        }
+        else
+        {
+            err = STREAM_STOP_PLAY;     // we've hit the end of the file, so stop
+            ended = TRUE;
+        }
+    }
+    first = pRA->ringSize - writeOffset;
+    if (first > outputBufferSize)
+    {
+        first = outputBufferSize;
+    }
+    XBlockMove(pRA->pChunk, pRA->pRing + writeOffset, (int32_t)first);
+    XBlockMove(pRA->pChunk + first, pRA->pRing, (int32_t)(outputBufferSize - first));
+
+    BAE_AcquireMutex(pRA->countLock);
+    pRA->filled += outputBufferSize;
+    if (looped)
+    {
+        pRA->loopsAhead++;
+    }
+    if (ended)
+    {
+        pRA->ended = TRUE;
+        pRA->decodeErr = err;
+    }
+    // a decode error short of the end just comes up short, as it does in line
+    progressed = (outputBufferSize || looped || ended);
+    pRA->stalled = (progressed == FALSE);
+    BAE_ReleaseMutex(pRA->countLock);
+    return progressed;
+}
+
+// Copy up to wantBytes of decoded frames to pDest, and return the bytes copied. Once the
+// ring is empty and the decoder has ended, *pErr says why.
+static uint32_t PV_TakeReadAhead(GM_StreamReadAhead *pRA, XBYTE *pDest, uint32_t wantBytes, OPErr *pErr)
+{
+    uint32_t    readOffset, count, first, generation;
+    XBOOL       attached;
+
+    *pErr = NO_ERR;
+    BAE_AcquireMutex(pRA->countLock);
+    pRA->stalled = FALSE;       // give the decoder another try
+    attached = pRA->attached;
+    BAE_ReleaseMutex(pRA->countLock);
+    if (attached == FALSE)
+    {
+        // nobody else will fill it
+        BAE_AcquireMutex(pRA->decodeLock);
+        while ((pRA->filled < wantBytes) && PV_FillReadAhead(pRA))
+        {
+        }
+        BAE_ReleaseMutex(pRA->decodeLock);
+    }
+
+    BAE_AcquireMutex(pRA->countLock);
+    readOffset = pRA->readOffset;
+    count = pRA->filled;
+    generation = pRA->generation;
+    if ((count == 0) && pRA->ended && wantBytes)
+    {
+        *pErr = pRA->decodeErr;
+    }
+    BAE_ReleaseMutex(pRA->countLock);
+
+    // the decoder only writes outside the filled part, so this can be copied unlocked
+    if (count > wantBytes)
+    {
+        count = wantBytes;
+    }
+    first = pRA->ringSize - readOffset;
+    if (first > count)
+    {
+        first = count;
+    }
+    XBlockMove(pRA->pRing + readOffset, pDest, (int32_t)first);
+    XBlockMove(pRA->pRing, pDest + first, (int32_t)(count - first));
+
+    BAE_AcquireMutex(pRA->countLock);
+    if (pRA->generation == generation)
+    {
+        pRA->readOffset = (readOffset + count) % pRA->ringSize;
+        pRA->filled -= count;
+        if ((count < wantBytes) && (pRA->ended == FALSE))
+        {
+            pRA->underruns++;
+            pRA->missingFrames += (wantBytes - count) / pRA->blockAlign;
+        }
+    }
+    else
+    {
+        count = 0;  // a seek threw away what was copied
+    }
+    if (pRA->attached)
+    {
+        BAE_SignalEvent(pRA->pDecoder->wakeEvent);
+    }
+    BAE_ReleaseMutex(pRA->countLock);
+    return count;
+}
+
+// Called when the stream reaches the end of a looping file. TRUE if the decoder already
+// went back to the start, and the ring carries on from there.
+static XBOOL PV_TakeReadAheadLoop(GM_StreamReadAhead *pRA)
+{
+    XBOOL   looped;
+
+    BAE_AcquireMutex(pRA->countLock);
+    looped = (pRA->loopsAhead > 0);
+    if (looped)
+    {
+        pRA->loopsAhead--;
+    }
+    BAE_ReleaseMutex(pRA->countLock);
+    return looped;
+}
+
+// Throw away the ring after a seek. Called with decodeLock held.
+static void PV_ResetReadAhead(GM_StreamReadAhead *pRA)
+{
+    BAE_AcquireMutex(pRA->countLock);
+    pRA->decodePosition = pRA->pInfo->filePlaybackPosition;
+    pRA->readOffset = 0;
+    pRA->filled = 0;
+    pRA->generation++;
+    pRA->loopsAhead = 0;
+    pRA->stalled = FALSE;
+    pRA->ended = FALSE;
+    pRA->decodeErr = NO_ERR;
+    if (pRA->attached)
+    {
+        BAE_SignalEvent(pRA->pDecoder->wakeEvent);
+    }
+    BAE_ReleaseMutex(pRA->countLock);
+}
+
+// Called once the stream is set up. Decodes the first couple of chunks here, so playback
+// doesn't start by waiting on the decoder, and hands the ring to the decoder thread to fill
+// the rest.
+static void PV_StartReadAhead(GM_StreamReadAhead *pRA)
+{
+    GM_Mixer            *pMixer;
+    GM_StreamDecoder    *pDecoder;
+    uint32_t            count;
+
+    BAE_AcquireMutex(pRA->decodeLock);
+    for (count = 0; (count < STREAM_READ_AHEAD_PRIME) && PV_FillReadAhead(pRA); count++)
+    {
+    }
+    BAE_ReleaseMutex(pRA->decodeLock);
+
+    pMixer = MusicGlobals;
+    if (pMixer && pMixer->streamDecoderLock)
+    {
+        BAE_AcquireMutex(pMixer->streamDecoderLock);
+        pDecoder = pMixer->pStreamDecoder;
+        if (pDecoder)
+        {
+            BAE_AcquireMutex(pDecoder->listLock);
+            BAE_AcquireMutex(pRA->countLock);
+            pRA->pDecoder = pDecoder;
+            pRA->attached = TRUE;
+            BAE_ReleaseMutex(pRA->countLock);
+            pRA->pNext = pDecoder->pStreams;
+            pDecoder->pStreams = pRA;
+            BAE_ReleaseMutex(pDecoder->listLock);
+            BAE_SignalEvent(pDecoder->wakeEvent);
+        }
+        BAE_ReleaseMutex(pMixer->streamDecoderLock);
+    }
+}
+
+// Called from STREAM_DESTROY. Takes the ring off the decoder's list, and waits for a
+// decode the thread already started on it. GM_SetStreamReadAhead detaches every ring
+// before it frees the decoder, so a ring that isn't attached is left alone.
+static void PV_StopReadAhead(GM_StreamReadAhead *pRA)
+{
+    GM_Mixer            *pMixer;
+    GM_StreamDecoder    *pDecoder;
+    GM_StreamReadAhead  **ppLink;
+    XBOOL               attached;
+
+    BAE_AcquireMutex(pRA->countLock);
+    attached = pRA->attached;
+    BAE_ReleaseMutex(pRA->countLock);
+
+    pMixer = MusicGlobals;
+    if (attached && pMixer && pMixer->streamDecoderLock)
+    {
+        // the decoder can't be detached and freed while this is held
+        BAE_AcquireMutex(pMixer->streamDecoderLock);
+        pDecoder = pRA->pDecoder;
+        if (pDecoder)
+        {
+            BAE_AcquireMutex(pDecoder->listLock);
+            for (ppLink = &pDecoder->pStreams; *ppLink; ppLink = &(*ppLink)->pNext)
+            {
+                if (*ppLink == pRA)
+                {
+                    *ppLink = pRA->pNext;
+                    break;
+                }
+            }
+            BAE_AcquireMutex(pRA->countLock);
+            pRA->pDecoder = NULL;
+            pRA->attached = FALSE;
+            BAE_ReleaseMutex(pRA->countLock);
+            BAE_ReleaseMutex(pDecoder->listLock);
+        }
+        BAE_ReleaseMutex(pMixer->streamDecoderLock);
+    }
+    BAE_AcquireMutex(pRA->decodeLock);
+    BAE_ReleaseMutex(pRA->decodeLock);
+}
+
+// Each pass decodes one chunk for every ring with room, so a long ring filling up can't
+// starve the others, until all are full or ended. Takes and seeks wake it again.
+static void PV_StreamDecoderProc(void *context)
+{
+    GM_StreamDecoder    *pDecoder;
+    GM_StreamReadAhead  *pRA;
+    XBOOL               busy;
+    uint32_t            index, count;
+
+    pDecoder = (GM_StreamDecoder *)context;
+    while (1)
+    {
+        BAE_WaitEvent(pDecoder->wakeEvent);
+        if (pDecoder->quit)
+        {
+            break;
+        }
+        busy = TRUE;
+        while (busy && (pDecoder->quit == FALSE))
+        {
+            busy = FALSE;
+            for (index = 0; pDecoder->quit == FALSE; index++)
+            {
+                // the ring's decodeLock keeps it alive once listLock is let go
+                BAE_AcquireMutex(pDecoder->listLock);
+                pRA = pDecoder->pStreams;
+                for (count = 0; pRA && (count < index); count++)
+                {
+                    pRA = pRA->pNext;
+                }
+                if (pRA)
+                {
+                    BAE_AcquireMutex(pRA->decodeLock);
+                }
+                BAE_ReleaseMutex(pDecoder->listLock);
+                if (pRA == NULL)
+                {
+                    break;
+                }
+                if (PV_FillReadAhead(pRA))
+                {
+                    busy = TRUE;
+                }
+                BAE_ReleaseMutex(pRA->decodeLock);
+            }
+        }
+    }
+}
+
+static void PV_FreeStreamDecoder(GM_StreamDecoder *pDecoder)
+{
+    if (pDecoder->wakeEvent)
+    {
+        BAE_DestroyEvent(pDecoder->wakeEvent);
+    }
+    if (pDecoder->listLock)
+    {
+        BAE_DestroyMutex(pDecoder->listLock);
+    }
+    XDisposePtr((XPTR)pDecoder);
+}
+
+// Decode file streams this many milliseconds ahead on a thread of their own, or 0 to
+// decode them when the mixer asks. This applies to streams set up from then on, though
+// turning it off moves every stream back to decoding in line. Fails with NOT_SETUP if
+// the platform can't start threads. Do not call at interrupt time.
+OPErr GM_SetStreamReadAhead(XDWORD milliseconds)
+{
+    GM_Mixer            *pMixer;
+    GM_StreamDecoder    *pDecoder;
+    GM_StreamReadAhead  *pRA;
+
+    pMixer = MusicGlobals;
+    if ((pMixer == NULL) || (pMixer->streamDecoderLock == NULL))
+    {
+        return NOT_SETUP;
+    }
+    if (milliseconds > MAX_STREAM_READ_AHEAD)
+    {
+        milliseconds = MAX_STREAM_READ_AHEAD;
+    }
+    if (milliseconds)
+    {
+        if (pMixer->pStreamDecoder == NULL)
+        {
+            pDecoder = (GM_StreamDecoder *)XNewTaggedPtr((int32_t)sizeof(GM_StreamDecoder), X_MEMORY_STREAMS);
+            if (pDecoder == NULL)
+            {
+                return MEMORY_ERR;
+            }
+            if ((BAE_NewMutex(&pDecoder->listLock, "bae", "sdec", __LINE__) == 0) ||
+                (BAE_NewEvent(&pDecoder->wakeEvent) == 0) ||
+                (BAE_NewWorkerThread(&pDecoder->thread, PV_StreamDecoderProc, pDecoder) == 0))
+            {
+                PV_FreeStreamDecoder(pDecoder);
+                return NOT_SETUP;
+            }
+            BAE_AcquireMutex(pMixer->streamDecoderLock);
+            pMixer->pStreamDecoder = pDecoder;
+            BAE_ReleaseMutex(pMixer->streamDecoderLock);
+        }
+    }
+    else
+    {
+        BAE_AcquireMutex(pMixer->streamDecoderLock);
+        pDecoder = pMixer->pStreamDecoder;
+        if (pDecoder)
+        {
+            // the rings stay with their streams, which fill them in line from now on
+            BAE_AcquireMutex(pDecoder->listLock);
+            while (pDecoder->pStreams)
+            {
+                pRA = pDecoder->pStreams;
+                pDecoder->pStreams = pRA->pNext;
+                pRA->pNext = NULL;
+                BAE_AcquireMutex(pRA->countLock);
+                pRA->pDecoder = NULL;
+                pRA->attached = FALSE;
+                BAE_ReleaseMutex(pRA->countLock);
+            }
+            pMixer->pStreamDecoder = NULL;
+            BAE_ReleaseMutex(pDecoder->listLock);
+        }
+        BAE_ReleaseMutex(pMixer->streamDecoderLock);
+
+        if (pDecoder)
+        {
+            pDecoder->quit = TRUE;
+            BAE_SignalEvent(pDecoder->wakeEvent);
+            BAE_JoinWorkerThread(pDecoder->thread);
+            PV_FreeStreamDecoder(pDecoder);
+        }
+    }
+    pMixer->streamReadAhead = milliseconds;
+    return NO_ERR;
+}
+
+XDWORD GM_GetStreamReadAhead(void)
+{
+    if (MusicGlobals)
+    {
+        return MusicGlobals->streamReadAhead;
+    }
+    return 0;
+}
+#endif  // USE_HIGHLEVEL_FILE_API
+
 #if USE_HIGHLEVEL_FILE_API
 // streaming file callback. Used for GM_AudioStreamFileStart to decode typed files.
 static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_StreamData *pAS)
@@ -1049,7 +1580,7 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
 
                         // remember to take in account that the data length passed is always in audio frames not bytes
                         bufferSize = pAS->dataLength * pAS->channelSize * (pAS->dataBitSize / 8);
-                        pAS->pData = XNewPtr(bufferSize);
+                        pAS->pData = XNewTaggedPtr(bufferSize, X_MEMORY_STREAMS);
                         if (pAS->pData)
                         {
                             error = NO_ERR;
@@ -1074,7 +1605,7 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
                         // remember to take in account that the data length passed is always in audio frames not bytes
                         bufferSize = pAS->dataLength * pAS->channelSize * (pAS->dataBitSize / 8);
 
-                        pAS->pData = XNewPtr(bufferSize);
+                        pAS->pData = XNewTaggedPtr(bufferSize, X_MEMORY_STREAMS);
                         if (pAS->pData)
                         {
                             error = NO_ERR;
@@ -1090,12 +1621,22 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
                         error = GENERAL_BAD;
                     }
             }
+            if (error == NO_ERR)
+            {
+                pASInfo->pReadAhead = PV_NewReadAhead(pASInfo, pAS);
+            }
             break;
         case STREAM_DESTROY:
             #if DEBUG_STREAMS
             BAE_PRINTF("PV_FileStreamCallback::STREAM_DESTROY\r");
             #endif
             pASInfo = (GM_AudioStreamFileInfo *)pAS->userReference;
+            if (pASInfo->pReadAhead)
+            {
+                PV_StopReadAhead(pASInfo->pReadAhead);
+                PV_FreeReadAhead(pASInfo->pReadAhead);
+                pASInfo->pReadAhead = NULL;
+            }
 
             switch (pASInfo->fileType)
             {
@@ -1136,6 +1677,10 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
                 samplePosition = pAS->framePosition * blockAlign;   // convert from bytes to samples
                 if (samplePosition < pASInfo->fileEndPosition)
                 {
+                    if (pASInfo->pReadAhead)
+                    {
+                        BAE_AcquireMutex(pASInfo->pReadAhead->decodeLock);
+                    }
                     pASInfo->filePlaybackPosition = pASInfo->fileStartPosition + samplePosition;
 
                     // ok now we know we're in range, so seek the file
@@ -1149,6 +1694,11 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
                                                             pAS->framePosition,
                                                             pASInfo->fileStartPosition,
                                                             &pASInfo->filePlaybackPosition);
+                    if (pASInfo->pReadAhead)
+                    {
+                        PV_ResetReadAhead(pASInfo->pReadAhead);
+                        BAE_ReleaseMutex(pASInfo->pReadAhead->decodeLock);
+                    }
                 }
                 else
                 {
@@ -1173,18 +1723,41 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
             blockAlign = (int16_t)PV_GetSampleSizeInBytes(pAS);
             if (pAS->pData)
             {
-                // get the desired length, and account for stereo and bit size
-                error  = GM_ReadAndDecodeFileStream(    pASInfo->fileOpenRef,
-                                                            pASInfo->fileType,
-                                                            pASInfo->formatType,
-                                                            pASInfo->pBlockBuffer,
-                                                            pASInfo->blockSize,
-                                                            (XPTR)pAS->pData,
-                                                            pAS->dataLength,
-                                                            pAS->channelSize,
-                                                            pAS->dataBitSize,
-                                                            &outputBufferSize,
-                                                            &fileSize);
+                if (pASInfo->pReadAhead)
+                {
+                    // already decoded. Stop at the end of the file, which the decoder may have looped past
+                    bufferSize = pAS->dataLength * blockAlign;
+                    fileSize = 0;
+                    if (pASInfo->filePlaybackPosition < pASInfo->fileEndPosition)
+                    {
+                        fileSize = pASInfo->fileEndPosition - pASInfo->filePlaybackPosition;
+                    }
+                    if (bufferSize > fileSize)
+                    {
+                        bufferSize = fileSize;
+                    }
+                    outputBufferSize = PV_TakeReadAhead(pASInfo->pReadAhead, (XBYTE *)pAS->pData, bufferSize, &error);
+                    if (error != NO_ERR)
+                    {
+                        pAS->dataLength = 0;
+                        break;
+                    }
+                }
+                else
+                {
+                    // get the desired length, and account for stereo and bit size
+                    error  = GM_ReadAndDecodeFileStream(    pASInfo->fileOpenRef,
+                                                                pASInfo->fileType,
+                                                                pASInfo->formatType,
+                                                                pASInfo->pBlockBuffer,
+                                                                pASInfo->blockSize,
+                                                                (XPTR)pAS->pData,
+                                                                pAS->dataLength,
+                                                                pAS->channelSize,
+                                                                pAS->dataBitSize,
+                                                                &outputBufferSize,
+                                                                &fileSize);
+                }
 
                 #if DEBUG_STREAMS && 1
                     BAE_PRINTF("STREAM_GET_DATA::frames %ld outputBufferSize %ld fileSize %ld", pAS->dataLength, outputBufferSize, fileSize);
@@ -1230,23 +1803,29 @@ static OPErr PV_FileStreamCallback(void *context, GM_StreamMessage message, GM_S
 
                         pStream->streamPlaybackResetToThisPosition = pASInfo->fileStartPosition / blockAlign;
 */
-                        savePos = pStream->streamPlaybackPosition;
-                        error = GM_AudioStreamSetFileSamplePosition((STREAM_REFERENCE)pAS->streamReference,
-                                        pStream->streamPlaybackResetToThisPosition);
-                        pStream->streamPlaybackPosition = savePos;
-
-
-                        switch (pASInfo->fileType)
+                        if (pASInfo->pReadAhead && PV_TakeReadAheadLoop(pASInfo->pReadAhead))
                         {
-#if USE_MPEG_DECODER != 0
-                            case FILE_MPEG_TYPE:
-                                // do nothing, because in this case pBlockBuffer is our mpeg stream
-                                break;
-#endif
-                            default:
-                                // clear transient data
-                                XSetMemory(pASInfo->pBlockBuffer, pASInfo->blockSize, 0);
-                                break;
+                            // the decoder went back to the start already, and the ring carries on from there
+                            pASInfo->filePlaybackPosition = pASInfo->fileStartPosition;
+                        }
+                        else
+                        {
+                            // the lock is recursive, and keeps the decoder off the file until its state is cleared
+                            if (pASInfo->pReadAhead)
+                            {
+                                BAE_AcquireMutex(pASInfo->pReadAhead->decodeLock);
+                            }
+                            savePos = pStream->streamPlaybackPosition;
+                            error = GM_AudioStreamSetFileSamplePosition((STREAM_REFERENCE)pAS->streamReference,
+                                            pStream->streamPlaybackResetToThisPosition);
+                            pStream->streamPlaybackPosition = savePos;
+
+                            // clear transient data
+                            PV_ClearFileStreamState(pASInfo);
+                            if (pASInfo->pReadAhead)
+                            {
+                                BAE_ReleaseMutex(pASInfo->pReadAhead->decodeLock);
+                            }
                         }
                     }
                     else
@@ -1346,6 +1925,46 @@ XBOOL GM_AudioStreamGetLoop(STREAM_REFERENCE reference)
     }
     return loopFile;
 }
+
+// Get the read ahead counters of a audio stream. Fails with NOT_SETUP if it isn't decoded
+// ahead. Any pointer can be NULL.
+OPErr GM_AudioStreamGetReadAheadStats(STREAM_REFERENCE reference, uint32_t *pUnderruns, uint32_t *pMissingFrames,
+                                        uint32_t *pBufferedFrames, uint32_t *pCapacityFrames)
+{
+    GM_AudioStream      *pStream;
+    GM_StreamReadAhead  *pRA;
+    uint32_t            underruns, missingFrames, bufferedFrames, capacityFrames;
+
+    pStream = PV_AudioStreamGetFromReference(reference);
+    if ((pStream == NULL) || (pStream->pFileStream == NULL) || (pStream->pFileStream->pReadAhead == NULL))
+    {
+        return NOT_SETUP;
+    }
+    pRA = pStream->pFileStream->pReadAhead;
+    BAE_AcquireMutex(pRA->countLock);
+    underruns = pRA->underruns;
+    missingFrames = pRA->missingFrames;
+    bufferedFrames = pRA->filled / pRA->blockAlign;
+    capacityFrames = pRA->ringSize / pRA->blockAlign;
+    BAE_ReleaseMutex(pRA->countLock);
+    if (pUnderruns)
+    {
+        *pUnderruns = underruns;
+    }
+    if (pMissingFrames)
+    {
+        *pMissingFrames = missingFrames;
+    }
+    if (pBufferedFrames)
+    {
+        *pBufferedFrames = bufferedFrames;
+    }
+    if (pCapacityFrames)
+    {
+        *pCapacityFrames = capacityFrames;
+    }
+    return NO_ERR;
+}
 #endif
 
 #if USE_HIGHLEVEL_FILE_API != FALSE
@@ -1368,7 +1987,7 @@ STREAM_REFERENCE GM_AudioStreamFileSetup(void *threadContext,
     pWaveform = GM_ReadFileInformation(file, fileType, &format, &blockPtr, &blockSize, &err);
     if (pWaveform && (err == NO_ERR))
     {
-        pStream = (GM_AudioStreamFileInfo *)XNewPtr((int32_t)sizeof(GM_AudioStreamFileInfo));
+        pStream = (GM_AudioStreamFileInfo *)XNewTaggedPtr((int32_t)sizeof(GM_AudioStreamFileInfo), X_MEMORY_STREAMS);
         if (pStream)
         {
             pStream->playbackFile = *file;
@@ -1382,7 +2001,7 @@ STREAM_REFERENCE GM_AudioStreamFileSetup(void *threadContext,
             }
             else if (blockSize)
             {
-                pStream->pBlockBuffer = XNewPtr(blockSize);
+                pStream->pBlockBuffer = XNewTaggedPtr(blockSize, X_MEMORY_STREAMS);
             }
             // now the file is positioned right at the data block
             pStream->filePlaybackPosition = pWaveform->currentFilePosition;
@@ -1403,6 +2022,10 @@ STREAM_REFERENCE GM_AudioStreamFileSetup(void *threadContext,
                                                 pWaveform->sampledRate,
                                                 pWaveform->bitSize,
                                                 pWaveform->channels);
+            if ((reference != DEAD_STREAM) && pStream->pReadAhead)
+            {
+                PV_StartReadAhead(pStream->pReadAhead);
+            }
         }
         XDisposePtr(pWaveform);
     }
@@ -3125,7 +3748,7 @@ LINKED_STREAM_REFERENCE GM_NewLinkedStreamList(STREAM_REFERENCE reference, void
     pNew = NULL;
     if (GM_IsAudioStreamValid(reference))
     {
-        pNew = (GM_LinkedStream *)XNewPtr(sizeof(GM_LinkedStream));
+        pNew = (GM_LinkedStream *)XNewTaggedPtr(sizeof(GM_LinkedStream), X_MEMORY_STREAMS);
         if (pNew)
         {
             pNew->playbackReference = reference;
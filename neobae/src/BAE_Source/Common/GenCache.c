@@ -79,12 +79,55 @@
 
 //#define DISPLAY_INSTRUMENTS   1
 
+// One block of decoded sample frames in the pool, shared by every pooled sample that
+// decodes to the same bytes
+typedef struct GM_SampleData GM_SampleData;
+struct GM_SampleData
+{
+    GM_SampleData *         pNext;          // next block in the same bucket
+    uint64_t                contentHash;    // see PV_HashSampleData
+    uint32_t                length;         // bytes at pSampleData
+    int16_t                 bitSize;
+    int16_t                 channels;
+    int32_t                 references;     // pool entries using this
+    XPTR                    pMasterPtr;     // owns the data
+    XPTR                    pSampleData;
+};
+
+// One decoded sample in the process wide pool, see "Shared sample pool" below
+typedef struct GM_SharedSample GM_SharedSample;
+struct GM_SharedSample
+{
+    GM_SharedSample *       pNext;          // next entry in the same bucket
+    uint64_t                bankKey;        // XFileGetContentKey of the sample's bank
+    XSampleID               theID;
+    int32_t                 references;     // cache entries using this, across all mixers
+    SampleDataInfo          info;           // as conformed and loop checked, pMasterPtr is pData's
+    XPTR                    pSampleData;
+    GM_SampleData *         pData;
+};
+
 // Private Prototypes
 static OPErr PV_FreeCacheEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache);
+static GM_SampleCacheEntry * PV_ReferenceCacheEntry(GM_Mixer * pMixer, XSampleID theID, XBankToken bankToken);
+static void PV_DisposeSampleData(XPTR pData);
 UINT32 PV_GetCacheIndexFromCachePtr(GM_Mixer * pMixer,
                                     GM_SampleCacheEntry * pCache,
                                     OPErr * pErr);
 OPErr PV_PlaceSampleInCache(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache);
+static void PV_AddCacheToIndex(GM_Mixer * pMixer, UINT32 slot);
+static void PV_RemoveCacheFromIndex(GM_Mixer * pMixer, UINT32 slot);
+static GM_SharedSample * PV_AcquireSharedSample(uint64_t bankKey, XSampleID theID);
+static GM_SharedSample * PV_PublishSharedSample(uint64_t bankKey, XSampleID theID,
+                                                SampleDataInfo const * pInfo, XPTR pSampleData);
+static void PV_ReleaseSharedSample(GM_SharedSample * pShared);
+static void PV_TrimSampleCache(GM_Mixer * pMixer, uint32_t incomingBytes);
+static XBOOL PV_EvictIdleEntry(GM_Mixer * pMixer);
+static void PV_AddIdleEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache);
+static void PV_RemoveIdleEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache);
+static XBOOL PV_IsIdleEntryStale(const GM_SampleCacheEntry * pCache);
+static XPTR PV_ReadSampleResource(XFILE sampleFile, XSampleID theID);
+static XPTR PV_DecodeSampleData(XPTR theData, SampleDataInfo * pInfo);
 
 // if CONFORM_SAMPLES is 1, then sample data is modified to match, as closely as possible
 // the hardware output. Sample rate conversion is not appiled.
@@ -105,191 +148,1145 @@ static XPTR PV_ConvertToMono(XPTR pSamples, SampleDataInfo *pInfo)
     {
         if (pInfo->channels > 1)
         {
-            sizeb = pInfo->frames * ((pInfo->bitSize == 16) ? sizeof(int16_t) : sizeof(char));
-            newData = XNewPtr((int32_t)sizeb);
-            if (newData)
+            sizeb = pInfo->frames * ((pInfo->bitSize == 16) ? sizeof(int16_t) : sizeof(char));
+            newData = XNewTaggedPtr((int32_t)sizeb, X_MEMORY_SAMPLES);
+            if (newData)
+            {
+                if (pInfo->bitSize == 16)
+                {
+                    dest16 = (XWORD *)newData;
+                    src16 = (XWORD *)pSamples;
+                    for (count = 0; count < pInfo->frames; count++)
+                    {
+                        dest16[count] = (src16[count] + src16[count+1]) / 2;
+                        dest16++;
+                        src16 += 2;
+                    }
+                }
+                else
+                {
+                    dest8 = (XBYTE *)newData;
+                    src8 = (XBYTE *)pSamples;
+                    for (count = 0; count < pInfo->frames; count++)
+                    {
+                        dest8[count] = (src8[count] + src8[count+1]) / 2;
+                        dest8++;
+                        src8 += 2;
+                    }
+                }
+                pInfo->channels = 1;
+                pInfo->size = sizeb;
+            }
+        }
+    }
+    return newData;
+}
+#endif
+
+#if USE_16_BIT_OUTPUT == FALSE
+static XPTR PV_ConvertTo8Bit(XPTR pSamples, SampleDataInfo *pInfo)
+{
+    XPTR    newData = NULL;
+
+    if (pSamples && pInfo)
+    {
+        if (pInfo->bitSize != 8)
+        {
+            newData = XConvert16BitTo8Bit((XWORD *)pSamples, pInfo->frames, pInfo->channels);
+            if (newData)
+            {
+                XDisposePtr(pSamples);
+                pInfo->bitSize = 8;
+                pInfo->size = pInfo->frames * sizeof(char);
+            }
+        }
+    }
+    return newData;
+}
+#endif
+#endif
+
+// Sample data either belongs to us or is on loan from a mapped bank file. Mapped references
+// are counted under their own lock, so the prefetch decoders and the pool give back their
+// duplicates here without holding theirs while another thread takes a new one.
+static void PV_DisposeSampleData(XPTR pData)
+{
+    if (XReleaseMappedPtr(pData) == FALSE)
+    {
+        XDisposePtr(pData);
+    }
+}
+
+/******************************************************************************
+*******************************************************************************
+*******************************************************************************
+**
+**  Functions which directly manipulate the Sample Cache
+**
+*******************************************************************************
+*******************************************************************************
+******************************************************************************/
+
+/******************************************************************************
+**
+**  Sample cache lock
+**
+**  Covers each mixer's cache table, hash index, idle list and counters, and
+**      nothing else. The sequencer places embedded samples in the cache while
+**      the instrument loader thread holds its own lock for whole decodes, so
+**      this one is never held while a sample is read or decoded, only while
+**      the tables change. It's taken inside the lock around the pool, never
+**      the other way round. Recursive, like every BAE_Mutex. If it can't be
+**      made, the cache goes unlocked, as before.
+**
+******************************************************************************/
+static BAE_Mutex            g_sampleCacheLock = NULL;
+
+// Called as each mixer is set up. Shared by every mixer, so never freed.
+void GMCache_InitSampleCacheLock(void)
+{
+    if (g_sampleCacheLock == NULL)
+    {
+        if (BAE_NewMutex(&g_sampleCacheLock, "bae", "scache", __LINE__) == 0)
+        {
+            g_sampleCacheLock = NULL;
+        }
+    }
+}
+
+static void PV_AcquireSampleCacheLock(void)
+{
+    if (g_sampleCacheLock)
+    {
+        BAE_AcquireMutex(g_sampleCacheLock);
+    }
+}
+
+static void PV_ReleaseSampleCacheLock(void)
+{
+    if (g_sampleCacheLock)
+    {
+        BAE_ReleaseMutex(g_sampleCacheLock);
+    }
+}
+
+// The cache entry for theID with one more reference, or NULL if it isn't cached. Found
+// and referenced under the one lock, so the entry can't be evicted in between.
+static GM_SampleCacheEntry * PV_ReferenceCacheEntry(GM_Mixer * pMixer, XSampleID theID, XBankToken bankToken)
+{
+    GM_SampleCacheEntry *   pCache;
+    OPErr                   err;
+
+    PV_AcquireSampleCacheLock();
+    pCache = GMCache_GetCachePtrFromID(pMixer, theID, bankToken, &err);
+    if (pCache)
+    {
+        GMCache_IncrCacheEntryRef(pMixer, pCache);
+    }
+    PV_ReleaseSampleCacheLock();
+    return pCache;
+}
+
+
+/******************************************************************************
+**
+**  PV_ReadSampleResource
+**
+**  Gets the encoded sample resource theID from sampleFile, or from the open
+**      resource files if it's NULL. Samples decoded ahead of time, or raw in
+**      a mapped bank, are played where they lie. The rest are copied. Not
+**      thread safe, like the rest of the resource file code.
+**
+******************************************************************************/
+static XPTR PV_ReadSampleResource(XFILE sampleFile, XSampleID theID)
+{
+    XPTR    theData;
+    INT32   size;
+
+    if (sampleFile)
+    {
+        theData = XGetSnapshotFileSoundResourceByID(sampleFile, theID, &size);
+        if (theData == NULL)
+        {
+            theData = XGetMappedFileSoundResourceByID(sampleFile, theID, &size);
+        }
+        if (theData == NULL)
+        {
+            theData = XGetFileSoundResourceByID(sampleFile, theID, &size);
+        }
+        return theData;
+    }
+    theData = XGetSnapshotSoundResourceByID(theID, &size);
+    if (theData == NULL)
+    {
+        theData = XGetMappedSoundResourceByID(theID, &size);
+    }
+    if (theData == NULL)
+    {
+        theData = XGetSoundResourceByID(theID, &size);
+    }
+    return theData;
+}
+
+/******************************************************************************
+**
+**  PV_DecodeSampleData
+**
+**  Decodes a sample resource read with PV_ReadSampleResource, conforms it to
+**      the output and checks its loop points. theData is owned by the result
+**      afterwards, or freed. Returns NULL if theData isn't a sample. Only
+**      touches the memory passed, so more than one thread can decode at once.
+**
+******************************************************************************/
+static XPTR PV_DecodeSampleData(XPTR theData, SampleDataInfo * pInfo)
+{
+    XPTR    thePreSound;
+
+    thePreSound = XGetSamplePtrFromSnd(theData, pInfo);
+
+    if (pInfo->pMasterPtr != theData)
+    {
+        PV_DisposeSampleData(theData);
+    }
+
+    #if CONFORM_SAMPLES
+        #if USE_STEREO_OUTPUT == FALSE
+            if (pInfo->channels > 1)
+            {
+                thePreSound = PV_ConvertToMono(thePreSound, pInfo);
+            }
+        #endif
+        #if USE_16_BIT_OUTPUT == FALSE
+            if (pInfo->bitSize == 16)
+            {
+                thePreSound = PV_ConvertTo8Bit(thePreSound, pInfo);
+            }
+        #endif
+    #endif
+    if (thePreSound)
+    {
+        if ((pInfo->loopStart > pInfo->loopEnd) ||
+            (pInfo->loopEnd > pInfo->frames) ||
+            ((pInfo->loopEnd - pInfo->loopStart) < MIN_LOOP_SIZE) )
+        {
+            pInfo->loopStart = 0;
+            pInfo->loopEnd = 0;
+        }
+        XSetPtrTag(pInfo->pMasterPtr, X_MEMORY_SAMPLES);   // the cache owns the sample data now
+        if (thePreSound != pInfo->pMasterPtr)
+        {
+            XSetPtrTag(thePreSound, X_MEMORY_SAMPLES);
+        }
+    }
+    return thePreSound;
+}
+
+
+/******************************************************************************
+**
+**  GMCache_BuildSampleCacheEntry (previously PV_GetSampleData and
+**                                            GMCache_BuildCacheSample)
+**
+**  This function:
+**      * Takes either an XSampleID/XBankToken pair or a PCM sample pointer,
+**      * Creates and fills out a cache entry,
+**      * Places it in the cache (so it has a reference count of one), and
+**      * Returns a pointer to that entry.
+**  The cache entry data structure contains, among other things, a pointer to
+**      the PCM sound data.
+**  If a pointer to PCM data is passed (UseThisSnd), it is not disposed after
+**      use, so you must dispose of it.
+**  If the sample is cached already, or gets cached by another thread while
+**      this one decodes it, that entry is returned with another reference
+**      instead, so callers needn't look it up first.
+**  GMCache_BuildSampleCacheEntryFromFile reads the sample from sampleFile
+**      rather than the first open resource file that has theID, for loads
+**      made after the files around it may have changed.
+**
+**  ????.??.?? ???  Function created
+**  2000.05.02 AER  Renamed function BuildCacheSampleData, since that's what
+**                      it really does, after all...
+**                  Funtion previously returned redundant data -- the out
+**                      parameter pCache contained theSound as a member...
+**                      Now, return an OPErr, and have caller use pCache
+**
+******************************************************************************/
+static GM_SampleCacheEntry * PV_BuildSampleCacheEntry(GM_Mixer * pMixer,
+                                                      const XSampleID theID,
+                                                      const XBankToken bankToken,
+                                                      const XPTR useThisSnd,
+                                                      XFILE sampleFile,
+                                                      OPErr * pErr)
+{
+    XPTR                    theData, thePreSound;
+    GM_SampleCacheEntry *   pCache;
+    GM_SampleCacheEntry *   pExisting;
+    GM_SharedSample *       pShared;
+    SampleDataInfo          newSoundInfo;
+    uint64_t                bankKey;
+
+    *pErr = NO_ERR;
+    pCache = NULL;
+    pShared = NULL;
+    thePreSound = NULL;
+    bankKey = 0;
+
+    // already cached, so just take another reference
+    pCache = PV_ReferenceCacheEntry(pMixer, theID, bankToken);
+    if (pCache)
+    {
+        return pCache;
+    }
+
+    if (useThisSnd)
+    {
+        theData = useThisSnd;
+    }
+    else
+    {
+        // another song or mixer may have decoded this sample from the same bank already
+        bankKey = XFileGetContentKey(sampleFile ? sampleFile : XFindSoundResourceFile(theID));
+        pShared = PV_AcquireSharedSample(bankKey, theID);
+        theData = NULL;
+        if (pShared == NULL)
+        {
+            theData = PV_ReadSampleResource(sampleFile, theID);
+        }
+    }
+    if (pShared)
+    {
+        newSoundInfo = pShared->info;
+        thePreSound = pShared->pSampleData;
+    }
+    else if (theData)
+    {
+        thePreSound = PV_DecodeSampleData(theData, &newSoundInfo);
+        if (thePreSound)
+        {
+            // hand it to the pool. If someone beat us to it we get their copy back instead.
+            pShared = PV_PublishSharedSample(bankKey, theID, &newSoundInfo, thePreSound);
+            if (pShared)
+            {
+                newSoundInfo = pShared->info;
+                thePreSound = pShared->pSampleData;
+            }
+        }
+    }
+    else
+    {
+        *pErr = BAD_SAMPLE;
+        return NULL;
+    }
+
+    if (thePreSound)
+    {
+        pCache = (GM_SampleCacheEntry *) XNewTaggedPtr(sizeof(GM_SampleCacheEntry), X_MEMORY_SAMPLES);
+        if (pCache)
+        {
+            pCache->theID = theID;
+            pCache->bankToken = bankToken;
+            pCache->referenceCount = 0;
+            pCache->waveSize = newSoundInfo.size;
+            pCache->waveFrames = newSoundInfo.frames;
+            pCache->loopStart = newSoundInfo.loopStart;
+            pCache->loopEnd = newSoundInfo.loopEnd;
+            pCache->baseKey = newSoundInfo.baseKey;
+            pCache->bitSize = (char)newSoundInfo.bitSize;
+            pCache->channels = (char)newSoundInfo.channels;
+            pCache->rate = newSoundInfo.rate;
+            pCache->pSampleData = thePreSound;
+            pCache->pMasterPtr = newSoundInfo.pMasterPtr;
+            pCache->pShared = pShared;
+            pCache->tokenKey = XFileGetContentKey(bankToken.xFile);
+            pCache->pIdlePrev = NULL;
+            pCache->pIdleNext = NULL;
+
+            PV_AcquireSampleCacheLock();
+            // the sequencer or the loader may have placed it while we decoded
+            pExisting = PV_ReferenceCacheEntry(pMixer, theID, bankToken);
+            if (pExisting == NULL)
+            {
+                pMixer->sampleCacheStats.misses++;
+                // make room under the budget by letting go of samples nothing uses
+                PV_TrimSampleCache(pMixer, newSoundInfo.size);
+                PV_PlaceSampleInCache(pMixer, pCache);
+            }
+            PV_ReleaseSampleCacheLock();
+            if (pExisting)
+            {
+                if (pShared)
+                {
+                    PV_ReleaseSharedSample(pShared);
+                }
+                else
+                {
+                    PV_DisposeSampleData(newSoundInfo.pMasterPtr);
+                }
+                XDisposePtr(pCache);
+                pCache = pExisting;
+            }
+        }
+        else
+        {
+            if (pShared)
+            {
+                PV_ReleaseSharedSample(pShared);
+            }
+            else
+            {
+                PV_DisposeSampleData(newSoundInfo.pMasterPtr);
+            }
+            *pErr = MEMORY_ERR;
+        }
+    }
+    else
+    {
+        *pErr = MEMORY_ERR;
+    }
+    return pCache;
+}
+
+GM_SampleCacheEntry * GMCache_BuildSampleCacheEntry(GM_Mixer * pMixer,
+                                                    const XSampleID theID,
+                                                    const XBankToken bankToken,
+                                                    const XPTR useThisSnd,
+                                                    OPErr * pErr)
+{
+    return PV_BuildSampleCacheEntry(pMixer, theID, bankToken, useThisSnd, NULL, pErr);
+}
+
+GM_SampleCacheEntry * GMCache_BuildSampleCacheEntryFromFile(GM_Mixer * pMixer,
+                                                            const XSampleID theID,
+                                                            const XBankToken bankToken,
+                                                            XFILE sampleFile,
+                                                            OPErr * pErr)
+{
+    return PV_BuildSampleCacheEntry(pMixer, theID, bankToken, NULL, sampleFile, pErr);
+}
+
+
+/******************************************************************************
+**
+**  Sample cache index
+**
+**  The mixer keeps two open addressing tables next to sampleCaches, one keyed
+**      on sample ID and bank token and one keyed on the sample data pointer.
+**      Each holds the sampleCaches slot + 1, with 0 meaning empty. Probing is
+**      linear and removal shifts the rest of the chain back, so there are no
+**      tombstones to clean up. The tables are twice the size of the cache so
+**      lookups stay close to one probe.
+**
+******************************************************************************/
+#define PV_CACHE_HASH_MASK      (MAX_SAMPLE_CACHE_HASH - 1)
+
+static UINT32 PV_MixCacheKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return (UINT32)key & PV_CACHE_HASH_MASK;
+}
+
+static UINT32 PV_HashCacheID(XSampleID theID, XBankToken bankToken)
+{
+    uint64_t    key;
+
+    key = (uint64_t)(uintptr_t)bankToken.xFile;
+    key ^= (uint64_t)(uint32_t)bankToken.fileLen << 32;
+    key ^= (uint64_t)(uint32_t)theID * 0x9E3779B97F4A7C15ULL;
+    return PV_MixCacheKey(key);
+}
+
+static UINT32 PV_HashCachePtr(XPTR pSample)
+{
+    return PV_MixCacheKey((uint64_t)(uintptr_t)pSample);
+}
+
+static UINT32 PV_GetCacheHome(const GM_Mixer * pMixer, const XWORD * pTable, UINT32 slot)
+{
+    GM_SampleCacheEntry *   pCache;
+
+    pCache = pMixer->sampleCaches[slot];
+    if (pTable == pMixer->sampleCacheIDHash)
+    {
+        return PV_HashCacheID(pCache->theID, pCache->bankToken);
+    }
+    return PV_HashCachePtr(pCache->pSampleData);
+}
+
+static void PV_InsertCacheHash(XWORD * pTable, UINT32 home, UINT32 slot)
+{
+    while (pTable[home])
+    {
+        home = (home + 1) & PV_CACHE_HASH_MASK;
+    }
+    pTable[home] = (XWORD)(slot + 1);
+}
+
+static void PV_DeleteCacheHash(const GM_Mixer * pMixer, XWORD * pTable, UINT32 home, UINT32 slot)
+{
+    UINT32  hole, next, nextHome;
+
+    hole = home;
+    while (pTable[hole] != (XWORD)(slot + 1))
+    {
+        if (pTable[hole] == 0)
+        {
+            BAE_ASSERT(FALSE);      // entry was never indexed
+            return;
+        }
+        hole = (hole + 1) & PV_CACHE_HASH_MASK;
+    }
+    pTable[hole] = 0;
+
+    // pull later members of the chain back into the hole if their home position allows it
+    next = hole;
+    while (TRUE)
+    {
+        next = (next + 1) & PV_CACHE_HASH_MASK;
+        if (pTable[next] == 0)
+        {
+            break;
+        }
+        nextHome = PV_GetCacheHome(pMixer, pTable, pTable[next] - 1);
+        if (((next - nextHome) & PV_CACHE_HASH_MASK) >= ((next - hole) & PV_CACHE_HASH_MASK))
+        {
+            pTable[hole] = pTable[next];
+            pTable[next] = 0;
+            hole = next;
+        }
+    }
+}
+
+static void PV_AddCacheToIndex(GM_Mixer * pMixer, UINT32 slot)
+{
+    GM_SampleCacheEntry *   pCache;
+
+    pCache = pMixer->sampleCaches[slot];
+    pCache->cacheSlot = (XWORD)slot;
+    PV_InsertCacheHash(pMixer->sampleCacheIDHash, PV_HashCacheID(pCache->theID, pCache->bankToken), slot);
+    PV_InsertCacheHash(pMixer->sampleCachePtrHash, PV_HashCachePtr(pCache->pSampleData), slot);
+}
+
+// must be called while the entry is still in sampleCaches and its key fields are intact
+static void PV_RemoveCacheFromIndex(GM_Mixer * pMixer, UINT32 slot)
+{
+    GM_SampleCacheEntry *   pCache;
+
+    pCache = pMixer->sampleCaches[slot];
+    PV_DeleteCacheHash(pMixer, pMixer->sampleCacheIDHash,
+                       PV_HashCacheID(pCache->theID, pCache->bankToken), slot);
+    PV_DeleteCacheHash(pMixer, pMixer->sampleCachePtrHash,
+                       PV_HashCachePtr(pCache->pSampleData), slot);
+}
+
+
+/******************************************************************************
+**
+**  Shared sample pool
+**
+**  Decoded samples are pooled for the whole process, keyed on the content key
+**      of the bank file they come from (see XFileSetContentKey) and their ID.
+**      Every mixer, and every song whose bank token differs, that asks for the
+**      same sample from the same bank gets the same block. Each cache entry
+**      holds one reference on its pool entry, and the sample is freed when the
+**      last one goes.
+**  Pool entries are never written after they are published, so voices read
+**      them without locking. The lock covers only the table and the reference
+**      counts. If the lock can't be made, the pool stays empty and every cache
+**      entry owns its own sample, as before.
+**  Two cache entries in one mixer may now share a sample pointer, under
+**      different IDs too once their frames match below, so
+**      GMCache_GetCachePtrFromPtr matches the ID as well as the pointer.
+**      Otherwise unloading one instrument could let go of another sample's
+**      reference.
+**  Below the pool entries, the decoded frames themselves are kept once per
+**      content. Banks and RMF files often carry the same sample under another
+**      ID, or in another file, so as each sample is published its frames are
+**      hashed and, if a block with the same hash, format and bytes is pooled
+**      already, that block is used and the new copy freed. Loop points, rate
+**      and root key stay with each pool entry, since only the frames need to
+**      match. Blocks are counted by the pool entries using them.
+**
+******************************************************************************/
+static GM_SharedSample *    g_samplePool[MAX_SAMPLE_CACHE_HASH];
+static GM_SampleData *      g_sampleData[MAX_SAMPLE_CACHE_HASH];
+static BAE_Mutex            g_samplePoolLock = NULL;
+
+// Called as each mixer is set up. The pool outlives the mixers, so the lock is never freed.
+void GMCache_InitSharedSamplePool(void)
+{
+    if (g_samplePoolLock == NULL)
+    {
+        if (BAE_NewMutex(&g_samplePoolLock, "bae", "pool", __LINE__) == 0)
+        {
+            g_samplePoolLock = NULL;
+        }
+    }
+}
+
+static UINT32 PV_HashSharedSample(uint64_t bankKey, XSampleID theID)
+{
+    return PV_MixCacheKey(bankKey ^ ((uint64_t)(uint32_t)theID * 0x9E3779B97F4A7C15ULL));
+}
+
+// Called with g_samplePoolLock held
+static GM_SharedSample * PV_FindSharedSample(UINT32 bucket, uint64_t bankKey, XSampleID theID)
+{
+    GM_SharedSample *   pShared;
+
+    for (pShared = g_samplePool[bucket]; pShared; pShared = pShared->pNext)
+    {
+        if (pShared->bankKey == bankKey && pShared->theID == theID)
+        {
+            break;
+        }
+    }
+    return pShared;
+}
+
+// Bytes of frames at the start of a decoded sample
+static uint32_t PV_GetSampleDataLength(SampleDataInfo const * pInfo)
+{
+    return pInfo->frames * (uint32_t)pInfo->channels * (uint32_t)(pInfo->bitSize / 8);
+}
+
+// A 64 bit hash of a decoded sample's frames and format. Not cryptographic, matches are
+// compared byte for byte before they're shared. Reads a word at a time, but assembles each
+// from bytes, as the frames needn't be aligned.
+static uint64_t PV_HashSampleData(SampleDataInfo const * pInfo, XPTR pSampleData)
+{
+    unsigned char const *   pData;
+    uint64_t                hash;
+    uint32_t                length, word;
+
+    length = PV_GetSampleDataLength(pInfo);
+    pData = (unsigned char const *)pSampleData;
+    hash = 0xCBF29CE484222325ULL ^ ((uint64_t)length << 8) ^ ((uint64_t)pInfo->bitSize << 4) ^ (uint64_t)pInfo->channels;
+    while (length >= 4)
+    {
+        word = (uint32_t)pData[0] | ((uint32_t)pData[1] << 8) | ((uint32_t)pData[2] << 16) | ((uint32_t)pData[3] << 24);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29;
+        pData += 4;
+        length -= 4;
+    }
+    while (length--)
+    {
+        hash = (hash ^ *pData++) * 0x100000001B3ULL;
+    }
+    return hash ^ (hash >> 32);
+}
+
+// Called with g_samplePoolLock held. A pooled block holding the same frames, or NULL
+static GM_SampleData * PV_FindSampleData(uint64_t contentHash, SampleDataInfo const * pInfo, XPTR pSampleData)
+{
+    GM_SampleData *     pData;
+    uint32_t            length;
+
+    length = PV_GetSampleDataLength(pInfo);
+    for (pData = g_sampleData[PV_MixCacheKey(contentHash)]; pData; pData = pData->pNext)
+    {
+        if ((pData->contentHash == contentHash) &&
+            (pData->length == length) &&
+            (pData->bitSize == pInfo->bitSize) &&
+            (pData->channels == pInfo->channels) &&
+            (XMemCmp(pData->pSampleData, pSampleData, (int32_t)length) == 0))
+        {
+            break;
+        }
+    }
+    return pData;
+}
+
+// Returns the pooled sample with a reference added for the caller, or NULL
+static GM_SharedSample * PV_AcquireSharedSample(uint64_t bankKey, XSampleID theID)
+{
+    GM_SharedSample *   pShared;
+
+    pShared = NULL;
+    if (g_samplePoolLock && bankKey)
+    {
+        BAE_AcquireMutex(g_samplePoolLock);
+        pShared = PV_FindSharedSample(PV_HashSharedSample(bankKey, theID), bankKey, theID);
+        if (pShared)
+        {
+            pShared->references++;
+        }
+        BAE_ReleaseMutex(g_samplePoolLock);
+    }
+    return pShared;
+}
+
+// Give a freshly decoded sample to the pool. If another thread published the same one while
+// we were decoding, ours is disposed of and theirs returned. If the pool holds the same
+// frames from another sample already, those are used and ours disposed of. Returns NULL,
+// and the caller keeps the data, if the pool is unavailable.
+static GM_SharedSample * PV_PublishSharedSample(uint64_t bankKey, XSampleID theID,
+                                                SampleDataInfo const * pInfo, XPTR pSampleData)
+{
+    GM_SharedSample *   pShared;
+    GM_SharedSample *   pNew;
+    GM_SampleData *     pData;
+    GM_SampleData *     pNewData;
+    UINT32              bucket;
+    uint64_t            contentHash;
+
+    if ((g_samplePoolLock == NULL) || (bankKey == 0))
+    {
+        return NULL;
+    }
+    pNew = (GM_SharedSample *)XNewTaggedPtr(sizeof(GM_SharedSample), X_MEMORY_SAMPLES);
+    pNewData = (GM_SampleData *)XNewTaggedPtr(sizeof(GM_SampleData), X_MEMORY_SAMPLES);
+    if ((pNew == NULL) || (pNewData == NULL))
+    {
+        XDisposePtr(pNew);
+        XDisposePtr(pNewData);
+        return NULL;
+    }
+    // hashing reads the whole sample, so it's done before taking the lock
+    contentHash = PV_HashSampleData(pInfo, pSampleData);
+    pNew->bankKey = bankKey;
+    pNew->theID = theID;
+    pNew->references = 1;
+    pNew->info = *pInfo;
+    pNew->pSampleData = pSampleData;
+    pNewData->contentHash = contentHash;
+    pNewData->length = PV_GetSampleDataLength(pInfo);
+    pNewData->bitSize = pInfo->bitSize;
+    pNewData->channels = pInfo->channels;
+    pNewData->references = 1;
+    pNewData->pMasterPtr = pInfo->pMasterPtr;
+    pNewData->pSampleData = pSampleData;
+
+    bucket = PV_HashSharedSample(bankKey, theID);
+    BAE_AcquireMutex(g_samplePoolLock);
+    pShared = PV_FindSharedSample(bucket, bankKey, theID);
+    if (pShared)
+    {
+        pShared->references++;
+    }
+    else
+    {
+        pData = PV_FindSampleData(contentHash, pInfo, pSampleData);
+        if (pData)
+        {
+            pData->references++;
+        }
+        else
+        {
+            pData = pNewData;
+            pData->pNext = g_sampleData[PV_MixCacheKey(contentHash)];
+            g_sampleData[PV_MixCacheKey(contentHash)] = pData;
+            pNewData = NULL;
+        }
+        pNew->pData = pData;
+        pNew->info.pMasterPtr = pData->pMasterPtr;
+        pNew->pSampleData = pData->pSampleData;
+        pNew->pNext = g_samplePool[bucket];
+        g_samplePool[bucket] = pNew;
+        pShared = pNew;
+        pNew = NULL;
+    }
+    BAE_ReleaseMutex(g_samplePoolLock);
+
+    // whichever of ours went unused is a duplicate now
+    if (pNewData)
+    {
+        PV_DisposeSampleData(pNewData->pMasterPtr);
+        XDisposePtr(pNewData);
+    }
+    XDisposePtr(pNew);
+    return pShared;
+}
+
+static void PV_ReleaseSharedSample(GM_SharedSample * pShared)
+{
+    GM_SharedSample **  ppLink;
+    GM_SampleData **    ppData;
+    GM_SampleData *     pData;
+
+    pData = NULL;
+    BAE_AcquireMutex(g_samplePoolLock);
+    pShared->references--;
+    if (pShared->references == 0)
+    {
+        ppLink = &g_samplePool[PV_HashSharedSample(pShared->bankKey, pShared->theID)];
+        while (*ppLink != pShared)
+        {
+            ppLink = &(*ppLink)->pNext;
+        }
+        *ppLink = pShared->pNext;
+
+        pData = pShared->pData;
+        pData->references--;
+        if (pData->references == 0)
+        {
+            ppData = &g_sampleData[PV_MixCacheKey(pData->contentHash)];
+            while (*ppData != pData)
+            {
+                ppData = &(*ppData)->pNext;
+            }
+            *ppData = pData->pNext;
+        }
+        else
+        {
+            pData = NULL;
+        }
+    }
+    else
+    {
+        pShared = NULL;
+    }
+    BAE_ReleaseMutex(g_samplePoolLock);
+
+    if (pData)
+    {
+        PV_DisposeSampleData(pData->pMasterPtr);
+        XDisposePtr(pData);
+    }
+    if (pShared)
+    {
+        XDisposePtr(pShared);
+    }
+}
+
+
+/******************************************************************************
+**
+**  Parallel sample decoding
+**
+**  GMCache_PrefetchSamples decodes a list of samples into the shared pool on
+**      up to MAX_PREFETCH_THREADS threads, the caller's included, so the cache
+**      entries built for them later are pool hits. Resource reads are taken
+**      one at a time under the prefetch's own lock, since the resource file
+**      code isn't thread safe; only the decoding overlaps. The caller must
+**      keep every other thread out of the resource files until it returns.
+**  Each decoded sample holds a pool reference until
+**      GMCache_ReleasePrefetchedSamples, so none are lost between the two.
+**      Samples with no bank content key can't be pooled and are left for
+**      GMCache_BuildSampleCacheEntry to load as before.
+**
+******************************************************************************/
+#define MAX_PREFETCH_THREADS    8
+
+struct GM_SamplePrefetch
+{
+    BAE_Mutex           lock;           // serializes reads and hands out work
+    UINT32              next;           // next sample to take
+    UINT32              count;
+    XSampleID *         pIDs;           // count entries, after pShared
+    GM_SharedSample **  pShared;        // count entries, NULL if it didn't decode
+};
+
+// Decode one sample into the pool, reading it under pPrefetch->lock
+static GM_SharedSample * PV_PrefetchSample(GM_SamplePrefetch * pPrefetch, XSampleID theID)
+{
+    GM_SharedSample *   pShared;
+    SampleDataInfo      info;
+    XPTR                theData, thePreSound;
+    uint64_t            bankKey;
+
+    pShared = NULL;
+    theData = NULL;
+    BAE_AcquireMutex(pPrefetch->lock);
+    bankKey = XFileGetContentKey(XFindSoundResourceFile(theID));
+    if (bankKey)
+    {
+        pShared = PV_AcquireSharedSample(bankKey, theID);
+        if (pShared == NULL)
+        {
+            theData = PV_ReadSampleResource(NULL, theID);
+        }
+    }
+    BAE_ReleaseMutex(pPrefetch->lock);
+
+    if (theData)
+    {
+        thePreSound = PV_DecodeSampleData(theData, &info);
+        if (thePreSound)
+        {
+            pShared = PV_PublishSharedSample(bankKey, theID, &info, thePreSound);
+            if (pShared == NULL)
             {
-                if (pInfo->bitSize == 16)
-                {
-                    dest16 = (XWORD *)newData;
-                    src16 = (XWORD *)pSamples;
-                    for (count = 0; count < pInfo->frames; count++)
-                    {
-                        dest16[count] = (src16[count] + src16[count+1]) / 2;
-                        dest16++;
-                        src16 += 2;
-                    }
-                }
-                else
-                {
-                    dest8 = (XBYTE *)newData;
-                    src8 = (XBYTE *)pSamples;
-                    for (count = 0; count < pInfo->frames; count++)
-                    {
-                        dest8[count] = (src8[count] + src8[count+1]) / 2;
-                        dest8++;
-                        src8 += 2;
-                    }
-                }
-                pInfo->channels = 1;
-                pInfo->size = sizeb;
+                PV_DisposeSampleData(info.pMasterPtr);
             }
         }
     }
-    return newData;
+    return pShared;
 }
-#endif
 
-#if USE_16_BIT_OUTPUT == FALSE
-static XPTR PV_ConvertTo8Bit(XPTR pSamples, SampleDataInfo *pInfo)
+static void PV_PrefetchThreadProc(void *context)
 {
-    XPTR    newData = NULL;
+    GM_SamplePrefetch * pPrefetch;
+    UINT32              index;
 
-    if (pSamples && pInfo)
+    pPrefetch = (GM_SamplePrefetch *)context;
+    while (1)
     {
-        if (pInfo->bitSize != 8)
+        BAE_AcquireMutex(pPrefetch->lock);
+        index = pPrefetch->next;
+        if (index < pPrefetch->count)
         {
-            newData = XConvert16BitTo8Bit((XWORD *)pSamples, pInfo->frames, pInfo->channels);
-            if (newData)
-            {
-                XDisposePtr(pSamples);
-                pInfo->bitSize = 8;
-                pInfo->size = pInfo->frames * sizeof(char);
-            }
+            pPrefetch->next++;
+        }
+        BAE_ReleaseMutex(pPrefetch->lock);
+        if (index >= pPrefetch->count)
+        {
+            break;
         }
+        pPrefetch->pShared[index] = PV_PrefetchSample(pPrefetch, pPrefetch->pIDs[index]);
     }
-    return newData;
 }
-#endif
-#endif
 
 /******************************************************************************
-*******************************************************************************
-*******************************************************************************
 **
-**  Functions which directly manipulate the Sample Cache
+**  GMCache_PrefetchSamples
+**
+**  Decodes the count samples in pIDs into the shared sample pool, in
+**      parallel where the platform has threads and processors for it.
+**      Returns NULL if there is nothing to do or no memory for it, in which
+**      case the samples just load one at a time as they are asked for.
 **
-*******************************************************************************
-*******************************************************************************
 ******************************************************************************/
+GM_SamplePrefetch * GMCache_PrefetchSamples(XSampleID const * pIDs, UINT32 count)
+{
+    GM_SamplePrefetch * pPrefetch;
+    BAE_WorkerThread    threads[MAX_PREFETCH_THREADS - 1];
+    int                 threadCount, started, index;
+
+    if ((count < 2) || (g_samplePoolLock == NULL))
+    {
+        return NULL;
+    }
+    pPrefetch = (GM_SamplePrefetch *)XNewTaggedPtr((int32_t)(sizeof(GM_SamplePrefetch) +
+                                                    (count * sizeof(GM_SharedSample *)) +
+                                                    (count * sizeof(XSampleID))), X_MEMORY_SAMPLES);
+    if (pPrefetch == NULL)
+    {
+        return NULL;
+    }
+    if (BAE_NewMutex(&pPrefetch->lock, "bae", "pref", __LINE__) == 0)
+    {
+        XDisposePtr((XPTR)pPrefetch);
+        return NULL;
+    }
+    pPrefetch->count = count;
+    pPrefetch->pShared = (GM_SharedSample **)(pPrefetch + 1);
+    pPrefetch->pIDs = (XSampleID *)(pPrefetch->pShared + count);
+    XBlockMove((XPTR)pIDs, (XPTR)pPrefetch->pIDs, (int32_t)(count * sizeof(XSampleID)));
 
+    // the calling thread is one of the decoders
+    threadCount = BAE_GetProcessorCount();
+    if (threadCount > MAX_PREFETCH_THREADS)
+    {
+        threadCount = MAX_PREFETCH_THREADS;
+    }
+    if ((UINT32)threadCount > count)
+    {
+        threadCount = (int)count;
+    }
+    started = 0;
+    for (index = 1; index < threadCount; index++)
+    {
+        if (BAE_NewWorkerThread(&threads[started], PV_PrefetchThreadProc, pPrefetch) == 0)
+        {
+            break;
+        }
+        started++;
+    }
+    PV_PrefetchThreadProc(pPrefetch);
+    for (index = 0; index < started; index++)
+    {
+        BAE_JoinWorkerThread(threads[index]);
+    }
+    return pPrefetch;
+}
 
 /******************************************************************************
 **
-**  GMCache_BuildSampleCacheEntry (previously PV_GetSampleData and
-**                                            GMCache_BuildCacheSample)
-**
-**  This function:
-**      * Takes either an XSampleID/XBankToken pair or a PCM sample pointer,
-**      * Creates and fills out a cache entry,
-**      * Places it in the cache (so it has a reference count of one), and
-**      * Returns a pointer to that entry.
-**  The cache entry data structure contains, among other things, a pointer to
-**      the PCM sound data.
-**  If a pointer to PCM data is passed (UseThisSnd), it is not disposed after
-**      use, so you must dispose of it.
+**  GMCache_ReleasePrefetchedSamples
 **
-**  ????.??.?? ???  Function created
-**  2000.05.02 AER  Renamed function BuildCacheSampleData, since that's what
-**                      it really does, after all...
-**                  Funtion previously returned redundant data -- the out
-**                      parameter pCache contained theSound as a member...
-**                      Now, return an OPErr, and have caller use pCache
+**  Lets go of the pool references GMCache_PrefetchSamples took. Samples that
+**      cache entries were built for since stay in the pool for them.
 **
 ******************************************************************************/
-GM_SampleCacheEntry * GMCache_BuildSampleCacheEntry(GM_Mixer * pMixer,
-                                                    const XSampleID theID,
-                                                    const XBankToken bankToken,
-                                                    const XPTR useThisSnd,
-                                                    OPErr * pErr)
+void GMCache_ReleasePrefetchedSamples(GM_SamplePrefetch * pPrefetch)
 {
-    XPTR                    theData, thePreSound;
-    GM_SampleCacheEntry *   pCache;
-    SampleDataInfo          newSoundInfo;
-    INT32                   size;
+    UINT32  index;
+
+    if (pPrefetch)
+    {
+        for (index = 0; index < pPrefetch->count; index++)
+        {
+            if (pPrefetch->pShared[index])
+            {
+                PV_ReleaseSharedSample(pPrefetch->pShared[index]);
+            }
+        }
+        BAE_DestroyMutex(pPrefetch->lock);
+        XDisposePtr((XPTR)pPrefetch);
+    }
+}
 
-    *pErr = NO_ERR;
-    pCache = NULL;
 
-    if (GMCache_IsIDInCache(pMixer, theID, bankToken) == TRUE)
+/******************************************************************************
+**
+**  Sample cache budget
+**
+**  Entries whose reference count drops to zero are not freed right away. They
+**      go on the end of the mixer's idle list, so a later song asking for the
+**      same sample gets it back without loading it again. Idle entries are
+**      freed from the front of the list, least recently released first, while
+**      the cache holds more sample bytes than sampleCacheStats.budget, or when
+**      it runs out of slots. Entries still referenced are never freed here, so
+**      the budget can be exceeded by what the loaded songs actually use. Idle
+**      samples a voice is still playing out are skipped until it is done.
+**  The budget starts at zero, which frees entries as soon as they are idle.
+**
+******************************************************************************/
+static void PV_AddIdleEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache)
+{
+    pCache->pIdleNext = NULL;
+    pCache->pIdlePrev = pMixer->sampleCacheIdleTail;
+    if (pMixer->sampleCacheIdleTail)
     {
-        *pErr = ALREADY_EXISTS;
-        return NULL;
+        pMixer->sampleCacheIdleTail->pIdleNext = pCache;
+    }
+    else
+    {
+        pMixer->sampleCacheIdleHead = pCache;
     }
+    pMixer->sampleCacheIdleTail = pCache;
+    pMixer->sampleCacheStats.idleBytes += pCache->waveSize;
+}
 
-    if (useThisSnd)
+static void PV_RemoveIdleEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache)
+{
+    if ((pCache->pIdlePrev == NULL) && (pMixer->sampleCacheIdleHead != pCache))
     {
-        theData = useThisSnd;
+        return;     // never released
+    }
+    if (pCache->pIdlePrev)
+    {
+        pCache->pIdlePrev->pIdleNext = pCache->pIdleNext;
     }
     else
     {
-        theData = XGetSoundResourceByID(theID, &size);
+        pMixer->sampleCacheIdleHead = pCache->pIdleNext;
     }
-    if (theData)
+    if (pCache->pIdleNext)
+    {
+        pCache->pIdleNext->pIdlePrev = pCache->pIdlePrev;
+    }
+    else
+    {
+        pMixer->sampleCacheIdleTail = pCache->pIdlePrev;
+    }
+    pCache->pIdlePrev = NULL;
+    pCache->pIdleNext = NULL;
+    pMixer->sampleCacheStats.idleBytes -= pCache->waveSize;
+}
+
+// An idle entry outlives the song that loaded it, and so maybe the file its bank token
+// names. If that file has gone, or another file now sits at the same address, the entry
+// can't be handed out again.
+static XBOOL PV_IsIdleEntryStale(const GM_SampleCacheEntry * pCache)
+{
+    if (pCache->referenceCount == 0)
     {
-        thePreSound = XGetSamplePtrFromSnd(theData, &newSoundInfo);
+        return (XFileGetContentKey(pCache->bankToken.xFile) != pCache->tokenKey);
+    }
+    return FALSE;
+}
+
+static XBOOL PV_IsSamplePlaying(const GM_Mixer * pMixer, const GM_SampleCacheEntry * pCache)
+{
+    register INT32          count;
+    const GM_Voice *        pVoice;
+    const XBYTE *           pStart;
 
-        if (newSoundInfo.pMasterPtr != theData)
+    pStart = (const XBYTE *)pCache->pSampleData;
+    for (count = 0; count < (pMixer->MaxNotes + pMixer->MaxEffects); count++)
+    {
+        pVoice = &pMixer->NoteEntry[count];
+        if ((pVoice->voiceMode != VOICE_UNUSED) &&
+            (pVoice->NotePtr >= pStart) && (pVoice->NotePtr < pStart + pCache->waveSize))
         {
-            XDisposePtr(theData);
+            return TRUE;
         }
+    }
+    return FALSE;
+}
 
-        #if CONFORM_SAMPLES
-            #if USE_STEREO_OUTPUT == FALSE
-                if (newSoundInfo.channels > 1)
-                {
-                    thePreSound = PV_ConvertToMono(thePreSound, &newSoundInfo);
-                }
-            #endif
-            #if USE_16_BIT_OUTPUT == FALSE
-                if (newSoundInfo.bitSize == 16)
-                {
-                    thePreSound = PV_ConvertTo8Bit(thePreSound, &newSoundInfo);
-                }
-            #endif
-        #endif
-        if (thePreSound)
+// Free the least recently released idle entry that no voice is playing
+static XBOOL PV_EvictIdleEntry(GM_Mixer * pMixer)
+{
+    GM_SampleCacheEntry *   pCache;
+
+    for (pCache = pMixer->sampleCacheIdleHead; pCache; pCache = pCache->pIdleNext)
+    {
+        if (PV_IsSamplePlaying(pMixer, pCache) == FALSE)
         {
-            pCache = (GM_SampleCacheEntry *) XNewPtr(sizeof(GM_SampleCacheEntry));
-            if (pCache)
-            {
-                if ((newSoundInfo.loopStart > newSoundInfo.loopEnd) ||
-                    (newSoundInfo.loopEnd > newSoundInfo.frames) ||
-                    ((newSoundInfo.loopEnd - newSoundInfo.loopStart) < MIN_LOOP_SIZE) )
-                {
-                    newSoundInfo.loopStart = 0;
-                    newSoundInfo.loopEnd = 0;
-                }
-                pCache->theID = theID;
-                pCache->bankToken = bankToken;
-                pCache->referenceCount = 0;
-                pCache->waveSize = newSoundInfo.size;
-                pCache->waveFrames = newSoundInfo.frames;
-                pCache->loopStart = newSoundInfo.loopStart;
-                pCache->loopEnd = newSoundInfo.loopEnd;
-                pCache->baseKey = newSoundInfo.baseKey;
-                pCache->bitSize = (char)newSoundInfo.bitSize;
-                pCache->channels = (char)newSoundInfo.channels;
-                pCache->rate = newSoundInfo.rate;
-                pCache->pSampleData = thePreSound;
-                pCache->pMasterPtr = newSoundInfo.pMasterPtr;
-                PV_PlaceSampleInCache(pMixer, pCache);
-            }
-            else
-            {
-                *pErr = MEMORY_ERR;
-            }
+            PV_FreeCacheEntry(pMixer, pCache);
+            pMixer->sampleCacheStats.evictions++;
+            return TRUE;
         }
-        else
+    }
+    return FALSE;
+}
+
+// Evict idle entries until incomingBytes more would fit in the budget, or none are left
+static void PV_TrimSampleCache(GM_Mixer * pMixer, uint32_t incomingBytes)
+{
+    while (pMixer->sampleCacheStats.idleBytes &&
+           ((pMixer->sampleCacheStats.bytes + incomingBytes) > pMixer->sampleCacheStats.budget))
+    {
+        if (PV_EvictIdleEntry(pMixer) == FALSE)
         {
-            *pErr = MEMORY_ERR;
+            break;
         }
     }
-    else
+}
+
+/******************************************************************************
+**
+**  GMCache_SetSampleCacheBudget
+**
+**  Sets how many bytes of sample data the mixer's cache may hold before idle
+**      entries are freed, and frees any that no longer fit. Zero frees every
+**      entry as soon as nothing references it.
+**
+******************************************************************************/
+void GMCache_SetSampleCacheBudget(GM_Mixer * pMixer, uint32_t budgetBytes)
+{
+    if (pMixer)
     {
-        *pErr = BAD_SAMPLE;
+        PV_AcquireSampleCacheLock();
+        pMixer->sampleCacheStats.budget = budgetBytes;
+        PV_TrimSampleCache(pMixer, 0);
+        PV_ReleaseSampleCacheLock();
+    }
+}
+
+/******************************************************************************
+**
+**  GMCache_GetSampleCacheStats
+**
+**  Copies out the mixer's sample cache counters. hits, misses and evictions
+**      count from when the mixer was set up.
+**
+******************************************************************************/
+void GMCache_GetSampleCacheStats(const GM_Mixer * pMixer, GM_SampleCacheStats * pStats)
+{
+    if (pMixer && pStats)
+    {
+        PV_AcquireSampleCacheLock();
+        *pStats = pMixer->sampleCacheStats;
+        PV_ReleaseSampleCacheLock();
     }
-    return pCache;
 }
 
 
@@ -315,33 +1312,38 @@ GM_SampleCacheEntry * GMCache_BuildSampleCacheEntry(GM_Mixer * pMixer,
 ******************************************************************************/
 OPErr PV_PlaceSampleInCache(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache)
 {
-    register INT16          count;
+    register UINT32         count;
     OPErr                   pErr;
 
-    pErr = GENERAL_BAD;
+    if (pCache == NULL)
+    {
+        return MEMORY_ERR;
+    }
+    if (GMCache_IsIDInCache(pMixer, pCache->theID, pCache->bankToken))
+    {
+        BAE_ASSERT(FALSE);
+        return ALREADY_EXISTS;
+    }
 
-    for (count = 0; count < MAX_SAMPLES; count++)
+    pErr = GENERAL_BAD;
+    while (pErr != NO_ERR)
     {
-        if (pMixer->sampleCaches[count] == NULL)
+        for (count = pMixer->sampleCacheFreeHint; count < MAX_SAMPLES; count++)
         {
-            if (pCache)
+            if (pMixer->sampleCaches[count] == NULL)
             {
                 pMixer->sampleCaches[count] = pCache;
-                pMixer->sampleCaches[count]->referenceCount = 1;
+                pCache->referenceCount = 1;
+                PV_AddCacheToIndex(pMixer, count);
+                pMixer->sampleCacheFreeHint = (XWORD)(count + 1);
+                pMixer->sampleCacheStats.bytes += pCache->waveSize;
                 pErr = NO_ERR;
                 break;
             }
-            else
-            {
-                pErr = MEMORY_ERR;
-                break;
-            }
         }
-        else if (pMixer->sampleCaches[count]->theID == pCache->theID &&
-                 AreBankTokensIdentical(pMixer->sampleCaches[count]->bankToken, pCache->bankToken))
+        // every slot is taken, so give up the least recently used idle one if there is one
+        if ((pErr != NO_ERR) && (PV_EvictIdleEntry(pMixer) == FALSE))
         {
-            pErr = ALREADY_EXISTS;
-            BAE_ASSERT(FALSE);
             break;
         }
     }
@@ -359,7 +1361,7 @@ OPErr PV_PlaceSampleInCache(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache)
 **  2000.05.09 AER  Imported from MiniBAE (was named GM_CacheAddRef)
 **
 ******************************************************************************/
-OPErr GMCache_IncrCacheEntryRef(const GM_Mixer * pMixer,
+OPErr GMCache_IncrCacheEntryRef(GM_Mixer * pMixer,
                                 GM_SampleCacheEntry * pCache)
 {
 #ifdef DISPLAY_CACHE_SAVINGS
@@ -369,7 +1371,14 @@ OPErr GMCache_IncrCacheEntryRef(const GM_Mixer * pMixer,
 
     if (pMixer && pCache)
     {
+        PV_AcquireSampleCacheLock();
+        if (pCache->referenceCount == 0)
+        {
+            PV_RemoveIdleEntry(pMixer, pCache);
+        }
         pCache->referenceCount++;
+        pMixer->sampleCacheStats.hits++;
+        PV_ReleaseSampleCacheLock();
 #ifdef DISPLAY_CACHE_SAVINGS
         byteCount += pCache->waveSize;
         sprintf(foo, "Added a cache entry of %d bytes\n", pCache->waveSize);
@@ -388,7 +1397,8 @@ OPErr GMCache_IncrCacheEntryRef(const GM_Mixer * pMixer,
 **  GMCache_DecrCacheEntryRef
 **
 **  Decrements a cache's reference count
-**  Removes the cache entry should its reference count hit zero
+**  Once its reference count hits zero the entry goes on the mixer's idle
+**      list, and is removed when the sample cache budget needs the room
 **
 **  2000.03.08 AER  Function created but not implemented
 **  2000.03.29 AER  Function completed and integrated
@@ -402,11 +1412,15 @@ OPErr GMCache_DecrCacheEntryRef(GM_Mixer * pMixer,
 
     if (pMixer && pCache)
     {
+        PV_AcquireSampleCacheLock();
         pCache->referenceCount--;
         if (pCache->referenceCount == 0)
         {
-            pErr = PV_FreeCacheEntry(pMixer, pCache);
+            // keep it around for the next song that wants it, as the budget allows
+            PV_AddIdleEntry(pMixer, pCache);
+            PV_TrimSampleCache(pMixer, 0);
         }
+        PV_ReleaseSampleCacheLock();
         return pErr;
     }
     return PARAM_ERR;
@@ -433,6 +1447,7 @@ OPErr GMCache_ClearSampleCache(GM_Mixer * pMixer)
 
     if (pMixer)
     {
+        PV_AcquireSampleCacheLock();
         for (count = 0; count < MAX_SAMPLES; count++)
         {
             if (pMixer->sampleCaches[count])
@@ -440,6 +1455,14 @@ OPErr GMCache_ClearSampleCache(GM_Mixer * pMixer)
                 PV_FreeCacheEntry(pMixer, pMixer->sampleCaches[count]);
             }
         }
+        XSetMemory(pMixer->sampleCacheIDHash, (int32_t)sizeof(pMixer->sampleCacheIDHash), 0);
+        XSetMemory(pMixer->sampleCachePtrHash, (int32_t)sizeof(pMixer->sampleCachePtrHash), 0);
+        pMixer->sampleCacheFreeHint = 0;
+        pMixer->sampleCacheIdleHead = NULL;
+        pMixer->sampleCacheIdleTail = NULL;
+        pMixer->sampleCacheStats.bytes = 0;
+        pMixer->sampleCacheStats.idleBytes = 0;
+        PV_ReleaseSampleCacheLock();
         return NO_ERR;
     }
     return PARAM_ERR;
@@ -461,26 +1484,38 @@ static OPErr PV_FreeCacheEntry(GM_Mixer * pMixer, GM_SampleCacheEntry * pCache)
     UINT32              entryLoc;
     OPErr               pErr;
 
-    if (pCache)
+    if (pCache == NULL)
+    {
+        return RESOURCE_NOT_FOUND;
+    }
+
+    if (pCache->referenceCount == 0)
+    {
+        PV_RemoveIdleEntry(pMixer, pCache);
+    }
+    // take it out of the index while its keys are still readable
+    entryLoc = PV_GetCacheIndexFromCachePtr(pMixer, pCache, &pErr);
+    if (pErr == NO_ERR)
     {
-        if (pCache->pSampleData)
+        pMixer->sampleCacheStats.bytes -= pCache->waveSize;
+        PV_RemoveCacheFromIndex(pMixer, entryLoc);
+        pMixer->sampleCaches[entryLoc] = NULL;
+        if (entryLoc < pMixer->sampleCacheFreeHint)
         {
-            XDisposePtr(pCache->pMasterPtr);
+            pMixer->sampleCacheFreeHint = (XWORD)entryLoc;
         }
-        XDisposePtr(pCache);
     }
-    else
+
+    if (pCache->pShared)
     {
-        return RESOURCE_NOT_FOUND;
+        PV_ReleaseSharedSample(pCache->pShared);
     }
-
-    entryLoc = PV_GetCacheIndexFromCachePtr(pMixer, pCache, &pErr);
-    if (pErr != NO_ERR)
+    else if (pCache->pSampleData)
     {
-        return RESOURCE_NOT_FOUND;
+        PV_DisposeSampleData(pCache->pMasterPtr);
     }
-    pMixer->sampleCaches[entryLoc] = NULL;
-    return NO_ERR;
+    XDisposePtr(pCache);
+    return (pErr == NO_ERR) ? NO_ERR : RESOURCE_NOT_FOUND;
 }
 
 
@@ -513,27 +1548,11 @@ XBOOL GMCache_IsIDInCache(const GM_Mixer * pMixer,
                           const XSampleID theID,
                           const XBankToken bankToken)
 {
-    register INT16          count;
-    GM_SampleCacheEntry *   pCache;
+    OPErr                   err;
 
     BAE_ASSERT(pMixer);
 
-    if (pMixer)
-    {
-        for (count = 0; count < MAX_SAMPLES; count++)
-        {
-            pCache = pMixer->sampleCaches[count];
-            if (pCache)
-            {
-                if (pCache->theID == theID &&
-                    AreBankTokensIdentical(pCache->bankToken, bankToken))
-                {
-                    return TRUE;
-                }
-            }
-        }
-    }
-    return FALSE;
+    return (GMCache_GetCachePtrFromID(pMixer, theID, bankToken, &err) != NULL);
 }
 
 
@@ -553,26 +1572,29 @@ GM_SampleCacheEntry * GMCache_GetCachePtrFromID(const GM_Mixer * pMixer,
                                                 const XBankToken bankToken,
                                                 OPErr * pErr)
 {
-    register UINT16         count;
+    register UINT32         index;
+    XWORD                   slot;
     GM_SampleCacheEntry *   pCache;
 
     if (pMixer)
     {
-        for (count = 0; count < MAX_SAMPLES; count++)
+        *pErr = RESOURCE_NOT_FOUND;
+        PV_AcquireSampleCacheLock();
+        index = PV_HashCacheID(theID, bankToken);
+        while ((slot = pMixer->sampleCacheIDHash[index]) != 0)
         {
-            pCache = pMixer->sampleCaches[count];
-            if (pCache)
+            pCache = pMixer->sampleCaches[slot - 1];
+            if (pCache->theID == theID &&
+                AreBankTokensIdentical(pCache->bankToken, bankToken) &&
+                PV_IsIdleEntryStale(pCache) == FALSE)
             {
-                if (pCache->theID == theID &&
-                    AreBankTokensIdentical(pCache->bankToken, bankToken))
-                {
-                    *pErr = NO_ERR;
-                    return pCache;
-                }
+                *pErr = NO_ERR;
+                break;
             }
+            index = (index + 1) & PV_CACHE_HASH_MASK;
         }
-        *pErr = RESOURCE_NOT_FOUND;
-        return NULL;
+        PV_ReleaseSampleCacheLock();
+        return (*pErr == NO_ERR) ? pCache : NULL;
     }
     *pErr = PARAM_ERR;
     return NULL;
@@ -584,34 +1606,40 @@ GM_SampleCacheEntry * GMCache_GetCachePtrFromID(const GM_Mixer * pMixer,
 **  GMCache_GetCachePtrFromPtr
 **
 **  Returns a pointer to a mixer cache entry (or NULL) given a pointer to
-**      sample data
+**      sample data and the ID it was loaded as. The pool can give entries
+**      with other IDs the same data, so both have to match. Only entries
+**      that are still referenced are considered.
 **
 **  2000.05.15 AER  Function created
 **
 ******************************************************************************/
 GM_SampleCacheEntry * GMCache_GetCachePtrFromPtr(const GM_Mixer * pMixer,
                                                  const XPTR pSample,
+                                                 const XSampleID theID,
                                                  OPErr * pErr)
 {
-    register UINT16         count;
+    register UINT32         index;
+    XWORD                   slot;
     GM_SampleCacheEntry *   pCache;
 
     if (pMixer)
     {
-        for (count = 0; count < MAX_SAMPLES; count++)
+        *pErr = RESOURCE_NOT_FOUND;
+        PV_AcquireSampleCacheLock();
+        index = PV_HashCachePtr(pSample);
+        while ((slot = pMixer->sampleCachePtrHash[index]) != 0)
         {
-            pCache = pMixer->sampleCaches[count];
-            if (pCache)
+            pCache = pMixer->sampleCaches[slot - 1];
+            // idle entries can share data with a live one through the pool; callers want the live one
+            if ((pCache->pSampleData == pSample) && (pCache->theID == theID) && (pCache->referenceCount > 0))
             {
-                if (pCache->pSampleData == pSample)
-                {
-                    *pErr = NO_ERR;
-                    return pCache;
-                }
+                *pErr = NO_ERR;
+                break;
             }
+            index = (index + 1) & PV_CACHE_HASH_MASK;
         }
-        *pErr = RESOURCE_NOT_FOUND;
-        return NULL;
+        PV_ReleaseSampleCacheLock();
+        return (*pErr == NO_ERR) ? pCache : NULL;
     }
     *pErr = PARAM_ERR;
     return NULL;
@@ -654,17 +1682,12 @@ UINT32 PV_GetCacheIndexFromCachePtr(GM_Mixer * pMixer,
                                     GM_SampleCacheEntry * pCache,
                                     OPErr * pErr)
 {
-    register UINT32     count;
-
     if (pMixer && pCache)
     {
-        for (count = 0; count < MAX_SAMPLES; count++)
+        if (pCache->cacheSlot < MAX_SAMPLES && pMixer->sampleCaches[pCache->cacheSlot] == pCache)
         {
-            if (pCache == pMixer->sampleCaches[count])
-            {
-                *pErr = NO_ERR;
-                return count;
-            }
+            *pErr = NO_ERR;
+            return pCache->cacheSlot;
         }
         *pErr = RESOURCE_NOT_FOUND;
         return 0;
@@ -79,16 +79,28 @@
 #endif
 
 // Prototypes (Documentation in .c file)
+void GMCache_InitSharedSamplePool(void);
+void GMCache_InitSampleCacheLock(void);
 GM_SampleCacheEntry * GMCache_BuildSampleCacheEntry(GM_Mixer * pMixer,
                                                     const XSampleID theID,
                                                     const XBankToken bankToken,
                                                     const XPTR useThisSnd,
                                                     OPErr * pErr);
-OPErr GMCache_IncrCacheEntryRef(const GM_Mixer * pMixer,
+GM_SampleCacheEntry * GMCache_BuildSampleCacheEntryFromFile(GM_Mixer * pMixer,
+                                                            const XSampleID theID,
+                                                            const XBankToken bankToken,
+                                                            XFILE sampleFile,
+                                                            OPErr * pErr);
+OPErr GMCache_IncrCacheEntryRef(GM_Mixer * pMixer,
                                 GM_SampleCacheEntry * pCache);
 OPErr GMCache_DecrCacheEntryRef(GM_Mixer * pMixer,
                                 GM_SampleCacheEntry * pCache);
 OPErr GMCache_ClearSampleCache(GM_Mixer * pMixer);
+void GMCache_SetSampleCacheBudget(GM_Mixer * pMixer, uint32_t budgetBytes);
+void GMCache_GetSampleCacheStats(const GM_Mixer * pMixer, GM_SampleCacheStats * pStats);
+typedef struct GM_SamplePrefetch GM_SamplePrefetch;
+GM_SamplePrefetch * GMCache_PrefetchSamples(XSampleID const * pIDs, UINT32 count);
+void GMCache_ReleasePrefetchedSamples(GM_SamplePrefetch * pPrefetch);
 
 
 
@@ -101,6 +113,7 @@ GM_SampleCacheEntry * GMCache_GetCachePtrFromID(const GM_Mixer * pMixer,
                                                 OPErr * pErr);
 GM_SampleCacheEntry * GMCache_GetCachePtrFromPtr(const GM_Mixer * pMixer,
                                                  const XPTR pSample,
+                                                 const XSampleID theID,
                                                  OPErr * pErr);
 XPTR GMCache_GetSamplePtr(const GM_SampleCacheEntry * pCache,
                           OPErr * pErr);
@@ -76,6 +76,8 @@
 **  8/10/98     igor        Moved #if USE_NEW_EFFECTS to after include of X_API.h
 **  7/13/99     Removed use of BAE_API.h
 **  2/4/2000    Changed copyright. We're Y2K compliant!
+**  10/18/26    RunChorus reads taps a block at a time in wrap-free spans, then writes
+**              the delay lines and output in a separate loop
 */
 /*****************************************************************************/
 #include "GenPriv.h"
@@ -113,6 +115,9 @@ ChorusParams        gChorusParams;
 
 #define kModulationTableLength      200
 
+// frames of taps read ahead of the delay line writes. Must stay below the shortest delay
+#define kChorusBlockFrames          64
+
 //++------------------------------------------------------------------------------
 //  GetChorusParams()
 //
@@ -131,10 +136,15 @@ void InitChorus()
 {
     ChorusParams* params = GetChorusParams();
     
-    // allocate the delay line memory
+    // take the delay line memory from the reverb arena
     int32_t kMaxBytes = 2 * sizeof(INT32) * kChorusBufferFrameSize;
-    params->mChorusBufferL = (INT32*)XNewPtr(kMaxBytes );
-    params->mChorusBufferR = (INT32*)XNewPtr(kMaxBytes );
+    params->mChorusBufferL = (INT32*)GM_TakeReverbMemory(kMaxBytes );
+    params->mChorusBufferR = (INT32*)GM_TakeReverbMemory(kMaxBytes );
+    if ((params->mChorusBufferL == NULL) || (params->mChorusBufferR == NULL))
+    {
+        params->mIsInitialized = FALSE;
+        return;
+    }
 
     SetupChorusDelay();
     
@@ -198,9 +208,9 @@ void ShutdownChorus()
     if(!params->mIsInitialized) return; // don't shutdown twice!!
     params->mIsInitialized = FALSE;     // do this before deallocating stuff!!
 
-    // deallocate the buffer
-    XDisposePtr(params->mChorusBufferL );
-    XDisposePtr(params->mChorusBufferR );
+    // the buffers belong to the reverb arena, which GM_CleanupReverb frees
+    params->mChorusBufferL = NULL;
+    params->mChorusBufferR = NULL;
 }
 
 
@@ -333,6 +343,66 @@ INT32 GetChorusReadIncrement(INT32 readIndex, int32_t writeIndex, int32_t nSampl
     return ratio;
 }
 
+//++------------------------------------------------------------------------------
+//  PV_ReadChorusTaps()
+//
+//  Read nSampleFrames linearly interpolated taps from a delay line, starting at
+//  readIndex and moving by readIndexIncr each frame. Runs of frames that don't
+//  touch the last frame of the delay line are read without any wrap tests.
+//  Returns the read index for the next frame.
+//++------------------------------------------------------------------------------
+static INT32 PV_ReadChorusTaps(INT32 const *buffer, INT32 readIndex, INT32 readIndexIncr, INT32 *taps, int nSampleFrames)
+{
+    INT32   kReadIndexAdjust = (kChorusBufferFrameSize << READINDEXSHIFT);
+    INT32   kReadIndexLast = ((kChorusBufferFrameSize - 1) << READINDEXSHIFT);
+
+    while(nSampleFrames > 0)
+    {
+        if(readIndex < kReadIndexLast)
+        {
+            int span = nSampleFrames;
+
+            // frames until the read head reaches the last frame, where the
+            // second interpolation point wraps to the start
+            if(readIndexIncr > 0)
+            {
+                INT32 framesToLast = (kReadIndexLast - readIndex + readIndexIncr - 1) / readIndexIncr;
+
+                if(framesToLast < span)
+                {
+                    span = (int)framesToLast;
+                }
+            }
+            nSampleFrames -= span;
+            while(span-- > 0)
+            {
+                int     intReadIndex = readIndex >> READINDEXSHIFT;
+                INT32   b = buffer[intReadIndex];
+                INT32   c = buffer[intReadIndex + 1];
+
+                *taps++ = (((INT32) (readIndex & READINDEXMASK) * (c - b))>>READINDEXSHIFT) + b;
+                readIndex += readIndexIncr;
+            }
+        }
+        else
+        {
+            int     intReadIndex = readIndex >> READINDEXSHIFT;
+            INT32   b = buffer[intReadIndex];
+            INT32   c = buffer[(intReadIndex + 1) % kChorusBufferFrameSize];
+
+            *taps++ = (((INT32) (readIndex & READINDEXMASK) * (c - b))>>READINDEXSHIFT) + b;
+            readIndex += readIndexIncr;
+            nSampleFrames--;
+        }
+        // wrap-around read index
+        if(readIndex >= kReadIndexAdjust)
+        {
+            readIndex -= kReadIndexAdjust;
+        }
+    }
+    return readIndex;
+}
+
 //++------------------------------------------------------------------------------
 //  RunChorus()
 //
@@ -357,7 +427,8 @@ void RunChorus(INT32 *sourceP, INT32 *destP, int nSampleFrames)
     INT32   readIndexIncrR;
 
 
-    INT32   kReadIndexAdjust = (kChorusBufferFrameSize << READINDEXSHIFT);
+    INT32   tapL[kChorusBlockFrames];
+    INT32   tapR[kChorusBlockFrames];
     
 
     if(!params->mIsInitialized) return; // we're not properly initialized for processing...
@@ -387,60 +458,57 @@ void RunChorus(INT32 *sourceP, INT32 *destP, int nSampleFrames)
 
     
     
-    while(nSampleFrames-- > 0)
+    while(nSampleFrames > 0)
     {
-    // get input
-        INT32 inputL = *sourceP++;  // mono input
-        INT32 inputR = inputL;
-
+        int     count;
+        int     frames = nSampleFrames;
+        int     span;
 
-    // calculate sample value
-        int intReadIndexL = readIndexL >> READINDEXSHIFT;
-        int intReadIndex2L = (intReadIndexL + 1) % kChorusBufferFrameSize;
-        INT32 bL = bufferL[intReadIndexL];
-        INT32 cL = bufferL[intReadIndex2L];
-        
-        
-        int intReadIndexR = readIndexR >> READINDEXSHIFT;
-        int intReadIndex2R = (intReadIndexR + 1) % kChorusBufferFrameSize;
-        INT32 bR = bufferR[intReadIndexR];
-        INT32 cR = bufferR[intReadIndex2R];
-        
-        INT32 tapL = (((INT32) (readIndexL & READINDEXMASK) * (cL - bL))>>READINDEXSHIFT) + bL;
-        INT32 tapR = (((INT32) (readIndexR & READINDEXMASK) * (cR - bR))>>READINDEXSHIFT) + bR;
-
-    // write input plus feedback back into the delay line
-        bufferL[writeIndex] = inputL + ((tapL*feedbackGain) >> FEEDBACKSHIFT) ;
-        bufferR[writeIndex] = inputR + ((tapR*feedbackGain) >> FEEDBACKSHIFT) ;
-        
-    
-
-    // write to output
-#if 1
-        *destP++ += (tapL ) ;
-        *destP++ += (tapR ) ;
-#else
-        *destP++ = 0;
-        *destP++ = 0;
-#endif
-    
-    // increment the read head by fractional amounts    
-        readIndexL += readIndexIncrL;
-        readIndexR += readIndexIncrR;
-        
-    // wrap-around read indices 
-        if(readIndexL >=  kReadIndexAdjust)
+        if(frames > kChorusBlockFrames)
         {
-            readIndexL -= kReadIndexAdjust;
+            frames = kChorusBlockFrames;
         }
 
-        if(readIndexR >=  kReadIndexAdjust)
+    // read both taps for the block. The delay is always longer than a block, so nothing
+    // written below is read back within the same block.
+        readIndexL = PV_ReadChorusTaps(bufferL, readIndexL, readIndexIncrL, tapL, frames);
+        readIndexR = PV_ReadChorusTaps(bufferR, readIndexR, readIndexIncrR, tapR, frames);
+
+    // write input plus feedback back into the delay line, and the taps to the output,
+    // in spans that don't cross the end of the delay line
+        count = 0;
+        while(count < frames)
         {
-            readIndexR -= kReadIndexAdjust;
-        }
+            INT32   *pTapL = tapL + count;
+            INT32   *pTapR = tapR + count;
+            INT32   *pWriteL = bufferL + writeIndex;
+            INT32   *pWriteR = bufferR + writeIndex;
+            int     i;
+
+            span = frames - count;
+            if(span > kChorusBufferFrameSize - writeIndex)
+            {
+                span = kChorusBufferFrameSize - writeIndex;
+            }
+            for(i = 0; i < span; i++)
+            {
+                INT32 input = sourceP[i];   // mono input
 
-    // wrap-around write pointer
-        writeIndex = (writeIndex + 1) % kChorusBufferFrameSize;
+                pWriteL[i] = input + ((pTapL[i]*feedbackGain) >> FEEDBACKSHIFT);
+                pWriteR[i] = input + ((pTapR[i]*feedbackGain) >> FEEDBACKSHIFT);
+                destP[i*2] += pTapL[i];
+                destP[i*2+1] += pTapR[i];
+            }
+            sourceP += span;
+            destP += span * 2;
+            count += span;
+            writeIndex += span;
+            if(writeIndex >= kChorusBufferFrameSize)
+            {
+                writeIndex = 0;
+            }
+        }
+        nSampleFrames -= frames;
     }
 
     // remember state
@@ -451,6 +519,47 @@ void RunChorus(INT32 *sourceP, INT32 *destP, int nSampleFrames)
 }
 
 
+//++------------------------------------------------------------------------------
+//  SkipChorus()
+//
+//  Advance the modulation and delay heads by nSampleFrames without processing,
+//  for slices where the chorus is bypassed, so it resumes in phase.
+//++------------------------------------------------------------------------------
+void SkipChorus(int nSampleFrames)
+{
+    ChorusParams* params = GetChorusParams();
+
+    INT32   readIndexIncrL;
+    INT32   readIndexIncrR;
+    INT32   kReadIndexAdjust = (kChorusBufferFrameSize << READINDEXSHIFT);
+
+    if(!params->mIsInitialized) return;
+
+    readIndexIncrL =  GetChorusReadIncrement(params->mReadIndexL, params->mWriteIndex, nSampleFrames, 0);
+    readIndexIncrR =  GetChorusReadIncrement(params->mReadIndexR, params->mWriteIndex, nSampleFrames, kModulationTableLength/2);
+
+    params->mPhi = (params->mPhi + ((params->mRate * nSampleFrames) >> 7)) % 65536;
+
+    if(params->mSampleRate != MusicGlobals->outputRate)
+    {
+        params->mSampleRate = MusicGlobals->outputRate;
+        SetupChorusDelay();
+        return;
+    }
+
+    params->mReadIndexL += readIndexIncrL * nSampleFrames;
+    params->mReadIndexR += readIndexIncrR * nSampleFrames;
+    while(params->mReadIndexL >= kReadIndexAdjust)
+    {
+        params->mReadIndexL -= kReadIndexAdjust;
+    }
+    while(params->mReadIndexR >= kReadIndexAdjust)
+    {
+        params->mReadIndexR -= kReadIndexAdjust;
+    }
+    params->mWriteIndex = (params->mWriteIndex + nSampleFrames) % kChorusBufferFrameSize;
+}
+
 #if 0       // old mono chorus code   -- don't delete!
     while(nSampleFrames-- > 0)
     {
@@ -0,0 +1,631 @@
+/*
+    Copyright (c) 2025 NeoBAE Contributors
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are
+    met:
+
+    Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    Neither the name of NeoBAE nor the names of its contributors may be
+    used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+    TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+    PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+    HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+    SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+    TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+    PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*****************************************************************************/
+/*
+** "GenMaster.c"
+**
+**  Master bus stage for miniBAE: a small parametric EQ and a lookahead peak
+**  limiter, run while the dry mix is converted to 16 bit output samples.
+**
+**  Written by: NeoBAE Contributors
+**  Created: 2026
+**
+**  With both sections off the mixer keeps using PV_Generate16outputStereo and
+**  PV_Generate16outputMono, so output is unchanged. Once either is on, the
+**  slice is converted to float a block at a time, filtered band by band,
+**  limited, then rounded and saturated to 16 bits.
+**
+**  The EQ is up to MAX_MASTER_EQ_BANDS biquads (peak, low shelf, high shelf)
+**  from the usual RBJ cookbook formulas. Coefficients are rebuilt by the audio
+**  thread at the start of a slice whenever a band or the output rate changes.
+**
+**  The limiter delays the signal by L-1 frames. For every frame it needs a gain
+**  that brings that frame's peak to the ceiling; the minimum of that over the
+**  last L frames, averaged over another L frames, is never above what any frame
+**  still in the delay line needs, so the gain ramps down ahead of a peak and no
+**  sample leaves above the ceiling. Gain then recovers with a one pole release.
+**
+** Modification History:
+**  10/18/26    Created
+*/
+/*****************************************************************************/
+
+#include "GenSnd.h"
+#include "GenPriv.h"
+#include "BAE_API.h"
+#include "X_API.h"
+#include <math.h>
+
+#if (USE_NEO_EFFECTS == TRUE) && (USE_16_BIT_OUTPUT == TRUE)    // Conditionally compile this file
+
+#define MASTER_PI                   3.14159265358979323846
+
+// frames converted to float and processed at a time
+#define MASTER_BLOCK_FRAMES         64
+
+#define MASTER_EQ_MAX_GAIN          (24L << 16)         // dB, 16.16
+#define MASTER_EQ_MIN_Q             (XFIXED_1 / 10)
+#define MASTER_EQ_MAX_Q             (20L << 16)
+#define MASTER_EQ_MIN_FREQUENCY     20
+
+#define MASTER_LIMITER_CEILING      32000.0f            // in 16 bit units, about -0.2 dBFS
+#define MASTER_LIMITER_LOOKAHEAD_US 2000                // lookahead time
+#define MASTER_LIMITER_RELEASE_S    0.1                 // time constant of the gain recovery
+#define MASTER_LIMITER_MIN_LOOKAHEAD 16
+
+// filter state below this is flushed to zero, to keep denormals out of the loops
+#define MASTER_EQ_FLUSH             1.0e-20f
+
+// Sample rate of the dry mix buffer. The TERP modes build half rate and double on output.
+static XDWORD PV_GetMasterMixRate(void)
+{
+    XDWORD  rate;
+
+    rate = GM_ConvertFromOutputRateToRate(MusicGlobals->outputRate);
+    if ((MusicGlobals->outputRate == Q_RATE_11K_TERP_22K) || (MusicGlobals->outputRate == Q_RATE_22K_TERP_44K))
+    {
+        rate /= 2;
+    }
+    return rate;
+}
+
+static XBOOL PV_IsTerpRate(void)
+{
+    return (XBOOL)((MusicGlobals->outputRate == Q_RATE_11K_TERP_22K) ||
+                   (MusicGlobals->outputRate == Q_RATE_22K_TERP_44K));
+}
+
+static void PV_BuildMasterEqBand(GM_MasterEqBand *pBand, XDWORD rate)
+{
+    double  A, w0, cosw0, alpha, sqrtA2alpha, frequency;
+    double  b0, b1, b2, a0, a1, a2;
+
+    frequency = (double)pBand->frequency;
+    if (frequency > rate * 0.45)
+    {
+        frequency = rate * 0.45;
+    }
+    A = pow(10.0, ((double)pBand->gain / 65536.0) / 40.0);
+    w0 = 2.0 * MASTER_PI * frequency / (double)rate;
+    cosw0 = cos(w0);
+    alpha = sin(w0) / (2.0 * ((double)pBand->q / 65536.0));
+    sqrtA2alpha = 2.0 * sqrt(A) * alpha;
+
+    switch (pBand->type)
+    {
+        default:
+        case MASTER_EQ_PEAK:
+            b0 = 1.0 + alpha * A;
+            b1 = -2.0 * cosw0;
+            b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;
+            a1 = -2.0 * cosw0;
+            a2 = 1.0 - alpha / A;
+            break;
+        case MASTER_EQ_LOW_SHELF:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cosw0 + sqrtA2alpha);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw0);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cosw0 - sqrtA2alpha);
+            a0 = (A + 1.0) + (A - 1.0) * cosw0 + sqrtA2alpha;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosw0);
+            a2 = (A + 1.0) + (A - 1.0) * cosw0 - sqrtA2alpha;
+            break;
+        case MASTER_EQ_HIGH_SHELF:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cosw0 + sqrtA2alpha);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw0);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cosw0 - sqrtA2alpha);
+            a0 = (A + 1.0) - (A - 1.0) * cosw0 + sqrtA2alpha;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosw0);
+            a2 = (A + 1.0) - (A - 1.0) * cosw0 - sqrtA2alpha;
+            break;
+    }
+    pBand->b0 = (float)(b0 / a0);
+    pBand->b1 = (float)(b1 / a0);
+    pBand->b2 = (float)(b2 / a0);
+    pBand->a1 = (float)(a1 / a0);
+    pBand->a2 = (float)(a2 / a0);
+}
+
+static void PV_ResetMasterLimiter(GM_MasterStage *pMaster, XDWORD rate)
+{
+    int     count, lookahead;
+
+    lookahead = (int)((rate * MASTER_LIMITER_LOOKAHEAD_US) / 1000000L);
+    if (lookahead < MASTER_LIMITER_MIN_LOOKAHEAD)
+    {
+        lookahead = MASTER_LIMITER_MIN_LOOKAHEAD;
+    }
+    if (lookahead > MASTER_LIMITER_MAX_LOOKAHEAD)
+    {
+        lookahead = MASTER_LIMITER_MAX_LOOKAHEAD;
+    }
+    pMaster->lookahead = lookahead;
+    pMaster->ceiling = MASTER_LIMITER_CEILING;
+    pMaster->releaseCoef = (float)(1.0 - exp(-1.0 / (MASTER_LIMITER_RELEASE_S * (double)rate)));
+    pMaster->envelope = 1.0f;
+    XSetMemory(pMaster->delay, (int32_t)sizeof(pMaster->delay), 0);
+    pMaster->delayPos = 0;
+    for (count = 0; count < MASTER_LIMITER_MAX_LOOKAHEAD; count++)
+    {
+        pMaster->minGain[count] = 1.0f;
+    }
+    pMaster->minGainSum = (float)lookahead;
+    pMaster->minGainPos = 0;
+    pMaster->dequeHead = 0;
+    pMaster->dequeCount = 0;
+    pMaster->time = 0;
+}
+
+// Called by the audio thread before each slice. Picks up band and rate changes.
+static void PV_PrepareMasterStage(GM_MasterStage *pMaster)
+{
+    XDWORD  rate;
+    int     count, channel;
+    float   sum;
+
+    rate = PV_GetMasterMixRate();
+    if (pMaster->eqEnabled)
+    {
+        if (pMaster->eqChanged || (pMaster->eqRate != MusicGlobals->outputRate))
+        {
+            if (pMaster->eqRate != MusicGlobals->outputRate)
+            {
+                pMaster->eqReset = TRUE;
+            }
+            pMaster->eqChanged = FALSE;
+            pMaster->eqRate = MusicGlobals->outputRate;
+            pMaster->activeBandCount = 0;
+            for (count = 0; count < MAX_MASTER_EQ_BANDS; count++)
+            {
+                if ((pMaster->band[count].type != MASTER_EQ_OFF) && (pMaster->band[count].gain != 0))
+                {
+                    PV_BuildMasterEqBand(&pMaster->band[count], rate);
+                    pMaster->activeBands[pMaster->activeBandCount++] = (XSWORD)count;
+                }
+            }
+        }
+        if (pMaster->eqReset)
+        {
+            pMaster->eqReset = FALSE;
+            for (count = 0; count < MAX_MASTER_EQ_BANDS; count++)
+            {
+                for (channel = 0; channel < 2; channel++)
+                {
+                    pMaster->band[count].z1[channel] = 0.0f;
+                    pMaster->band[count].z2[channel] = 0.0f;
+                }
+            }
+        }
+    }
+    if (pMaster->limiterEnabled)
+    {
+        if (pMaster->limiterReset || (pMaster->limiterRate != MusicGlobals->outputRate))
+        {
+            pMaster->limiterReset = FALSE;
+            pMaster->limiterRate = MusicGlobals->outputRate;
+            PV_ResetMasterLimiter(pMaster, rate);
+        }
+        // resum the box average so rounding can't build up
+        sum = 0.0f;
+        for (count = 0; count < pMaster->lookahead; count++)
+        {
+            sum += pMaster->minGain[count];
+        }
+        pMaster->minGainSum = sum;
+    }
+}
+
+// Run the active EQ bands over frames of interleaved float samples, in place
+static void PV_RunMasterEq(GM_MasterStage *pMaster, float *pBuffer, int frames, int channels)
+{
+    GM_MasterEqBand *pBand;
+    float           b0, b1, b2, a1, a2, z1, z2, x, y;
+    float           *pSample;
+    int             count, channel, index;
+
+    for (index = 0; index < pMaster->activeBandCount; index++)
+    {
+        pBand = &pMaster->band[pMaster->activeBands[index]];
+        b0 = pBand->b0;
+        b1 = pBand->b1;
+        b2 = pBand->b2;
+        a1 = pBand->a1;
+        a2 = pBand->a2;
+        for (channel = 0; channel < channels; channel++)
+        {
+            z1 = pBand->z1[channel];
+            z2 = pBand->z2[channel];
+            pSample = pBuffer + channel;
+            for (count = frames; count > 0; --count)
+            {
+                x = *pSample;
+                y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                *pSample = y;
+                pSample += channels;
+            }
+            pBand->z1[channel] = z1;
+            pBand->z2[channel] = z2;
+        }
+    }
+}
+
+static void PV_FlushMasterEq(GM_MasterStage *pMaster)
+{
+    GM_MasterEqBand *pBand;
+    int             index, channel;
+
+    for (index = 0; index < pMaster->activeBandCount; index++)
+    {
+        pBand = &pMaster->band[pMaster->activeBands[index]];
+        for (channel = 0; channel < 2; channel++)
+        {
+            if (fabs(pBand->z1[channel]) < MASTER_EQ_FLUSH)
+            {
+                pBand->z1[channel] = 0.0f;
+            }
+            if (fabs(pBand->z2[channel]) < MASTER_EQ_FLUSH)
+            {
+                pBand->z2[channel] = 0.0f;
+            }
+        }
+    }
+}
+
+// Limit frames of interleaved float samples in place. Output lags input by lookahead-1 frames.
+static void PV_RunMasterLimiter(GM_MasterStage *pMaster, float *pBuffer, int frames, int channels)
+{
+    float   peak, need, gain, average, envelope, invLookahead, sample;
+    float   *pDelay;
+    int     count, back, lookahead, delayLength;
+
+    lookahead = pMaster->lookahead;
+    delayLength = lookahead - 1;
+    invLookahead = 1.0f / (float)lookahead;
+    envelope = pMaster->envelope;
+    for (count = frames; count > 0; --count)
+    {
+        peak = (float)fabs(pBuffer[0]);
+        if (channels == 2)
+        {
+            sample = (float)fabs(pBuffer[1]);
+            if (sample > peak)
+            {
+                peak = sample;
+            }
+        }
+        need = (peak > pMaster->ceiling) ? (pMaster->ceiling / peak) : 1.0f;
+
+        // sliding minimum of need over the last lookahead frames. The deque holds
+        // gains in ascending order; larger ones behind a new gain can never be the minimum.
+        while (pMaster->dequeCount > 0)
+        {
+            back = (pMaster->dequeHead + pMaster->dequeCount - 1) & (MASTER_LIMITER_MAX_LOOKAHEAD - 1);
+            if (pMaster->dequeGain[back] < need)
+            {
+                break;
+            }
+            pMaster->dequeCount--;
+        }
+        back = (pMaster->dequeHead + pMaster->dequeCount) & (MASTER_LIMITER_MAX_LOOKAHEAD - 1);
+        pMaster->dequeGain[back] = need;
+        pMaster->dequeTime[back] = pMaster->time;
+        pMaster->dequeCount++;
+        if ((pMaster->time - pMaster->dequeTime[pMaster->dequeHead]) >= (XDWORD)lookahead)
+        {
+            pMaster->dequeHead = (pMaster->dequeHead + 1) & (MASTER_LIMITER_MAX_LOOKAHEAD - 1);
+            pMaster->dequeCount--;
+        }
+        gain = pMaster->dequeGain[pMaster->dequeHead];
+        pMaster->time++;
+
+        // box average of the minimum, so the gain ramps instead of stepping
+        pMaster->minGainSum += gain - pMaster->minGain[pMaster->minGainPos];
+        pMaster->minGain[pMaster->minGainPos] = gain;
+        if (++pMaster->minGainPos >= lookahead)
+        {
+            pMaster->minGainPos = 0;
+        }
+        average = pMaster->minGainSum * invLookahead;
+
+        // attack is already shaped by the average, only the release is smoothed
+        if (average < envelope)
+        {
+            envelope = average;
+        }
+        else
+        {
+            envelope += (average - envelope) * pMaster->releaseCoef;
+        }
+
+        pDelay = &pMaster->delay[pMaster->delayPos * 2];
+        sample = pDelay[0];
+        pDelay[0] = pBuffer[0];
+        pBuffer[0] = sample * envelope;
+        if (channels == 2)
+        {
+            sample = pDelay[1];
+            pDelay[1] = pBuffer[1];
+            pBuffer[1] = sample * envelope;
+        }
+        if (++pMaster->delayPos >= delayLength)
+        {
+            pMaster->delayPos = 0;
+        }
+        pBuffer += channels;
+    }
+    pMaster->envelope = envelope;
+}
+
+// Round and saturate a float sample in 16 bit units
+static OUTSAMPLE16 PV_MasterToSample(float value)
+{
+    if (value >= 32767.0f)
+    {
+        return (OUTSAMPLE16)32767;
+    }
+    if (value <= -32768.0f)
+    {
+        return (OUTSAMPLE16)-32768;
+    }
+    return (OUTSAMPLE16)(INT32)((value >= 0.0f) ? (value + 0.5f) : (value - 0.5f));
+}
+
+static void PV_GenerateMaster16output(OUTSAMPLE16 *dest16, int channels)
+{
+    GM_MasterStage  *pMaster;
+    float           buffer[MASTER_BLOCK_FRAMES * 2];
+    INT32           *source;
+    LOOPCOUNT       frames, block, count, samples;
+    XBOOL           eqEnabled, limiterEnabled, terp;
+    OUTSAMPLE16     left, right;
+    const float     scale = 1.0f / (float)(1L << OUTPUT_SCALAR);
+
+    pMaster = &MusicGlobals->master;
+    PV_PrepareMasterStage(pMaster);
+    eqEnabled = (XBOOL)(pMaster->eqEnabled && (pMaster->activeBandCount > 0));
+    limiterEnabled = pMaster->limiterEnabled;
+    terp = PV_IsTerpRate();
+
+    source = &MusicGlobals->songBufferDry[0];
+    for (frames = MusicGlobals->One_Loop; frames > 0; frames -= block)
+    {
+        block = (frames > MASTER_BLOCK_FRAMES) ? MASTER_BLOCK_FRAMES : frames;
+        samples = block * channels;
+        for (count = 0; count < samples; count++)
+        {
+            buffer[count] = (float)source[count] * scale;
+        }
+        source += samples;
+
+        if (eqEnabled)
+        {
+            PV_RunMasterEq(pMaster, buffer, block, channels);
+        }
+        if (limiterEnabled)
+        {
+            PV_RunMasterLimiter(pMaster, buffer, block, channels);
+        }
+
+        if (channels == 2)
+        {
+            if (terp)
+            {
+                for (count = 0; count < samples; count += 2)
+                {
+                    left = PV_MasterToSample(buffer[count]);
+                    right = PV_MasterToSample(buffer[count + 1]);
+                    dest16[0] = left;
+                    dest16[1] = right;
+                    dest16[2] = left;
+                    dest16[3] = right;
+                    dest16 += 4;
+                }
+            }
+            else
+            {
+                for (count = 0; count < samples; count++)
+                {
+                    dest16[count] = PV_MasterToSample(buffer[count]);
+                }
+                dest16 += samples;
+            }
+        }
+        else
+        {
+            if (terp)
+            {
+                for (count = 0; count < samples; count++)
+                {
+                    left = PV_MasterToSample(buffer[count]);
+                    dest16[0] = left;
+                    dest16[1] = left;
+                    dest16 += 2;
+                }
+            }
+            else
+            {
+                for (count = 0; count < samples; count++)
+                {
+                    dest16[count] = PV_MasterToSample(buffer[count]);
+                }
+                dest16 += samples;
+            }
+        }
+    }
+    if (eqEnabled)
+    {
+        PV_FlushMasterEq(pMaster);
+    }
+}
+
+#if USE_STEREO_OUTPUT == TRUE
+void PV_GenerateMaster16outputStereo(OUTSAMPLE16 * dest16)
+{
+    PV_GenerateMaster16output(dest16, 2);
+}
+#endif
+
+#if USE_MONO_OUTPUT == TRUE
+void PV_GenerateMaster16outputMono(OUTSAMPLE16 * dest16)
+{
+    PV_GenerateMaster16output(dest16, 1);
+}
+#endif
+#endif  // (USE_NEO_EFFECTS == TRUE) && (USE_16_BIT_OUTPUT == TRUE)
+
+#if USE_NEO_EFFECTS == TRUE
+//++------------------------------------------------------------------------------
+//  GM_SetMasterEqBand()
+//
+//  Set one band of the master EQ. The audio thread rebuilds the filters at the
+//  start of its next slice.
+//++------------------------------------------------------------------------------
+OPErr GM_SetMasterEqBand(short int band, MasterEqType type, XDWORD frequency, XSDWORD gain, XFIXED q)
+{
+    GM_MasterEqBand *pBand;
+
+    if (MusicGlobals == NULL)
+    {
+        return NOT_SETUP;
+    }
+    if ((band < 0) || (band >= MAX_MASTER_EQ_BANDS) ||
+        (type < MASTER_EQ_OFF) || (type > MASTER_EQ_HIGH_SHELF))
+    {
+        return PARAM_ERR;
+    }
+    if (frequency < MASTER_EQ_MIN_FREQUENCY)
+    {
+        frequency = MASTER_EQ_MIN_FREQUENCY;
+    }
+    if (gain > MASTER_EQ_MAX_GAIN)
+    {
+        gain = MASTER_EQ_MAX_GAIN;
+    }
+    if (gain < -MASTER_EQ_MAX_GAIN)
+    {
+        gain = -MASTER_EQ_MAX_GAIN;
+    }
+    if (q < MASTER_EQ_MIN_Q)
+    {
+        q = MASTER_EQ_MIN_Q;
+    }
+    if (q > MASTER_EQ_MAX_Q)
+    {
+        q = MASTER_EQ_MAX_Q;
+    }
+    pBand = &MusicGlobals->master.band[band];
+    pBand->type = type;
+    pBand->frequency = frequency;
+    pBand->gain = gain;
+    pBand->q = q;
+    MusicGlobals->master.eqChanged = TRUE;
+    return NO_ERR;
+}
+
+OPErr GM_GetMasterEqBand(short int band, MasterEqType *pType, XDWORD *pFrequency, XSDWORD *pGain, XFIXED *pQ)
+{
+    GM_MasterEqBand *pBand;
+
+    if (MusicGlobals == NULL)
+    {
+        return NOT_SETUP;
+    }
+    if ((band < 0) || (band >= MAX_MASTER_EQ_BANDS))
+    {
+        return PARAM_ERR;
+    }
+    pBand = &MusicGlobals->master.band[band];
+    if (pType)
+    {
+        *pType = pBand->type;
+    }
+    if (pFrequency)
+    {
+        *pFrequency = pBand->frequency;
+    }
+    if (pGain)
+    {
+        *pGain = pBand->gain;
+    }
+    if (pQ)
+    {
+        *pQ = pBand->q;
+    }
+    return NO_ERR;
+}
+
+void GM_SetMasterEqEnabled(XBOOL enabled)
+{
+    if (MusicGlobals)
+    {
+        if (enabled && (MusicGlobals->master.eqEnabled == FALSE))
+        {
+            // start from silence, the old filter state belongs to long ago audio
+            MusicGlobals->master.eqReset = TRUE;
+            MusicGlobals->master.eqChanged = TRUE;
+        }
+        MusicGlobals->master.eqEnabled = enabled ? TRUE : FALSE;
+    }
+}
+
+XBOOL GM_IsMasterEqEnabled(void)
+{
+    if (MusicGlobals)
+    {
+        return MusicGlobals->master.eqEnabled;
+    }
+    return FALSE;
+}
+
+void GM_SetMasterLimiterEnabled(XBOOL enabled)
+{
+    if (MusicGlobals)
+    {
+        if (enabled && (MusicGlobals->master.limiterEnabled == FALSE))
+        {
+            MusicGlobals->master.limiterReset = TRUE;
+        }
+        MusicGlobals->master.limiterEnabled = enabled ? TRUE : FALSE;
+    }
+}
+
+XBOOL GM_IsMasterLimiterEnabled(void)
+{
+    if (MusicGlobals)
+    {
+        return MusicGlobals->master.limiterEnabled;
+    }
+    return FALSE;
+}
+#endif  // USE_NEO_EFFECTS == TRUE
+
@@ -689,7 +689,8 @@ bailoninstrument:
 **
 **  PV_CreateInstrumentFromResource
 **
-**  Create instrument from a raw 'snd' resource ID
+**  Create instrument from a raw 'snd' resource ID, read from sampleFile, or
+**  the first open resource file that has it if that's NULL
 **
 **  ????.??.?? ???  Function created
 **  2000.05.10 AER  Rewrote sample cache code to work with improved cache code
@@ -698,6 +699,7 @@ bailoninstrument:
 static GM_Instrument * PV_CreateInstrumentFromResource(GM_Instrument *theMaster,
                                                        XSampleID theID,
                                                        XBankToken bankToken,
+                                                       XFILE sampleFile,
                                                        OPErr *pErr)
 {
     GM_Instrument *         theI;
@@ -708,9 +710,12 @@ static GM_Instrument * PV_CreateInstrumentFromResource(GM_Instrument *theMaster,
     theI = NULL;
     pMixer = MusicGlobals;
 
-    //  First, if there is no entry in the cache for this ID, create it.
-    //  Next, increment refcount and grab it's pointer.
-    if (GMCache_IsIDInCache(pMixer, theID, bankToken) != TRUE)
+    //  Take a reference on the cache entry for this ID, creating it if there isn't one
+    if (sampleFile)
+    {
+        sndInfo = GMCache_BuildSampleCacheEntryFromFile(pMixer, theID, bankToken, sampleFile, pErr);
+    }
+    else
     {
         sndInfo = GMCache_BuildSampleCacheEntry(pMixer,
                                                 theID,
@@ -718,18 +723,12 @@ static GM_Instrument * PV_CreateInstrumentFromResource(GM_Instrument *theMaster,
                                                 NULL,
                                                 pErr);
     }
-    else
-    {
-        sndInfo = GMCache_GetCachePtrFromID(pMixer, theID, bankToken, pErr);
-        if (*pErr != NO_ERR) return theI;
-        *pErr = GMCache_IncrCacheEntryRef(pMixer, sndInfo);
-    }
     if (*pErr != NO_ERR) return theI;
     theSound = GMCache_GetSamplePtr(sndInfo, pErr);
 
     if (theSound)
     {
-        theI = (GM_Instrument *)XNewPtr((int32_t)sizeof(GM_Instrument));
+        theI = (GM_Instrument *)XNewTaggedPtr((int32_t)sizeof(GM_Instrument), X_MEMORY_INSTRUMENTS);
         if (theI)
         {
             theI->u.w.theWaveform = (SBYTE *)theSound;
@@ -779,6 +778,80 @@ static GM_Instrument * PV_CreateInstrumentFromResource(GM_Instrument *theMaster,
     return theI;
 }
 
+// Create the instrument for one split of theI from its sample, set up like theI
+static GM_Instrument * PV_CreateSplitInstrument(GM_Instrument *theI, GM_KeymapSplit *pSplit,
+                                               XBankToken bankToken, OPErr *pErr)
+{
+    GM_Instrument   *theS;
+    LOOPCOUNT       i;
+
+    theS = PV_CreateInstrumentFromResource(theI, (XSampleID)pSplit->sndResourceID, bankToken, pSplit->sampleFile, pErr);
+    if (theS)
+    {
+        theS->useSoundModifierAsRootKey = theI->useSoundModifierAsRootKey;
+        theS->miscParameter1 = pSplit->miscParameter1;
+        theS->miscParameter2 = pSplit->miscParameter2;
+        theS->masterRootKey = theI->masterRootKey;
+        theS->panPlacement = theI->panPlacement;
+#if REVERB_USED != REVERB_DISABLED
+        theS->avoidReverb = theI->avoidReverb;
+#endif
+        theS->volumeADSRRecord = theI->volumeADSRRecord;
+        for (i = 0; i < theI->LFORecordCount; i++) { theS->LFORecords[i] = theI->LFORecords[i]; }
+        theS->LFORecordCount = theI->LFORecordCount;
+        for (i = 0; i < theI->curveRecordCount; i++) { theS->curve[i] = theI->curve[i]; }
+        theS->curveRecordCount = theI->curveRecordCount;
+        theS->LPF_frequency = theI->LPF_frequency;
+        theS->LPF_resonance = theI->LPF_resonance;
+        theS->LPF_lowpassAmount = theI->LPF_lowpassAmount;
+    }
+    // the voices read this without a lock, so it's only set once the split is complete
+    pSplit->pSplitInstrument = theS;
+    return theS;
+}
+
+static XBOOL PV_IsLazySplitDecoding(GM_Mixer *pMixer)
+{
+    return (pMixer->lazySplitDecoding && pMixer->pInstrumentLoader) ? TRUE : FALSE;
+}
+
+// The split of theI whose key range is nearest thePitch, counting only the loaded ones
+// if loadedOnly. -1 if there are none. Safe at interrupt time.
+INT16 PV_GetNearestSplit(GM_Instrument *theI, INT16 thePitch, XBOOL loadedOnly)
+{
+    GM_KeymapSplit  *k;
+    INT16           count, best, distance, bestDistance;
+
+    best = -1;
+    bestDistance = 0;
+    k = theI->u.k.keySplits;
+    for (count = 0; count < (INT16)theI->u.k.KeymapSplitCount; count++)
+    {
+        if ((loadedOnly == FALSE) || k->pSplitInstrument)
+        {
+            if (thePitch < k->lowMidi)
+            {
+                distance = k->lowMidi - thePitch;
+            }
+            else if (thePitch > k->highMidi)
+            {
+                distance = thePitch - k->highMidi;
+            }
+            else
+            {
+                distance = 0;
+            }
+            if ((best == -1) || (distance < bestDistance))
+            {
+                best = count;
+                bestDistance = distance;
+            }
+        }
+        k++;
+    }
+    return best;
+}
+
 /******************************************************************************
 **
 **  PV_GetInstrument
@@ -800,7 +873,6 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
                                  OPErr *pErr)
 {
     GM_Instrument *         theI;
-    GM_Instrument *         theS;
     InstrumentResource *    theX;
     InstrumentResourceHeaderView header;
     int32_t                 size;
@@ -808,8 +880,9 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
     XPTR                    theSound;
     KeySplit                theXSplit;
     GM_SampleCacheEntry *   sndInfo;
-    LOOPCOUNT               i;
     XSampleID               theSampleID;
+    XBOOL                   lazy, used;
+    int16_t                 loaded;
 
     theI = NULL;
     theX = (InstrumentResource *)theExternalX;
@@ -825,21 +898,12 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
         if (header.keySplitCount < 2)
         {
             theSampleID = (int32_t)header.sndResourceID;
-            if (GMCache_IsIDInCache(pMixer, theSampleID, bankToken) != TRUE)
-            {
-                sndInfo = GMCache_BuildSampleCacheEntry(pMixer, theSampleID, bankToken, NULL, pErr);
-            }
-            else
-            {
-                sndInfo = GMCache_GetCachePtrFromID(pMixer, theSampleID, bankToken, pErr);
-                if (pErr && *pErr != NO_ERR) { return theI; }
-                *pErr = GMCache_IncrCacheEntryRef(pMixer, sndInfo);
-            }
+            sndInfo = GMCache_BuildSampleCacheEntry(pMixer, theSampleID, bankToken, NULL, pErr);
             if (pErr && *pErr != NO_ERR) { return theI; }
             theSound = GMCache_GetSamplePtr(sndInfo, pErr);
             if (theSound)
             {
-                theI = (GM_Instrument *)XNewPtr((int32_t)sizeof(GM_Instrument));
+                theI = (GM_Instrument *)XNewTaggedPtr((int32_t)sizeof(GM_Instrument), X_MEMORY_INSTRUMENTS);
                 if (theI)
                 {
                     theI->u.w.theWaveform = (SBYTE *)theSound;
@@ -896,7 +960,7 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
         {
             size = header.keySplitCount * sizeof(GM_KeymapSplit);
             size += sizeof(GM_KeymapSplitInfo);
-            theI = (GM_Instrument *)XNewPtr(size + sizeof(GM_Instrument));
+            theI = (GM_Instrument *)XNewTaggedPtr(size + sizeof(GM_Instrument), X_MEMORY_INSTRUMENTS);
             if (theI)
             {
                 theI->disableSndLooping = TEST_FLAG_VALUE(header.flags1, ZBF_disableSndLooping);
@@ -926,6 +990,12 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
                     theI->enableSoundModifier = TEST_FLAG_VALUE(header.flags2, ZBF_enableSoundModifier);
                     theI->smodResourceID = header.smodResourceID;
                 }
+                theI->u.k.bankToken = bankToken;
+                // With lazy decoding, only the splits the song is known to play are loaded
+                // now. The rest wait for a note to need them. Live songs aren't scanned, so
+                // none are known.
+                lazy = PV_IsLazySplitDecoding(pMixer);
+                loaded = 0;
                 for (count = 0; count < theI->u.k.KeymapSplitCount; count++)
                 {
                     XGetKeySplitFromPtr(theX, count, &theXSplit);
@@ -934,29 +1004,18 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
                     theI->u.k.keySplits[count].miscParameter1 = theXSplit.miscParameter1;
                     if (theI->useSoundModifierAsRootKey && (theXSplit.miscParameter2 == 0)) { theXSplit.miscParameter2 = 100; }
                     theI->u.k.keySplits[count].miscParameter2 = theXSplit.miscParameter2;
-                    if (GM_IsInstrumentRangeUsed(pSong, theID, (INT16)theXSplit.lowMidi, (INT16)theXSplit.highMidi))
+                    theI->u.k.keySplits[count].sndResourceID = theXSplit.sndResourceID;
+                    theI->u.k.keySplits[count].sampleFile = NULL;
+                    used = GM_IsInstrumentRangeUsed(pSong, theID, (INT16)theXSplit.lowMidi, (INT16)theXSplit.highMidi);
+                    if (lazy && ((pSong == NULL) || (pSong->pUsedPatchList == NULL)))
+                    {
+                        used = FALSE;
+                    }
+                    if (used)
                     {
-                        theS =  PV_CreateInstrumentFromResource(theI, (XSampleID) theXSplit.sndResourceID, bankToken, pErr);
-                        theI->u.k.keySplits[count].pSplitInstrument = theS;
-                        if (theS)
+                        if (PV_CreateSplitInstrument(theI, &theI->u.k.keySplits[count], bankToken, pErr))
                         {
-                            theS->useSoundModifierAsRootKey = theI->useSoundModifierAsRootKey;
-                            theS->miscParameter1 = theXSplit.miscParameter1;
-                            if (theS->useSoundModifierAsRootKey && (theXSplit.miscParameter2 == 0)) { theXSplit.miscParameter2 = 100; }
-                            theS->miscParameter2 = theXSplit.miscParameter2;
-                            theS->masterRootKey = theI->masterRootKey;
-                            theS->panPlacement = theI->panPlacement;
-#if REVERB_USED != REVERB_DISABLED
-                            theS->avoidReverb = theI->avoidReverb;
-#endif
-                            theS->volumeADSRRecord = theI->volumeADSRRecord;
-                            for (i = 0; i < theI->LFORecordCount; i++) { theS->LFORecords[i] = theI->LFORecords[i]; }
-                            theS->LFORecordCount = theI->LFORecordCount;
-                            for (i = 0; i < theI->curveRecordCount; i++) { theS->curve[i] = theI->curve[i]; }
-                            theS->curveRecordCount = theI->curveRecordCount;
-                            theS->LPF_frequency = theI->LPF_frequency;
-                            theS->LPF_resonance = theI->LPF_resonance;
-                            theS->LPF_lowpassAmount = theI->LPF_lowpassAmount;
+                            loaded++;
                         }
                         else if (pErr && *pErr != NO_ERR)
                         {
@@ -964,6 +1023,23 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
                                       (long)theID, (int)count, (int)theXSplit.sndResourceID, (int)*pErr);
                         }
                     }
+                    else if (lazy)
+                    {
+                        // by the time a note wants it, other banks may have come in front, or
+                        // this one gone, so the file the sample is in now is kept
+                        theI->u.k.keySplits[count].lazyDecode = TRUE;
+                        theI->u.k.keySplits[count].sampleFile = XFindSoundResourceFile((XLongResourceID)theXSplit.sndResourceID);
+                        theI->u.k.keySplits[count].sampleFileKey = XFileGetContentKey(theI->u.k.keySplits[count].sampleFile);
+                    }
+                }
+                if (lazy && (loaded == 0) && theI->u.k.KeymapSplitCount)
+                {
+                    // keep one split, the one nearest middle C, so early notes have something
+                    // to stand in with
+                    count = PV_GetNearestSplit(theI, 60, FALSE);
+                    theI->u.k.keySplits[count].lazyDecode = FALSE;
+                    theI->u.k.keySplits[count].sampleFile = NULL;
+                    PV_CreateSplitInstrument(theI, &theI->u.k.keySplits[count], bankToken, pErr);
                 }
             }
             else
@@ -1032,6 +1108,7 @@ OPErr GM_LoadInstrumentFromExternalData(GM_Song *pSong,
     OPErr                   theErr;
 
     theErr = MEMORY_ERR;
+    PV_AcquireInstrumentLoadLock();
     if ( (instrument >= 0) && (instrument < (MAX_INSTRUMENTS*MAX_BANKS)) )
     {
         if (pSong)
@@ -1064,6 +1141,7 @@ OPErr GM_LoadInstrumentFromExternalData(GM_Song *pSong,
     {
         theErr = PARAM_ERR;
     }
+    PV_ReleaseInstrumentLoadLock();
     return theErr;
 }
 
@@ -1078,6 +1156,7 @@ OPErr GM_LoadInstrument(GM_Song *pSong,
     OPErr                   theErr;
 
     theErr = MEMORY_ERR;
+    PV_AcquireInstrumentLoadLock();
     if ( (instrument >= 0) && (instrument < (MAX_INSTRUMENTS*MAX_BANKS)) )
     {
         if (pSong)
@@ -1126,6 +1205,7 @@ OPErr GM_LoadInstrument(GM_Song *pSong,
     {
         theErr = PARAM_ERR;
     }
+    PV_ReleaseInstrumentLoadLock();
     return theErr;
 }
 
@@ -1158,6 +1238,7 @@ OPErr PV_UnloadInstrumentData(GM_Instrument *theI, GM_Mixer *pMixer, XBOOL freeS
                                 {
                                     pCache = GMCache_GetCachePtrFromPtr(pMixer,
                                                                         k->pSplitInstrument->u.w.theWaveform,
+                                                                        k->pSplitInstrument->u.w.waveformID,
                                                                         &theErr);
                                     if (pCache && theErr == NO_ERR)
                                     {
@@ -1178,6 +1259,7 @@ OPErr PV_UnloadInstrumentData(GM_Instrument *theI, GM_Mixer *pMixer, XBOOL freeS
                         {
                             pCache = GMCache_GetCachePtrFromPtr(pMixer,
                                                                 theI->u.w.theWaveform,
+                                                                theI->u.w.waveformID,
                                                                 &theErr);
                             if (pCache && theErr == NO_ERR)
                             {
@@ -1214,6 +1296,7 @@ static OPErr PV_UnloadSongInstrument(GM_Song *pSong, XLongResourceID instrument,
     register OPErr              theErr;
 
     theErr = BAD_INSTRUMENT;
+    PV_AcquireInstrumentLoadLock();
     if ( (instrument >= 0) && (instrument < (MAX_INSTRUMENTS*MAX_BANKS)) )
     {
         if (pSong)
@@ -1241,6 +1324,7 @@ static OPErr PV_UnloadSongInstrument(GM_Song *pSong, XLongResourceID instrument,
     {
         theErr = PARAM_ERR;
     }
+    PV_ReleaseInstrumentLoadLock();
     return theErr;
 }
 
@@ -1252,6 +1336,456 @@ OPErr GM_UnloadInstrument(GM_Song *pSong, XLongResourceID instrument)
     return PV_UnloadSongInstrument(pSong, instrument, TRUE);
 }
 
+// Instrument loader. Loads and unloads from every thread go through one lock, so the
+// loader thread never sees an instrument or sample cache entry half built. The lock is
+// recursive, and is never held while waiting for the audio thread.
+static BAE_Mutex            g_instrumentLoadLock = NULL;
+
+// Called as each mixer is set up. Like the shared sample pool, the lock is never freed.
+void PV_InitInstrumentLoadLock(void)
+{
+    if (g_instrumentLoadLock == NULL)
+    {
+        if (BAE_NewMutex(&g_instrumentLoadLock, "bae", "inst", __LINE__) == 0)
+        {
+            g_instrumentLoadLock = NULL;
+        }
+    }
+}
+
+void PV_AcquireInstrumentLoadLock(void)
+{
+    if (g_instrumentLoadLock)
+    {
+        BAE_AcquireMutex(g_instrumentLoadLock);
+    }
+}
+
+void PV_ReleaseInstrumentLoadLock(void)
+{
+    if (g_instrumentLoadLock)
+    {
+        BAE_ReleaseMutex(g_instrumentLoadLock);
+    }
+}
+
+// Takes the oldest request off the queue. The load lock is held, so a song can't be freed
+// between its request leaving the queue and its load finishing.
+static XBOOL PV_NextInstrumentRequest(GM_InstrumentLoader *pLoader, GM_InstrumentRequest *pRequest)
+{
+    XBOOL   found;
+
+    found = FALSE;
+    BAE_AcquireMutex(pLoader->queueLock);
+    if (pLoader->count)
+    {
+        *pRequest = pLoader->requests[pLoader->head];
+        pLoader->head = (XSWORD)((pLoader->head + 1) % MAX_INSTRUMENT_REQUESTS);
+        pLoader->count--;
+        found = TRUE;
+    }
+    BAE_ReleaseMutex(pLoader->queueLock);
+    return found;
+}
+
+// Decode a split registered with lazyDecode, now that a note wants it. The instrument
+// is looked up again under the load lock, as it may have been unloaded since the request.
+// The sample is only read from the file it was in at load. If that file has been closed
+// since, as an RMF is once its song loads, the split keeps its stand in and isn't asked
+// for again.
+static void PV_DecodeLazySplit(GM_Song *pSong, XLongResourceID instrument, XSWORD split)
+{
+    GM_Instrument   *theI;
+    GM_KeymapSplit  *pSplit;
+    OPErr           theErr;
+
+    theI = pSong->instrumentData[instrument];
+    if (theI && theI->doKeymapSplit && (split < (XSWORD)theI->u.k.KeymapSplitCount))
+    {
+        pSplit = &theI->u.k.keySplits[split];
+        if (pSplit->lazyDecode && (pSplit->pSplitInstrument == NULL))
+        {
+            if (pSplit->sampleFile == NULL)
+            {
+                // it wasn't in any file at load, so it goes silent like one that failed then
+                pSplit->lazyDecode = FALSE;
+                return;
+            }
+            if ((XFileIsOpenResource(pSplit->sampleFile) == FALSE) ||
+                (XFileGetContentKey(pSplit->sampleFile) != pSplit->sampleFileKey))
+            {
+                return;
+            }
+            theErr = NO_ERR;
+            // if it fails, the split goes silent like one that failed at load
+            PV_CreateSplitInstrument(theI, pSplit, theI->u.k.bankToken, &theErr);
+            pSplit->lazyDecode = FALSE;
+        }
+    }
+}
+
+static void PV_InstrumentLoaderProc(void *context)
+{
+    GM_InstrumentLoader     *pLoader;
+    GM_InstrumentRequest    request;
+
+    pLoader = (GM_InstrumentLoader *)context;
+    while (1)
+    {
+        BAE_WaitEvent(pLoader->wakeEvent);
+        if (pLoader->quit)
+        {
+            break;
+        }
+        while (pLoader->quit == FALSE)
+        {
+            PV_AcquireInstrumentLoadLock();
+            if (PV_NextInstrumentRequest(pLoader, &request) == FALSE)
+            {
+                PV_ReleaseInstrumentLoadLock();
+                break;
+            }
+            if (request.split < 0)
+            {
+                GM_LoadSongInstrument(request.pSong, request.instrument, request.bankToken);
+                BAE_AcquireMutex(pLoader->queueLock);
+                XClearBit(request.pSong->pendingInstruments, (uint32_t)request.instrument);
+                BAE_ReleaseMutex(pLoader->queueLock);
+            }
+            else
+            {
+                PV_DecodeLazySplit(request.pSong, request.instrument, request.split);
+            }
+            PV_ReleaseInstrumentLoadLock();
+        }
+    }
+}
+
+static void PV_FreeInstrumentLoader(GM_InstrumentLoader *pLoader)
+{
+    if (pLoader->wakeEvent)
+    {
+        BAE_DestroyEvent(pLoader->wakeEvent);
+    }
+    if (pLoader->queueLock)
+    {
+        BAE_DestroyMutex(pLoader->queueLock);
+    }
+    XDisposePtr((XPTR)pLoader);
+}
+
+// Enable or disable the instrument loader. Fails with NOT_SETUP if the platform can't
+// start threads, in which case GM_RequestSongInstrument loads in line. Do not call at
+// interrupt time. Disabling decodes the lazy splits already asked for in line; splits no
+// note has landed on yet stay lazy, and go on playing their nearest decoded split until
+// their instrument is loaded again.
+OPErr GM_SetInstrumentLoaderEnabled(XBOOL enabled)
+{
+    GM_Mixer                *pMixer;
+    GM_InstrumentLoader     *pLoader;
+    GM_InstrumentRequest    *pRequest;
+
+    pMixer = MusicGlobals;
+    if (pMixer == NULL)
+    {
+        return NOT_SETUP;
+    }
+    if (enabled)
+    {
+        if (pMixer->pInstrumentLoader == NULL)
+        {
+            pLoader = (GM_InstrumentLoader *)XNewTaggedPtr((int32_t)sizeof(GM_InstrumentLoader), X_MEMORY_INSTRUMENTS);
+            if (pLoader == NULL)
+            {
+                return MEMORY_ERR;
+            }
+            if ((BAE_NewMutex(&pLoader->queueLock, "bae", "load", __LINE__) == 0) ||
+                (BAE_NewEvent(&pLoader->wakeEvent) == 0) ||
+                (BAE_NewWorkerThread(&pLoader->thread, PV_InstrumentLoaderProc, pLoader) == 0))
+            {
+                PV_FreeInstrumentLoader(pLoader);
+                return NOT_SETUP;
+            }
+            pMixer->pInstrumentLoader = pLoader;
+        }
+    }
+    else
+    {
+        pLoader = pMixer->pInstrumentLoader;
+        if (pLoader)
+        {
+            pMixer->pInstrumentLoader = NULL;
+            // the audio thread may be queueing a split on it this slice, so let it finish first
+            while (pMixer->insideAudioInterrupt)
+            {
+                XWaitMicroseconds(BAE_GetSliceTimeInMicroseconds());
+            }
+            pLoader->quit = TRUE;
+            BAE_SignalEvent(pLoader->wakeEvent);
+            BAE_JoinWorkerThread(pLoader->thread);
+            // whatever didn't get to load is no longer pending, while the splits asked for
+            // are decoded here, as nothing would ask for them again
+            PV_AcquireInstrumentLoadLock();
+            BAE_AcquireMutex(pLoader->queueLock);
+            while (pLoader->count)
+            {
+                pRequest = &pLoader->requests[pLoader->head];
+                if (pRequest->split < 0)
+                {
+                    XClearBit(pRequest->pSong->pendingInstruments, (uint32_t)pRequest->instrument);
+                }
+                else
+                {
+                    PV_DecodeLazySplit(pRequest->pSong, pRequest->instrument, pRequest->split);
+                }
+                pLoader->head = (XSWORD)((pLoader->head + 1) % MAX_INSTRUMENT_REQUESTS);
+                pLoader->count--;
+            }
+            BAE_ReleaseMutex(pLoader->queueLock);
+            PV_ReleaseInstrumentLoadLock();
+            PV_FreeInstrumentLoader(pLoader);
+        }
+    }
+    return NO_ERR;
+}
+
+XBOOL GM_IsInstrumentLoaderEnabled(void)
+{
+    if (MusicGlobals)
+    {
+        return (MusicGlobals->pInstrumentLoader != NULL) ? TRUE : FALSE;
+    }
+    return FALSE;
+}
+
+OPErr GM_RequestSongInstrument(GM_Song *pSong, XLongResourceID instrument, XBankToken bankToken)
+{
+    GM_InstrumentLoader     *pLoader;
+    GM_InstrumentRequest    *pRequest;
+    OPErr                   theErr;
+
+    if ((instrument < 0) || (instrument >= (MAX_INSTRUMENTS*MAX_BANKS)))
+    {
+        return PARAM_ERR;
+    }
+    if (pSong == NULL)
+    {
+        return NOT_SETUP;
+    }
+    pLoader = MusicGlobals ? MusicGlobals->pInstrumentLoader : NULL;
+    if (pLoader == NULL)
+    {
+        return GM_LoadSongInstrument(pSong, instrument, bankToken);
+    }
+    theErr = NO_ERR;
+    BAE_AcquireMutex(pLoader->queueLock);
+    if (XTestBit(pSong->pendingInstruments, (uint32_t)instrument) == FALSE)
+    {
+        if (pLoader->count < MAX_INSTRUMENT_REQUESTS)
+        {
+            pRequest = &pLoader->requests[(pLoader->head + pLoader->count) % MAX_INSTRUMENT_REQUESTS];
+            pRequest->pSong = pSong;
+            pRequest->instrument = instrument;
+            pRequest->bankToken = bankToken;
+            pRequest->split = -1;
+            pLoader->count++;
+            XSetBit(pSong->pendingInstruments, (uint32_t)instrument);
+        }
+        else
+        {
+            theErr = NOT_READY;
+        }
+    }
+    BAE_ReleaseMutex(pLoader->queueLock);
+    if (theErr == NO_ERR)
+    {
+        BAE_SignalEvent(pLoader->wakeEvent);
+    }
+    return theErr;
+}
+
+// TRUE while instrument is queued on the loader or loading. Safe at interrupt time.
+XBOOL GM_IsSongInstrumentPending(GM_Song *pSong, XLongResourceID instrument)
+{
+    if (pSong && (instrument >= 0) && (instrument < (MAX_INSTRUMENTS*MAX_BANKS)))
+    {
+        return XTestBit(pSong->pendingInstruments, (uint32_t)instrument);
+    }
+    return FALSE;
+}
+
+// Queue a lazyDecode split of the loaded instrument for the loader. Called from the
+// mixer when a note first lands on it, so it only takes the queue lock.
+OPErr PV_RequestLazySplit(GM_Song *pSong, XLongResourceID instrument, INT16 split)
+{
+    GM_InstrumentLoader     *pLoader;
+    GM_InstrumentRequest    *pRequest;
+    OPErr                   theErr;
+
+    pLoader = MusicGlobals ? MusicGlobals->pInstrumentLoader : NULL;
+    if (pLoader == NULL)
+    {
+        return NOT_SETUP;
+    }
+    theErr = NO_ERR;
+    BAE_AcquireMutex(pLoader->queueLock);
+    if (pLoader->count < MAX_INSTRUMENT_REQUESTS)
+    {
+        pRequest = &pLoader->requests[(pLoader->head + pLoader->count) % MAX_INSTRUMENT_REQUESTS];
+        XSetMemory(pRequest, (int32_t)sizeof(GM_InstrumentRequest), 0);
+        pRequest->pSong = pSong;
+        pRequest->instrument = instrument;
+        pRequest->split = (XSWORD)split;
+        pLoader->count++;
+    }
+    else
+    {
+        theErr = NOT_READY;
+    }
+    BAE_ReleaseMutex(pLoader->queueLock);
+    if (theErr == NO_ERR)
+    {
+        BAE_SignalEvent(pLoader->wakeEvent);
+    }
+    return theErr;
+}
+
+// With enabled, and the instrument loader running, instruments loaded from now on only
+// decode the key splits their song is known to play. The rest are decoded on the loader
+// the first time a note lands on them, while the nearest loaded split plays in their place.
+void GM_SetLazySplitDecoding(XBOOL enabled)
+{
+    if (MusicGlobals)
+    {
+        MusicGlobals->lazySplitDecoding = enabled;
+    }
+}
+
+XBOOL GM_IsLazySplitDecoding(void)
+{
+    if (MusicGlobals)
+    {
+        return MusicGlobals->lazySplitDecoding;
+    }
+    return FALSE;
+}
+
+void GM_CancelSongInstrumentRequests(GM_Song *pSong)
+{
+    GM_InstrumentLoader     *pLoader;
+    GM_InstrumentRequest    *pRequest;
+    XSWORD                  count, kept, total;
+
+    pLoader = MusicGlobals ? MusicGlobals->pInstrumentLoader : NULL;
+    if (pLoader && pSong)
+    {
+        BAE_AcquireMutex(pLoader->queueLock);
+        kept = 0;
+        total = pLoader->count;
+        for (count = 0; count < total; count++)
+        {
+            pRequest = &pLoader->requests[(pLoader->head + count) % MAX_INSTRUMENT_REQUESTS];
+            if (pRequest->pSong == pSong)
+            {
+                if (pRequest->split < 0)
+                {
+                    XClearBit(pSong->pendingInstruments, (uint32_t)pRequest->instrument);
+                }
+            }
+            else
+            {
+                pLoader->requests[(pLoader->head + kept) % MAX_INSTRUMENT_REQUESTS] = *pRequest;
+                kept++;
+            }
+        }
+        pLoader->count = kept;
+        BAE_ReleaseMutex(pLoader->queueLock);
+
+        // a load taken off the queue before we got here finishes under the load lock
+        PV_AcquireInstrumentLoadLock();
+        PV_ReleaseInstrumentLoadLock();
+    }
+}
+
+// Add theID to the samples to prefetch, unless it's there already or cached
+static void PV_AddPrefetchSample(XSampleID *pIDs, UINT32 *pCount, XSampleID theID, XBankToken bankToken)
+{
+    UINT32  index;
+
+    if ((*pCount < MAX_SAMPLES) && (GMCache_IsIDInCache(MusicGlobals, theID, bankToken) == FALSE))
+    {
+        for (index = 0; index < *pCount; index++)
+        {
+            if (pIDs[index] == theID)
+            {
+                return;
+            }
+        }
+        pIDs[(*pCount)++] = theID;
+    }
+}
+
+// Decode the samples of the instruments GM_LoadSongInstruments is about to load, across
+// the processors, so its loads find them in the shared sample pool. Call with the
+// instrument load lock held, which keeps the other threads out of the resource files
+// while the decoders read them. Instruments that fail here load the usual way.
+static GM_SamplePrefetch * PV_PrefetchSongSamples(GM_Song *pSong, XBankToken bankToken)
+{
+    GM_SamplePrefetch               *pPrefetch;
+    InstrumentResource              *theX;
+    InstrumentResourceHeaderView    header;
+    KeySplit                        theXSplit;
+    XSampleID                       *pIDs;
+    XLongResourceID                 realInstrument;
+    UINT32                          count;
+    int32_t                         instrument, size;
+    int16_t                         split;
+
+    pPrefetch = NULL;
+    pIDs = (XSampleID *)XNewPtr((int32_t)(MAX_SAMPLES * sizeof(XSampleID)));
+    if (pIDs)
+    {
+        count = 0;
+        for (instrument = 0; instrument < MAX_INSTRUMENTS*MAX_BANKS; instrument++)
+        {
+            if (GM_IsInstrumentUsed(pSong, (XLongResourceID)instrument, -1))
+            {
+                if (GM_GetSongInstrumentRemap(pSong, (XLongResourceID)instrument, &realInstrument) != NO_ERR)
+                {
+                    realInstrument = (XLongResourceID)instrument;
+                }
+                theX = (InstrumentResource *)XGetAndDetachResource(ID_INST, realInstrument, &size);
+                if (theX)
+                {
+                    header = PV_ReadInstrumentHeader(theX);
+                    if (header.keySplitCount < 2)
+                    {
+                        PV_AddPrefetchSample(pIDs, &count, (XSampleID)header.sndResourceID, bankToken);
+                    }
+                    else
+                    {
+                        // only the splits the song plays, like PV_GetInstrument. A remapped
+                        // instrument loads with the key range of the one it stands in for.
+                        for (split = 0; split < header.keySplitCount; split++)
+                        {
+                            XGetKeySplitFromPtr(theX, split, &theXSplit);
+                            if (GM_IsInstrumentRangeUsed(pSong, (XLongResourceID)instrument,
+                                                         (INT16)theXSplit.lowMidi, (INT16)theXSplit.highMidi))
+                            {
+                                PV_AddPrefetchSample(pIDs, &count, (XSampleID)theXSplit.sndResourceID, bankToken);
+                            }
+                        }
+                    }
+                    XDisposePtr((XPTR)theX);
+                }
+            }
+        }
+        pPrefetch = GMCache_PrefetchSamples(pIDs, count);
+        XDisposePtr((XPTR)pIDs);
+    }
+    return pPrefetch;
+}
+
 // Scan the midi file and determine which instrument that need to be loaded and load them.
 OPErr GM_LoadSongInstruments(GM_Song *theSong,
                              XShortResourceID *pArray,
@@ -1265,6 +1799,7 @@ OPErr GM_LoadSongInstruments(GM_Song *theSong,
     XBOOL               emptyStart;
     SBYTE               remapUsedSaved[MAX_INSTRUMENTS];
     SBYTE               remapUsed[MAX_INSTRUMENTS];
+    GM_SamplePrefetch   *pPrefetch;
 
     if (theSong->seqType != SEQ_MIDI)
     {
@@ -1272,7 +1807,7 @@ OPErr GM_LoadSongInstruments(GM_Song *theSong,
     }
     // Set the sequencer to mark instruments only
     theErr = NO_ERR;
-    theSong->pUsedPatchList = (SBYTE *)XNewPtr((MAX_INSTRUMENTS*MAX_BANKS*128L) / 8);
+    theSong->pUsedPatchList = (SBYTE *)XNewTaggedPtr((MAX_INSTRUMENTS*MAX_BANKS*128L) / 8, X_MEMORY_SONGS);
     if (theSong->pUsedPatchList)
     {
         GM_SetupSongRemaps(theSong, TRUE);
@@ -1348,6 +1883,12 @@ OPErr GM_LoadSongInstruments(GM_Song *theSong,
             #if DEBUG_DISPLAY_PATCHES
                 BAE_PRINTF("Loading instruments:\n");
             #endif
+                PV_AcquireInstrumentLoadLock();
+                pPrefetch = NULL;
+                if (loadInstruments)
+                {
+                    pPrefetch = PV_PrefetchSongSamples(theSong, bankToken);
+                }
                 instCount = 0;
                 for (count = 0; count < MAX_INSTRUMENTS*MAX_BANKS; count++)
                 {
@@ -1441,6 +1982,8 @@ OPErr GM_LoadSongInstruments(GM_Song *theSong,
                         }
                     }
                 }
+                GMCache_ReleasePrefetchedSamples(pPrefetch);
+                PV_ReleaseInstrumentLoadLock();
             }
         }   
     
@@ -507,7 +507,7 @@ struct GM_Voice
                                                     // A single pass search will happen and it will look for matching syncVoiceReference
                                                     // values. Once the voice is started it will be set to NULL.
     XSWORD                  NoteDecay;              // after voiceMode == VOICE_RELEASING then this is ticks of decay
-    XDWORD                  voiceStartTimeStamp;    // this is a time stamp of when this voice is started, used to
+    uint64_t                voiceStartTimeStamp;    // this is a time stamp of when this voice is started, used to
                                                     // track unique voices
     GM_Instrument           *pInstrument;           // read-only pointer to instrument information
     GM_Song                 *pSong;                 // read-only pointer to song information
@@ -625,9 +625,30 @@ struct GM_SampleCacheEntry
     int32_t            referenceCount; // how many references to this sample block
     void            *pSampleData;   // pointer to sample data. This may be an offset into the pMasterPtr
     void            *pMasterPtr;    // master pointer that contains the snd format information
+    XWORD           cacheSlot;      // index of this entry in the mixer's sampleCaches array
+    struct GM_SharedSample *pShared; // shared pool entry that owns pMasterPtr, or NULL if this entry owns it
+    uint64_t        tokenKey;       // XFileGetContentKey of bankToken's file when this was built
+    struct GM_SampleCacheEntry *pIdlePrev;  // while referenceCount is 0, neighbors in the mixer's idle list
+    struct GM_SampleCacheEntry *pIdleNext;
 };
 typedef struct GM_SampleCacheEntry GM_SampleCacheEntry;
 
+// Sample cache counters, see GMCache_GetSampleCacheStats
+struct GM_SampleCacheStats
+{
+    uint32_t        hits;           // requests served by an existing entry
+    uint32_t        misses;         // requests that built a new entry
+    uint32_t        evictions;      // idle entries dropped to stay within the budget
+    uint32_t        bytes;          // sample bytes held by cache entries, idle or not
+    uint32_t        idleBytes;      // the part of bytes no instrument references
+    uint32_t        budget;         // see GMCache_SetSampleCacheBudget
+};
+typedef struct GM_SampleCacheStats GM_SampleCacheStats;
+
+// size of the hash indexes kept alongside GM_Mixer::sampleCaches. Must be a power of two and
+// at least twice MAX_SAMPLES so probe chains stay short when the cache is full.
+#define MAX_SAMPLE_CACHE_HASH           (MAX_SAMPLES * 2)
+
 #define MAX_QUEUE_EVENTS                1024
 
 #define REVERB_BUFFER_SIZE_SMALL        4096        // * sizeof(int32_t)
@@ -664,6 +685,254 @@ struct Q_MIDIEvent
 };
 typedef struct Q_MIDIEvent Q_MIDIEvent;
 
+// Seek checkpoints. While a song is scanned with SCAN_DETERMINE_LENGTH (length calculation
+// and seeking) the sequencer state is captured every SEEK_CHECKPOINT_INTERVAL microseconds of
+// song time. GM_SetSongTickPosition & GM_SetSongMicrosecondPosition restore the closest
+// checkpoint and only replay the remaining slices, rather than starting from the top.
+#define SEEK_CHECKPOINT_INTERVAL        2000000     // in microseconds of song time
+#define SEEK_CHECKPOINT_GROW            32          // checkpoints added each time the index grows
+#define SEEK_TRACK_UNUSED               0xFFFFFFFFL // trackOffset value for a NULL track pointer
+
+struct GM_SeekCheckpoint
+{
+    // timing
+    UFLOAT          CurrentMidiClock;
+    UFLOAT          songMicroseconds;
+    UFLOAT          UnscaledMIDITempo;
+    UFLOAT          MIDITempo;
+    UFLOAT          MIDIDivision;
+    UFLOAT          UnscaledMIDIDivision;
+
+    // track positions. Pointers are stored as offsets from GM_Song->sequenceData
+    XDWORD          trackOffset[MAX_TRACKS];
+    IFLOAT          trackticks[MAX_TRACKS];
+    TrackStatus     trackon[MAX_TRACKS];
+    XBYTE           runningStatus[MAX_TRACKS];
+
+    // channel state
+    XBOOL           omniModeOn;
+    VelocityCurveType velocityCurveType;
+    XSWORD          firstNoteOnChannel;
+    XSBYTE          firstChannelBank[MAX_CHANNELS];
+    XSWORD          firstChannelProgram[MAX_CHANNELS];
+    XSBYTE          channelWhichParameter[MAX_CHANNELS];
+    XSBYTE          channelRegisteredParameterLSB[MAX_CHANNELS];
+    XSBYTE          channelRegisteredParameterMSB[MAX_CHANNELS];
+    XSBYTE          channelNonRegisteredParameterLSB[MAX_CHANNELS];
+    XSBYTE          channelNonRegisteredParameterMSB[MAX_CHANNELS];
+    XBYTE           channelBankMode[MAX_CHANNELS];
+    XBYTE           channelSustain[MAX_CHANNELS];
+    XBYTE           channelVolume[MAX_CHANNELS];
+    XBYTE           channelExpression[MAX_CHANNELS];
+    XBYTE           channelPitchBendRange[MAX_CHANNELS];
+#if DISABLE_NOKIA_PATCH != TRUE
+    XBOOL           isNokiaVibrationChannel[MAX_CHANNELS];
+#endif
+#if REVERB_USED != REVERB_DISABLED
+    XBYTE           channelReverb[MAX_CHANNELS];
+    XBYTE           channelChorus[MAX_CHANNELS];
+#endif
+    XBYTE           channelModWheel[MAX_CHANNELS];
+    XBYTE           channelLowPassAmount[MAX_CHANNELS];
+    XBYTE           channelResonanceFilterAmount[MAX_CHANNELS];
+    XBYTE           channelFrequencyFilterAmount[MAX_CHANNELS];
+    XBYTE           channelMonoMode[MAX_CHANNELS];
+    XSWORD          channelBend[MAX_CHANNELS];
+    XSWORD          channelProgram[MAX_CHANNELS];
+    XBYTE           channelRawBank[MAX_CHANNELS];
+    XSBYTE          channelLSB[MAX_CHANNELS];
+    XSBYTE          channelBank[MAX_CHANNELS];
+    XSWORD          channelStereoPosition[MAX_CHANNELS];
+#if USE_SF2_SUPPORT == TRUE
+    XBYTE           channelType[MAX_CHANNELS];
+    XBYTE           channelBankMSB[MAX_CHANNELS];
+    XBYTE           channelBankLSB[MAX_CHANNELS];
+#if DISABLE_BEATNIK_SF2_NRPN != TRUE
+    LastControlEntry lastThreeControl[MAX_CHANNELS][4];
+#endif
+#endif
+};
+typedef struct GM_SeekCheckpoint GM_SeekCheckpoint;
+
+// Checkpoints are only valid for the settings they were recorded with. If any of these
+// change, the index is emptied and rebuilt by the next scan.
+struct GM_SeekIndex
+{
+    void            *sequenceData;          // midi data the offsets refer to
+    XDWORD          sequenceDataSize;
+    XFIXED          MasterTempo;            // tempo scale used while recording
+    XDWORD          sliceTime;              // BAE_GetSliceTimeInMicroseconds while recording
+    XBOOL           allowProgramChanges;
+    XSWORD          defaultPercusionProgram;
+    XDWORD          trackMuted[(MAX_TRACKS / 32) + 1];
+    XDWORD          soloTrackMuted[(MAX_TRACKS / 32) + 1];
+    XWORD           channelMuted[(MAX_CHANNELS / 16) + 1];
+    XWORD           soloChannelMuted[(MAX_CHANNELS / 16) + 1];
+
+    int32_t         count;                  // number of valid checkpoints
+    int32_t         maxCount;               // number allocated in pCheckpoints
+    GM_SeekCheckpoint *pCheckpoints;        // sorted by time, ascending
+};
+typedef struct GM_SeekIndex GM_SeekIndex;
+
+// Compiled event stream. The first time a song is sequenced for playback each track is decoded
+// once into an array of events with absolute tick stamps and resolved running status. Tracks
+// are then scheduled from a heap ordered by their next due event, so a sequencer slice only
+// visits the tracks that have something to play instead of re-parsing every track.
+#define EVENT_STREAM_UNSYNCED           0           // rebuild cursors from the raw track positions
+#define EVENT_STREAM_SYNCED             1           // cursors are current, raw positions are stale
+#define EVENT_STREAM_RAW                2           // can't be represented, walk the raw tracks
+
+#define SEQ_EVENT_STATUS                0x01        // event had its own status byte
+#define SEQ_EVENT_END                   0x02        // track ran past its length, turn it off
+
+#if USE_FLOAT == FALSE
+    typedef int64_t     GM_SeqClock;                // 1/64 ticks, wide enough not to wrap
+#else
+    typedef double      GM_SeqClock;
+#endif
+
+struct GM_SeqEvent
+{
+    GM_SeqClock     tick;           // absolute track time in 1/64 ticks
+    XDWORD          offset;         // offset of the event from the start of its track
+    XBYTE           status;         // resolved status. 0xFF for meta events
+    XBYTE           data1;
+    XBYTE           data2;
+    XBYTE           flags;          // SEQ_EVENT_STATUS, SEQ_EVENT_END
+};
+typedef struct GM_SeqEvent GM_SeqEvent;
+
+struct GM_EventStream
+{
+    // compiled tracks, only valid for the track layout they were built from
+    XBYTE           *trackStart[MAX_TRACKS];
+    XDWORD          trackLength[MAX_TRACKS];
+    XDWORD          firstEvent[MAX_TRACKS];
+    XDWORD          endEvent[MAX_TRACKS];   // one past the last event of the track
+    XBOOL           usable;                 // FALSE if a track can't be compiled
+    GM_SeqEvent     *pEvents;
+
+    // playback state while GM_Song->eventStreamState is EVENT_STREAM_SYNCED. A track's next
+    // event is due when its tick + bias is below clock, which mirrors GM_Song->trackticks.
+    GM_SeqClock     clock;                  // sum of MIDIDivision
+    UFLOAT          division;               // MIDIDivision the waiting tracks' biases count down by this slice
+    GM_SeqClock     bias[MAX_TRACKS];
+    XDWORD          cursor[MAX_TRACKS];     // next event of each track
+    XBOOL           fresh[MAX_TRACKS];      // track was TRACK_FREE at the start of this slice
+    XBOOL           anyFresh;
+    XBYTE           heap[MAX_TRACKS];       // running tracks, earliest due first
+    XSWORD          heapCount;
+    XSWORD          aliveCount;
+    XSWORD          currentTrack;           // track being processed, or MAX_TRACKS
+    XDWORD          currentStart;           // its cursor when this slice started on it
+};
+typedef struct GM_EventStream GM_EventStream;
+
+#if defined(BAE_COMPLETE) && (REVERB_USED != REVERB_DISABLED)
+// Reverb and chorus run on a worker thread one slice behind the voices.
+// See GM_SetEffectsThreadEnabled
+struct GM_EffectsThread
+{
+    BAE_WorkerThread    thread;
+    BAE_Event           startEvent;                 // audio thread to worker, the sends are ready
+    BAE_Event           doneEvent;                  // worker to audio thread, wet is ready
+    XBOOL               quit;
+    XBOOL               pending;                    // sends held from the last slice, not yet run
+    XBOOL               running;                    // worker is running them this slice
+    XSDWORD             reverbSend[MAX_CHUNK_SIZE+64];
+    XSDWORD             chorusSend[MAX_CHUNK_SIZE+64];
+    XSDWORD             wet[(MAX_CHUNK_SIZE+64)*2]; // effects output, interleaved like songBufferDry
+};
+typedef struct GM_EffectsThread GM_EffectsThread;
+#endif
+
+// Instruments queued to load off the application thread. See GM_SetInstrumentLoaderEnabled
+#define MAX_INSTRUMENT_REQUESTS     64
+
+struct GM_InstrumentRequest
+{
+    GM_Song             *pSong;
+    XLongResourceID     instrument;
+    XBankToken          bankToken;
+    XSWORD              split;                      // -1 for the whole instrument, or a lazyDecode split of it
+};
+typedef struct GM_InstrumentRequest GM_InstrumentRequest;
+
+struct GM_InstrumentLoader
+{
+    BAE_WorkerThread        thread;
+    BAE_Event               wakeEvent;              // requests were queued, or quit was set
+    BAE_Mutex               queueLock;              // guards requests, head, count and GM_Song::pendingInstruments
+    XBOOL                   quit;
+    XSWORD                  head;                   // oldest request
+    XSWORD                  count;
+    GM_InstrumentRequest    requests[MAX_INSTRUMENT_REQUESTS];
+};
+typedef struct GM_InstrumentLoader GM_InstrumentLoader;
+
+// File streams decoded ahead of the mixer on a worker thread. See GM_SetStreamReadAhead
+typedef struct GM_StreamReadAhead GM_StreamReadAhead;
+
+struct GM_StreamDecoder
+{
+    BAE_WorkerThread        thread;
+    BAE_Event               wakeEvent;              // a ring was drained, added or reset, or quit was set
+    BAE_Mutex               listLock;               // guards pStreams
+    XBOOL                   quit;
+    GM_StreamReadAhead      *pStreams;              // rings the worker keeps filled
+};
+typedef struct GM_StreamDecoder GM_StreamDecoder;
+
+#if USE_NEO_EFFECTS == TRUE
+// Master bus EQ and limiter, applied while converting the dry mix to 16 bit output.
+// See GenMaster.c
+#define MAX_MASTER_EQ_BANDS             5
+#define MASTER_LIMITER_MAX_LOOKAHEAD    256     // frames, power of 2
+
+struct GM_MasterEqBand
+{
+    MasterEqType    type;
+    XDWORD          frequency;                  // in Hz
+    XSDWORD         gain;                       // in dB, 16.16 fixed
+    XFIXED          q;                          // 16.16 fixed
+    float           b0, b1, b2, a1, a2;         // normalized by a0
+    float           z1[2], z2[2];               // transposed direct form II state per channel
+};
+typedef struct GM_MasterEqBand GM_MasterEqBand;
+
+struct GM_MasterStage
+{
+    XBOOL           eqEnabled;
+    XBOOL           limiterEnabled;
+    XBOOL           eqChanged;                  // band settings changed since coefficients were built
+    XBOOL           eqReset;                    // clear filter state before the next slice
+    XBOOL           limiterReset;               // clear limiter state before the next slice
+    Rate            eqRate;                     // output rate the coefficients were built for
+    Rate            limiterRate;                // output rate the lookahead was built for
+    GM_MasterEqBand band[MAX_MASTER_EQ_BANDS];
+    XSWORD          activeBands[MAX_MASTER_EQ_BANDS];
+    XSWORD          activeBandCount;
+
+    // lookahead limiter
+    int             lookahead;                  // L, frames of lookahead
+    float           ceiling;                    // peak allowed in 16 bit units
+    float           releaseCoef;
+    float           envelope;                   // gain applied last frame
+    float           delay[MASTER_LIMITER_MAX_LOOKAHEAD * 2];   // signal delayed by L-1 frames, interleaved
+    int             delayPos;
+    float           minGain[MASTER_LIMITER_MAX_LOOKAHEAD];     // last L sliding minimums, for the box average
+    float           minGainSum;
+    int             minGainPos;
+    float           dequeGain[MASTER_LIMITER_MAX_LOOKAHEAD];   // ascending gains of the sliding minimum
+    XDWORD          dequeTime[MASTER_LIMITER_MAX_LOOKAHEAD];
+    int             dequeHead;
+    int             dequeCount;
+    XDWORD          time;                       // frame counter for the deque
+};
+typedef struct GM_MasterStage GM_MasterStage;
+#endif
+
 typedef void            (*InnerLoop)(GM_Voice *pVoice);
 typedef void            (*InnerLoop2)(GM_Voice *pVoice, XBOOL looping);
 
@@ -674,7 +943,7 @@ struct GM_Mixer
     Rate                outputRate;                 // output sample rate
 
     ReverbMode          reverbUnitType;                 // verb mode
-    ReverbMode          reverbTypeAllocated;            // verb mode allocated
+    ReverbMode          reverbTypeAllocated;            // verb mode the verb units are running
 
     XBYTE               sampleFrameSize;                // size in bytes of each sample frame
     XBYTE               sampleExpansion;                // output expansion factor 1, 2, or 4
@@ -707,6 +976,13 @@ struct GM_Mixer
     XBOOL       /*7*/   stereoFilter;                   // if TRUE, then filter stereo output
     XBYTE       /*0*/   processExternalMidiQueue;       // counter flag to lock processing of queue. 0 means process
     GM_SampleCacheEntry *sampleCaches[MAX_SAMPLES];     // cache of samples loaded
+    XWORD               sampleCacheIDHash[MAX_SAMPLE_CACHE_HASH];   // open addressing index of sampleCaches by ID and
+                                                                    // bank token. Holds slot + 1, 0 is empty
+    XWORD               sampleCachePtrHash[MAX_SAMPLE_CACHE_HASH];  // same, keyed on the sample data pointer
+    XWORD               sampleCacheFreeHint;            // lowest slot of sampleCaches that may be free
+    GM_SampleCacheEntry *sampleCacheIdleHead;          // unreferenced entries kept for reuse, least
+    GM_SampleCacheEntry *sampleCacheIdleTail;          // recently released first
+    GM_SampleCacheStats sampleCacheStats;
 
     // voice allocation, and dry and wet mix buffers
     GM_Voice            NoteEntry[MAX_VOICES];
@@ -715,14 +991,31 @@ struct GM_Mixer
 #if REVERB_USED != REVERB_DISABLED
     XSDWORD             songBufferReverb[MAX_CHUNK_SIZE+64];    // the +64 is for 48k output
     XSDWORD             songBufferChorus[MAX_CHUNK_SIZE+64];
+    XDWORD              reverbQuietSlices;              // slices with no reverb input and an inaudible tail
+    XDWORD              chorusQuietSlices;              // same for the chorus
+    XBOOL               reverbSendIsClear;              // TRUE if songBufferReverb was all zero after the last slice
+    XBOOL               chorusSendIsClear;              // TRUE if songBufferChorus was all zero after the last slice
+    GM_EffectsThread    *pEffectsThread;                // NULL unless effects run on their own thread
 #endif
+#endif
+    GM_InstrumentLoader *pInstrumentLoader;             // NULL unless instruments load on their own thread
+    XBOOL               lazySplitDecoding;              // key splits decode on their first note. See GM_SetLazySplitDecoding
+    GM_StreamDecoder    *pStreamDecoder;                // NULL unless file streams decode on their own thread
+    BAE_Mutex           streamDecoderLock;              // guards pStreamDecoder, and rings joining or leaving it
+    XDWORD              streamReadAhead;                // milliseconds decoded ahead by it. See GM_SetStreamReadAhead
+#if USE_NEO_EFFECTS == TRUE
+    GM_MasterStage      master;                         // master bus EQ and limiter
 #endif
 #if USE_SF2_SUPPORT == TRUE
     XBOOL               isSF2;
 #endif
 
 // MIDI Interpreter variables
-    GM_Song             *pSongsToPlay[MAX_SONGS];       // number of songs to play at once
+    GM_Song             **pSongsToPlay;                 // song slots, maxSongs long. Empty slots are NULL
+    XSWORD              *pFreeSongSlots;                // stack of empty slots below songSlotCount
+    XSWORD              freeSongSlotCount;              // entries in pFreeSongSlots
+    XSWORD              songSlotCount;                  // high water mark of used slots; loops stop here
+    XSWORD              maxSongs;                       // number of songs that can play at once
 
 // normal inner loop procs
     InnerLoop2          partialBufferProc;
@@ -746,10 +1039,10 @@ struct GM_Mixer
     Q_MIDIEvent         *pHead;                         // pointer to events to read from queue
     Q_MIDIEvent         *pTail;                         // pointer to events to write to queue
                                                         // always points to the next one to use
-    XDWORD              syncCount;                      // in microseconds. Current tick of audio output
+    uint64_t            syncCount;                      // in microseconds. Current tick of audio output
     XSDWORD             syncBufferCount;
 
-    XDWORD              samplesPlayed;                  // number of samples played by device
+    uint64_t            samplesPlayed;                  // number of samples played by device
     XDWORD              samplesWritten;                 // number of samples written to device
     XDWORD              lastSamplePosition;             // last time GM_UpdateSamplesPlayed was called
 
@@ -772,6 +1065,12 @@ struct GM_Mixer
     XSDWORD             reverbPtr;              // delay line index into verb buffer
     XSDWORD             LPfilterL, LPfilterR;   // used for fixed verb
     XSDWORD             LPfilterLz, LPfilterRz;
+
+    XPTR                reverbArena;            // one block holding the delay lines of every
+    XDWORD              reverbArenaSize;        // verb and the chorus, handed out by
+    XDWORD              reverbArenaUsed;        // GM_TakeReverbMemory
+    XSDWORD             *reverbFadeBuffer;      // wet signal of the old and new verb while
+                                                // crossfading between verb types
 #endif
 };
 typedef struct GM_Mixer GM_Mixer;
@@ -787,6 +1086,11 @@ typedef struct GM_Mixer GM_Mixer;
 
 extern GM_Mixer *MusicGlobals;
 
+#if REVERB_USED != REVERB_DISABLED
+// Take cleared memory for a verb or the chorus from the mixer's reverb arena, see GenReverb.c
+void * GM_TakeReverbMemory(int32_t size);
+#endif
+
 #if USE_NEW_EFFECTS
 /******************************* new reverb stuff *****************************/
 
@@ -862,6 +1166,7 @@ NewReverbParams*    GetNewReverbParams();
 XBOOL InitNewReverb();  // returns TRUE if success
 void ShutdownNewReverb();
 XBOOL CheckReverbType();
+void ResetNewReverb();
 void ScaleDelayTimes();
 void GenerateDelayTimes();
 void GenerateFeedbackValues();
@@ -878,6 +1183,7 @@ XDWORD Get44100_SRRatio();
 XBOOL       InitNeoReverb(void);
 void        ShutdownNeoReverb(void);
 XBOOL       CheckNeoReverbType(void);
+void        ResetNeoReverb(void);
 void        RunNeoReverb(INT32 *sourceP, INT32 *destP, int numFrames);
 void        SetNeoReverbMix(int wetLevel);
 void        SetNeoReverbTime(int reverbTime);
@@ -900,6 +1206,19 @@ void        GetNeoReverbPresetParams(int reverbType, int *combCount, int *delays
 #define NEO_CUSTOM_MAX_GAIN     255   // Max gain value for combs
 #define NEO_CUSTOM_MAX_LOWPASS  127   // values over 127 appear to have no effect
 #define NEO_CUSTOM_MAX_DELAY_MS 500
+
+// Buffer sizes for MT-32 style delays, in frames (must be power of 2)
+// Tap delay needs to hold up to ~400ms @ 44.1kHz: 17640 frames.
+#define NEO_TAP_BUFFER_SIZE     32768
+// Custom reverb needs to hold up to 500ms at common output rates, max frames is size-2.
+// At 48kHz, 500ms is 24000 frames.
+#define NEO_CUSTOM_BUFFER_SIZE  32768
+
+// Convolution reverb (REVERB_TYPE_19), see GenReverbConv.c
+XBOOL       InitConvReverb(void);
+void        ShutdownConvReverb(void);
+void        ResetConvReverb(void);
+void        RunConvReverb(INT32 *sourceP, INT32 *destP, int numFrames);
 #endif
 
 /******************************* new chorus stuff *****************************/
@@ -935,6 +1254,7 @@ void ShutdownChorus();
 XSDWORD GetChorusReadIncrement(XSDWORD readIndex, int32_t writeIndex, int32_t nSampleFrames, XSDWORD phase);
 void SetupChorusDelay();
 void RunChorus(XSDWORD *sourceP, XSDWORD *destP, int nSampleFrames);
+void SkipChorus(int nSampleFrames);
 
 
 #if 0   // only reverb and chorus are currently activated...
@@ -1076,6 +1396,10 @@ void PV_Generate8outputStereo(OUTSAMPLE8 * dest8);
 void PV_Generate8outputMono(OUTSAMPLE8 * dest8);
 void PV_Generate16outputStereo(OUTSAMPLE16 * dest16);
 void PV_Generate16outputMono(OUTSAMPLE16 * dest16);
+#if USE_NEO_EFFECTS == TRUE
+void PV_GenerateMaster16outputStereo(OUTSAMPLE16 * dest16);
+void PV_GenerateMaster16outputMono(OUTSAMPLE16 * dest16);
+#endif
 
 int32_t PV_DoubleBufferCallbackAndSwap(GM_DoubleBufferCallbackPtr doubleBufferCallback, 
                                         GM_Voice *this_voice);
@@ -1260,6 +1584,16 @@ GM_Instrument * PV_GetInstrument(GM_Mixer *pMixer, GM_Song *pSong,
 // unload an instrument and remove all of its memory and optionally the samples
 OPErr PV_UnloadInstrumentData(GM_Instrument *theI, GM_Mixer *pMixer, XBOOL freeSamples);
 
+// serializes instrument loads and unloads, and the sample cache changes they make,
+// against the instrument loader thread
+void PV_InitInstrumentLoadLock(void);
+void PV_AcquireInstrumentLoadLock(void);
+void PV_ReleaseInstrumentLoadLock(void);
+
+// key splits decoded on their first note. See GM_SetLazySplitDecoding
+OPErr PV_RequestLazySplit(GM_Song *pSong, XLongResourceID instrument, INT16 split);
+INT16 PV_GetNearestSplit(GM_Instrument *theI, INT16 thePitch, XBOOL loadedOnly);
+
 XDWORD PV_ScaleVolumeFromChannelAndSong(GM_Song *pSong, XSWORD channel, XDWORD volume);
 #if USE_CALLBACKS
 void PV_DoCallBack(GM_Voice *this_one);
@@ -1291,7 +1625,12 @@ void PV_WriteModOutput(Rate q, XBOOL stereo);
 // GenAudioStreams.c
 void PV_ServeStreamFades(void);
 
+// GenSong.c
+// capture a seek checkpoint if enough song time has passed since the last one
+void PV_RecordSeekCheckpoint(GM_Song *pSong);
+
 // GenSeq.c
+void PV_FreeEventStream(GM_Song *pSong);
 void PV_FreePatchInfo(GM_Song *pSong);
 void PV_InsertBankSelect(GM_Song *pSong, int16_t channel, int16_t currentTrack);
 // process end song callback
@@ -418,7 +418,7 @@ OPErr GM_LoadRMIFromMemory(const unsigned char *buf, uint32_t len,
     BAE_PRINTF("[RMI] Extracted MIDI data: %u bytes\n", midiLen);
     
     // Allocate a copy of the MIDI data for the caller
-    unsigned char *midiCopy = (unsigned char *)XNewPtr(midiLen);
+    unsigned char *midiCopy = (unsigned char *)XNewTaggedPtr(midiLen, X_MEMORY_SONGS);
     if (!midiCopy)
     {
         return MEMORY_ERR;
@@ -610,7 +610,7 @@ OPErr GM_LoadRMIFromFile(const char *path,
     }
 
     // Allocate buffer for file data
-    fileData = XNewPtr(fileSize);
+    fileData = XNewTaggedPtr(fileSize, X_MEMORY_SONGS);
     XFileRead(fileRef, fileData, fileSize);
     XFileClose(fileRef);    
 
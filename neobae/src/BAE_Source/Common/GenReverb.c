@@ -114,7 +114,7 @@
 #if REVERB_USED != REVERB_DISABLED
 
 #if USE_MONO_OUTPUT == TRUE
-static void PV_RunMonoFixedReverb(ReverbMode which)
+static void PV_RunMonoFixedReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
 {
     register INT32      b, c, bz, cz;
     register INT32      *sourceLR;
@@ -125,7 +125,7 @@ static void PV_RunMonoFixedReverb(ReverbMode which)
     reverbBuf = &MusicGlobals->reverbBuffer[0];
     if (reverbBuf)
     {
-        sourceLR = &MusicGlobals->songBufferDry[0];        
+        sourceLR = destP;
 
         b = MusicGlobals->LPfilterL;
         c = MusicGlobals->LPfilterR;
@@ -396,13 +396,13 @@ static void PV_RunMonoFixedReverb(ReverbMode which)
     }
 }
 #else
-static void PV_RunMonoFixedReverb(ReverbMode which)
+static void PV_RunMonoFixedReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
 {
     return;
 }
 #endif  // USE_MONO_OUTPUT
 
-static void PV_RunStereoFixedReverb(ReverbMode which)
+static void PV_RunStereoFixedReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
 {
     register INT32      b, c, bz, cz;
     register INT32      *sourceLR;
@@ -413,7 +413,7 @@ static void PV_RunStereoFixedReverb(ReverbMode which)
     reverbBuf = &MusicGlobals->reverbBuffer[0];
     if (reverbBuf)
     {
-        sourceLR = &MusicGlobals->songBufferDry[0];
+        sourceLR = destP;
         b = MusicGlobals->LPfilterL;
         c = MusicGlobals->LPfilterR;
         bz = MusicGlobals->LPfilterLz;
@@ -718,19 +718,24 @@ static void PV_RunStereoFixedReverb(ReverbMode which)
 
 
 #if USE_NEW_EFFECTS == TRUE
-static void PV_RunStereoNewReverb(ReverbMode which)
+static void PV_RunStereoNewReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
 {
     CheckReverbType();
-    RunNewReverb(MusicGlobals->songBufferReverb, MusicGlobals->songBufferDry, MusicGlobals->One_Loop);
+    RunNewReverb(sourceP, destP, MusicGlobals->One_Loop);
 }
 #endif
 
 
 #if USE_NEO_EFFECTS == TRUE
-static void PV_RunStereoNeoReverb(ReverbMode which)
+static void PV_RunStereoNeoReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
 {
     CheckNeoReverbType();
-    RunNeoReverb(MusicGlobals->songBufferReverb, MusicGlobals->songBufferDry, MusicGlobals->One_Loop);
+    RunNeoReverb(sourceP, destP, MusicGlobals->One_Loop);
+}
+
+static void PV_RunStereoConvReverb(ReverbMode which, INT32 *sourceP, INT32 *destP)
+{
+    RunConvReverb(sourceP, destP, MusicGlobals->One_Loop);
 }
 #endif
 
@@ -941,13 +946,72 @@ static GM_ReverbConfigure verbTypes[MAX_REVERB_TYPES] =
         0,                              // Uses own buffer allocation
         NULL,
         PV_RunStereoNeoReverb
-    }   
+    },
+    {   // Convolution with a loaded impulse response
+        REVERB_TYPE_19,
+        0,                              // No threshold - always enabled when selected
+        TRUE,                           // fixed (uses separate buffer system)
+        0,                              // Uses own buffer allocation
+        NULL,
+        PV_RunStereoConvReverb
+    }
 #endif
 };
 
 #define MAX_VERB_CONFIG_ENTRIES     (int32_t)(sizeof (verbTypes) / sizeof(GM_ReverbConfigure))
 
-// private function to allocate and setup the fixed verb types
+// The verbs and the chorus carve their delay lines from one block, allocated by
+// GM_SetupReverb and sized for all of them at once. Nothing is allocated or freed when
+// the verb type changes.
+#define PV_REVERB_FADE_SAMPLES      ((MAX_CHUNK_SIZE+64)*2)
+
+static int32_t PV_RoundReverbMemory(int32_t size)
+{
+    return (size + 15L) & ~15L;
+}
+
+// Bytes of arena needed when the fixed verb buffer is fixedSize bytes. The other verbs
+// and the chorus are only set up along with the full size fixed buffer.
+static int32_t PV_GetReverbArenaSize(int32_t fixedSize)
+{
+    int32_t     size;
+
+    size = PV_RoundReverbMemory(fixedSize);
+    size += PV_RoundReverbMemory(PV_REVERB_FADE_SAMPLES * 2L * (int32_t)sizeof(INT32));
+#if USE_NEW_EFFECTS == TRUE
+    if (fixedSize == REVERB_BUFFER_SIZE * 2L * (int32_t)sizeof(int32_t))
+    {
+        size += kNumberOfDiffusionStages * PV_RoundReverbMemory(kDiffusionBufferFrameSize * (int32_t)sizeof(INT32));
+        size += 2 * PV_RoundReverbMemory(kStereoizerBufferFrameSize * (int32_t)sizeof(INT32));
+        size += 2 * PV_RoundReverbMemory(2L * kChorusBufferFrameSize * (int32_t)sizeof(INT32));
+#if USE_NEO_EFFECTS == TRUE
+        size += PV_RoundReverbMemory(NEO_TAP_BUFFER_SIZE * (int32_t)sizeof(INT32));
+        size += NEO_CUSTOM_MAX_COMBS * PV_RoundReverbMemory(NEO_CUSTOM_BUFFER_SIZE * (int32_t)sizeof(INT32));
+#endif
+    }
+#endif
+    return size;
+}
+
+// Take size bytes from the reverb arena. The memory is cleared, as the arena is new when
+// the verbs are set up. Returns NULL if there's no room left.
+void * GM_TakeReverbMemory(int32_t size)
+{
+    GM_Mixer    *pMixer;
+    char        *pMemory;
+
+    pMixer = MusicGlobals;
+    size = PV_RoundReverbMemory(size);
+    if ((pMixer->reverbArena == NULL) || ((pMixer->reverbArenaUsed + size) > pMixer->reverbArenaSize))
+    {
+        return NULL;
+    }
+    pMemory = (char *)pMixer->reverbArena + pMixer->reverbArenaUsed;
+    pMixer->reverbArenaUsed += size;
+    return pMemory;
+}
+
+// private function to allocate the reverb arena and setup the fixed verb types
 static XBOOL PV_SetupFixedReverb(void)
 {
     GM_Mixer    *pMixer;
@@ -962,100 +1026,223 @@ static XBOOL PV_SetupFixedReverb(void)
     pMixer->LPfilterRz = 0;
 
     size = REVERB_BUFFER_SIZE * 2L * sizeof(int32_t);
-    pMixer->reverbBuffer = (INT32 *)XNewPtr(size);
-    if (pMixer->reverbBuffer == NULL)
+    pMixer->reverbArenaSize = PV_GetReverbArenaSize(size);
+    pMixer->reverbArena = XNewTaggedPtr(pMixer->reverbArenaSize, X_MEMORY_EFFECTS);
+    if (pMixer->reverbArena == NULL)
     {
         // if this failed, try to allocate the smaller verb entry
         size = REVERB_BUFFER_SIZE_SMALL * 2L * sizeof(int32_t);
-        pMixer->reverbBuffer = (INT32 *)XNewPtr(size);
-        if (pMixer->reverbBuffer == NULL)
+        pMixer->reverbArenaSize = PV_GetReverbArenaSize(size);
+        pMixer->reverbArena = XNewTaggedPtr(pMixer->reverbArenaSize, X_MEMORY_EFFECTS);
+        if (pMixer->reverbArena == NULL)
         {
+            pMixer->reverbArenaSize = 0;
             size = 0;   // no verb
         }
     }
+    pMixer->reverbArenaUsed = 0;
+    if (size)
+    {
+        pMixer->reverbBuffer = (INT32 *)GM_TakeReverbMemory(size);
+        pMixer->reverbFadeBuffer = (INT32 *)GM_TakeReverbMemory(PV_REVERB_FADE_SAMPLES * 2L * (int32_t)sizeof(INT32));
+    }
     pMixer->reverbBufferSize = size;
     return (size) ? TRUE : FALSE;
 }
 
-// private function to deallocate and cleanup the fixed verb types
+// private function to cleanup the fixed verb types. The arena is freed by GM_CleanupReverb
+// once every verb has let go of it.
 static void PV_CleanupFixedReverb(void)
 {
-    XPTR    verb1;
-
     if (MusicGlobals)
     {
-        // capture all pointers and set them to zero so that the interrupt services
-        // will stop then deallocate the memory
-        verb1 = MusicGlobals->reverbBuffer;
-        if (verb1)
+        // set the pointers to zero so that the interrupt services will stop
+        if (MusicGlobals->reverbBuffer)
         {
             MusicGlobals->reverbPtr = 0;
             GM_SetReverbType(REVERB_TYPE_1);        // no reverb
             MusicGlobals->reverbBuffer = NULL;
-            XDisposePtr(verb1);
+            MusicGlobals->reverbFadeBuffer = NULL;
         }
     }
 }
 
-void GM_ProcessReverb(void)
+// Clear the fixed verb delay line, which the variable verb shares, and its filters
+static void PV_ResetFixedReverb(void)
+{
+    GM_Mixer    *pMixer;
+    int32_t     size;
+
+    pMixer = MusicGlobals;
+    // InitNewReverb counts its own buffers into reverbBufferSize
+    size = REVERB_BUFFER_SIZE * 2L * sizeof(int32_t);
+    if (pMixer->reverbBufferSize < (XDWORD)size)
+    {
+        size = (int32_t)pMixer->reverbBufferSize;
+    }
+    XSetMemory(pMixer->reverbBuffer, size, 0);
+    pMixer->reverbPtr = 0;
+    pMixer->LPfilterL = 0;
+    pMixer->LPfilterR = 0;
+    pMixer->LPfilterLz = 0;
+    pMixer->LPfilterRz = 0;
+}
+
+// Map the requested verb type to one the runtime table knows
+static ReverbMode PV_GetRunnableReverbType(ReverbMode type)
+{
+    switch (type)
+    {
+        default:
+            if (type >= MAX_REVERB_TYPES)
+            {                    
+                type = REVERB_TYPE_18;  // out of range, map to neo reverb custom types
+            } else {
+                type = REVERB_TYPE_1;   // none;
+            }
+            break;
+        
+        // valid table entries
+        case REVERB_TYPE_2:         // Igor's Closet
+        case REVERB_TYPE_3:         // Igor's Garage
+        case REVERB_TYPE_4:         // Igor's Acoustic Lab
+        case REVERB_TYPE_5:         // Igor's Cavern
+        case REVERB_TYPE_6:         // Igor's Dungeon
+        case REVERB_TYPE_7:         // Small reflections Reverb used for WebTV
+        case REVERB_TYPE_8:         // Early reflections (variable verb)
+        case REVERB_TYPE_9:         // Basement (variable verb)
+        case REVERB_TYPE_10:        // Banquet hall (variable verb)
+        case REVERB_TYPE_11:        // Catacombs (variable verb)
+        case REVERB_TYPE_12:        // Neo Room (Neo reverb)
+        case REVERB_TYPE_13:        // Neo Hall (Neo reverb)                        
+        case REVERB_TYPE_14:        // Neo Cavern (Neo reverb)
+        case REVERB_TYPE_15:        // Neo Dungeon (Neo reverb)
+        case REVERB_TYPE_16:        // Neo Reserved (Neo reverb)
+        case REVERB_TYPE_17:        // Neo Tap Delay (Neo reverb)
+        case REVERB_TYPE_18:        // Custom (Neo reverb)
+        case REVERB_TYPE_19:        // Convolution
+            break;
+    }
+    return type;
+}
+
+// Run one slice of verb type from sourceP into destP
+static void PV_RunReverbType(ReverbMode type, XSDWORD *sourceP, XSDWORD *destP)
 {
     GM_ReverbProc   pVerbProc;
+
+    if ((type != REVERB_TYPE_1) && (type != REVERB_NO_CHANGE))
+    {
+        if (verbTypes[(unsigned char)type].globalReverbUsageSize <= MusicGlobals->reverbBufferSize)
+        {
+            if (MusicGlobals->generateStereoOutput)
+            {
+                pVerbProc = verbTypes[(unsigned char)type].pStereoRuntimeProc;
+            }
+            else
+            {
+                pVerbProc = verbTypes[(unsigned char)type].pMonoRuntimeProc;
+            }
+            if (pVerbProc)
+            {
+                (*pVerbProc)(verbTypes[(unsigned char)type].type, sourceP, destP);
+            }
+        }
+    }
+}
+
+// Run one slice of verb type and store the change it makes to destP in pWet. This works
+// the same for the fixed verbs, which process destP in place.
+static void PV_RunReverbTypeWet(ReverbMode type, XSDWORD *sourceP, XSDWORD *destP,
+                                XSDWORD *pWet, LOOPCOUNT samples)
+{
+    LOOPCOUNT   count;
+
+    XBlockMove(destP, pWet, samples * (int32_t)sizeof(INT32));
+    PV_RunReverbType(type, sourceP, pWet);
+    for (count = 0; count < samples; count++)
+    {
+        pWet[count] -= destP[count];
+    }
+}
+
+// Switch the running verb to newType over one slice. The old verb runs once more and
+// fades out while the new one, starting from clear delay lines, fades in. Called from
+// the mixer, so it never allocates.
+static void PV_SwitchReverbType(ReverbMode newType, XSDWORD *sourceP, XSDWORD *destP)
+{
+    GM_Mixer    *pMixer;
+    ReverbMode  oldType;
+    XSDWORD     *pOld, *pNew;
+    LOOPCOUNT   frame, channel, channels, frames, sample;
+    int64_t     fadeIn;
+
+    pMixer = MusicGlobals;
+    oldType = pMixer->reverbTypeAllocated;
+    channels = pMixer->generateStereoOutput ? 2 : 1;
+    frames = pMixer->One_Loop;
+    pOld = pMixer->reverbFadeBuffer;
+    pNew = pOld + PV_REVERB_FADE_SAMPLES;
+
+    if ((oldType != REVERB_TYPE_1) && (oldType != REVERB_NO_CHANGE))
+    {
+        PV_RunReverbTypeWet(oldType, sourceP, destP, pOld, frames * channels);
+    }
+
+    pMixer->reverbTypeAllocated = newType;
+    if (verbTypes[(unsigned char)newType].pStereoRuntimeProc == PV_RunStereoFixedReverb)
+    {
+        PV_ResetFixedReverb();
+    }
+#if USE_NEW_EFFECTS == TRUE
+    ResetNewReverb();
+#endif
+#if USE_NEO_EFFECTS == TRUE
+    ResetNeoReverb();
+    ResetConvReverb();
+#endif
+
+    if ((oldType == REVERB_TYPE_1) || (oldType == REVERB_NO_CHANGE))
+    {
+        PV_RunReverbType(newType, sourceP, destP);  // nothing to fade out
+        return;
+    }
+    PV_RunReverbTypeWet(newType, sourceP, destP, pNew, frames * channels);
+    for (frame = 0; frame < frames; frame++)
+    {
+        fadeIn = ((int64_t)(frame + 1) << 16) / frames;
+        for (channel = 0; channel < channels; channel++)
+        {
+            sample = frame * channels + channel;
+            destP[sample] += (XSDWORD)(((int64_t)pOld[sample] * (65536 - fadeIn) +
+                                        (int64_t)pNew[sample] * fadeIn) >> 16);
+        }
+    }
+}
+
+void GM_ProcessReverb(void)
+{
+    GM_ProcessReverbBuses(MusicGlobals->songBufferReverb, MusicGlobals->songBufferDry);
+}
+
+// Run the verb from the send bus sourceP into the dry bus destP. The fixed verbs
+// ignore sourceP and work on destP in place.
+void GM_ProcessReverbBuses(XSDWORD *sourceP, XSDWORD *destP)
+{
     ReverbMode      type;
 
     if (MusicGlobals->reverbBuffer)
     {
-        pVerbProc = NULL;
-        type = MusicGlobals->reverbUnitType;
-        
-        
-        switch (type)
+        // reverbUnitType may be changed at any time by GM_SetReverbType. Only the mixer
+        // moves reverbTypeAllocated, and the verbs configure themselves from it.
+        type = PV_GetRunnableReverbType(MusicGlobals->reverbUnitType);
+        if (type != MusicGlobals->reverbTypeAllocated)
         {
-            default:
-                if (type >= MAX_REVERB_TYPES)
-                {                    
-                    type = REVERB_TYPE_18;  // out of range, map to neo reverb custom types
-                } else {
-                    type = REVERB_TYPE_1;   // none;
-                }
-                break;
-            
-            // valid table entries
-            case REVERB_TYPE_2:         // Igor's Closet
-            case REVERB_TYPE_3:         // Igor's Garage
-            case REVERB_TYPE_4:         // Igor's Acoustic Lab
-            case REVERB_TYPE_5:         // Igor's Cavern
-            case REVERB_TYPE_6:         // Igor's Dungeon
-            case REVERB_TYPE_7:         // Small reflections Reverb used for WebTV
-            case REVERB_TYPE_8:         // Early reflections (variable verb)
-            case REVERB_TYPE_9:         // Basement (variable verb)
-            case REVERB_TYPE_10:        // Banquet hall (variable verb)
-            case REVERB_TYPE_11:        // Catacombs (variable verb)
-            case REVERB_TYPE_12:        // Neo Room (Neo reverb)
-            case REVERB_TYPE_13:        // Neo Hall (Neo reverb)                        
-            case REVERB_TYPE_14:        // Neo Cavern (Neo reverb)
-            case REVERB_TYPE_15:        // Neo Dungeon (Neo reverb)
-            case REVERB_TYPE_16:        // Neo Reserved (Neo reverb)
-            case REVERB_TYPE_17:        // Neo Tap Delay (Neo reverb)
-            case REVERB_TYPE_18:        // Custom (Neo reverb)
-                break;
+            PV_SwitchReverbType(type, sourceP, destP);
         }
-        if (type != REVERB_TYPE_1)
+        else
         {
-            if (verbTypes[(unsigned char)type].globalReverbUsageSize <= MusicGlobals->reverbBufferSize)
-            {
-                if (MusicGlobals->generateStereoOutput)
-                {
-                    pVerbProc = verbTypes[(unsigned char)type].pStereoRuntimeProc;
-                }
-                else
-                {
-                    pVerbProc = verbTypes[(unsigned char)type].pMonoRuntimeProc;
-                }
-                if (pVerbProc)
-                {
-                    (*pVerbProc)(verbTypes[(unsigned char)type].type);
-                }
-            }
+            PV_RunReverbType(type, sourceP, destP);
         }
     }
 }
@@ -1075,7 +1262,8 @@ void GM_SetupReverb(void)
         pMixer->reverbBufferSize = 0;
 
         // since we can only allocate memory in this function because its not being called during 
-        // an interrupt, we need to walk through all the verb types 
+        // an interrupt, we need to walk through all the verb types. They all take their memory
+        // from the one arena PV_SetupFixedReverb allocates.
 
         if (PV_SetupFixedReverb())  // try to allocate the fixed verb first)
         {
@@ -1085,6 +1273,7 @@ void GM_SetupReverb(void)
                 InitChorus();
 #if USE_NEO_EFFECTS == TRUE
                 InitNeoReverb();
+                InitConvReverb();
 #endif       
             }
 #endif
@@ -1094,6 +1283,8 @@ void GM_SetupReverb(void)
 
 void GM_CleanupReverb(void)
 {
+    XPTR    arena;
+
     if (MusicGlobals)
     {
         PV_CleanupFixedReverb();
@@ -1103,6 +1294,7 @@ void GM_CleanupReverb(void)
         ShutdownChorus();
 #if USE_NEO_EFFECTS == TRUE
         ShutdownNeoReverb();
+        ShutdownConvReverb();
 #endif
 
         // these effects will be fully integrated later...
@@ -1111,6 +1303,14 @@ void GM_CleanupReverb(void)
         //ShutdownParametricEq();
         //ShutdownResonantFilter();
 #endif
+        arena = MusicGlobals->reverbArena;
+        if (arena)
+        {
+            MusicGlobals->reverbArena = NULL;
+            MusicGlobals->reverbArenaSize = 0;
+            MusicGlobals->reverbArenaUsed = 0;
+            XDisposePtr(arena);
+        }
     }
 }
 
@@ -1146,7 +1346,8 @@ XBOOL GM_IsReverbFixed(void)
     return fixed;
 }
 
-// Set the global reverb type. This can happen at interrupt time, so don't allocate any memory
+// Set the global reverb type. This can happen at interrupt time, so don't allocate any memory.
+// The verbs themselves are switched over by the mixer, see PV_SwitchReverbType.
 void GM_SetReverbType(ReverbMode reverbMode)
 {
     XBOOL   changed;
@@ -1164,7 +1365,6 @@ void GM_SetReverbType(ReverbMode reverbMode)
                     if (reverbMode >= REVERB_TYPE_18) {
                         reverbMode = REVERB_TYPE_18;
                         MusicGlobals->reverbUnitType = reverbMode;
-                        CheckNeoReverbType();
                         changed = TRUE;
                     }
                     break;
@@ -1181,9 +1381,6 @@ void GM_SetReverbType(ReverbMode reverbMode)
                 case REVERB_TYPE_10:
                 case REVERB_TYPE_11:
                     MusicGlobals->reverbUnitType = reverbMode;
-#if USE_NEW_EFFECTS == TRUE
-                    CheckReverbType();
-#endif
                     changed = TRUE;
                     break;
 #if USE_NEO_EFFECTS == TRUE
@@ -1193,8 +1390,8 @@ void GM_SetReverbType(ReverbMode reverbMode)
                 case REVERB_TYPE_15:
                 case REVERB_TYPE_16:
                 case REVERB_TYPE_17:                
+                case REVERB_TYPE_19:
                     MusicGlobals->reverbUnitType = reverbMode;
-                    CheckNeoReverbType();
                     changed = TRUE;
                     break;
 #endif
@@ -0,0 +1,610 @@
+/*
+    Copyright (c) 2025 NeoBAE Contributors
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are
+    met:
+
+    Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+
+    Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+    Neither the name of NeoBAE nor the names of its contributors may be
+    used to endorse or promote products derived from this software without
+    specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+    TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+    PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+    HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+    SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+    TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+    PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*****************************************************************************/
+/*
+** "GenReverbConv.c"
+**
+**  Convolution reverb for miniBAE (REVERB_TYPE_19)
+**
+**  Written by: NeoBAE Contributors
+**  Created: 2026
+**
+**  Convolves the mono reverb send (songBufferReverb) with a user supplied
+**  impulse response, one or two channels, using uniformly partitioned
+**  overlap-save FFT convolution:
+**
+**  - The impulse is cut into partitions of P frames, P being the mixer slice
+**    length rounded up to a power of two. Each partition is zero padded to 2P
+**    and transformed once, when the impulse or the output rate changes.
+**  - Every P input frames, the last 2P input frames are transformed and pushed
+**    into a ring of past input spectra. Multiplying that ring against the
+**    partition spectra and transforming back gives the next P output frames.
+**
+**  Per sample the cost grows with the number of partitions instead of the
+**  impulse length, so impulses of several seconds run in a steady per-slice
+**  time. Output lags the send by P frames.
+**
+**  The FFT is a self contained radix-2 complex transform, used through the
+**  usual half length packing trick for real signals.
+**
+** Modification History:
+**  10/18/26    Created
+*/
+/*****************************************************************************/
+
+#include "GenSnd.h"
+#include "GenPriv.h"
+#include "BAE_API.h"
+#include "X_API.h"
+#include <stdint.h>
+#include <math.h>
+
+#if USE_NEO_EFFECTS == TRUE     // Conditionally compile this file
+
+// longest impulse kept, in seconds at the impulse's own rate
+#define CONV_MAX_IMPULSE_SECONDS    10
+// smallest partition, in frames
+#define CONV_MIN_BLOCK_FRAMES       64
+
+#define CONV_PI                     3.14159265358979323846
+
+// One prepared impulse at a particular output rate. Allocated as a single block.
+typedef struct ConvReverbKernel
+{
+    Rate        outputRate;             // mixer rate the partitions were built for
+    int         blockFrames;            // P, partition and hop size. The FFT is 2P real points
+    int         bins;                   // P+1 complex bins per spectrum
+    int         partitions;
+    int         channels;               // 1 or 2, from the impulse
+    float       *pTwiddle;              // P complex, exp(-i*PI*k/P)
+    int         *pBitReverse;           // P entries
+    float       *pFilter;               // channels * partitions spectra of the impulse
+    float       *pHistory;              // partitions spectra of past input blocks
+    int         historyHead;            // slot holding the newest input spectrum
+    float       *pInput;                // last 2P input frames
+    float       *pWork;                 // 2P scratch
+    float       *pAccum;                // P+1 bins, sum of products for one channel
+    float       *pOutput;               // channels * P frames of wet output
+    int         fill;                   // input frames collected towards the next block
+} ConvReverbKernel;
+
+typedef struct ConvReverbParams
+{
+    float               *pImpulse;      // normalized impulse, channels interleaved
+    int                 impulseChannels;
+    XDWORD              impulseFrames;
+    uint32_t            impulseRate;    // Hz
+    ConvReverbKernel    *pKernel;       // used by the audio thread
+    XBOOL               resetPending;   // clear history before the next block
+} ConvReverbParams;
+
+static ConvReverbParams gConvReverbParams;
+
+// wait until the audio thread is out of the mixer, so a kernel it may be
+// using can be released
+static void PV_WaitForAudioThread(void)
+{
+    if (MusicGlobals)
+    {
+        while (MusicGlobals->insideAudioInterrupt)
+        {
+            XWaitMicroseconds(BAE_GetSliceTimeInMicroseconds());
+        }
+    }
+}
+
+// In place radix-2 complex FFT of n points, data interleaved re,im.
+// twiddle holds exp(-i*PI*k/n) for k < n, so the n point twiddles are every
+// other entry. inverse conjugates them; no scaling is applied.
+static void PV_ComplexFFT(float *data, int n, float const *twiddle, int const *bitReverse, XBOOL inverse)
+{
+    int     i, j, span, step, k;
+    float   wr, wi, tr, ti;
+    float   *a, *b;
+
+    for (i = 0; i < n; i++)
+    {
+        j = bitReverse[i];
+        if (j > i)
+        {
+            tr = data[i * 2];
+            ti = data[i * 2 + 1];
+            data[i * 2] = data[j * 2];
+            data[i * 2 + 1] = data[j * 2 + 1];
+            data[j * 2] = tr;
+            data[j * 2 + 1] = ti;
+        }
+    }
+    for (span = 1, step = n; span < n; span <<= 1)
+    {
+        step >>= 1;
+        for (k = 0; k < span; k++)
+        {
+            wr = twiddle[k * step * 4];
+            wi = twiddle[k * step * 4 + 1];
+            if (inverse)
+            {
+                wi = -wi;
+            }
+            for (i = k; i < n; i += span * 2)
+            {
+                a = &data[i * 2];
+                b = &data[(i + span) * 2];
+                tr = b[0] * wr - b[1] * wi;
+                ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+// Forward transform of 2P real points in work into P+1 bins at spectrum.
+// work is destroyed.
+static void PV_RealFFT(ConvReverbKernel *pKernel, float *work, float *spectrum)
+{
+    int         k, m;
+    float       zr, zi, cr, ci, er, ei, odr, odi, wr, wi;
+
+    m = pKernel->blockFrames;
+    PV_ComplexFFT(work, m, pKernel->pTwiddle, pKernel->pBitReverse, FALSE);
+    spectrum[0] = work[0] + work[1];
+    spectrum[1] = 0.0f;
+    spectrum[m * 2] = work[0] - work[1];
+    spectrum[m * 2 + 1] = 0.0f;
+    for (k = 1; k < m; k++)
+    {
+        zr = work[k * 2];
+        zi = work[k * 2 + 1];
+        cr = work[(m - k) * 2];         // conj(Z[m-k])
+        ci = -work[(m - k) * 2 + 1];
+        er = 0.5f * (zr + cr);
+        ei = 0.5f * (zi + ci);
+        odr = 0.5f * (zi - ci);         // (Z - conj)/2i
+        odi = -0.5f * (zr - cr);
+        wr = pKernel->pTwiddle[k * 2];
+        wi = pKernel->pTwiddle[k * 2 + 1];
+        spectrum[k * 2] = er + (odr * wr - odi * wi);
+        spectrum[k * 2 + 1] = ei + (odr * wi + odi * wr);
+    }
+}
+
+// Inverse of PV_RealFFT, P+1 bins at spectrum into 2P real points at work,
+// scaled up by P.
+static void PV_InverseRealFFT(ConvReverbKernel *pKernel, float const *spectrum, float *work)
+{
+    int         k, m;
+    float       xr, xi, cr, ci, er, ei, dr, di, odr, odi, wr, wi;
+
+    m = pKernel->blockFrames;
+    for (k = 0; k < m; k++)
+    {
+        xr = spectrum[k * 2];
+        xi = spectrum[k * 2 + 1];
+        cr = spectrum[(m - k) * 2];     // conj(X[m-k])
+        ci = -spectrum[(m - k) * 2 + 1];
+        er = 0.5f * (xr + cr);
+        ei = 0.5f * (xi + ci);
+        dr = 0.5f * (xr - cr);
+        di = 0.5f * (xi - ci);
+        wr = pKernel->pTwiddle[k * 2];  // times conj(w)
+        wi = -pKernel->pTwiddle[k * 2 + 1];
+        odr = dr * wr - di * wi;
+        odi = dr * wi + di * wr;
+        work[k * 2] = er - odi;          // E + iO
+        work[k * 2 + 1] = ei + odr;
+    }
+    PV_ComplexFFT(work, m, pKernel->pTwiddle, pKernel->pBitReverse, TRUE);
+}
+
+// Transform the input window, multiply it and the older input spectra against
+// the impulse partitions, and leave the next P wet frames in pOutput.
+static void PV_ProcessConvBlock(ConvReverbKernel *pKernel)
+{
+    int         p, c, k, slot, bins, blockFrames;
+    float       *x, *h, *y;
+    float       xr, xi, hr, hi;
+
+    blockFrames = pKernel->blockFrames;
+    bins = pKernel->bins;
+
+    pKernel->historyHead++;
+    if (pKernel->historyHead >= pKernel->partitions)
+    {
+        pKernel->historyHead = 0;
+    }
+    XBlockMove(pKernel->pInput, pKernel->pWork, blockFrames * 2 * (int32_t)sizeof(float));
+    PV_RealFFT(pKernel, pKernel->pWork, &pKernel->pHistory[pKernel->historyHead * bins * 2]);
+    // slide the window: this block becomes the first half of the next one
+    XBlockMove(&pKernel->pInput[blockFrames], pKernel->pInput, blockFrames * (int32_t)sizeof(float));
+
+    for (c = 0; c < pKernel->channels; c++)
+    {
+        y = pKernel->pAccum;
+        XSetMemory(y, bins * 2 * (int32_t)sizeof(float), 0);
+        slot = pKernel->historyHead;
+        for (p = 0; p < pKernel->partitions; p++)
+        {
+            x = &pKernel->pHistory[slot * bins * 2];
+            h = &pKernel->pFilter[(c * pKernel->partitions + p) * bins * 2];
+            for (k = 0; k < bins; k++)
+            {
+                xr = x[k * 2];
+                xi = x[k * 2 + 1];
+                hr = h[k * 2];
+                hi = h[k * 2 + 1];
+                y[k * 2] += xr * hr - xi * hi;
+                y[k * 2 + 1] += xr * hi + xi * hr;
+            }
+            slot = (slot == 0) ? pKernel->partitions - 1 : slot - 1;
+        }
+        PV_InverseRealFFT(pKernel, y, pKernel->pWork);
+        // overlap-save: only the second half is free of wrap-around
+        XBlockMove(&pKernel->pWork[blockFrames], &pKernel->pOutput[c * blockFrames],
+                   blockFrames * (int32_t)sizeof(float));
+    }
+}
+
+static void PV_ClearConvKernel(ConvReverbKernel *pKernel)
+{
+    XSetMemory(pKernel->pHistory, pKernel->partitions * pKernel->bins * 2 * (int32_t)sizeof(float), 0);
+    XSetMemory(pKernel->pInput, pKernel->blockFrames * 2 * (int32_t)sizeof(float), 0);
+    XSetMemory(pKernel->pOutput, pKernel->channels * pKernel->blockFrames * (int32_t)sizeof(float), 0);
+    pKernel->historyHead = 0;
+    pKernel->fill = 0;
+}
+
+// Build a kernel for the loaded impulse at the mixer's current rate and slice
+// size. Returns NULL if there is no impulse or no memory.
+static ConvReverbKernel * PV_NewConvKernel(void)
+{
+    ConvReverbParams    *params = &gConvReverbParams;
+    ConvReverbKernel    *pKernel;
+    uint32_t            rate;
+    XDWORD              frames, frame, source;
+    int                 blockFrames, bins, partitions, channels, bits, i, c, p, k;
+    int32_t             size;
+    float               *pFloat;
+    double              step, pos, frac;
+    float               scale, s0, s1;
+
+    if ((params->pImpulse == NULL) || (MusicGlobals == NULL))
+    {
+        return NULL;
+    }
+    rate = GM_ConvertFromOutputRateToRate(MusicGlobals->outputRate);
+    if (rate == 0)
+    {
+        return NULL;
+    }
+
+    blockFrames = CONV_MIN_BLOCK_FRAMES;
+    while (blockFrames < MusicGlobals->One_Loop)
+    {
+        blockFrames <<= 1;
+    }
+    bits = 0;
+    while ((1 << bits) < blockFrames)
+    {
+        bits++;
+    }
+    bins = blockFrames + 1;
+    channels = params->impulseChannels;
+    frames = (XDWORD)(((double)params->impulseFrames * rate) / params->impulseRate);
+    if (frames == 0)
+    {
+        frames = 1;
+    }
+    partitions = (int)((frames + blockFrames - 1) / blockFrames);
+
+    size = (int32_t)sizeof(ConvReverbKernel) +
+            (int32_t)sizeof(float) * (blockFrames * 2 +                        // twiddle
+                                      channels * partitions * bins * 2 +       // filter
+                                      partitions * bins * 2 +                  // history
+                                      blockFrames * 2 +                        // input
+                                      blockFrames * 2 +                        // work
+                                      bins * 2 +                               // accumulator
+                                      channels * blockFrames) +                // output
+            (int32_t)sizeof(int) * blockFrames;
+    pKernel = (ConvReverbKernel *)XNewTaggedPtr(size, X_MEMORY_EFFECTS);
+    if (pKernel == NULL)
+    {
+        return NULL;
+    }
+    pFloat = (float *)(pKernel + 1);
+    pKernel->outputRate = MusicGlobals->outputRate;
+    pKernel->blockFrames = blockFrames;
+    pKernel->bins = bins;
+    pKernel->partitions = partitions;
+    pKernel->channels = channels;
+    pKernel->pTwiddle = pFloat;         pFloat += blockFrames * 2;
+    pKernel->pFilter = pFloat;          pFloat += channels * partitions * bins * 2;
+    pKernel->pHistory = pFloat;         pFloat += partitions * bins * 2;
+    pKernel->pInput = pFloat;           pFloat += blockFrames * 2;
+    pKernel->pWork = pFloat;            pFloat += blockFrames * 2;
+    pKernel->pAccum = pFloat;           pFloat += bins * 2;
+    pKernel->pOutput = pFloat;          pFloat += channels * blockFrames;
+    pKernel->pBitReverse = (int *)pFloat;
+
+    for (k = 0; k < blockFrames; k++)
+    {
+        pKernel->pTwiddle[k * 2] = (float)cos(CONV_PI * k / blockFrames);
+        pKernel->pTwiddle[k * 2 + 1] = (float)-sin(CONV_PI * k / blockFrames);
+        p = 0;
+        for (i = 0; i < bits; i++)
+        {
+            p |= ((k >> i) & 1) << (bits - 1 - i);
+        }
+        pKernel->pBitReverse[k] = p;
+    }
+
+    // Resample each partition of the impulse to the output rate, zero pad it to
+    // 2P and transform it. The 1/P inverse scale is folded in here.
+    step = (double)params->impulseRate / rate;
+    scale = 1.0f / blockFrames;
+    for (c = 0; c < channels; c++)
+    {
+        for (p = 0; p < partitions; p++)
+        {
+            XSetMemory(pKernel->pWork, blockFrames * 2 * (int32_t)sizeof(float), 0);
+            for (i = 0; i < blockFrames; i++)
+            {
+                frame = (XDWORD)p * blockFrames + i;
+                if (frame >= frames)
+                {
+                    break;
+                }
+                pos = frame * step;
+                source = (XDWORD)pos;
+                frac = pos - source;
+                if (source >= params->impulseFrames)
+                {
+                    break;
+                }
+                s0 = params->pImpulse[source * channels + c];
+                s1 = (source + 1 < params->impulseFrames) ? params->pImpulse[(source + 1) * channels + c] : 0.0f;
+                pKernel->pWork[i] = (float)((s0 + (s1 - s0) * frac) * scale);
+            }
+            PV_RealFFT(pKernel, pKernel->pWork, &pKernel->pFilter[(c * partitions + p) * bins * 2]);
+        }
+    }
+    PV_ClearConvKernel(pKernel);
+    return pKernel;
+}
+
+// Replace the kernel the audio thread uses, and release the old one
+static void PV_InstallConvKernel(ConvReverbKernel *pKernel)
+{
+    ConvReverbKernel    *pOld;
+
+    pOld = gConvReverbParams.pKernel;
+    gConvReverbParams.pKernel = pKernel;
+    if (pOld)
+    {
+        PV_WaitForAudioThread();
+        XDisposePtr((XPTR)pOld);
+    }
+}
+
+//++------------------------------------------------------------------------------
+//  InitConvReverb()
+//
+//  Prepare the loaded impulse, if any, for the mixer's current rate
+//++------------------------------------------------------------------------------
+XBOOL InitConvReverb(void)
+{
+    ConvReverbKernel    *pKernel;
+
+    if (gConvReverbParams.pImpulse == NULL)
+    {
+        return TRUE;
+    }
+    pKernel = PV_NewConvKernel();
+    PV_InstallConvKernel(pKernel);
+    return (pKernel) ? TRUE : FALSE;
+}
+
+//++------------------------------------------------------------------------------
+//  ShutdownConvReverb()
+//
+//  Release the prepared kernel. The impulse itself is kept, so the reverb comes
+//  back when the mixer is reconfigured.
+//++------------------------------------------------------------------------------
+void ShutdownConvReverb(void)
+{
+    PV_InstallConvKernel(NULL);
+}
+
+//++------------------------------------------------------------------------------
+//  ResetConvReverb()
+//
+//  Drop the current tail. Safe to call at interrupt time.
+//++------------------------------------------------------------------------------
+void ResetConvReverb(void)
+{
+    gConvReverbParams.resetPending = TRUE;
+}
+
+//++------------------------------------------------------------------------------
+//  RunConvReverb()
+//
+//  Convolve numFrames of the mono send at sourceP and add the result to the
+//  interleaved stereo destP
+//++------------------------------------------------------------------------------
+void RunConvReverb(INT32 *sourceP, INT32 *destP, int numFrames)
+{
+    ConvReverbKernel    *pKernel;
+    float               *pLeft, *pRight, *pInput;
+    int                 count, i;
+
+    pKernel = gConvReverbParams.pKernel;
+    if ((pKernel == NULL) || (pKernel->outputRate != MusicGlobals->outputRate))
+    {
+        return;
+    }
+    if (gConvReverbParams.resetPending)
+    {
+        gConvReverbParams.resetPending = FALSE;
+        PV_ClearConvKernel(pKernel);
+    }
+
+    while (numFrames > 0)
+    {
+        count = pKernel->blockFrames - pKernel->fill;
+        if (count > numFrames)
+        {
+            count = numFrames;
+        }
+        pInput = &pKernel->pInput[pKernel->blockFrames + pKernel->fill];
+        pLeft = &pKernel->pOutput[pKernel->fill];
+        pRight = (pKernel->channels > 1) ? pLeft + pKernel->blockFrames : pLeft;
+        for (i = 0; i < count; i++)
+        {
+            pInput[i] = (float)sourceP[i];
+            destP[i * 2] += (INT32)pLeft[i];
+            destP[i * 2 + 1] += (INT32)pRight[i];
+        }
+        sourceP += count;
+        destP += count * 2;
+        numFrames -= count;
+        pKernel->fill += count;
+        if (pKernel->fill == pKernel->blockFrames)
+        {
+            PV_ProcessConvBlock(pKernel);
+            pKernel->fill = 0;
+        }
+    }
+}
+
+//++------------------------------------------------------------------------------
+//  GM_SetReverbImpulse()
+//
+//  Load the impulse response used by REVERB_TYPE_19 from a decoded waveform, or
+//  release it if pWave is NULL. The waveform may be 8 or 16 bit, mono or
+//  stereo, at any rate; it is copied, so the caller keeps ownership. The
+//  impulse is normalized to unit energy on its louder channel.
+//  Do not call at interrupt time.
+//++------------------------------------------------------------------------------
+OPErr GM_SetReverbImpulse(GM_Waveform const *pWave)
+{
+    ConvReverbParams    *params = &gConvReverbParams;
+    float               *pImpulse;
+    XDWORD              frames, count, maxFrames;
+    uint32_t            rate;
+    int                 channels, c;
+    double              energy[2], peak;
+    float               scale;
+
+    pImpulse = NULL;
+    frames = 0;
+    rate = 0;
+    channels = 0;
+    if (pWave)
+    {
+        if ((pWave->theWaveform == NULL) || (pWave->waveFrames == 0) ||
+            (pWave->channels < 1) || (pWave->channels > 2) ||
+            ((pWave->bitSize != 8) && (pWave->bitSize != 16)))
+        {
+            return PARAM_ERR;
+        }
+        rate = XFIXED_TO_UNSIGNED_LONG(pWave->sampledRate + XFIXED_1 / 2);
+        if (rate == 0)
+        {
+            return PARAM_ERR;
+        }
+        channels = pWave->channels;
+        frames = pWave->waveFrames;
+        maxFrames = (XDWORD)rate * CONV_MAX_IMPULSE_SECONDS;
+        if (frames > maxFrames)
+        {
+            frames = maxFrames;
+        }
+        pImpulse = (float *)XNewTaggedPtr((int32_t)(frames * channels * sizeof(float)), X_MEMORY_EFFECTS);
+        if (pImpulse == NULL)
+        {
+            return MEMORY_ERR;
+        }
+        energy[0] = energy[1] = 0.0;
+        for (count = 0; count < frames * channels; count++)
+        {
+            if (pWave->bitSize == 16)
+            {
+                pImpulse[count] = ((short *)pWave->theWaveform)[count] * (1.0f / 32768.0f);
+            }
+            else
+            {
+                pImpulse[count] = (((unsigned char *)pWave->theWaveform)[count] - 128) * (1.0f / 128.0f);
+            }
+            energy[count % channels] += (double)pImpulse[count] * pImpulse[count];
+        }
+        peak = energy[0];
+        for (c = 1; c < channels; c++)
+        {
+            if (energy[c] > peak)
+            {
+                peak = energy[c];
+            }
+        }
+        if (peak <= 0.0)
+        {
+            XDisposePtr((XPTR)pImpulse);
+            return PARAM_ERR;   // silent impulse
+        }
+        scale = (float)(1.0 / sqrt(peak));
+        for (count = 0; count < frames * channels; count++)
+        {
+            pImpulse[count] *= scale;
+        }
+    }
+
+    // the kernel references nothing in the impulse, so it can go first
+    PV_InstallConvKernel(NULL);
+    if (params->pImpulse)
+    {
+        XDisposePtr((XPTR)params->pImpulse);
+    }
+    params->pImpulse = pImpulse;
+    params->impulseChannels = channels;
+    params->impulseFrames = frames;
+    params->impulseRate = rate;
+    if (pImpulse && MusicGlobals)
+    {
+        if (InitConvReverb() == FALSE)
+        {
+            return MEMORY_ERR;
+        }
+    }
+    return NO_ERR;
+}
+
+#endif  // USE_NEO_EFFECTS
@@ -48,6 +48,10 @@
 **
 ** Modification History:
 **  12/24/25    Initial implementation of MT-32 style reverb
+**  10/18/26    Delay lines are now mono, since the send and every tap/comb are
+**              identical on both sides. Custom combs run a span of frames per comb
+**              instead of every comb per frame, so the inner loops carry no
+**              per-sample dependency and the compiler can vectorize them.
 */
 /*****************************************************************************/
 
@@ -105,18 +109,10 @@
 // In miniBAE, MusicGlobals->songBufferReverb is a MONO send buffer with
 // length == One_Loop (frames). The destination dry buffer is interleaved
 // stereo (L,R,L,R...).
-// This implementation keeps internal delay lines interleaved stereo for
-// a wider image, but consumes mono input.
-
-// Buffer sizes for MT-32 style delays (must be power of 2)
-// Tap delay needs to hold up to ~400ms @ 44.1kHz in *stereo-interleaved* samples:
-// 400ms is 17640 frames => 35280 interleaved samples, so 32768 would wrap.
-#define NEO_TAP_BUFFER_SIZE     65536
-// Custom reverb needs to hold up to 500ms at common output rates.
-// Buffer size is in *stereo-interleaved* samples, so max frames is (size/2)-2.
-// At 48kHz, 500ms is 24000 frames -> 48000 interleaved samples, so use 65536.
-#define NEO_CUSTOM_BUFFER_SIZE  65536
+// Every tap and comb treats both sides the same, so the delay lines are
+// kept mono and the wet result is written to both output channels.
 
+// NEO_TAP_BUFFER_SIZE and NEO_CUSTOM_BUFFER_SIZE are in GenPriv.h, which sizes the reverb arena
 #define NEO_TAP_BUFFER_MASK     (NEO_TAP_BUFFER_SIZE - 1)
 #define NEO_CUSTOM_BUFFER_MASK  (NEO_CUSTOM_BUFFER_SIZE - 1)
 
@@ -141,8 +137,7 @@ typedef struct NeoReverbParams
     int         mTapDelayFrames[NEO_TAP_COUNT];
     
     // Low-pass filter for smoothing
-    INT32       mFilterMemoryL;
-    INT32       mFilterMemoryR;
+    INT32       mFilterMemory;
     INT32       mLopassK;
     
     // Wet/dry mix
@@ -221,10 +216,9 @@ static INLINE INT32 PV_ZapSmall(INT32 v)
     return v;
 }
 
-static INLINE int PV_ClampDelayFramesForBuffer(int frames, int interleavedBufferSize)
+static INLINE int PV_ClampDelayFramesForBuffer(int frames, int bufferFrames)
 {
-    // Interleaved stereo buffer holds (size/2) frames.
-    const int maxFrames = (interleavedBufferSize / 2) - 2;
+    const int maxFrames = bufferFrames - 2;
     if (frames < 1) return 1;
     if (frames > maxFrames) return maxFrames;
     return frames;
@@ -380,8 +374,8 @@ XBOOL InitNeoReverb(void)
     
     params->mIsInitialized = FALSE;
     
-    // Allocate tap delay buffer
-    params->mTapBuffer = (INT32*)XNewPtr(sizeof(INT32) * NEO_TAP_BUFFER_SIZE);
+    // Take the tap delay buffer from the reverb arena
+    params->mTapBuffer = (INT32*)GM_TakeReverbMemory(sizeof(INT32) * NEO_TAP_BUFFER_SIZE);
     if (params->mTapBuffer == NULL)
     {
         ShutdownNeoReverb();
@@ -390,10 +384,10 @@ XBOOL InitNeoReverb(void)
     XSetMemory(params->mTapBuffer, sizeof(INT32) * NEO_TAP_BUFFER_SIZE, 0);
     params->mTapWriteIdx = 0;
     
-    // Allocate custom mode buffers
+    // Take the custom mode buffers from the reverb arena
     for (i = 0; i < NEO_CUSTOM_MAX_COMBS; i++)
     {
-        params->mCustomBuffer[i] = (INT32*)XNewPtr(sizeof(INT32) * NEO_CUSTOM_BUFFER_SIZE);
+        params->mCustomBuffer[i] = (INT32*)GM_TakeReverbMemory(sizeof(INT32) * NEO_CUSTOM_BUFFER_SIZE);
         if (params->mCustomBuffer[i] == NULL)
         {
             ShutdownNeoReverb();
@@ -410,22 +404,20 @@ XBOOL InitNeoReverb(void)
     params->mCustomParamsDirty = FALSE;
     
     // Setup delay tables and read indices based on delay times
-    // Multiply delays by 2 for stereo interleaving (L,R,L,R...)
     params->mSampleRate = MusicGlobals->outputRate;
     PV_UpdateNeoDelayTables(params);
     for (i = 0; i < NEO_TAP_COUNT; i++)
     {
-        params->mTapReadIdx[i] = (NEO_TAP_BUFFER_SIZE - (params->mTapDelayFrames[i] * 2)) & NEO_TAP_BUFFER_MASK;
+        params->mTapReadIdx[i] = (NEO_TAP_BUFFER_SIZE - params->mTapDelayFrames[i]) & NEO_TAP_BUFFER_MASK;
     }
     
     for (i = 0; i < NEO_CUSTOM_MAX_COMBS; i++)
     {
-        params->mCustomReadIdx[i] = (NEO_CUSTOM_BUFFER_SIZE - (params->mCustomDelayFrames[i] * 2)) & NEO_CUSTOM_BUFFER_MASK;
+        params->mCustomReadIdx[i] = (NEO_CUSTOM_BUFFER_SIZE - params->mCustomDelayFrames[i]) & NEO_CUSTOM_BUFFER_MASK;
     }
     
     // Initialize filter state
-    params->mFilterMemoryL = 0;
-    params->mFilterMemoryR = 0;
+    params->mFilterMemory = 0;
     params->mLopassK = 13107;  // ~0.2 filter coefficient (gentle smoothing)
     
     // Default wet/dry mix (MT-32 style: strong wet signal for obvious effect)
@@ -443,7 +435,8 @@ XBOOL InitNeoReverb(void)
 //++------------------------------------------------------------------------------
 //  ShutdownNeoReverb()
 //
-//  Clean up and deallocate Neo reverb resources
+//  Stop the Neo reverb. Its buffers belong to the reverb arena, which
+//  GM_CleanupReverb frees.
 //++------------------------------------------------------------------------------
 void ShutdownNeoReverb(void)
 {
@@ -451,25 +444,23 @@ void ShutdownNeoReverb(void)
     NeoReverbParams* params = GetNeoReverbParams();
     
     params->mIsInitialized = FALSE;
-    
-    // Deallocate tap buffer
-    if (params->mTapBuffer)
-    {
-        XDisposePtr(params->mTapBuffer);
-        params->mTapBuffer = NULL;
-    }
-    
-    // Deallocate custom buffers
+    params->mTapBuffer = NULL;
     for (i = 0; i < NEO_CUSTOM_MAX_COMBS; i++)
     {
-        if (params->mCustomBuffer[i])
-        {
-            XDisposePtr(params->mCustomBuffer[i]);
-            params->mCustomBuffer[i] = NULL;
-        }
+        params->mCustomBuffer[i] = NULL;
     }
 }
 
+//++------------------------------------------------------------------------------
+//  ResetNeoReverb()
+//
+//  Forget the current mode, so the next run starts with clear buffers
+//++------------------------------------------------------------------------------
+void ResetNeoReverb(void)
+{
+    GetNeoReverbParams()->mReverbMode = -1;
+}
+
 //++------------------------------------------------------------------------------
 //  CheckNeoReverbType()
 //
@@ -484,10 +475,10 @@ XBOOL CheckNeoReverbType(void)
     if (!params->mIsInitialized)
         return FALSE;
     
-    if (params->mReverbMode != MusicGlobals->reverbUnitType)
+    if (params->mReverbMode != MusicGlobals->reverbTypeAllocated)
     {
         changed = TRUE;
-        params->mReverbMode = MusicGlobals->reverbUnitType;
+        params->mReverbMode = MusicGlobals->reverbTypeAllocated;
 
         // If the output rate changes, keep the time constants stable.
         if (params->mSampleRate != MusicGlobals->outputRate)
@@ -510,8 +501,7 @@ XBOOL CheckNeoReverbType(void)
         params->mCustomParamsDirty = FALSE;
         
         // Reset filter memory
-        params->mFilterMemoryL = 0;
-        params->mFilterMemoryR = 0;
+        params->mFilterMemory = 0;
 
         params->mIdleFrames = 0;
         params->mWasActive = FALSE;
@@ -532,8 +522,8 @@ XBOOL CheckNeoReverbType(void)
 static void PV_ProcessNeoTapReverb(INT32 *sourceP, INT32 *destP, int numFrames)
 {
     NeoReverbParams* params = GetNeoReverbParams();
-    INT32 inputL, inputR, outputL, outputR;
-    INT32 tapL, tapR;
+    INT32 *buffer = params->mTapBuffer;
+    INT32 output, tap;
     int i, frame, readPos;
 
     const int idleHoldFrames = PV_ClampInt(params->mSampleRate / 50, NEO_IDLE_HOLD_FRAMES_MIN, NEO_IDLE_HOLD_FRAMES_MAX);
@@ -542,57 +532,44 @@ static void PV_ProcessNeoTapReverb(INT32 *sourceP, INT32 *destP, int numFrames)
     {
         // Get mono input from reverb send buffer
         INT32 input = PV_ScaleReverbSend(sourceP[frame]);
-        inputL = input;
-        inputR = input;
         
         // Write input to delay buffer first
-        params->mTapBuffer[params->mTapWriteIdx] = inputL;
-        params->mTapBuffer[(params->mTapWriteIdx + 1) & NEO_TAP_BUFFER_MASK] = inputR;
+        buffer[params->mTapWriteIdx] = input;
         
-        outputL = 0;
-        outputR = 0;
+        output = 0;
         
         // Sum all tap delays with decreasing gains
         for (i = 0; i < NEO_TAP_COUNT; i++)
         {
             // Calculate read position: delay samples back from write position
-            readPos = (params->mTapWriteIdx - (params->mTapDelayFrames[i] * 2)) & NEO_TAP_BUFFER_MASK;
-            
-            tapL = params->mTapBuffer[readPos];
-            tapR = params->mTapBuffer[(readPos + 1) & NEO_TAP_BUFFER_MASK];
-            
-            outputL = PV_Clamp32From64((int64_t)outputL + (((int64_t)tapL * (int64_t)neo_tap_gains[i]) >> NEO_COEFF_SHIFT));
-            outputR = PV_Clamp32From64((int64_t)outputR + (((int64_t)tapR * (int64_t)neo_tap_gains[i]) >> NEO_COEFF_SHIFT));
+            readPos = (params->mTapWriteIdx - params->mTapDelayFrames[i]) & NEO_TAP_BUFFER_MASK;
+            tap = buffer[readPos];
+            output = PV_Clamp32From64((int64_t)output + (((int64_t)tap * (int64_t)neo_tap_gains[i]) >> NEO_COEFF_SHIFT));
         }
         
         // Advance write index
-        params->mTapWriteIdx = (params->mTapWriteIdx + 2) & NEO_TAP_BUFFER_MASK;
+        params->mTapWriteIdx = (params->mTapWriteIdx + 1) & NEO_TAP_BUFFER_MASK;
         
         // Apply light filtering to taps
         {
-            INT32 dL = (INT32)(outputL - params->mFilterMemoryL);
-            INT32 dR = (INT32)(outputR - params->mFilterMemoryR);
-            params->mFilterMemoryL = PV_Clamp32From64((int64_t)params->mFilterMemoryL + (int64_t)PV_MulQ16_Round(dL, params->mLopassK));
-            params->mFilterMemoryR = PV_Clamp32From64((int64_t)params->mFilterMemoryR + (int64_t)PV_MulQ16_Round(dR, params->mLopassK));
+            INT32 d = (INT32)(output - params->mFilterMemory);
+            params->mFilterMemory = PV_Clamp32From64((int64_t)params->mFilterMemory + (int64_t)PV_MulQ16_Round(d, params->mLopassK));
         }
 
         // If we're effectively silent for long enough, hard reset state/buffers.
         // This stops low-level limit-cycle noise from keeping the VU alive.
         {
-            INT32 wetTestL = PV_MulQ16_Round(params->mFilterMemoryL, params->mWetGain);
-            INT32 wetTestR = PV_MulQ16_Round(params->mFilterMemoryR, params->mWetGain);
+            INT32 wet = PV_MulQ16_Round(params->mFilterMemory, params->mWetGain);
             const XBOOL isIdle = (PV_Abs32(input) < NEO_IDLE_INPUT_THRESHOLD) &&
-                                (PV_Abs32(wetTestL) < NEO_IDLE_WET_THRESHOLD) &&
-                                (PV_Abs32(wetTestR) < NEO_IDLE_WET_THRESHOLD);
+                                (PV_Abs32(wet) < NEO_IDLE_WET_THRESHOLD);
             if (isIdle)
             {
                 params->mIdleFrames++;
                 if (params->mWasActive && params->mIdleFrames >= idleHoldFrames)
                 {
-                    XSetMemory(params->mTapBuffer, sizeof(INT32) * NEO_TAP_BUFFER_SIZE, 0);
+                    XSetMemory(buffer, sizeof(INT32) * NEO_TAP_BUFFER_SIZE, 0);
                     params->mTapWriteIdx = 0;
-                    params->mFilterMemoryL = 0;
-                    params->mFilterMemoryR = 0;
+                    params->mFilterMemory = 0;
                     params->mWasActive = FALSE;
                 }
             }
@@ -605,10 +582,9 @@ static void PV_ProcessNeoTapReverb(INT32 *sourceP, INT32 *destP, int numFrames)
         
         // Mix wet reverb signal into destination (dry) buffer
         {
-            INT32 wetL = PV_MulQ16_Round(params->mFilterMemoryL, params->mWetGain);
-            INT32 wetR = PV_MulQ16_Round(params->mFilterMemoryR, params->mWetGain);
-            destP[frame * 2] += (XSDWORD)(((int64_t)wetL) << NEO_WETSHIFT);
-            destP[frame * 2 + 1] += (XSDWORD)(((int64_t)wetR) << NEO_WETSHIFT);
+            INT32 wet = PV_MulQ16_Round(params->mFilterMemory, params->mWetGain);
+            destP[frame * 2] += (XSDWORD)(((int64_t)wet) << NEO_WETSHIFT);
+            destP[frame * 2 + 1] += (XSDWORD)(((int64_t)wet) << NEO_WETSHIFT);
         }
     }
 }
@@ -625,11 +601,65 @@ static void PV_RebuildCustomDelayIndices(NeoReverbParams *params)
     {
         int clampedDelay = PV_ClampDelayFramesForBuffer(params->mCustomDelayFrames[i], NEO_CUSTOM_BUFFER_SIZE);
         params->mCustomDelayFrames[i] = clampedDelay;
-        params->mCustomReadIdx[i] = (NEO_CUSTOM_BUFFER_SIZE - (clampedDelay * 2)) & NEO_CUSTOM_BUFFER_MASK;
+        params->mCustomReadIdx[i] = (NEO_CUSTOM_BUFFER_SIZE - clampedDelay) & NEO_CUSTOM_BUFFER_MASK;
     }
     params->mCustomParamsDirty = FALSE;
 }
 
+//++------------------------------------------------------------------------------
+//  PV_RunNeoCombSpan()
+//
+//  Run one comb over numFrames of send input, adding its gained output into
+//  accum. Frames are taken in spans no longer than the comb delay and no
+//  wider than the distance to the buffer end, so every read in a span comes
+//  from before the span's writes and the loop body has no carried state.
+//++------------------------------------------------------------------------------
+static void PV_RunNeoCombSpan(NeoReverbParams *params, int comb, const INT32 *sourceP, int64_t *accum, int numFrames)
+{
+    INT32 *buffer = params->mCustomBuffer[comb];
+    const INT32 feedback = params->mCustomFeedback[comb];
+    const INT32 gain = params->mCustomGain[comb];
+    const int delay = params->mCustomDelayFrames[comb];
+    int writePos = params->mCustomWriteIdx[comb];
+    int readPos, span, done, count;
+
+    for (done = 0; done < numFrames; done += span)
+    {
+        readPos = (writePos - delay) & NEO_CUSTOM_BUFFER_MASK;
+        span = numFrames - done;
+        if (span > delay)
+        {
+            span = delay;
+        }
+        if (span > NEO_CUSTOM_BUFFER_SIZE - writePos)
+        {
+            span = NEO_CUSTOM_BUFFER_SIZE - writePos;
+        }
+        if (span > NEO_CUSTOM_BUFFER_SIZE - readPos)
+        {
+            span = NEO_CUSTOM_BUFFER_SIZE - readPos;
+        }
+        {
+            const INT32 *src = sourceP + done;
+            const INT32 *delayed = buffer + readPos;
+            INT32 *dest = buffer + writePos;
+            int64_t *out = accum + done;
+
+            for (count = 0; count < span; count++)
+            {
+                // Compute comb filter output: input + delayed * feedback
+                // Truncation needed to prevent infinite growth
+                INT32 fb = PV_ZapSmall(PV_MulQ16_Trunc(delayed[count], feedback));
+                dest[count] = PV_ZapSmall(PV_Clamp32From64((int64_t)PV_ScaleReverbSend(src[count]) + (int64_t)fb));
+                // Accumulate output with per-comb gain (use delayed values for output)
+                out[count] += (int64_t)PV_MulQ16_Trunc(delayed[count], gain);
+            }
+        }
+        writePos = (writePos + span) & NEO_CUSTOM_BUFFER_MASK;
+    }
+    params->mCustomWriteIdx[comb] = writePos;
+}
+
 //++------------------------------------------------------------------------------
 //  PV_ProcessNeoCustomReverb()
 //
@@ -639,10 +669,11 @@ static void PV_RebuildCustomDelayIndices(NeoReverbParams *params)
 static void PV_ProcessNeoCustomReverb(INT32 *sourceP, INT32 *destP, int numFrames)
 {
     NeoReverbParams* params = GetNeoReverbParams();
-    INT32 inputL, inputR, combOutL, combOutR;
-    int64_t outputL, outputR;
-    INT32 delayedL, delayedR, feedback, gain = 0;
-    int i, frame, readPos;
+    int64_t accum[MAX_CHUNK_SIZE];
+    int64_t output;
+    INT32 gain;
+    int i, frame, start, end;
+    XBOOL restart;
 
     const int idleHoldFrames = PV_ClampInt(params->mSampleRate / 50, NEO_IDLE_HOLD_FRAMES_MIN, NEO_IDLE_HOLD_FRAMES_MAX);
        
@@ -651,107 +682,86 @@ static void PV_ProcessNeoCustomReverb(INT32 *sourceP, INT32 *destP, int numFrame
     {
         PV_RebuildCustomDelayIndices(params);
     }
+    // the idle test below keys off the last comb's gain
+    gain = (params->mCustomCombCount > 0) ? params->mCustomGain[params->mCustomCombCount - 1] : 0;
     
-    for (frame = 0; frame < numFrames; frame++)
+    for (start = 0; start < numFrames; start = end)
     {
-        // Get mono input from reverb send buffer
-        INT32 input = PV_ScaleReverbSend(sourceP[frame]);
-        inputL = input;
-        inputR = input;
-        
-        outputL = 0;
-        outputR = 0;
-        
-        // Process parallel comb filters (up to user-defined count)
-        for (i = 0; i < params->mCustomCombCount; i++)
+        end = numFrames;
+        if (end - start > MAX_CHUNK_SIZE)
         {
-            // Calculate read position: delay samples back from write position
-            readPos = (params->mCustomWriteIdx[i] - (params->mCustomDelayFrames[i] * 2)) & NEO_CUSTOM_BUFFER_MASK;
-            
-            // Read delayed samples
-            delayedL = params->mCustomBuffer[i][readPos];
-            delayedR = params->mCustomBuffer[i][(readPos + 1) & NEO_CUSTOM_BUFFER_MASK];
-            
-            // Compute comb filter output: input + delayed * feedback
-            // Truncation needed to prevent infinite growth
-            feedback = params->mCustomFeedback[i];
-            INT32 feedbackL = PV_ZapSmall(PV_MulQ16_Trunc(delayedL, feedback));
-            INT32 feedbackR = PV_ZapSmall(PV_MulQ16_Trunc(delayedR, feedback));
-            
-            combOutL = PV_ZapSmall(PV_Clamp32From64((int64_t)inputL + (int64_t)feedbackL));
-            combOutR = PV_ZapSmall(PV_Clamp32From64((int64_t)inputR + (int64_t)feedbackR));
-
-            // Write to current position
-            params->mCustomBuffer[i][params->mCustomWriteIdx[i]] = combOutL;
-            params->mCustomBuffer[i][(params->mCustomWriteIdx[i] + 1) & NEO_CUSTOM_BUFFER_MASK] = combOutR;
-            
-            // Accumulate output with per-comb gain (use delayed values for output)
-            gain = params->mCustomGain[i];
-            outputL += (int64_t)PV_MulQ16_Trunc(delayedL, gain);
-            outputR += (int64_t)PV_MulQ16_Trunc(delayedR, gain);
-            
-            // Advance write index
-            params->mCustomWriteIdx[i] = (params->mCustomWriteIdx[i] + 2) & NEO_CUSTOM_BUFFER_MASK;
+            end = start + MAX_CHUNK_SIZE;
         }
-        
-        // Average the output from all combs to prevent clipping
-        if (params->mCustomCombCount > 0)
-        {
-            outputL = outputL / params->mCustomCombCount;
-            outputR = outputR / params->mCustomCombCount;
-        }
-        
-        // Apply low-pass filtering for smoothing
+
+        // Run the parallel comb bank for the whole chunk, one comb at a time
+        XSetMemory(accum, (int32_t)(sizeof(int64_t) * (end - start)), 0);
+        for (i = 0; i < params->mCustomCombCount; i++)
         {
-            INT32 out32L = PV_Clamp32From64(outputL);
-            INT32 out32R = PV_Clamp32From64(outputR);
-            INT32 dL = (INT32)(out32L - params->mFilterMemoryL);
-            INT32 dR = (INT32)(out32R - params->mFilterMemoryR);
-            params->mFilterMemoryL = PV_Clamp32From64((int64_t)params->mFilterMemoryL + (int64_t)PV_MulQ16_Round(dL, params->mLopassK));
-            params->mFilterMemoryR = PV_Clamp32From64((int64_t)params->mFilterMemoryR + (int64_t)PV_MulQ16_Round(dR, params->mLopassK));
+            PV_RunNeoCombSpan(params, i, sourceP + start, accum, end - start);
         }
 
-        // Output-side idle shutoff: once wet is very small for long enough (and no input),
-        // clear filter state and delay lines to fully stop the tail.
+        restart = FALSE;
+        for (frame = start; frame < end; frame++)
         {
-            INT32 wetTestL = PV_MulQ16_Round(params->mFilterMemoryL, params->mWetGain);
-            INT32 wetTestR = PV_MulQ16_Round(params->mFilterMemoryR, params->mWetGain);
-            XBOOL isIdle = FALSE;
-            if (gain > 127) {
-                isIdle = (PV_Abs32(wetTestL) < NEO_IDLE_WET_THRESHOLD * 1.5f) &&
-                         (PV_Abs32(wetTestR) < NEO_IDLE_WET_THRESHOLD * 1.5f);
-            } else {
-                isIdle = (PV_Abs32(wetTestL) < NEO_IDLE_WET_THRESHOLD) &&
-                         (PV_Abs32(wetTestR) < NEO_IDLE_WET_THRESHOLD);
+            output = accum[frame - start];
+
+            // Average the output from all combs to prevent clipping
+            if (params->mCustomCombCount > 0)
+            {
+                output = output / params->mCustomCombCount;
             }
-            if (isIdle)
+            
+            // Apply low-pass filtering for smoothing
             {
-                params->mIdleFrames++;
-                if (params->mWasActive && params->mIdleFrames >= idleHoldFrames)
+                INT32 out32 = PV_Clamp32From64(output);
+                INT32 d = (INT32)(out32 - params->mFilterMemory);
+                params->mFilterMemory = PV_Clamp32From64((int64_t)params->mFilterMemory + (int64_t)PV_MulQ16_Round(d, params->mLopassK));
+            }
+
+            // Output-side idle shutoff: once wet is very small for long enough (and no input),
+            // clear filter state and delay lines to fully stop the tail.
+            {
+                INT32 wetTest = PV_MulQ16_Round(params->mFilterMemory, params->mWetGain);
+                XBOOL isIdle = FALSE;
+                if (gain > 127) {
+                    isIdle = (PV_Abs32(wetTest) < NEO_IDLE_WET_THRESHOLD * 1.5f);
+                } else {
+                    isIdle = (PV_Abs32(wetTest) < NEO_IDLE_WET_THRESHOLD);
+                }
+                if (isIdle)
                 {
-                    for (i = 0; i < params->mCustomCombCount; i++)
+                    params->mIdleFrames++;
+                    if (params->mWasActive && params->mIdleFrames >= idleHoldFrames)
                     {
-                        XSetMemory(params->mCustomBuffer[i], sizeof(INT32) * NEO_CUSTOM_BUFFER_SIZE, 0);
-                        params->mCustomWriteIdx[i] = 0;
+                        for (i = 0; i < params->mCustomCombCount; i++)
+                        {
+                            XSetMemory(params->mCustomBuffer[i], sizeof(INT32) * NEO_CUSTOM_BUFFER_SIZE, 0);
+                            params->mCustomWriteIdx[i] = 0;
+                        }
+                        params->mFilterMemory = 0;
+                        params->mWasActive = FALSE;
+                        // the combs already ran past this frame, so run the rest of the chunk again from the cleared lines
+                        restart = TRUE;
                     }
-                    params->mFilterMemoryL = 0;
-                    params->mFilterMemoryR = 0;
-                    params->mWasActive = FALSE;
+                }
+                else
+                {
+                    params->mIdleFrames = 0;
+                    params->mWasActive = TRUE;
                 }
             }
-            else
+            
+            // Mix wet reverb signal into destination (dry) buffer
             {
-                params->mIdleFrames = 0;
-                params->mWasActive = TRUE;
+                INT32 wet = PV_MulQ16_Round(params->mFilterMemory, params->mWetGain);
+                destP[frame * 2] += (XSDWORD)(((int64_t)wet) << NEO_WETSHIFT);
+                destP[frame * 2 + 1] += (XSDWORD)(((int64_t)wet) << NEO_WETSHIFT);
+            }
+            if (restart)
+            {
+                end = frame + 1;
+                break;
             }
-        }
-        
-        // Mix wet reverb signal into destination (dry) buffer
-        {
-            INT32 wetL = PV_MulQ16_Round(params->mFilterMemoryL, params->mWetGain);
-            INT32 wetR = PV_MulQ16_Round(params->mFilterMemoryR, params->mWetGain);
-            destP[frame * 2] += (XSDWORD)(((int64_t)wetL) << NEO_WETSHIFT);
-            destP[frame * 2 + 1] += (XSDWORD)(((int64_t)wetR) << NEO_WETSHIFT);
         }
     }
 }
@@ -224,10 +224,10 @@ XBOOL InitNewReverb()
     params->mEarlyReflectionBuffer = MusicGlobals->reverbBuffer + REVERB_BUFFER_SIZE*2 - kEarlyReflectionBufferFrameSize;
 #endif
 
-    // allocate the diffusion delay line memory
+    // take the diffusion delay line memory from the reverb arena
     for(i = 0; i < kNumberOfDiffusionStages; i++)
     {
-        params->mDiffusionBuffer[i] = (INT32*)XNewPtr(sizeof(INT32) * kDiffusionBufferFrameSize);       
+        params->mDiffusionBuffer[i] = (INT32*)GM_TakeReverbMemory(sizeof(INT32) * kDiffusionBufferFrameSize);       
         if (params->mDiffusionBuffer[i] == NULL)
         {
             ShutdownNewReverb();
@@ -235,13 +235,13 @@ XBOOL InitNewReverb()
         }
     }
 
-    params->mStereoizerBufferL = (INT32*)XNewPtr(sizeof(INT32) * kStereoizerBufferFrameSize);
+    params->mStereoizerBufferL = (INT32*)GM_TakeReverbMemory(sizeof(INT32) * kStereoizerBufferFrameSize);
     if (params->mStereoizerBufferL == NULL)
     {
         ShutdownNewReverb();
         return FALSE;
     }
-    params->mStereoizerBufferR = (INT32*)XNewPtr(sizeof(INT32) * kStereoizerBufferFrameSize);
+    params->mStereoizerBufferR = (INT32*)GM_TakeReverbMemory(sizeof(INT32) * kStereoizerBufferFrameSize);
     if (params->mStereoizerBufferR == NULL)
     {
         ShutdownNewReverb();
@@ -302,21 +302,27 @@ void ShutdownNewReverb()
 
 
 
-    // deallocate the diffusion buffers
+    // the diffusion and stereoizer buffers belong to the reverb arena, which
+    // GM_CleanupReverb frees
     for(i = 0; i < kNumberOfDiffusionStages; i++)
     {
-        XDisposePtr(params->mDiffusionBuffer[i]);
         params->mDiffusionBuffer[i] = NULL;
     }
-
-    // deallocate stereoizer buffers
-    XDisposePtr(params->mStereoizerBufferL);
     params->mStereoizerBufferL = NULL;
-    XDisposePtr(params->mStereoizerBufferR);
     params->mStereoizerBufferR = NULL;
     
 }
 
+//++------------------------------------------------------------------------------
+//  ResetNewReverb()
+//
+//      Forget the current type, so the next run starts with clear delay lines
+//++------------------------------------------------------------------------------
+void ResetNewReverb()
+{
+    GetNewReverbParams()->mReverbType = -1;
+}
+
 
 //++------------------------------------------------------------------------------
 //  CheckReverbType()
@@ -331,15 +337,15 @@ XBOOL CheckReverbType()
     
     if (params->mIsInitialized)
     {
-        if(params->mReverbType != MusicGlobals->reverbUnitType)
+        if(params->mReverbType != MusicGlobals->reverbTypeAllocated)
         {
             params->mIsInitialized = FALSE; // set to false to stop playback
             changed = TRUE;
-            params->mReverbType = MusicGlobals->reverbUnitType;
+            params->mReverbType = MusicGlobals->reverbTypeAllocated;
 
             params->mDiffusedBalance = 64;  // default to reasonable diffused sound
 
-            switch(MusicGlobals->reverbUnitType)
+            switch(MusicGlobals->reverbTypeAllocated)
             {
                 case REVERB_TYPE_1:     // no reverb
                     break;
@@ -1249,7 +1249,7 @@ OPErr GM_EnableSF2ForSong(GM_Song* pSong, XBOOL enable)
     // Allocate SF2Info if needed
     if (!pSong->sf2Info && enable)
     {
-        pSong->sf2Info = XNewPtr(sizeof(GM_SF2Info));
+        pSong->sf2Info = XNewTaggedPtr(sizeof(GM_SF2Info), X_MEMORY_SOUNDFONTS);
         if (!pSong->sf2Info)
         {
             return MEMORY_ERR;
@@ -2164,7 +2164,7 @@ static void PV_SF2_AllocateMixBuffer(int32_t frameCount)
     if (g_fluidsynth_mix_buffer_frames < requiredSize)
     {
         PV_SF2_FreeMixBuffer();
-        g_fluidsynth_mix_buffer = (float*)XNewPtr(requiredSize * sizeof(float));
+        g_fluidsynth_mix_buffer = (float*)XNewTaggedPtr(requiredSize * sizeof(float), X_MEMORY_SOUNDFONTS);
         if (g_fluidsynth_mix_buffer)
         {
             g_fluidsynth_mix_buffer_frames = requiredSize;
@@ -837,7 +837,7 @@ OPErr GM_StartSample(VOICE_REFERENCE reference)
     pVoice = PV_GetVoiceFromSoundReference(reference);
     if (pVoice)
     {
-        pVoice->voiceStartTimeStamp = XMicroseconds();
+        pVoice->voiceStartTimeStamp = XMicroseconds64();
 #ifdef BAE_MCU
         if (GM_InitVoiceOnDSP(pVoice) == NO_ERR)
         {
@@ -916,10 +916,10 @@ void GM_EndAllSamples(void)
 
 #if X_PLATFORM != X_WEBTV
 
-uint32_t GM_GetSampleStartTimeStamp(VOICE_REFERENCE reference)
+uint64_t GM_GetSampleStartTimeStamp64(VOICE_REFERENCE reference)
 {
     GM_Voice        *pVoice;
-    uint32_t   time;
+    uint64_t   time;
 
     time = 0;
     pVoice = PV_GetVoiceFromSoundReference(reference);
@@ -930,6 +930,11 @@ uint32_t GM_GetSampleStartTimeStamp(VOICE_REFERENCE reference)
     return time;
 }
 
+uint32_t GM_GetSampleStartTimeStamp(VOICE_REFERENCE reference)
+{
+    return (uint32_t)GM_GetSampleStartTimeStamp64(reference);
+}
+
 // given a valid voice, return the current playback position
 uint32_t GM_GetSamplePlaybackPosition(VOICE_REFERENCE reference)
 {
@@ -1697,7 +1702,7 @@ GM_Waveform *GM_NewWaveform(void)
 {
     GM_Waveform *result;
 
-    result = (GM_Waveform *)XNewPtr(sizeof(GM_Waveform));
+    result = (GM_Waveform *)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
 
     return result;
 }
@@ -585,6 +585,7 @@ OPErr PV_ConfigureMusic(GM_Song *pSong)
     XDWORD lengthToMidiEnd;
 
     theErr = BAD_MIDI_DATA; // assume the worst
+    pSong->eventStreamState = EVENT_STREAM_UNSYNCED; // tracks are rewound below
     // Reset lyric state
     pSong->lastLyricTimeUs = 0;
     pSong->currentLineLength = 0;
@@ -794,7 +795,7 @@ void GM_PauseSequencer(XBOOL endVoices)
         GM_Mixer *pMixer = GM_GetCurrentMixer();
         if (pMixer)
         {
-            for (int i = 0; i < MAX_SONGS; ++i)
+            for (int i = 0; i < pMixer->songSlotCount; ++i)
             {
                 GM_Song *s = pMixer->pSongsToPlay[i];
                 if (s && GM_IsSF2Song(s))
@@ -819,7 +820,7 @@ void GM_ResumeSequencer(void)
     {
         if ((pMixer->systemPaused == FALSE) && (pMixer->sequencerPaused))
         {
-            for (count = 0; count < MAX_SONGS; count++)
+            for (count = 0; count < pMixer->songSlotCount; count++)
             {
                 pSong = pMixer->pSongsToPlay[count];
                 if (pSong)
@@ -1635,7 +1636,7 @@ static void PV_AddInstrumentEntry(GM_Song *pSong, INT16 currentTrack, INT16 MIDI
         entry = pSong->pPatchInfo->instrChangeInfo;
         prev = NULL;
         ticks = pSong->trackcumuticks[currentTrack];
-        e = (InstrumentEntry *)XNewPtr(sizeof(InstrumentEntry));
+        e = (InstrumentEntry *)XNewTaggedPtr(sizeof(InstrumentEntry), X_MEMORY_SONGS);
         if (e)
         {
             while (entry) 
@@ -1915,11 +1916,8 @@ static void PV_ProcessProgramChange(GM_Song *pSong, INT16 MIDIChannel, INT16 cur
     }
 }
 
-static INT16 PV_ConvertPatchBank(GM_Song *pSong, INT16 thePatch, INT16 theChannel)
+static INT16 PV_ConvertPatchFromBank(GM_Song *pSong, INT16 theBank, INT16 thePatch, INT16 theChannel)
 {
-    INT16 theBank;
-
-    theBank = pSong->channelBank[theChannel];
     switch (pSong->channelBankMode[theChannel])
     {
     default:
@@ -1966,6 +1964,55 @@ static INT16 PV_ConvertPatchBank(GM_Song *pSong, INT16 thePatch, INT16 theChanne
     return thePatch;
 }
 
+static INT16 PV_ConvertPatchBank(GM_Song *pSong, INT16 thePatch, INT16 theChannel)
+{
+    return PV_ConvertPatchFromBank(pSong, pSong->channelBank[theChannel], thePatch, theChannel);
+}
+
+// Given a program, and the bank select MSB sent with it or -1 for the channel's current
+// bank, return the instrument notes on theChannel will play once the program change is
+// processed. Returns -1 if that depends on the note, as it does for percussion.
+XLongResourceID GM_GetProgramInstrument(GM_Song *pSong, INT16 theChannel, INT16 theBank, INT16 theProgram)
+{
+    if ((pSong == NULL) || (theChannel < 0) || (theChannel >= MAX_CHANNELS) ||
+        (theProgram < 0) || (theProgram >= MAX_INSTRUMENTS))
+    {
+        return -1;
+    }
+#if USE_SF2_SUPPORT == TRUE
+    if ((GM_IsSF2Song(pSong) || pSong->channelType[theChannel] == CHANNEL_TYPE_SF2) && pSong->channelType[theChannel] != CHANNEL_TYPE_RMF)
+    {   // the soundfont plays it
+        return -1;
+    }
+#endif
+    if (theBank < 0)
+    {
+        theBank = pSong->channelBank[theChannel];
+    }
+    else if (theBank > (MAX_BANKS / 2))
+    {   // same as B_BANK_MSB
+        theBank = 0;
+    }
+    if (pSong->defaultPercusionProgram >= 0)
+    {
+        return theProgram;
+    }
+    switch (pSong->channelBankMode[theChannel])
+    {
+    case USE_GM_PERC_BANK:
+        return -1;
+    case USE_GM_DEFAULT:
+        if (theChannel == PERCUSSION_CHANNEL)
+        {
+            return -1;
+        }
+        break;
+    default:
+        break;
+    }
+    return PV_ConvertPatchFromBank(pSong, theBank, theProgram, theChannel);
+}
+
 // Given a song and a midi note, this will determine the instrument to use based upon the percussion mode,
 // bank selectable mode, and other factors
 static INT16 PV_DetermineInstrumentToUse(GM_Song *pSong, INT16 midiNote, INT16 MIDIChannel)
@@ -2551,7 +2598,8 @@ void PV_ProcessController(GM_Song *pSong, INT16 MIDIChannel, INT16 currentTrack,
             break;
         case B_REVERB_TYPE: // reverb type
 #if REVERB_USED != REVERB_DISABLED
-            GM_SetReverbType((ReverbMode)((value % MAX_REVERB_TYPES) + 1));
+            // content can select up to REVERB_TYPE_18, the convolution reverb needs a host loaded impulse
+            GM_SetReverbType((ReverbMode)((value % REVERB_TYPE_18) + 1));
 #endif
             break;
 //          case 71:        // XG harmonic      (gm2) When the value is smaller than 64, the effect becomes weaker. When the value is bigger than 64, the effect becomes stronger.
@@ -3438,7 +3486,7 @@ static void PV_ProcessIgorResource(GM_Song *pSong,
         break;
     case ID_ESND:
         // since this is encrypted, make a new copy and decrypt
-        theNewData = XNewPtr(length);
+        theNewData = XNewTaggedPtr(length, X_MEMORY_SAMPLES);
         if (theNewData)
         {
             XBlockMove((XPTR)pMidiStream, theNewData, length);
@@ -3454,7 +3502,7 @@ static void PV_ProcessIgorResource(GM_Song *pSong,
     case ID_SND:
         // we need to copy the sample data because if the midi stream is thrown away
         // then we loose our access.
-        theNewData = XNewPtr(length);
+        theNewData = XNewTaggedPtr(length, X_MEMORY_SAMPLES);
         if (theNewData)
         {
             XBlockMove((XPTR)pMidiStream, theNewData, length);
@@ -3506,24 +3554,14 @@ static void PV_SetSampleIntoCache(GM_Song *pSong,
     GM_Mixer *pMixer;
 
     pMixer = GM_GetCurrentMixer();
-    //  First, if there is no entry in the cache for this ID, create it.
-    //  Next, increment refcount and grab it's pointer.
-    if (GMCache_IsIDInCache(pMixer, theID, bankToken) != TRUE)
-    {
-        pCache = GMCache_BuildSampleCacheEntry(pMixer,
-                                               theID,
-                                               bankToken,
-                                               pSndFormatData,
-                                               pErr);
-    }
-    else
-    {
-        pCache = GMCache_GetCachePtrFromID(pMixer, theID, bankToken, pErr);
-        if (*pErr == NO_ERR)
-        {
-            *pErr = GMCache_IncrCacheEntryRef(pMixer, pCache);
-        }
-    }
+    //  Take a reference on the cache entry for this ID, creating it if there isn't one.
+    //  The cache locks only its own tables, so the instrument loader thread's decodes
+    //  don't hold up the sequencer here.
+    pCache = GMCache_BuildSampleCacheEntry(pMixer,
+                                           theID,
+                                           bankToken,
+                                           pSndFormatData,
+                                           pErr);
 }
 
 // Validate command types. This is used to protect us from bad memory pointers, etc
@@ -3756,494 +3794,1063 @@ static UINT32 PV_ReadVariableLengthMidi(UBYTE **ppMidiStream)
     return value;
 }
 
-// Walk through the midi stream and process midi events for one slice of time.
-OPErr PV_ProcessMidiSequencerSlice(void *threadContext, GM_Song *pSong)
+// Given a pointer to a midi stream, read a variable length value like PV_ReadVariableLengthMidi
+// but without reading at or past pEnd. Returns FALSE if the value runs off the end.
+static XBOOL PV_ReadCompiledLength(XBYTE **ppMidiStream, XBYTE *pEnd, XDWORD *pValue)
 {
-    register LOOPCOUNT currentTrack;
-    register XBYTE midi_byte, volume, controler;
-    register XDWORD value;
-    register XBYTE *midi_stream;
-    register XSWORD MIDIChannel;
-    register XBYTE valueLSB, valueMSB;
-    XBYTE *temp_midi_stream;
-    OPErr theErr;
-    XBOOL reloopTracks;
-
-    theErr = NO_ERR;
+    XBYTE *midi_stream;
+    XDWORD value;
 
-    // Song not loaded, bail
-    if (pSong == NULL)
+    midi_stream = *ppMidiStream;
+    value = 0;
+    while ((midi_stream < pEnd) && (*midi_stream & 0x80))
     {
-        return NO_SONG_PLAYING;
+        value = value << 7;
+        value |= *midi_stream++ - 0x80;
     }
-    pSong->SomeTrackIsAlive = FALSE;
-    pSong->processingSlice = TRUE;
-
-    pSong->CurrentMidiClock += pSong->MIDIDivision;
+    if (midi_stream >= pEnd)
+    {
+        return FALSE;
+    }
+    value = value << 7;
+    value |= *midi_stream++;
 
-    // 1 000 000 / 22050 * 256
-    //  1 second / sample rate * samples
-    pSong->songMicroseconds += (UFLOAT)BAE_GetSliceTimeInMicroseconds();
-    reloopTracks = FALSE;
+    *ppMidiStream = midi_stream;
+    *pValue = value;
+    return TRUE;
+}
 
-    for (currentTrack = 0; currentTrack < MAX_TRACKS; currentTrack++)
-    {
-        midi_stream = pSong->ptrack[currentTrack];
-        if (midi_stream == NULL)
+// Decode one track the same way PV_ProcessMidiSequencerSlice walks it, into pEvents or just
+// counting when pEvents is NULL. Returns the number of events, or -1 if the track reads past
+// pEnd or uses running status before its first status byte. Those are left to the raw walker.
+static int32_t PV_CompileTrackEvents(XBYTE *pTrack, XDWORD trackLength, XBYTE *pEnd, GM_SeqEvent *pEvents)
+{
+    XBYTE *midi_stream;
+    XBYTE *pEvent;
+    XBYTE status, runningStatus, data1, data2, flags;
+    XDWORD value;
+    GM_SeqClock tick;
+    int32_t count;
+
+    midi_stream = pTrack;
+    runningStatus = 0;
+    tick = 0;
+    count = 0;
+    while (1)
+    {
+        if (PV_ReadCompiledLength(&midi_stream, pEnd, &value) == FALSE)
         {
-            goto ServeNextTrack;
+            return -1;
+        }
+        tick += (IFLOAT)(value << 6);
+        pEvent = midi_stream;
+        data1 = 0;
+        data2 = 0;
+        flags = 0;
+        if ((XDWORD)(pEvent - pTrack) > trackLength)
+        {
+            status = 0;
+            flags = SEQ_EVENT_END;
         }
-        if (pSong->trackon[currentTrack] != TRACK_OFF)
+        else
         {
-            pSong->SomeTrackIsAlive = TRUE;
-            if (pSong->trackon[currentTrack] == TRACK_FREE) // first time
+            if (midi_stream >= pEnd)
             {
-                pSong->trackon[currentTrack] = TRACK_RUNNING; // running
-                goto UpdateDeltaTime;
+                return -1;
             }
-            pSong->trackticks[currentTrack] -= (IFLOAT)pSong->MIDIDivision;
-        Do_GetEvent:
-            if (pSong->trackticks[currentTrack] < (IFLOAT)0)
+            status = *midi_stream++;
+            if (status == 0xFF)
             {
-                /* 64-bit safe bounds check: ensure we don't truncate pointer difference */
+                if (midi_stream >= pEnd)
                 {
-                    size_t __offset = (size_t)(midi_stream - pSong->trackstart[currentTrack]);
-                    if (__offset > (size_t)pSong->tracklen[currentTrack])
+                    return -1;
+                }
+                data1 = *midi_stream++;
+                if (data1 != 0x2F)
+                {
+                    if ((PV_ReadCompiledLength(&midi_stream, pEnd, &value) == FALSE) ||
+                        (value > (XDWORD)(pEnd - midi_stream)))
                     {
-                        // the track has ended unexpectedly.
-                        // just fall through and assume things are cool and go to the next track
-                        pSong->trackon[currentTrack] = TRACK_OFF;
-                        goto ServeNextTrack;
+                        return -1;
                     }
+                    midi_stream += value;
                 }
-                goto GetMIDIevent;
-            }
-            if (pSong->trackticks[currentTrack] >= (IFLOAT)0)
-            {
-                goto ServeNextTrack;
             }
-        UpdateDeltaTime:
-            temp_midi_stream = midi_stream;
-            value = PV_ReadVariableLengthMidi(&temp_midi_stream);
-            midi_stream = temp_midi_stream;
-            pSong->trackticks[currentTrack] += (IFLOAT)(value << 6);
-            //          pSong->trackcumuticks[currentTrack] += value;
-            //          printf("track %ld, time %ld\n", (long)currentTrack, (long)pSong->trackticks[currentTrack]);
-            goto Do_GetEvent;
-        }
-        goto ServeNextTrack;
-    GetMIDIevent:
-        midi_byte = *midi_stream++;
-        if (midi_byte == 0xFF)
-        {
-            /* Meta Event
-             */
-            midi_byte = *midi_stream++;
-            switch (midi_byte)
+            else
             {
-            default:
-                //      if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //          printf("Meta event 0x%x, ignored\n", midi_byte);
-                break;
-            // Set MIDI Tempo:
-            case 0x51:
-                value = midi_stream[1] << 8;
-                value |= midi_stream[2];
-                value = value << 8;
-                value |= midi_stream[3];
-                GM_SetSongTempo(pSong, value);
-                //      if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //          printf("Tempo, microseconds-per-MIDI-quarter-note %ld\n", value);
-                goto SkipMeta;
-
-#if 0
-                // Set Time Signature:
-                case 0x58:
-                    pSong->TSNumerator = midi_stream[1];
-                    pSong->TSDenominator = midi_stream[2];
-                    break;
-#endif
-            // generic text event
-            case 0x01:
-            // copyright event
-            case 0x02:
-            // track name
-            case 0x03:
-            // instrument name
-            case 0x04:
-            // Lyric event
-            case 0x05:
-#if SUPPORT_KARAOKE
-                // Karaoke is not in sync when played back at 1x speed
-                // Needs more work
-                /* ORIGINAL BUGFIX (2025-08-16):
-                   Previous implementation wrote a '\0' terminator directly into the
-                   MIDI stream (temp_midi_stream[value] = '\0'). This mutated the next
-                   byte after the lyric text – potentially a delta-time or status byte –
-                   corrupting the track and causing incorrect duration calculations for
-                   some files containing lyric meta events. We now avoid modifying the
-                   underlying MIDI data. If a C-string is desired by the callback, we
-                   provide a temporary copy.
-                */
-                temp_midi_stream = midi_stream;
-                value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
+                if ((status & 0x80) == 0) // running status
                 {
-                    void *metaPtr = (void *)temp_midi_stream; // start of lyric text
-                    void *cbPtr = metaPtr;
-                    char *allocated = NULL;
-                    if (value > 0)
-                    {
-                        allocated = (char *)XNewPtr((int32_t)value + 1);
-                        if (allocated)
-                        {
-                            XBlockMove(metaPtr, allocated, value);
-                            allocated[value] = '\0';
-                            cbPtr = allocated; // pass copy
-                        }
-                    }
-                    PV_CallSongMetaEventCallback(threadContext, pSong, midi_byte, cbPtr, value, (int16_t)currentTrack);
-                    if (pSong->lyricCallbackPtr)
-                    {
-                        XBOOL invoke = FALSE;
-                        const char *lyricStr = (const char *)cbPtr; /* NUL terminated */
-                        if (midi_byte == 0x05 && !pSong->seenGenericTextLyric)
-                        {
-                            pSong->seenTrueLyric = TRUE;
-                            pSong->seenLyricMeta = TRUE;
-                            if (lyricStr && lyricStr[0] && lyricStr[0] == '\r')
-                            {
-                                /* Translate Carrage Return to newline by sending empty lyric */
-                                pSong->lyricsHaveNewlines = TRUE;
-                                uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
-                                char empty[1] = {'\0'};
-                                pSong->lyricCallbackPtr(pSong, empty, lyrTimeUs, pSong->lyricCallbackReference);
-                            }
-                            else
-                            {
-                                invoke = TRUE; /* real lyric */
-                            }
-                        }
-                        else if (midi_byte == 0x01 && !pSong->seenLyricMeta)
-                        {
-                            /* Follow negated form: do NOT treat GenericText starting with '@' as lyric content. */
-                            if (lyricStr && lyricStr[0] == '@')
-                            {
-                                /* Control/reset: translate to newline by sending empty lyric */
-                                uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
-                                char empty[1] = {'\0'};
-                                pSong->lyricsHaveNewlines = TRUE;
-                                pSong->lyricCallbackPtr(pSong, empty, lyrTimeUs, pSong->lyricCallbackReference);
-                            }
-                            else if (lyricStr && lyricStr[0] == '\\')
-                            {
-                                /* Generic text lyrics with \\ prefix - set flags and process */
-                                pSong->seenGenericTextLyric = TRUE;
-                                pSong->seenTrueLyric = TRUE;
-                                invoke = TRUE;
-                            }
-                            else if (!pSong->seenGenericTextLyric)
-                            {
-                                /* Only process plain 0x01 events before any \\ prefix is seen,
-                                   to avoid duplicates when both 0x05 and 0x01 events exist */
-                                invoke = FALSE;
-                            }
-                            else
-                            {
-                                /* After \\ prefix seen, continue processing 0x01 events */
-                                invoke = TRUE;
-                            }
-                        }
-                        if (invoke && lyricStr && lyricStr[0])
-                        {
-                            uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
-                            
-                            // Deduplicate: skip if this exact lyric was just sent at the same timestamp
-                            // (Some MIDI files have duplicate lyric events written consecutively)
-                            size_t lyricLen = strlen(lyricStr);
-                            XBOOL isDuplicate = FALSE;
-                            if (lyricLen < sizeof(pSong->lastLyric) &&
-                                pSong->lastLyricTimestamp == lyrTimeUs &&
-                                strcmp(pSong->lastLyric, lyricStr) == 0)
-                            {
-                                isDuplicate = TRUE;
-                            }
-                            
-                            if (!isDuplicate)
-                            {
-
-                                // Timing-based lyric line breaks
-                                XDWORD currentTime = lyrTimeUs;
-                                XBOOL insertLineBreak = (pSong->lastLyricTimeUs != 0) &&
-                                                        ((currentTime - pSong->lastLyricTimeUs) > pSong->lyricLineBreakThreshold) &&
-                                                        !pSong->lyricsHaveNewlines;
-
-                                // Word wrapping: break line if adding this word would exceed 128 characters
-                                size_t wordLen = strlen(lyricStr);
-                                XBOOL forceBreak = FALSE;
-                                if (pSong->currentLineLength + wordLen > 64 && !pSong->lyricsHaveNewlines)
-                                {
-                                    forceBreak = TRUE;
-                                }
-
-                                if (insertLineBreak || forceBreak)
-                                {
-                                    // Prepend newline to indicate line break
-                                    pSong->lyricCallbackPtr(pSong, "\0", lyrTimeUs, pSong->lyricCallbackReference);
-                                    pSong->lyricCallbackPtr(pSong, lyricStr, lyrTimeUs, pSong->lyricCallbackReference);
-                                    pSong->currentLineLength = wordLen;
-                                }
-                                else
-                                {
-                                    pSong->lyricCallbackPtr(pSong, lyricStr, lyrTimeUs, pSong->lyricCallbackReference);
-                                    pSong->currentLineLength += wordLen;
-                                }
-
-                                // Update timing
-                                pSong->lastLyricTimeUs = currentTime;
-
-                                // Store this lyric for duplicate detection
-                                if (lyricLen < sizeof(pSong->lastLyric))
-                                {
-                                    strcpy(pSong->lastLyric, lyricStr);
-                                    pSong->lastLyricTimestamp = lyrTimeUs;
-                                }
-                            }
-                        }
-                    }
-                    // Free allocated buffer AFTER all callbacks complete
-                    if (allocated)
+                    if (runningStatus == 0)
                     {
-                        XDisposePtr((XPTR)allocated);
+                        return -1; // depends on whatever the previous play left behind
                     }
+                    --midi_stream;
+                    status = runningStatus;
                 }
-                //                  BAE_PRINTF("lyric event: %s\n", (char *)cbPtr);
-                goto SkipMeta;
-#endif
-            // Cue point event
-            case 0x07:
-            // program name
-            case 0x08:
-            // port name
-            case 0x09:
-            // Marker event
-            case 0x06:
-                temp_midi_stream = midi_stream;
-                value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
-                // there might be a problem here. need to relook into this.
-                // maybe we should only do these callbacks during NORMAL_SCAN??
-                PV_CallSongMetaEventCallback(threadContext, pSong, midi_byte, (void *)temp_midi_stream, value, (short)currentTrack);
-
-                if (midi_byte == 0x06)
+                else
                 {
-                    if (PV_ProcessMetaMarkerEvents(pSong, (char *)temp_midi_stream, value))
-                    {
-                        reloopTracks = TRUE; // this will finish up these tracks, then restart
-                    }
+                    runningStatus = status;
+                    flags = SEQ_EVENT_STATUS;
                 }
-
-                //  if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //      printf("Meta event 0x%x length %ld\n", midi_byte, value);
-                goto SkipMeta;
-
-            // Sequencer specific event (The heart of eMidi)
-            case 0x7F:
-                temp_midi_stream = midi_stream;
-                value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
-                midi_stream = temp_midi_stream;
-                //  if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //  {
-                //      printf("Meta event 0x7F length %ld\n", value);
-                //      BAE_PrintHexDump(midi_stream, (value < 32) ? value : 32);
-                //  }
-#if SUPPORT_IGOR_FEATURE
-                if (midi_stream[0] == 0x00) // IGOR sysex ID
+                switch (status & 0xF0)
                 {
-                    if (midi_stream[1] == 0x01)
+                case 0x80:
+                case 0x90:
+                case 0xA0:
+                case 0xB0:
+                case 0xE0:
+                    if ((pEnd - midi_stream) < 2)
                     {
-                        if (midi_stream[2] == 0x0D)
-                        {
-                            PV_ProcessIgorMeta(pSong, midi_stream + 3);
-                        }
+                        return -1;
+                    }
+                    data1 = *midi_stream++;
+                    data2 = *midi_stream++;
+                    break;
+                case 0xC0:
+                case 0xD0:
+                    if (midi_stream >= pEnd)
+                    {
+                        return -1;
+                    }
+                    data1 = *midi_stream++;
+                    break;
+                case 0xF0:
+                    if ((PV_ReadCompiledLength(&midi_stream, pEnd, &value) == FALSE) ||
+                        (value > (XDWORD)(pEnd - midi_stream)))
+                    {
+                        return -1;
                     }
+                    midi_stream += value;
+                    break;
                 }
-#endif
-                midi_stream += value; // skip meta
-                goto UpdateDeltaTime;
-
-            // End-of-track:
-            case 0x2F:
-                //      if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //          printf("End of track %ld\n", (long)currentTrack);
-                pSong->trackon[currentTrack] = TRACK_OFF;
-                goto ServeNextTrack;
             }
-            goto SkipMeta;
         }
-        else
+        if (pEvents)
         {
-            if ((midi_byte & 0x80) == 0) /* running status? */
-            {
-                --midi_stream;
-                midi_byte = pSong->runningStatus[currentTrack];
-            }
-            else
+            pEvents[count].tick = tick;
+            pEvents[count].offset = (XDWORD)(pEvent - pTrack);
+            pEvents[count].status = status;
+            pEvents[count].data1 = data1;
+            pEvents[count].data2 = data2;
+            pEvents[count].flags = flags;
+        }
+        count++;
+        if ((flags & SEQ_EVENT_END) || ((status == 0xFF) && (data1 == 0x2F)))
+        {
+            return count;
+        }
+    }
+}
+
+// Compile the tracks found by PV_ConfigureMusic. If a track can't be represented the stream is
+// still returned, marked unusable, so the work isn't repeated every slice.
+static GM_EventStream *PV_CompileEventStream(GM_Song *pSong)
+{
+    GM_EventStream *pStream;
+    XBYTE *pEnd;
+    int32_t count, total;
+    short int track;
+
+    pStream = (GM_EventStream *)XNewTaggedPtr(sizeof(GM_EventStream), X_MEMORY_SONGS);
+    if (pStream)
+    {
+        pEnd = (XBYTE *)pSong->sequenceData + pSong->sequenceDataSize;
+        total = 0;
+        for (track = 0; track < MAX_TRACKS; track++)
+        {
+            pStream->trackStart[track] = pSong->trackstart[track];
+            pStream->trackLength[track] = pSong->tracklen[track];
+            pStream->firstEvent[track] = total;
+            if (pSong->trackstart[track])
             {
-                pSong->runningStatus[currentTrack] = midi_byte;
-                if (midi_byte == 0) /* 0 = null event. */
+                count = PV_CompileTrackEvents(pSong->trackstart[track], pSong->tracklen[track], pEnd, NULL);
+                if (count < 0)
                 {
-                    goto GetMIDIevent;
+                    return pStream;
                 }
+                total += count;
             }
-            MIDIChannel = midi_byte & 0xF;
-            switch (midi_byte & 0xF0) // process commands
+            pStream->endEvent[track] = total;
+        }
+        if (total)
+        {
+            pStream->pEvents = (GM_SeqEvent *)XNewTaggedPtr(total * (int32_t)sizeof(GM_SeqEvent), X_MEMORY_SONGS);
+            if (pStream->pEvents)
             {
-            case 0x90:                   // �� Note On
-                value = *midi_stream++;  // MIDI note
-                volume = *midi_stream++; // note on velocity
-                {
-                    unsigned char msg[3];
-                    msg[0] = (unsigned char)(0x90 | (MIDIChannel & 0x0F));
-                    msg[1] = (unsigned char)value;
-                    msg[2] = (unsigned char)volume;
-                    PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
-                }
-                PV_ProcessNoteOn(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)value, (XSWORD)volume);
-                break;
-            case 0x80:                   // �� Note Off
-                value = *midi_stream++;  // MIDI note
-                volume = *midi_stream++; // note off velocity, ignore for now
+                for (track = 0; track < MAX_TRACKS; track++)
                 {
-                    unsigned char msg[3];
-                    msg[0] = (unsigned char)(0x80 | (MIDIChannel & 0x0F));
-                    msg[1] = (unsigned char)value;
-                    msg[2] = (unsigned char)volume;
-                    PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
-                }
-                PV_ProcessNoteOff(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)value, (XSWORD)volume);
-                break;
-            case 0xB0:                      // �� Control Change
-                controler = *midi_stream++; // control #
-#if 0 && USE_CREATION_API == TRUE
-                    if (controler == 0 && (pSong->AnalyzeMode == SCAN_COUNT_PATCHES || pSong->AnalyzeMode == SCAN_FIND_PATCHES))
+                    if (pSong->trackstart[track])
                     {
-                        if (pSong->pPatchInfo)
-                        {
-                            if (pSong->pPatchInfo->bankPtrLoc)
-                            {
-                                pSong->pPatchInfo->bankPtrLoc = midi_stream;
-                            }
-                        }
+                        PV_CompileTrackEvents(pSong->trackstart[track], pSong->tracklen[track], pEnd,
+                                              &pStream->pEvents[pStream->firstEvent[track]]);
                     }
-#endif
-                midi_byte = *midi_stream++; // controller value
-                {
-                    unsigned char msg[3];
-                    msg[0] = (unsigned char)(0xB0 | (MIDIChannel & 0x0F));
-                    msg[1] = (unsigned char)controler;
-                    msg[2] = (unsigned char)midi_byte;
-                    PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
                 }
-                PV_ProcessController(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)controler, (XSWORD)midi_byte);
+                pStream->usable = TRUE;
+            }
+        }
+    }
+    return pStream;
+}
 
-                if (pSong->AnalyzeMode == SCAN_NORMAL)
-                {
-                    PV_CallControlCallbacks(threadContext, pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)controler, (XSWORD)midi_byte);
-                }
-                break;
-            case 0xC0: // �� ProgramChange
-                value = *midi_stream;
-#if 0 && USE_CREATION_API == TRUE
-                    if (pSong->AnalyzeMode == SCAN_FIND_PATCHES || pSong->AnalyzeMode == SCAN_COUNT_PATCHES)
-                    {
-                        if (pSong->pPatchInfo)
-                        {
-                            if (pSong->pPatchInfo->instrPtrLoc)
-                            {
-                                pSong->pPatchInfo->instrPtrLoc = midi_stream;
-                            }
-                        }
-                    }
-#endif
-                midi_stream++;
-                {
-                    unsigned char msg[2];
-                    msg[0] = (unsigned char)(0xC0 | (MIDIChannel & 0x0F));
-                    msg[1] = (unsigned char)value;
-                    PV_CallMidiEventCallback(threadContext, pSong, msg, 2);
-                }
-                PV_ProcessProgramChange(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)value);
-#if 0 && USE_CREATION_API == TRUE
-                    if (pSong->AnalyzeMode == SCAN_FIND_PATCHES) 
-                    {
-                        if (pSong->pPatchInfo)
-                        {
-                            midi_stream += pSong->pPatchInfo->streamIncrement;
-                            pSong->pPatchInfo->streamIncrement = 0;
-                        }
-                    }
-#endif
-                break;
-            case 0xE0: // �� SetPitchBend
-                valueLSB = *midi_stream++;
-                valueMSB = *midi_stream++;
-                {
-                    unsigned char msg[3];
-                    msg[0] = (unsigned char)(0xE0 | (MIDIChannel & 0x0F));
-                    msg[1] = (unsigned char)valueLSB;
-                    msg[2] = (unsigned char)valueMSB;
-                    PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
-                }
-                PV_ProcessPitchBend(pSong, MIDIChannel, (XSWORD)currentTrack, valueMSB, valueLSB);
-                break;
-            case 0xA0:            // ��  Key Pressure
-                midi_stream += 2; // note, key pressure
-                break;
-            case 0xD0: // �� ChannelPressure
-                midi_stream++;
-                break;
-            case 0xF7: // �� System Exclusive
-            case 0xF0: // �� System Exclusive
-                temp_midi_stream = midi_stream;
-                value = PV_ReadVariableLengthMidi(&temp_midi_stream);
-                midi_stream = temp_midi_stream;
-                //      if (pSong->AnalyzeMode == SCAN_NORMAL)
-                //      {
-                //          printf("sysex 0x%x length %ld\n", midi_byte, value);
-                //          BAE_PrintHexDump(midi_stream, (value < 32) ? value : 32);
-                //      }
-                // For sysex, pass the full sysex message (0xF0 ... data ... 0xF7)
-                if (midi_byte == 0xF0 && value > 0)
-                {
-                    // Build a simple buffer on stack if size reasonable
-                    int sendLen = (int)value + 1;                          // include initial 0xF0
-                    unsigned char *syx = (unsigned char *)midi_stream - 1; // points to 0xF0
-                    PV_CallMidiEventCallback(threadContext, pSong, syx, sendLen);
+void PV_FreeEventStream(GM_Song *pSong)
+{
+    GM_EventStream *pStream;
 
-#if USE_SF2_SUPPORT == TRUE
-                    // FluidSynth CLI applies SysEx from MIDI files (GM reset, MTS tuning, etc.).
-                    // Forward SysEx during SF2 playback so synthesis matches.
-                    if (GM_IsSF2Song(pSong) || GM_SF2_HasXmfEmbeddedBank())
+    pStream = (GM_EventStream *)pSong->eventStream;
+    if (pStream)
+    {
+        pSong->eventStream = NULL;
+        XDisposePtr((XPTR)pStream->pEvents);
+        XDisposePtr((XPTR)pStream);
+    }
+}
+
+// when the next event of track is due
+#define PV_STREAM_DUE(pStream, track) \
+    ((pStream)->pEvents[(pStream)->cursor[track]].tick + (pStream)->bias[track])
+
+static void PV_EventStreamSiftDown(GM_EventStream *pStream, short int index)
+{
+    short int child;
+    XBYTE track;
+
+    track = pStream->heap[index];
+    while ((child = (short int)(index * 2 + 1)) < pStream->heapCount)
+    {
+        if (((child + 1) < pStream->heapCount) &&
+            (PV_STREAM_DUE(pStream, pStream->heap[child + 1]) < PV_STREAM_DUE(pStream, pStream->heap[child])))
+        {
+            child++;
+        }
+        if (PV_STREAM_DUE(pStream, pStream->heap[child]) >= PV_STREAM_DUE(pStream, track))
+        {
+            break;
+        }
+        pStream->heap[index] = pStream->heap[child];
+        index = child;
+    }
+    pStream->heap[index] = track;
+}
+
+static void PV_EventStreamPush(GM_EventStream *pStream, XBYTE track)
+{
+    short int index, parent;
+
+    index = pStream->heapCount++;
+    while (index > 0)
+    {
+        parent = (short int)((index - 1) / 2);
+        if (PV_STREAM_DUE(pStream, pStream->heap[parent]) <= PV_STREAM_DUE(pStream, track))
+        {
+            break;
+        }
+        pStream->heap[index] = pStream->heap[parent];
+        index = parent;
+    }
+    pStream->heap[index] = track;
+}
+
+// Remove the tracks after afterTrack that have an event due this slice and return them in
+// track order, the order the raw sequencer would visit them.
+static short int PV_EventStreamPopDue(GM_EventStream *pStream, short int afterTrack, XBYTE *pDue)
+{
+    XBYTE skipped[MAX_TRACKS];
+    short int dueCount, skipCount, index;
+    XBYTE track;
+
+    dueCount = 0;
+    skipCount = 0;
+    while (pStream->heapCount && (PV_STREAM_DUE(pStream, pStream->heap[0]) < pStream->clock))
+    {
+        track = pStream->heap[0];
+        pStream->heap[0] = pStream->heap[--pStream->heapCount];
+        PV_EventStreamSiftDown(pStream, 0);
+        if ((short int)track > afterTrack)
+        {
+            for (index = dueCount++; (index > 0) && (pDue[index - 1] > track); index--)
+            {
+                pDue[index] = pDue[index - 1];
+            }
+            pDue[index] = track;
+        }
+        else
+        {
+            skipped[skipCount++] = track; // already passed over this slice
+        }
+    }
+    while (skipCount)
+    {
+        PV_EventStreamPush(pStream, skipped[--skipCount]);
+    }
+    return dueCount;
+}
+
+// Write the stream position back into GM_Song->ptrack, trackticks and trackon, as they would
+// be had the raw sequencer been running and reached currentTrack in this slice.
+static void PV_ExportEventStream(GM_Song *pSong, short int currentTrack)
+{
+    GM_EventStream *pStream;
+    short int track;
+
+    pStream = (GM_EventStream *)pSong->eventStream;
+    for (track = 0; track < MAX_TRACKS; track++)
+    {
+        if ((pSong->ptrack[track] == NULL) || (pSong->trackon[track] == TRACK_OFF))
+        {
+            continue;
+        }
+        if ((track > currentTrack) && pStream->fresh[track])
+        {
+            // not started yet, trackon is still TRACK_FREE
+            pSong->trackticks[track] = (IFLOAT)(pStream->bias[track] - pStream->clock);
+            continue;
+        }
+        if (track == currentTrack)
+        {
+            // the raw sequencer only stores the track pointer once it's done with the track
+            pSong->ptrack[track] = (pStream->fresh[track]) ? pStream->trackStart[track] :
+                pStream->trackStart[track] + pStream->pEvents[pStream->currentStart].offset;
+        }
+        else
+        {
+            pSong->ptrack[track] = pStream->trackStart[track] + pStream->pEvents[pStream->cursor[track]].offset;
+        }
+        pSong->trackticks[track] = (IFLOAT)(PV_STREAM_DUE(pStream, track) - pStream->clock);
+        if (track > currentTrack)
+        {
+            pSong->trackticks[track] += (IFLOAT)pStream->division; // not counted down yet
+        }
+        pSong->trackon[track] = TRACK_RUNNING;
+    }
+}
+
+// Point the stream cursors at the raw track positions, compiling the tracks first if needed.
+// Called at the start of a slice, after the raw sequencer would have advanced CurrentMidiClock.
+// Returns FALSE if the raw state can't be represented by the compiled events.
+static XBOOL PV_SyncEventStream(GM_Song *pSong)
+{
+    GM_EventStream *pStream;
+    GM_SeqEvent *pEvent;
+    XDWORD low, high, middle, offset;
+    short int track;
+
+    pStream = (GM_EventStream *)pSong->eventStream;
+    if (pStream)
+    {
+        for (track = 0; track < MAX_TRACKS; track++)
+        {
+            if ((pStream->trackStart[track] != pSong->trackstart[track]) ||
+                (pStream->trackLength[track] != pSong->tracklen[track]))
+            {
+                PV_FreeEventStream(pSong);
+                pStream = NULL;
+                break;
+            }
+        }
+    }
+    if (pStream == NULL)
+    {
+        pStream = PV_CompileEventStream(pSong);
+        pSong->eventStream = pStream;
+    }
+    if ((pStream == NULL) || (pStream->usable == FALSE))
+    {
+        return FALSE;
+    }
+
+    pStream->clock = (IFLOAT)pSong->MIDIDivision;
+    pStream->division = pSong->MIDIDivision;
+    pStream->heapCount = 0;
+    pStream->aliveCount = 0;
+    pStream->anyFresh = FALSE;
+    pStream->currentTrack = MAX_TRACKS;
+    for (track = 0; track < MAX_TRACKS; track++)
+    {
+        pStream->fresh[track] = FALSE;
+        if ((pSong->ptrack[track] == NULL) || (pSong->trackon[track] == TRACK_OFF))
+        {
+            continue;
+        }
+        if (pSong->trackstart[track] == NULL)
+        {
+            return FALSE;
+        }
+        if (pSong->trackon[track] == TRACK_FREE)
+        {
+            if (pSong->ptrack[track] != pSong->trackstart[track])
+            {
+                return FALSE;
+            }
+            // starts this slice. Its first delta time isn't counted down until the next one
+            pStream->cursor[track] = pStream->firstEvent[track];
+            pStream->bias[track] = pSong->trackticks[track] + pStream->clock;
+            pStream->fresh[track] = TRUE;
+            pStream->anyFresh = TRUE;
+        }
+        else
+        {
+            // find the event the track is parked on
+            offset = (XDWORD)(pSong->ptrack[track] - pSong->trackstart[track]);
+            low = pStream->firstEvent[track];
+            high = pStream->endEvent[track];
+            while (low < high)
+            {
+                middle = low + (high - low) / 2;
+                if (pStream->pEvents[middle].offset < offset)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            if ((low >= pStream->endEvent[track]) || (pStream->pEvents[low].offset != offset))
+            {
+                return FALSE;
+            }
+            pStream->cursor[track] = low;
+            pStream->bias[track] = (pSong->trackticks[track] - (IFLOAT)pSong->MIDIDivision) +
+                pStream->clock - pStream->pEvents[low].tick;
+
+            // events compiled with running status must resolve the same way now
+            for (pEvent = &pStream->pEvents[low]; pEvent < &pStream->pEvents[pStream->endEvent[track]]; pEvent++)
+            {
+                if ((pEvent->status != 0xFF) || (pEvent->flags & SEQ_EVENT_END))
+                {
+                    if (((pEvent->flags & (SEQ_EVENT_STATUS | SEQ_EVENT_END)) == 0) &&
+                        (pEvent->status != pSong->runningStatus[track]))
+                    {
+                        return FALSE;
+                    }
+                    break;
+                }
+            }
+        }
+        pStream->aliveCount++;
+        PV_EventStreamPush(pStream, (XBYTE)track);
+    }
+    return TRUE;
+}
+
+// Process the meta event at midi_stream, which points just past the 0xFF. Returns the position
+// of the following delta time. *pTrackEnded is set at the end of the track and *pReloop when a
+// loop end marker wants the tracks restarted at the end of this slice.
+static XBYTE *PV_ProcessMetaEvent(void *threadContext, GM_Song *pSong, short int currentTrack,
+                                  XBYTE *midi_stream, XBOOL *pTrackEnded, XBOOL *pReloop)
+{
+    XBYTE *temp_midi_stream;
+    XBYTE midi_byte;
+    XDWORD value;
+
+    *pTrackEnded = FALSE;
+    midi_byte = *midi_stream++;
+    switch (midi_byte)
+    {
+    default:
+        //      if (pSong->AnalyzeMode == SCAN_NORMAL)
+        //          printf("Meta event 0x%x, ignored\n", midi_byte);
+        break;
+    // Set MIDI Tempo:
+    case 0x51:
+        value = midi_stream[1] << 8;
+        value |= midi_stream[2];
+        value = value << 8;
+        value |= midi_stream[3];
+        GM_SetSongTempo(pSong, value);
+        //      if (pSong->AnalyzeMode == SCAN_NORMAL)
+        //          printf("Tempo, microseconds-per-MIDI-quarter-note %ld\n", value);
+        break;
+
+#if 0
+        // Set Time Signature:
+        case 0x58:
+            pSong->TSNumerator = midi_stream[1];
+            pSong->TSDenominator = midi_stream[2];
+            break;
+#endif
+    // generic text event
+    case 0x01:
+    // copyright event
+    case 0x02:
+    // track name
+    case 0x03:
+    // instrument name
+    case 0x04:
+    // Lyric event
+    case 0x05:
+#if SUPPORT_KARAOKE
+        // Karaoke is not in sync when played back at 1x speed
+        // Needs more work
+        /* ORIGINAL BUGFIX (2025-08-16):
+           Previous implementation wrote a '\0' terminator directly into the
+           MIDI stream (temp_midi_stream[value] = '\0'). This mutated the next
+           byte after the lyric text – potentially a delta-time or status byte –
+           corrupting the track and causing incorrect duration calculations for
+           some files containing lyric meta events. We now avoid modifying the
+           underlying MIDI data. If a C-string is desired by the callback, we
+           provide a temporary copy.
+        */
+        temp_midi_stream = midi_stream;
+        value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
+        {
+            void *metaPtr = (void *)temp_midi_stream; // start of lyric text
+            void *cbPtr = metaPtr;
+            char *allocated = NULL;
+            if (value > 0)
+            {
+                allocated = (char *)XNewTaggedPtr((int32_t)value + 1, X_MEMORY_SONGS);
+                if (allocated)
+                {
+                    XBlockMove(metaPtr, allocated, value);
+                    allocated[value] = '\0';
+                    cbPtr = allocated; // pass copy
+                }
+            }
+            PV_CallSongMetaEventCallback(threadContext, pSong, midi_byte, cbPtr, value, (int16_t)currentTrack);
+            if (pSong->lyricCallbackPtr)
+            {
+                XBOOL invoke = FALSE;
+                const char *lyricStr = (const char *)cbPtr; /* NUL terminated */
+                if (midi_byte == 0x05 && !pSong->seenGenericTextLyric)
+                {
+                    pSong->seenTrueLyric = TRUE;
+                    pSong->seenLyricMeta = TRUE;
+                    if (lyricStr && lyricStr[0] && lyricStr[0] == '\r')
                     {
-                        GM_SF2_ProcessSysEx(pSong, syx, (int32_t)sendLen);
+                        /* Translate Carrage Return to newline by sending empty lyric */
+                        pSong->lyricsHaveNewlines = TRUE;
+                        uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
+                        char empty[1] = {'\0'};
+                        pSong->lyricCallbackPtr(pSong, empty, lyrTimeUs, pSong->lyricCallbackReference);
+                    }
+                    else
+                    {
+                        invoke = TRUE; /* real lyric */
+                    }
+                }
+                else if (midi_byte == 0x01 && !pSong->seenLyricMeta)
+                {
+                    /* Follow negated form: do NOT treat GenericText starting with '@' as lyric content. */
+                    if (lyricStr && lyricStr[0] == '@')
+                    {
+                        /* Control/reset: translate to newline by sending empty lyric */
+                        uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
+                        char empty[1] = {'\0'};
+                        pSong->lyricsHaveNewlines = TRUE;
+                        pSong->lyricCallbackPtr(pSong, empty, lyrTimeUs, pSong->lyricCallbackReference);
+                    }
+                    else if (lyricStr && lyricStr[0] == '\\')
+                    {
+                        /* Generic text lyrics with \\ prefix - set flags and process */
+                        pSong->seenGenericTextLyric = TRUE;
+                        pSong->seenTrueLyric = TRUE;
+                        invoke = TRUE;
+                    }
+                    else if (!pSong->seenGenericTextLyric)
+                    {
+                        /* Only process plain 0x01 events before any \\ prefix is seen,
+                           to avoid duplicates when both 0x05 and 0x01 events exist */
+                        invoke = FALSE;
+                    }
+                    else
+                    {
+                        /* After \\ prefix seen, continue processing 0x01 events */
+                        invoke = TRUE;
+                    }
+                }
+                if (invoke && lyricStr && lyricStr[0])
+                {
+                    uint32_t lyrTimeUs = (uint32_t)pSong->songMicroseconds;
+                    
+                    // Deduplicate: skip if this exact lyric was just sent at the same timestamp
+                    // (Some MIDI files have duplicate lyric events written consecutively)
+                    size_t lyricLen = strlen(lyricStr);
+                    XBOOL isDuplicate = FALSE;
+                    if (lyricLen < sizeof(pSong->lastLyric) &&
+                        pSong->lastLyricTimestamp == lyrTimeUs &&
+                        strcmp(pSong->lastLyric, lyricStr) == 0)
+                    {
+                        isDuplicate = TRUE;
+                    }
+                    
+                    if (!isDuplicate)
+                    {
+
+                        // Timing-based lyric line breaks
+                        XDWORD currentTime = lyrTimeUs;
+                        XBOOL insertLineBreak = (pSong->lastLyricTimeUs != 0) &&
+                                                ((currentTime - pSong->lastLyricTimeUs) > pSong->lyricLineBreakThreshold) &&
+                                                !pSong->lyricsHaveNewlines;
+
+                        // Word wrapping: break line if adding this word would exceed 128 characters
+                        size_t wordLen = strlen(lyricStr);
+                        XBOOL forceBreak = FALSE;
+                        if (pSong->currentLineLength + wordLen > 64 && !pSong->lyricsHaveNewlines)
+                        {
+                            forceBreak = TRUE;
+                        }
+
+                        if (insertLineBreak || forceBreak)
+                        {
+                            // Prepend newline to indicate line break
+                            pSong->lyricCallbackPtr(pSong, "\0", lyrTimeUs, pSong->lyricCallbackReference);
+                            pSong->lyricCallbackPtr(pSong, lyricStr, lyrTimeUs, pSong->lyricCallbackReference);
+                            pSong->currentLineLength = wordLen;
+                        }
+                        else
+                        {
+                            pSong->lyricCallbackPtr(pSong, lyricStr, lyrTimeUs, pSong->lyricCallbackReference);
+                            pSong->currentLineLength += wordLen;
+                        }
+
+                        // Update timing
+                        pSong->lastLyricTimeUs = currentTime;
+
+                        // Store this lyric for duplicate detection
+                        if (lyricLen < sizeof(pSong->lastLyric))
+                        {
+                            strcpy(pSong->lastLyric, lyricStr);
+                            pSong->lastLyricTimestamp = lyrTimeUs;
+                        }
                     }
+                }
+            }
+            // Free allocated buffer AFTER all callbacks complete
+            if (allocated)
+            {
+                XDisposePtr((XPTR)allocated);
+            }
+        }
+        //                  BAE_PRINTF("lyric event: %s\n", (char *)cbPtr);
+        break;
 #endif
+    // Cue point event
+    case 0x07:
+    // program name
+    case 0x08:
+    // port name
+    case 0x09:
+    // Marker event
+    case 0x06:
+        temp_midi_stream = midi_stream;
+        value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
+        // there might be a problem here. need to relook into this.
+        // maybe we should only do these callbacks during NORMAL_SCAN??
+        PV_CallSongMetaEventCallback(threadContext, pSong, midi_byte, (void *)temp_midi_stream, value, (short)currentTrack);
+
+        if (midi_byte == 0x06)
+        {
+            if ((pSong->eventStreamState == EVENT_STREAM_SYNCED) && (pSong->loopbackSaved == FALSE))
+            {
+                // a loop start saves the raw track positions, so bring them up to date first
+                PV_ExportEventStream(pSong, currentTrack);
+            }
+            if (PV_ProcessMetaMarkerEvents(pSong, (char *)temp_midi_stream, value))
+            {
+                *pReloop = TRUE; // this will finish up these tracks, then restart
+            }
+        }
+
+        //  if (pSong->AnalyzeMode == SCAN_NORMAL)
+        //      printf("Meta event 0x%x length %ld\n", midi_byte, value);
+        break;
+
+    // Sequencer specific event (The heart of eMidi)
+    case 0x7F:
+        temp_midi_stream = midi_stream;
+        value = PV_ReadVariableLengthMidi(&temp_midi_stream); // get length
+        midi_stream = temp_midi_stream;
+        //  if (pSong->AnalyzeMode == SCAN_NORMAL)
+        //  {
+        //      printf("Meta event 0x7F length %ld\n", value);
+        //      BAE_PrintHexDump(midi_stream, (value < 32) ? value : 32);
+        //  }
+#if SUPPORT_IGOR_FEATURE
+        if (midi_stream[0] == 0x00) // IGOR sysex ID
+        {
+            if (midi_stream[1] == 0x01)
+            {
+                if (midi_stream[2] == 0x0D)
+                {
+                    PV_ProcessIgorMeta(pSong, midi_stream + 3);
                 }
-                midi_stream += value; // skip sysex
+            }
+        }
+#endif
+        return midi_stream + value; // skip meta
+
+    // End-of-track:
+    case 0x2F:
+        //      if (pSong->AnalyzeMode == SCAN_NORMAL)
+        //          printf("End of track %ld\n", (long)currentTrack);
+        *pTrackEnded = TRUE;
+        return midi_stream;
+    }
+    // skip meta
+    temp_midi_stream = midi_stream;
+    value = PV_ReadVariableLengthMidi(&temp_midi_stream);
+    return temp_midi_stream + value;
+}
+
+// Process a system exclusive event. midi_stream points just past the status byte. Returns the
+// position of the following delta time.
+static XBYTE *PV_ProcessSysExEvent(void *threadContext, GM_Song *pSong, XBYTE midi_byte, XBYTE *midi_stream)
+{
+    XBYTE *temp_midi_stream;
+    XDWORD value;
+
+    temp_midi_stream = midi_stream;
+    value = PV_ReadVariableLengthMidi(&temp_midi_stream);
+    midi_stream = temp_midi_stream;
+    //      if (pSong->AnalyzeMode == SCAN_NORMAL)
+    //      {
+    //          printf("sysex 0x%x length %ld\n", midi_byte, value);
+    //          BAE_PrintHexDump(midi_stream, (value < 32) ? value : 32);
+    //      }
+    // For sysex, pass the full sysex message (0xF0 ... data ... 0xF7)
+    if (midi_byte == 0xF0 && value > 0)
+    {
+        // Build a simple buffer on stack if size reasonable
+        int sendLen = (int)value + 1;                          // include initial 0xF0
+        unsigned char *syx = (unsigned char *)midi_stream - 1; // points to 0xF0
+        PV_CallMidiEventCallback(threadContext, pSong, syx, sendLen);
+
+#if USE_SF2_SUPPORT == TRUE
+        // FluidSynth CLI applies SysEx from MIDI files (GM reset, MTS tuning, etc.).
+        // Forward SysEx during SF2 playback so synthesis matches.
+        if (GM_IsSF2Song(pSong) || GM_SF2_HasXmfEmbeddedBank())
+        {
+            GM_SF2_ProcessSysEx(pSong, syx, (int32_t)sendLen);
+        }
+#endif
+    }
+    return midi_stream + value; // skip sysex
+}
+
+// Process a channel voice message for currentTrack. data2 is unused for program change and
+// channel pressure.
+static void PV_ProcessChannelEvent(void *threadContext, GM_Song *pSong, short int currentTrack,
+                                   XBYTE midi_byte, XBYTE data1, XBYTE data2)
+{
+    XSWORD MIDIChannel;
+    unsigned char msg[3];
+
+    MIDIChannel = midi_byte & 0xF;
+    msg[0] = midi_byte;
+    msg[1] = data1;
+    msg[2] = data2;
+    switch (midi_byte & 0xF0) // process commands
+    {
+    case 0x90: // Note On
+        PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
+        PV_ProcessNoteOn(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)data1, (XSWORD)data2);
+        break;
+    case 0x80: // Note Off
+        PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
+        PV_ProcessNoteOff(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)data1, (XSWORD)data2);
+        break;
+    case 0xB0: // Control Change
+        PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
+        PV_ProcessController(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)data1, (XSWORD)data2);
+
+        if (pSong->AnalyzeMode == SCAN_NORMAL)
+        {
+            PV_CallControlCallbacks(threadContext, pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)data1, (XSWORD)data2);
+        }
+        break;
+    case 0xC0: // ProgramChange
+        PV_CallMidiEventCallback(threadContext, pSong, msg, 2);
+        PV_ProcessProgramChange(pSong, MIDIChannel, (XSWORD)currentTrack, (XSWORD)data1);
+        break;
+    case 0xE0: // SetPitchBend
+        PV_CallMidiEventCallback(threadContext, pSong, msg, 3);
+        PV_ProcessPitchBend(pSong, MIDIChannel, (XSWORD)currentTrack, data2, data1);
+        break;
+    case 0xA0: // Key Pressure
+    case 0xD0: // ChannelPressure
+        break;
+    }
+}
+
+// Play the events of one track that are due this slice from the compiled stream
+static void PV_ProcessEventStreamTrack(void *threadContext, GM_Song *pSong, GM_EventStream *pStream,
+                                       short int currentTrack, XBOOL *pReloop)
+{
+    GM_SeqEvent *pEvent;
+    XBYTE *pTrack;
+    XBOOL trackEnded;
+
+    if (pSong->trackon[currentTrack] == TRACK_FREE) // first time
+    {
+        pSong->trackon[currentTrack] = TRACK_RUNNING;
+    }
+    pStream->currentTrack = currentTrack;
+    pStream->currentStart = pStream->cursor[currentTrack];
+    pTrack = pStream->trackStart[currentTrack];
+    trackEnded = FALSE;
+    while (PV_STREAM_DUE(pStream, currentTrack) < pStream->clock)
+    {
+        pEvent = &pStream->pEvents[pStream->cursor[currentTrack]];
+        if (pEvent->flags & SEQ_EVENT_END)
+        {
+            // the track has ended unexpectedly.
+            trackEnded = TRUE;
+        }
+        else if (pEvent->status == 0xFF)
+        {
+            PV_ProcessMetaEvent(threadContext, pSong, currentTrack, pTrack + pEvent->offset + 1, &trackEnded, pReloop);
+        }
+        else
+        {
+            if (pEvent->flags & SEQ_EVENT_STATUS)
+            {
+                pSong->runningStatus[currentTrack] = pEvent->status;
+            }
+            if ((pEvent->status & 0xF0) == 0xF0)
+            {
+                PV_ProcessSysExEvent(threadContext, pSong, pEvent->status,
+                                     pTrack + pEvent->offset + ((pEvent->flags & SEQ_EVENT_STATUS) ? 1 : 0));
+            }
+            else
+            {
+                PV_ProcessChannelEvent(threadContext, pSong, currentTrack, pEvent->status, pEvent->data1, pEvent->data2);
+            }
+        }
+        if (trackEnded)
+        {
+            break;
+        }
+        pStream->cursor[currentTrack]++;
+    }
+    pStream->currentTrack = MAX_TRACKS;
+    if (trackEnded)
+    {
+        pSong->trackon[currentTrack] = TRACK_OFF;
+        pStream->aliveCount--;
+    }
+    else
+    {
+        PV_EventStreamPush(pStream, (XBYTE)currentTrack);
+    }
+}
+
+// Sequence one slice from the compiled stream. pStream->clock has already been advanced.
+static void PV_ProcessEventStreamSlice(void *threadContext, GM_Song *pSong, XBOOL *pReloop)
+{
+    GM_EventStream *pStream;
+    XBYTE due[MAX_TRACKS];
+    short int dueCount, index, track, currentTrack;
+    GM_SeqClock change;
+
+    pStream = (GM_EventStream *)pSong->eventStream;
+    pSong->SomeTrackIsAlive = (pStream->aliveCount > 0);
+    pStream->division = pSong->MIDIDivision;
+    dueCount = PV_EventStreamPopDue(pStream, -1, due);
+    for (index = 0; index < dueCount; index++)
+    {
+        currentTrack = due[index];
+        PV_ProcessEventStreamTrack(threadContext, pSong, pStream, currentTrack, pReloop);
+        if (pSong->MIDIDivision != pStream->division)
+        {
+            // The tempo changed part way through the slice. The raw sequencer counts down
+            // each track as it reaches it, so the tracks after this one use the new division
+            // this slice while the earlier ones used the old.
+            change = (GM_SeqClock)(IFLOAT)pSong->MIDIDivision - (GM_SeqClock)(IFLOAT)pStream->division;
+            pStream->division = pSong->MIDIDivision;
+            while (++index < dueCount)
+            {
+                PV_EventStreamPush(pStream, due[index]);
+            }
+            for (index = 0; index < pStream->heapCount; index++)
+            {
+                track = pStream->heap[index];
+                if ((track > currentTrack) && (pStream->fresh[track] == FALSE))
+                {
+                    pStream->bias[track] -= change;
+                }
+            }
+            for (index = (short int)(pStream->heapCount / 2 - 1); index >= 0; index--)
+            {
+                PV_EventStreamSiftDown(pStream, index);
+            }
+            dueCount = PV_EventStreamPopDue(pStream, currentTrack, due);
+            index = -1;
+        }
+    }
+    if (pStream->anyFresh)
+    {
+        // tracks that were started this slice are running now, whether or not they played
+        for (track = 0; track < MAX_TRACKS; track++)
+        {
+            if (pStream->fresh[track])
+            {
+                pStream->fresh[track] = FALSE;
+                if (pSong->trackon[track] == TRACK_FREE)
+                {
+                    pSong->trackon[track] = TRACK_RUNNING;
+                }
+            }
+        }
+        pStream->anyFresh = FALSE;
+    }
+}
+
+// Walk through the midi stream and process midi events for one slice of time.
+OPErr PV_ProcessMidiSequencerSlice(void *threadContext, GM_Song *pSong)
+{
+    register LOOPCOUNT currentTrack;
+    register XBYTE midi_byte;
+    register XDWORD value;
+    register XBYTE *midi_stream;
+    register XBYTE valueLSB, valueMSB;
+    XBYTE *temp_midi_stream;
+    OPErr theErr;
+    XBOOL reloopTracks;
+    XBOOL trackEnded;
+    XBOOL songDone;
+
+    theErr = NO_ERR;
+
+    // Song not loaded, bail
+    if (pSong == NULL)
+    {
+        return NO_SONG_PLAYING;
+    }
+    pSong->SomeTrackIsAlive = FALSE;
+    pSong->processingSlice = TRUE;
+
+    pSong->CurrentMidiClock += pSong->MIDIDivision;
+
+    // 1 000 000 / 22050 * 256
+    //  1 second / sample rate * samples
+    pSong->songMicroseconds += (UFLOAT)BAE_GetSliceTimeInMicroseconds();
+    reloopTracks = FALSE;
+
+    // normal playback runs from the compiled event stream. Analysis scans walk the raw tracks.
+    if (pSong->eventStreamState == EVENT_STREAM_SYNCED)
+    {
+        if (pSong->AnalyzeMode == SCAN_NORMAL)
+        {
+            ((GM_EventStream *)pSong->eventStream)->clock += (IFLOAT)pSong->MIDIDivision;
+        }
+        else
+        {
+            PV_ExportEventStream(pSong, MAX_TRACKS);
+            pSong->eventStreamState = EVENT_STREAM_UNSYNCED;
+        }
+    }
+    else if ((pSong->eventStreamState == EVENT_STREAM_UNSYNCED) && (pSong->AnalyzeMode == SCAN_NORMAL))
+    {
+        pSong->eventStreamState = (PV_SyncEventStream(pSong)) ? EVENT_STREAM_SYNCED : EVENT_STREAM_RAW;
+    }
+
+    if (pSong->eventStreamState == EVENT_STREAM_SYNCED)
+    {
+        PV_ProcessEventStreamSlice(threadContext, pSong, &reloopTracks);
+        songDone = (((GM_EventStream *)pSong->eventStream)->aliveCount == 0);
+        goto SliceDone;
+    }
+
+    for (currentTrack = 0; currentTrack < MAX_TRACKS; currentTrack++)
+    {
+        midi_stream = pSong->ptrack[currentTrack];
+        if (midi_stream == NULL)
+        {
+            goto ServeNextTrack;
+        }
+        if (pSong->trackon[currentTrack] != TRACK_OFF)
+        {
+            pSong->SomeTrackIsAlive = TRUE;
+            if (pSong->trackon[currentTrack] == TRACK_FREE) // first time
+            {
+                pSong->trackon[currentTrack] = TRACK_RUNNING; // running
+                goto UpdateDeltaTime;
+            }
+            pSong->trackticks[currentTrack] -= (IFLOAT)pSong->MIDIDivision;
+        Do_GetEvent:
+            if (pSong->trackticks[currentTrack] < (IFLOAT)0)
+            {
+                /* 64-bit safe bounds check: ensure we don't truncate pointer difference */
+                {
+                    size_t __offset = (size_t)(midi_stream - pSong->trackstart[currentTrack]);
+                    if (__offset > (size_t)pSong->tracklen[currentTrack])
+                    {
+                        // the track has ended unexpectedly.
+                        // just fall through and assume things are cool and go to the next track
+                        pSong->trackon[currentTrack] = TRACK_OFF;
+                        goto ServeNextTrack;
+                    }
+                }
+                goto GetMIDIevent;
+            }
+            if (pSong->trackticks[currentTrack] >= (IFLOAT)0)
+            {
+                goto ServeNextTrack;
+            }
+        UpdateDeltaTime:
+            temp_midi_stream = midi_stream;
+            value = PV_ReadVariableLengthMidi(&temp_midi_stream);
+            midi_stream = temp_midi_stream;
+            pSong->trackticks[currentTrack] += (IFLOAT)(value << 6);
+            //          pSong->trackcumuticks[currentTrack] += value;
+            //          printf("track %ld, time %ld\n", (long)currentTrack, (long)pSong->trackticks[currentTrack]);
+            goto Do_GetEvent;
+        }
+        goto ServeNextTrack;
+    GetMIDIevent:
+        midi_byte = *midi_stream++;
+        if (midi_byte == 0xFF)
+        {
+            /* Meta Event
+             */
+            midi_stream = PV_ProcessMetaEvent(threadContext, pSong, (short int)currentTrack, midi_stream,
+                                              &trackEnded, &reloopTracks);
+            if (trackEnded)
+            {
+                pSong->trackon[currentTrack] = TRACK_OFF;
+                goto ServeNextTrack;
+            }
+            goto UpdateDeltaTime;
+        }
+        else
+        {
+            if ((midi_byte & 0x80) == 0) /* running status? */
+            {
+                --midi_stream;
+                midi_byte = pSong->runningStatus[currentTrack];
+            }
+            else
+            {
+                pSong->runningStatus[currentTrack] = midi_byte;
+                if (midi_byte == 0) /* 0 = null event. */
+                {
+                    goto GetMIDIevent;
+                }
+            }
+            switch (midi_byte & 0xF0) // process commands
+            {
+            case 0x90: // Note On
+            case 0x80: // Note Off
+            case 0xB0: // Control Change
+            case 0xE0: // SetPitchBend
+            case 0xA0: // Key Pressure
+                valueLSB = *midi_stream++;
+                valueMSB = *midi_stream++;
+                PV_ProcessChannelEvent(threadContext, pSong, (short int)currentTrack, midi_byte, valueLSB, valueMSB);
+                break;
+            case 0xC0: // ProgramChange
+            case 0xD0: // ChannelPressure
+                valueLSB = *midi_stream++;
+                PV_ProcessChannelEvent(threadContext, pSong, (short int)currentTrack, midi_byte, valueLSB, 0);
+                break;
+            case 0xF0: // System Exclusive
+                midi_stream = PV_ProcessSysExEvent(threadContext, pSong, midi_byte, midi_stream);
                 break;
             } /* end switch */
             /* Not Meta Event. */
             goto UpdateDeltaTime;
         }
-        // THE COMPILER WARNS THAT WE CAN'T GET HERE.
-        // WHAT DO YOU THINK STEVE?
-    //      goto ServeNextTrack;
-    // I HATE THIS CODE!!! This needs to be reworked. SH
-    SkipMeta:
-        temp_midi_stream = midi_stream;
-        value = PV_ReadVariableLengthMidi(&temp_midi_stream);
-        midi_stream = temp_midi_stream;
-        midi_stream += value; // skip meta
-        goto UpdateDeltaTime;
     ServeNextTrack:
         pSong->ptrack[currentTrack] = midi_stream;
 
@@ -4262,7 +4869,9 @@ OPErr PV_ProcessMidiSequencerSlice(void *threadContext, GM_Song *pSong)
             }
         }
     }
+    songDone = GM_IsSongDone(pSong);
 
+SliceDone:
     if (pSong->AnalyzeMode == SCAN_NORMAL) // song finished?
     {
         if (pSong->songTimeCallbackPtr)
@@ -4287,15 +4896,20 @@ OPErr PV_ProcessMidiSequencerSlice(void *threadContext, GM_Song *pSong)
             pSong->CurrentMidiClock = pSong->currentMidiClockSave;
             pSong->songMicroseconds = pSong->songMicrosecondsSave;
             pSong->CurrentMidiClock -= pSong->MIDIDivision;
+            if (pSong->eventStreamState == EVENT_STREAM_SYNCED)
+            {
+                pSong->eventStreamState = EVENT_STREAM_UNSYNCED; // pick up the restored positions
+            }
 
             // 1 000 000 / 22050 * 256
             //  1 second / sample rate * samples
             pSong->songMicroseconds -= (UFLOAT)BAE_GetSliceTimeInMicroseconds();
             GM_KillSongNotes(pSong); // go ahead and stop all notes currently playing. This will insure that
                                      // there are no hanging notes at loop restart
+            songDone = GM_IsSongDone(pSong);
         }
 
-        if ((reloopTracks == FALSE) && (GM_IsSongDone(pSong)))
+        if ((reloopTracks == FALSE) && songDone)
         {
             if (pSong->songFinished == FALSE)
             {
@@ -4341,6 +4955,10 @@ OPErr PV_ProcessMidiSequencerSlice(void *threadContext, GM_Song *pSong)
             }
         }
     }
+    else if ((pSong->AnalyzeMode == SCAN_DETERMINE_LENGTH) && pSong->seekIndex)
+    {
+        PV_RecordSeekCheckpoint(pSong);
+    }
     pSong->processingSlice = FALSE;
     return theErr;
 }
@@ -4359,19 +4977,21 @@ void PV_ProcessSequencerEvents(void *threadContext)
         { // if enabled, this will fix the drift of real time with our synth time. This
             // is used only when real time midi data, that is being time stamped with
             // XMicroseconds is enabled
-            long drift;
+            int64_t drift;
+            uint64_t now;
 
-            drift = (long)XMicroseconds() - (long)pMixer->syncCount;
+            now = XMicroseconds64();
+            drift = (int64_t)(now - pMixer->syncCount);
             if (drift > 1000) // if drift more than 1 ms reset
             {
-                pMixer->syncCount = XMicroseconds();
+                pMixer->syncCount = now;
                 pMixer->syncBufferCount = 0;
             }
         }
 
         if (pMixer->sequencerPaused == FALSE)
         {
-            for (count = 0; count < MAX_SONGS; count++)
+            for (count = 0; count < pMixer->songSlotCount; count++)
             {
                 pSong = pMixer->pSongsToPlay[count];
                 if (pSong)
@@ -4451,7 +5071,7 @@ void GM_MuteChannel(GM_Song *pSong, short int channel)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4480,7 +5100,7 @@ void GM_UnmuteChannel(GM_Song *pSong, short int channel)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4517,7 +5137,7 @@ void GM_GetChannelMuteStatus(GM_Song *pSong, char *pStatus)
             }
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4558,7 +5178,7 @@ void GM_SoloChannel(GM_Song *pSong, short int channel)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4614,7 +5234,7 @@ void GM_UnsoloChannel(GM_Song *pSong, short int channel)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4651,7 +5271,7 @@ void GM_GetChannelSoloStatus(GM_Song *pSong, char *pStatus)
             }
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4721,7 +5341,7 @@ void GM_MuteTrack(GM_Song *pSong, short int track)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4750,7 +5370,7 @@ void GM_UnmuteTrack(GM_Song *pSong, short int track)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4786,7 +5406,7 @@ void GM_GetTrackMuteStatus(GM_Song *pSong, char *pStatus)
             }
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4831,7 +5451,7 @@ void GM_SoloTrack(GM_Song *pSong, short int track)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4888,7 +5508,7 @@ void GM_UnsoloTrack(GM_Song *pSong, short int track)
         {
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
@@ -4925,7 +5545,7 @@ void GM_GetTrackSoloStatus(GM_Song *pSong, char *pStatus)
             }
             if (pMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
+                for (count = 0; count < pMixer->songSlotCount; count++)
                 {
                     pSong = pMixer->pSongsToPlay[count];
                     if (pSong)
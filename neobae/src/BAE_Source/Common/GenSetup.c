@@ -412,7 +412,7 @@ void GM_SetMasterVolume(INT32 theVolume)
             GM_SetEffectsVolume(GM_GetEffectsVolume());
 
             // walk through songs and reset volumes
-            for (count = 0; count < MAX_SONGS; count++)
+            for (count = 0; count < MusicGlobals->songSlotCount; count++)
             {
                 pSong = MusicGlobals->pSongsToPlay[count];
                 if (pSong)
@@ -611,6 +611,14 @@ OPErr GM_InitGeneralSound(void *threadContext, Rate theRate, TerpMode theTerp, A
                 pMixer->NoteEntry[count].voiceMode = VOICE_UNUSED;
             }
             pMixer->interpolationMode = theTerp;
+
+            pMixer->maxSongs = MAX_SONGS;
+            pMixer->pSongsToPlay = (GM_Song **)XNewPtr((int32_t)(sizeof(GM_Song *) * MAX_SONGS));
+            pMixer->pFreeSongSlots = (XSWORD *)XNewPtr((int32_t)(sizeof(XSWORD) * MAX_SONGS));
+            if ((pMixer->pSongsToPlay == NULL) || (pMixer->pFreeSongSlots == NULL))
+            {
+                theErr = MEMORY_ERR;
+            }
         
             pMixer->MasterVolume = MAX_MASTER_VOLUME;
             pMixer->globalVolume = MAX_MASTER_VOLUME;
@@ -698,13 +706,25 @@ OPErr GM_InitGeneralSound(void *threadContext, Rate theRate, TerpMode theTerp, A
     {
         pMixer->insideAudioInterrupt = 0;
         pMixer->enableDriftFixer = TRUE;    // always fix drift for realtime vs parsed events.
-        pMixer->syncCount = XMicroseconds();
+        pMixer->syncCount = XMicroseconds64();
         pMixer->samplesPlayed = 0;
         pMixer->samplesWritten = 0;
         pMixer->lastSamplePosition = 0;
         pMixer->sequencerPaused = TRUE;
         pMixer->systemPaused = TRUE;
         BAE_NewMutex(&pMixer->queueLock, "bae", "seqq", __LINE__);
+        if (BAE_NewMutex(&pMixer->streamDecoderLock, "bae", "sdlk", __LINE__) == 0)
+        {
+            pMixer->streamDecoderLock = NULL;   // no read ahead then, see GM_SetStreamReadAhead
+        }
+        XInitMemoryTagLock();
+        XInitFileMappingLock();
+        GMCache_InitSharedSamplePool();
+        GMCache_InitSampleCacheLock();
+        PV_InitInstrumentLoadLock();
+        pMixer->sampleCacheIdleHead = NULL;
+        pMixer->sampleCacheIdleTail = NULL;
+        XSetMemory(&pMixer->sampleCacheStats, (int32_t)sizeof(GM_SampleCacheStats), 0);
         PV_CleanExternalQueue(pMixer);
 
         // calculate sample size for conversion of bytes to sample frames
@@ -819,6 +839,10 @@ OPErr GM_ChangeAudioModes(void *threadContext,
             pMixer->stereoFilter = ( (pMixer->generateStereoOutput) &&
                                                  ((theMods & M_STEREO_FILTER) == M_STEREO_FILTER) ) ? TRUE : FALSE;
 
+            // set control loops. Before the reverb setup, which sizes
+            // itself from the new rate and slice.
+            PV_SetSampleSliceSize(pMixer, theRate);
+
 #if REVERB_USED != REVERB_DISABLED
             verb = GM_GetReverbType();  // preserve current
             if ( (theMods & M_DISABLE_REVERB) == M_DISABLE_REVERB)
@@ -833,9 +857,6 @@ OPErr GM_ChangeAudioModes(void *threadContext,
             GM_SetReverbType(verb);     // restore verb
 #endif
 
-            // set control loops
-            PV_SetSampleSliceSize(pMixer, theRate);
-
 #if LOOPS_USED != LIMITED_LOOPS
             // if we've changed terp modes translate the all the active voices
             // sample position
@@ -885,16 +906,34 @@ void GM_FinisGeneralSound(void *threadContext, GM_Mixer *mixer)
     {
         mixer->systemPaused = TRUE;
         BAE_DestroyMutex(mixer->queueLock);
+        GM_SetInstrumentLoaderEnabled(FALSE);   // before the songs it loads into go
+#if USE_HIGHLEVEL_FILE_API
+        GM_SetStreamReadAhead(0);               // streams left over decode in line
+#endif
+        if (mixer->streamDecoderLock)
+        {
+            BAE_DestroyMutex(mixer->streamDecoderLock);
+            mixer->streamDecoderLock = NULL;
+        }
         GM_FreeSong(threadContext, NULL);       // free all songs
+        GMCache_ClearSampleCache(mixer);        // and the idle samples kept for them
 
         // Close up sound manager BEFORE releasing memory!
 //      GM_StopHardwareSoundManager(threadContext);
 
 #if REVERB_USED != REVERB_DISABLED
+#ifdef BAE_COMPLETE
+        GM_SetEffectsThreadEnabled(FALSE);
+#endif
         // clean up the verb buffers
+#if USE_NEO_EFFECTS == TRUE
+        GM_SetReverbImpulse(NULL);
+#endif
         GM_CleanupReverb();
 #endif
 
+        XDisposePtr((XPTR)mixer->pSongsToPlay);
+        XDisposePtr((XPTR)mixer->pFreeSongSlots);
         XDisposePtr((XPTR)mixer);
         MusicGlobals = NULL;
     }
@@ -1424,23 +1463,30 @@ void GM_StopHardwareSoundManager(void *threadContext)
 // audio device.  it never decreases.
 // $$kk: this and all the time stamp methods should move into a common file
 // CLS:  copied this function in from Kara's
-UINT32 GM_GetDeviceTimeStamp(void)
+uint64_t GM_GetDeviceTimeStamp64(void)
 {
-    UINT16  sampleRate;
+    uint64_t    sampleRate;
+    uint64_t    played;
 
     if (MusicGlobals)
     {
-        // convert from samples into microseconds
-        sampleRate = (UINT16)GM_ConvertFromOutputRateToRate(MusicGlobals->outputRate);
-#if USE_FLOAT == FALSE
-        return (MusicGlobals->samplesPlayed * 1000000) / sampleRate;
-#else
-        return (UINT32)(((float) MusicGlobals->samplesPlayed / sampleRate) * 1000000);
-#endif
+        // convert from samples into microseconds. Split the divide so the
+        // multiply can't overflow however long the device has been running.
+        sampleRate = (uint64_t)GM_ConvertFromOutputRateToRate(MusicGlobals->outputRate);
+        if (sampleRate)
+        {
+            played = MusicGlobals->samplesPlayed;
+            return (played / sampleRate) * 1000000ULL + ((played % sampleRate) * 1000000ULL) / sampleRate;
+        }
     }
     return 0L;
 }
 
+UINT32 GM_GetDeviceTimeStamp(void)
+{
+    return (UINT32)GM_GetDeviceTimeStamp64();
+}
+
 // Update count of samples played.  This function caluculates from number of bytes,
 // given the sample frame size from the mixer variables
 // $$kk: 08.12.98 merge: changed this function
@@ -1507,9 +1553,9 @@ void GM_GetDeviceName(int32_t deviceID, char *cName, uint32_t cNameLength)
 }
 
 // Get current audio time stamp based upon the audio built interrupt
-UINT32 GM_GetSyncTimeStamp(void)
+uint64_t GM_GetSyncTimeStamp64(void)
 {
-    UINT32  ticks;
+    uint64_t    ticks;
 
     ticks = 0L;
     if (MusicGlobals)
@@ -1519,6 +1565,11 @@ UINT32 GM_GetSyncTimeStamp(void)
     return ticks;
 }
 
+UINT32 GM_GetSyncTimeStamp(void)
+{
+    return (UINT32)GM_GetSyncTimeStamp64();
+}
+
 int32_t GM_GetAudioBufferOutputSize(void)
 {
     return BAE_GetAudioByteBufferSize();
@@ -501,12 +501,14 @@ extern "C"
         REVERB_TYPE_15,       // Neo Dungeon (Neo reverb)
         REVERB_TYPE_16,       // Neo Reserved (Neo reverb)
         REVERB_TYPE_17,       // Neo Tap Delay (Neo reverb)
-        REVERB_TYPE_18        // Neo Custom
+        REVERB_TYPE_18,       // Neo Custom
+        REVERB_TYPE_19        // Convolution with the impulse set by GM_SetReverbImpulse
     };
     typedef char ReverbMode;
-#define MAX_REVERB_TYPES 19
+#define MAX_REVERB_TYPES 20
 
-    typedef void (*GM_ReverbProc)(ReverbMode which);
+    // sourceP is the reverb send bus, destP the stereo or mono dry bus the verb adds to
+    typedef void (*GM_ReverbProc)(ReverbMode which, XSDWORD *sourceP, XSDWORD *destP);
 
     typedef struct
     {
@@ -565,7 +567,7 @@ extern "C"
 #define MAX_LFOS 6                // max LFO's, make sure to add one extra for MOD wheel support
 #define MAX_MASTER_VOLUME 256     // max volume level for master volume level
 #define MAX_SAMPLES 2048           // max number of samples that can be loaded
-#define MAX_SONGS 16              // max number of songs that can play at one time
+#define MAX_SONGS 16              // default number of songs that can play at one time, see GM_SetMaxSongs
 #define PERCUSSION_CHANNEL 9      // which channel (zero based) is the default percussion channel
 #define MAX_SAMPLE_FRAMES 1048576 // max number of sample frames that we can play in one voice
                                   // 1024 * 1024 = 1MB. This limit exisits only in DROP_SAMPLE, TERP1, TERP2 cases
@@ -982,6 +984,11 @@ typedef int32_t UNIT_TYPE;
                                // rootKey for sample
         XSWORD miscParameter2;
         struct GM_Instrument *pSplitInstrument;
+        XShortResourceID sndResourceID; // sample to decode on the first note, if lazyDecode
+        XBOOL lazyDecode;               // pSplitInstrument waits for a note to need it
+        XBOOL decodeQueued;             // and one has, it's on the instrument loader
+        XFILE sampleFile;               // where a lazyDecode sample was at load, NULL otherwise
+        uint64_t sampleFileKey;         // XFileGetContentKey of sampleFile then, in case it's reopened
     };
     typedef struct GM_KeymapSplit GM_KeymapSplit;
 
@@ -989,6 +996,7 @@ typedef int32_t UNIT_TYPE;
     {
         XShortResourceID defaultInstrumentID;
         XWORD KeymapSplitCount;
+        XBankToken bankToken;           // where lazyDecode splits come from
         GM_KeymapSplit keySplits[1];
     };
     typedef struct GM_KeymapSplitInfo GM_KeymapSplitInfo;
@@ -1214,6 +1222,7 @@ typedef int32_t UNIT_TYPE;
 
         UFLOAT songMidiTickLength;    // song midi tick length. 0 not calculated yet.
         UFLOAT songMicrosecondLength; // song microsecond length. 0 not calculated yet.
+        void *seekIndex;              // GM_SeekIndex of sequencer checkpoints. NULL until first scan
 
         SequenceType seqType;
         void *sequenceData;      // sequence pointer data for this song
@@ -1225,6 +1234,7 @@ typedef int32_t UNIT_TYPE;
   
         GM_Instrument *instrumentData[MAX_INSTRUMENTS * MAX_BANKS];
         XLongResourceID remapArray[MAX_INSTRUMENTS * MAX_BANKS];
+        XDWORD pendingInstruments[((MAX_INSTRUMENTS * MAX_BANKS) / 32) + 1]; // bit set while queued on the instrument loader
 
         void *pUsedPatchList; // This is NULL most of the time, only
                               // GM_LoadSongInstruments sets it
@@ -1306,6 +1316,9 @@ typedef int32_t UNIT_TYPE;
         XBYTE *trackstart[MAX_TRACKS];   // start of track
         XBYTE runningStatus[MAX_TRACKS]; // midi running status
         IFLOAT trackticks[MAX_TRACKS];   // current position of track in ticks. must be signed
+        void *eventStream;               // GM_EventStream compiled from the tracks. NULL until played
+        XBYTE eventStreamState;          // EVENT_STREAM_UNSYNCED, EVENT_STREAM_SYNCED, EVENT_STREAM_RAW
+        XSWORD mixerSlot;                // index into the mixer song table; valid only while it points back here
         //  XSDWORD             trackcumuticks[MAX_TRACKS];     // current number of beat ticks into track
 
 #if USE_SF2_SUPPORT == TRUE
@@ -1428,6 +1441,22 @@ typedef int32_t UNIT_TYPE;
 
     // process the verb. Only call on data currently in the mix bus
     void GM_ProcessReverb(void);
+    // same, but reading the send from sourceP and mixing into destP
+    void GM_ProcessReverbBuses(XSDWORD *sourceP, XSDWORD *destP);
+
+    // Run the variable verbs and the chorus on a worker thread, one slice behind the
+    // voices, so both can use another processor. Adds GM_GetEffectsThreadLatency
+    // frames of delay to the effects. Fails with NOT_SETUP on platforms without
+    // threads. Do not call at interrupt time.
+    OPErr GM_SetEffectsThreadEnabled(XBOOL enabled);
+    XBOOL GM_IsEffectsThreadEnabled(void);
+    XDWORD GM_GetEffectsThreadLatency(void);
+
+#if USE_NEO_EFFECTS == TRUE
+    // Set the impulse response used by REVERB_TYPE_19, or release it with NULL.
+    // The waveform is copied. Do not call at interrupt time.
+    OPErr GM_SetReverbImpulse(GM_Waveform const *pWave);
+#endif
 #endif
 
     void GM_TestTone(XBOOL toneStatus);
@@ -1468,6 +1497,11 @@ typedef int32_t UNIT_TYPE;
 
     void GM_GetSystemVoices(XSWORD *pMaxSongVoices, XSWORD *pMixLevel, XSWORD *pMaxEffectVoices);
 
+    // Change the number of songs that can play at once. Defaults to MAX_SONGS. Fails with
+    // PARAM_ERR if maxSongs is below the highest slot currently in use.
+    OPErr GM_SetMaxSongs(XSWORD maxSongs);
+    XSWORD GM_GetMaxSongs(void);
+
     OPErr GM_ChangeSystemVoices(XSWORD maxVoices, XSWORD mixLevel, XSWORD maxEffects);
 
     OPErr GM_ChangeAudioModes(void *threadContext, Rate theRate, TerpMode theTerp, AudioModifiers theMods);
@@ -1670,17 +1704,32 @@ typedef int32_t UNIT_TYPE;
     OPErr GM_GetSongInstrumentChanges(void *theSongResource, GM_Song **outSong, XBYTE **outTrackNames);
 
     XDWORD GM_SongMicroseconds(GM_Song *pSong);
+    uint64_t GM_SongMicroseconds64(GM_Song *pSong);
     XDWORD GM_GetSongMicrosecondLength(GM_Song *pSong, OPErr *pErr);
     // Set the song position in microseconds
     OPErr GM_SetSongMicrosecondPosition(GM_Song *pSong, XDWORD songMicrosecondPosition);
 
-    // Get current audio time stamp based upon the audio built interrupt
+    // Return the play length of standard midi file data without creating a song or running the
+    // sequencer. Track events are merged by time, tempo events applied, and finite Beatnik
+    // loopstart=n/loopend markers expanded; endless loops are counted once.
+    //  theExternalSong     SongResource for tempo scaling, or NULL for normal tempo
+    //  pMidiData           SMF (or RMI) data
+    //  pTicks              if not NULL, length in midi ticks of the file division
+    //  pMicroseconds       if not NULL, length in microseconds
+    OPErr GM_ScanMidiLength(void *theExternalSong, void const *pMidiData, int32_t midiSize,
+                            XDWORD *pTicks, XDWORD *pMicroseconds);
+
+    // Get current audio time stamp based upon the audio built interrupt. The 32 bit
+    // version wraps about every 71 minutes; MIDI queue time stamps are compared with
+    // that in mind.
     XDWORD GM_GetSyncTimeStamp(void);
+    uint64_t GM_GetSyncTimeStamp64(void);
 
     // Get current audio time stamp in microseconds; this is the
     // microseconds' worth of samples that have passed through the
     // audio device.  it never decreases.
     XDWORD GM_GetDeviceTimeStamp(void);
+    uint64_t GM_GetDeviceTimeStamp64(void);
 
     // Update count of samples played.  This function caluculates from number of bytes,
     // given the sample frame size from the mixer variables, and the bytes of data written
@@ -1765,6 +1814,31 @@ typedef int32_t UNIT_TYPE;
     void GM_SetGlobalVolume(XSDWORD theVolume);
     XSDWORD GM_GetGlobalVolume(void);
 
+#if USE_NEO_EFFECTS == TRUE
+    // Master bus EQ and lookahead limiter. Both are off by default, in which case
+    // 16 bit output keeps the plain hard clip. 8 bit output never uses them.
+    typedef enum
+    {
+        MASTER_EQ_OFF = 0,
+        MASTER_EQ_PEAK,             // bell around frequency, width from q
+        MASTER_EQ_LOW_SHELF,        // boost or cut below frequency
+        MASTER_EQ_HIGH_SHELF        // boost or cut above frequency
+    } MasterEqType;
+
+    // Set one of the master EQ bands (0 to 4). gain is in dB, 16.16 fixed and signed,
+    // clamped to +/-24 dB. q is 16.16 fixed, clamped to 0.1 - 20.
+    OPErr GM_SetMasterEqBand(short int band, MasterEqType type, XDWORD frequency, XSDWORD gain, XFIXED q);
+    OPErr GM_GetMasterEqBand(short int band, MasterEqType *pType, XDWORD *pFrequency, XSDWORD *pGain, XFIXED *pQ);
+    void GM_SetMasterEqEnabled(XBOOL enabled);
+    XBOOL GM_IsMasterEqEnabled(void);
+
+    // Peak limiter on the master bus with about 2 ms of lookahead. While enabled the
+    // output is delayed by the lookahead, and peaks are pulled under full scale
+    // instead of being clipped.
+    void GM_SetMasterLimiterEnabled(XBOOL enabled);
+    XBOOL GM_IsMasterLimiterEnabled(void);
+#endif
+
 // This is an active voice reference that represents a valid/active voice.
 // Used in various functions that need to return and reference a voice.
 #define DEAD_VOICE (void *)-1L            // this represents a dead or invalid voice
@@ -1887,6 +1961,7 @@ typedef int32_t UNIT_TYPE;
     OPErr GM_GetWaveformSampleData(GM_Waveform *pWave, XPTR *outSampleData);
 
     uint32_t GM_GetSampleStartTimeStamp(VOICE_REFERENCE reference);
+    uint64_t GM_GetSampleStartTimeStamp64(VOICE_REFERENCE reference);
 
     // given a valid voice, return the current playback position
     uint32_t GM_GetSamplePlaybackPosition(VOICE_REFERENCE reference);
@@ -2017,6 +2092,29 @@ typedef int32_t UNIT_TYPE;
                                 XLongResourceID instrument,
                                 XBankToken bankToken);
 
+    // Load instruments requested with GM_RequestSongInstrument on a worker thread, so
+    // the caller never waits on the bank. Fails with NOT_SETUP on platforms without
+    // threads. Disabling waits for the load in progress and drops the rest. Do not
+    // call at interrupt time.
+    OPErr GM_SetInstrumentLoaderEnabled(XBOOL enabled);
+    XBOOL GM_IsInstrumentLoaderEnabled(void);
+    // Queue an instrument to load into pSong, following remaps like GM_LoadSongInstrument.
+    // Loads it right away if the loader isn't enabled. Until the load completes, notes
+    // for it play on the GM instrument of the same program, if that one is loaded.
+    // Returns NOT_READY if MAX_INSTRUMENT_REQUESTS loads are already queued.
+    OPErr GM_RequestSongInstrument(GM_Song *pSong, XLongResourceID instrument, XBankToken bankToken);
+    XBOOL GM_IsSongInstrumentPending(GM_Song *pSong, XLongResourceID instrument);
+    // The instrument a program change, with an optional bank select MSB (-1 for none),
+    // selects on channel. -1 when notes pick the instrument, as on the percussion channel.
+    XLongResourceID GM_GetProgramInstrument(GM_Song *pSong, INT16 channel, INT16 bank, INT16 program);
+    // Drop the queued loads for pSong and wait for one in progress.
+    void GM_CancelSongInstrumentRequests(GM_Song *pSong);
+    // Decode the key splits of instruments loaded from now on only when their song is
+    // known to play them, or a note first lands on them. Until then the nearest loaded
+    // split stands in. Needs the instrument loader, and is ignored while it is off.
+    void GM_SetLazySplitDecoding(XBOOL enabled);
+    XBOOL GM_IsLazySplitDecoding(void);
+
     // Will unload an instrument from this song. Will follow remaps or instrument aliases.
     // can return STILL_PLAYING if instruments are still in process. Call again to clear
     OPErr GM_UnloadSongInstrument(GM_Song *pSong, XLongResourceID instrument);
@@ -2517,6 +2615,18 @@ typedef int32_t UNIT_TYPE;
     void *GM_AudioStreamGetDoneCallback(STREAM_REFERENCE reference, GM_SoundDoneCallbackPtr *pDoneCallback);
     // Set the done callback and reference flag of a audio stream
     void GM_AudioStreamSetDoneCallback(STREAM_REFERENCE reference, GM_SoundDoneCallbackPtr doneCallback, void *doneCallbackReference);
+
+    // Decode file streams set up from now on this many milliseconds ahead, on a worker
+    // thread, so the mixer only copies decoded frames. 0 stops the thread, and every stream
+    // decodes in line again. Fails with NOT_SETUP on platforms without threads. Do not
+    // call at interrupt time.
+    OPErr GM_SetStreamReadAhead(XDWORD milliseconds);
+    XDWORD GM_GetStreamReadAhead(void);
+    // Get the read ahead counters of a audio stream: the times a buffer came up short of
+    // decoded frames, the frames missed, and the frames decoded now out of the most it holds.
+    // Fails with NOT_SETUP if the stream isn't decoded ahead.
+    OPErr GM_AudioStreamGetReadAheadStats(STREAM_REFERENCE reference, uint32_t *pUnderruns, uint32_t *pMissingFrames,
+                                            uint32_t *pBufferedFrames, uint32_t *pCapacityFrames);
 #endif
 
     // Get the file position of a audio stream, in samples. This
@@ -242,7 +242,7 @@ static GM_Song *PV_CreateSongFromMidi(XLongResourceID theID,
     }
     if (theMidiData)
     {
-        theSong = (GM_Song *)XNewPtr((int32_t)sizeof(GM_Song));
+        theSong = (GM_Song *)XNewTaggedPtr((int32_t)sizeof(GM_Song), X_MEMORY_SONGS);
         if (theSong)
         {
             // Initialize the structure to zero to avoid garbage values
@@ -267,20 +267,26 @@ static GM_Song *PV_CreateSongFromMidi(XLongResourceID theID,
     return theSong;
 }
 
+// Convert a SONG resource tempo (16667 = 1.0) to a master tempo
+static XFIXED PV_TranslateSongTempo(int32_t masterTempo)
+{
+    if (masterTempo == 0L)
+    {
+        masterTempo = 16667;
+    }
+    masterTempo = (100L * masterTempo) / 16667;
+    if (masterTempo < 25)
+        masterTempo = 25;
+    if (masterTempo > 300)
+        masterTempo = 300;
+    return (XFIXED)((masterTempo << 16L) / 100L);
+}
+
 static void PV_SetTempo(GM_Song *pSong, int32_t masterTempo)
 {
     if (pSong)
     {
-        if (masterTempo == 0L)
-        {
-            masterTempo = 16667;
-        }
-        masterTempo = (100L * masterTempo) / 16667;
-        if (masterTempo < 25)
-            masterTempo = 25;
-        if (masterTempo > 300)
-            masterTempo = 300;
-        GM_SetMasterSongTempo(pSong, (masterTempo << 16L) / 100L);
+        GM_SetMasterSongTempo(pSong, PV_TranslateSongTempo(masterTempo));
     }
 }
 
@@ -420,7 +426,7 @@ static int16_t PV_GetMaxVoicesPlayingFromAllSongs(void)
     pMixer = GM_GetCurrentMixer();
     if (pMixer)
     {
-        for (count = 0; count < MAX_SONGS; count++)
+        for (count = 0; count < pMixer->songSlotCount; count++)
         {
             pSong = pMixer->pSongsToPlay[count];
             if (pSong)
@@ -445,7 +451,7 @@ static int16_t PV_GetMixLevelPlayingFromAllSongs(void)
     pMixer = MusicGlobals;
     if (pMixer)
     {
-        for (count = 0; count < MAX_SONGS; count++)
+        for (count = 0; count < pMixer->songSlotCount; count++)
         {
             pSong = pMixer->pSongsToPlay[count];
             if (pSong)
@@ -461,43 +467,160 @@ static int16_t PV_GetMixLevelPlayingFromAllSongs(void)
 }
 #endif
 
-// scan through mixer and find an empty song slot.
-// Returns -1, if failure.
-static int16_t PV_FindEmptySongSlot(GM_Mixer *pMixer, GM_Song *pSong)
+// Return pSong's slot in the mixer song table, or -1 if it isn't in the table.
+static XSWORD PV_GetSongSlot(GM_Mixer *pMixer, GM_Song *pSong)
 {
-    int16_t songSlot = -1;
-    int16_t count;
+    XSWORD slot;
 
-    if (pSong)
+    slot = pSong->mixerSlot;
+    // mixerSlot is only trusted when the table agrees, because cloned songs copy it
+    if ((slot >= 0) && (slot < pMixer->songSlotCount) && (pMixer->pSongsToPlay[slot] == pSong))
     {
-        // first find a slot in the song queue
-        for (count = 0; count < MAX_SONGS; count++)
+        return slot;
+    }
+    return -1;
+}
+
+// Put pSong into an empty slot of the mixer song table. Empty slots below the high water
+// mark are reused first; stale entries left behind when the mark drops are discarded.
+// Returns -1, if the table is full.
+static XSWORD PV_AddSongToMixer(GM_Mixer *pMixer, GM_Song *pSong)
+{
+    XSWORD slot;
+
+    while (pMixer->freeSongSlotCount > 0)
+    {
+        slot = pMixer->pFreeSongSlots[--pMixer->freeSongSlotCount];
+        if ((slot < pMixer->songSlotCount) && (pMixer->pSongsToPlay[slot] == NULL))
         {
-            // Reuse slot, if song already playing
-            if (pMixer->pSongsToPlay[count] == pSong)
-            {
-                pMixer->pSongsToPlay[count] = NULL;
-                GM_KillSongNotes(pSong);
-                songSlot = count;
-                break;
-            }
+            pSong->mixerSlot = slot;
+            pMixer->pSongsToPlay[slot] = pSong;
+            return slot;
         }
-        if (songSlot == -1)
+    }
+    if (pMixer->songSlotCount < pMixer->maxSongs)
+    {
+        slot = pMixer->songSlotCount;
+        pSong->mixerSlot = slot;
+        // publish the song before the audio thread can walk to it
+        pMixer->pSongsToPlay[slot] = pSong;
+        pMixer->songSlotCount = slot + 1;
+        return slot;
+    }
+    return -1;
+}
+
+// Take pSong out of the mixer song table, and drop the high water mark past any
+// trailing empty slots so per slice loops stay short.
+static void PV_RemoveSongFromMixer(GM_Mixer *pMixer, GM_Song *pSong)
+{
+    XSWORD slot;
+
+    slot = PV_GetSongSlot(pMixer, pSong);
+    if (slot != -1)
+    {
+        pMixer->pSongsToPlay[slot] = NULL;
+        pSong->mixerSlot = -1;
+        if (slot == pMixer->songSlotCount - 1)
         {
-            // Song wasn't already playing, so try to find empty slot.
-            for (count = 0; count < MAX_SONGS; count++)
+            while ((slot > 0) && (pMixer->pSongsToPlay[slot - 1] == NULL))
             {
-                if (pMixer->pSongsToPlay[count] == NULL)
-                {
-                    songSlot = count;
-                    break;
-                }
+                slot--;
             }
+            pMixer->songSlotCount = slot;
+        }
+        else
+        {
+            pMixer->pFreeSongSlots[pMixer->freeSongSlotCount++] = slot;
+        }
+    }
+}
+
+// Find a slot in the mixer for pSong. If the song is already playing its notes are
+// killed and it keeps its slot. Returns -1, if failure.
+static XSWORD PV_FindEmptySongSlot(GM_Mixer *pMixer, GM_Song *pSong)
+{
+    XSWORD songSlot = -1;
+
+    if (pSong)
+    {
+        // Reuse slot, if song already playing
+        songSlot = PV_GetSongSlot(pMixer, pSong);
+        if (songSlot != -1)
+        {
+            GM_KillSongNotes(pSong);
+        }
+        else
+        {
+            songSlot = PV_AddSongToMixer(pMixer, pSong);
         }
     }
     return songSlot;
 }
 
+OPErr GM_SetMaxSongs(XSWORD maxSongs)
+{
+    GM_Mixer *pMixer;
+    GM_Song **pNewSongs;
+    GM_Song **pOldSongs;
+    XSWORD *pNewFree;
+    XSWORD *pOldFree;
+    XSWORD count, freeCount;
+
+    pMixer = MusicGlobals;
+    if (pMixer == NULL)
+    {
+        return NOT_SETUP;
+    }
+    if ((maxSongs < 1) || (maxSongs < pMixer->songSlotCount))
+    {
+        return PARAM_ERR;
+    }
+    if (maxSongs == pMixer->maxSongs)
+    {
+        return NO_ERR;
+    }
+    pNewSongs = (GM_Song **)XNewPtr((int32_t)(sizeof(GM_Song *) * maxSongs));
+    pNewFree = (XSWORD *)XNewPtr((int32_t)(sizeof(XSWORD) * maxSongs));
+    if ((pNewSongs == NULL) || (pNewFree == NULL))
+    {
+        XDisposePtr((XPTR)pNewSongs);
+        XDisposePtr((XPTR)pNewFree);
+        return MEMORY_ERR;
+    }
+    XBlockMove(pMixer->pSongsToPlay, pNewSongs, (int32_t)(sizeof(GM_Song *) * pMixer->songSlotCount));
+    // carry over only the live free slots, stale ones above the high water mark may not fit
+    freeCount = 0;
+    for (count = 0; count < pMixer->freeSongSlotCount; count++)
+    {
+        if ((pMixer->pFreeSongSlots[count] < pMixer->songSlotCount) &&
+            (pMixer->pSongsToPlay[pMixer->pFreeSongSlots[count]] == NULL))
+        {
+            pNewFree[freeCount++] = pMixer->pFreeSongSlots[count];
+        }
+    }
+
+    pOldSongs = pMixer->pSongsToPlay;
+    pOldFree = pMixer->pFreeSongSlots;
+    pMixer->pSongsToPlay = pNewSongs;
+    pMixer->pFreeSongSlots = pNewFree;
+    pMixer->freeSongSlotCount = freeCount;
+    pMixer->maxSongs = maxSongs;
+    // the audio thread may still be walking the old table, so let it finish first
+    while (pMixer->insideAudioInterrupt)
+    {
+        XWaitMicroseconds(BAE_GetSliceTimeInMicroseconds());
+    }
+    XDisposePtr((XPTR)pOldSongs);
+    XDisposePtr((XPTR)pOldFree);
+    return NO_ERR;
+}
+
+XSWORD GM_GetMaxSongs(void)
+{
+    return MusicGlobals ? MusicGlobals->maxSongs : 0;
+}
+
 // preroll song but don't start
 OPErr GM_PrerollSong(GM_Song *pSong, GM_SongCallbackProcPtr theCallbackProc,
                      XBOOL useEmbeddedMixerSettings, XBOOL autoLevel)
@@ -630,7 +753,7 @@ OPErr GM_BeginSong(GM_Song *pSong, GM_SongCallbackProcPtr theCallbackProc,
 {
     OPErr theErr;
     GM_Mixer *pMixer = GM_GetCurrentMixer();
-    int16_t songSlot;
+    XSWORD songSlot;
 
     theErr = NO_ERR;
     if (pSong)
@@ -648,7 +771,6 @@ OPErr GM_BeginSong(GM_Song *pSong, GM_SongCallbackProcPtr theCallbackProc,
             songSlot = PV_FindEmptySongSlot(pMixer, pSong);
             if (songSlot != -1)
             {
-                pMixer->pSongsToPlay[songSlot] = pSong;
                 pSong->songPrerolled = FALSE;
                 pSong->songPaused = FALSE; // start sequencer
             }
@@ -819,7 +941,7 @@ GM_Song *GM_CreateLiveSong(void *context, XShortResourceID songID)
 
     pSong = NULL;
 
-    pSong = (GM_Song *)XNewPtr((int32_t)sizeof(GM_Song));
+    pSong = (GM_Song *)XNewTaggedPtr((int32_t)sizeof(GM_Song), X_MEMORY_SONGS);
     if (pSong)
     {
         // Initialize the structure to zero to avoid garbage values
@@ -870,22 +992,13 @@ void GM_ResetSongLyricState(GM_Song *pSong)
 OPErr GM_StartLiveSong(GM_Song *pSong, XBOOL loadPatches, XBankToken bankToken)
 {
     OPErr theErr;
-    int16_t songSlot, count;
+    int16_t count;
 
     theErr = NO_ERR;
     if (pSong)
     {
-        // first find a slot in the song queue
-        songSlot = -1;
-        for (count = 0; count < MAX_SONGS; count++)
-        {
-            if (MusicGlobals->pSongsToPlay[count] == NULL)
-            {
-                songSlot = count;
-                break;
-            }
-        }
-        if (songSlot != -1)
+        // first make sure there is a slot in the song queue
+        if ((MusicGlobals->songSlotCount < MusicGlobals->maxSongs) || (MusicGlobals->freeSongSlotCount > 0))
         {
             if (loadPatches)
             {
@@ -931,7 +1044,10 @@ OPErr GM_StartLiveSong(GM_Song *pSong, XBOOL loadPatches, XBankToken bankToken)
             pSong->velocityCurveType = DEFAULT_VELOCITY_CURVE;
 
             // Start song playing now.
-            MusicGlobals->pSongsToPlay[songSlot] = pSong;
+            if (PV_AddSongToMixer(MusicGlobals, pSong) == -1)
+            {
+                theErr = TOO_MANY_SONGS_PLAYING;
+            }
         }
     }
     return theErr;
@@ -1149,25 +1265,19 @@ static void PV_EndSongWithControl(void *threadContext, GM_Song *pSong, XBOOL rem
             }
             if (removeFromMixer)
             {
-                for (count = 0; count < MAX_SONGS; count++)
-                {
-                    if (pMixer->pSongsToPlay[count] == pSong)
-                    {
-                        pMixer->pSongsToPlay[count] = NULL;
-                        break;
-                    }
-                }
+                PV_RemoveSongFromMixer(pMixer, pSong);
             }
             for (count = 0; count < MAX_TRACKS; count++)
             {
                 pSong->ptrack[count] = NULL;
                 pSong->trackon[count] = TRACK_OFF;
             }
+            pSong->eventStreamState = EVENT_STREAM_UNSYNCED;
             PV_CallSongCallback(threadContext, pSong, TRUE);
         }
         else
         {
-            for (count = 0; count < MAX_SONGS; count++)
+            for (count = 0; count < pMixer->songSlotCount; count++)
             {
                 if (pMixer->pSongsToPlay[count])
                 {
@@ -1215,6 +1325,282 @@ void GM_KillSongEventsFromQueue(GM_Song *pSong)
     }
 }
 
+// Seek checkpoints. See GM_SeekCheckpoint in GenPriv.h
+
+static void PV_FreeSeekIndex(GM_Song *pSong)
+{
+    GM_SeekIndex *pIndex;
+
+    pIndex = (GM_SeekIndex *)pSong->seekIndex;
+    if (pIndex)
+    {
+        pSong->seekIndex = NULL;
+        XDisposePtr((XPTR)pIndex->pCheckpoints);
+        XDisposePtr((XPTR)pIndex);
+    }
+}
+
+// Return the seek index for this song, creating it if needed. If the settings that affect
+// sequencer timing have changed since the checkpoints were recorded, they are thrown away.
+static GM_SeekIndex *PV_GetSeekIndex(GM_Song *pSong)
+{
+    GM_SeekIndex *pIndex;
+
+    pIndex = (GM_SeekIndex *)pSong->seekIndex;
+    if (pIndex == NULL)
+    {
+        pIndex = (GM_SeekIndex *)XNewTaggedPtr(sizeof(GM_SeekIndex), X_MEMORY_SONGS);
+        if (pIndex == NULL)
+        {
+            return NULL; // seeking still works, just without checkpoints
+        }
+        pSong->seekIndex = pIndex;
+    }
+    if ((pIndex->sequenceData != pSong->sequenceData) ||
+        (pIndex->sequenceDataSize != pSong->sequenceDataSize) ||
+        (pIndex->MasterTempo != pSong->MasterTempo) ||
+        (pIndex->sliceTime != BAE_GetSliceTimeInMicroseconds()) ||
+        (pIndex->allowProgramChanges != pSong->allowProgramChanges) ||
+        (pIndex->defaultPercusionProgram != pSong->defaultPercusionProgram) ||
+        XMemCmp(pIndex->trackMuted, pSong->trackMuted, sizeof(pIndex->trackMuted)) ||
+        XMemCmp(pIndex->soloTrackMuted, pSong->soloTrackMuted, sizeof(pIndex->soloTrackMuted)) ||
+        XMemCmp(pIndex->channelMuted, pSong->channelMuted, sizeof(pIndex->channelMuted)) ||
+        XMemCmp(pIndex->soloChannelMuted, pSong->soloChannelMuted, sizeof(pIndex->soloChannelMuted)))
+    {
+        pIndex->count = 0;
+        pIndex->sequenceData = pSong->sequenceData;
+        pIndex->sequenceDataSize = pSong->sequenceDataSize;
+        pIndex->MasterTempo = pSong->MasterTempo;
+        pIndex->sliceTime = BAE_GetSliceTimeInMicroseconds();
+        pIndex->allowProgramChanges = pSong->allowProgramChanges;
+        pIndex->defaultPercusionProgram = pSong->defaultPercusionProgram;
+        XBlockMove(pSong->trackMuted, pIndex->trackMuted, sizeof(pIndex->trackMuted));
+        XBlockMove(pSong->soloTrackMuted, pIndex->soloTrackMuted, sizeof(pIndex->soloTrackMuted));
+        XBlockMove(pSong->channelMuted, pIndex->channelMuted, sizeof(pIndex->channelMuted));
+        XBlockMove(pSong->soloChannelMuted, pIndex->soloChannelMuted, sizeof(pIndex->soloChannelMuted));
+    }
+    return pIndex;
+}
+
+// Copy sequencer state between a song and a checkpoint. If save is TRUE the song state
+// is stored into the checkpoint, otherwise the checkpoint is loaded into the song.
+static void PV_CopySeekCheckpoint(GM_Song *pSong, GM_SeekCheckpoint *pCheck, XBOOL save)
+{
+    int16_t count;
+    XBYTE *pStart;
+
+#define PV_SEEK_COPY(field)                                                         \
+    if (save)                                                                       \
+        XBlockMove((void *)&pSong->field, (void *)&pCheck->field, sizeof(pCheck->field)); \
+    else                                                                            \
+        XBlockMove((void *)&pCheck->field, (void *)&pSong->field, sizeof(pCheck->field))
+
+    PV_SEEK_COPY(CurrentMidiClock);
+    PV_SEEK_COPY(songMicroseconds);
+    PV_SEEK_COPY(UnscaledMIDITempo);
+    PV_SEEK_COPY(MIDITempo);
+    PV_SEEK_COPY(MIDIDivision);
+    PV_SEEK_COPY(UnscaledMIDIDivision);
+    PV_SEEK_COPY(trackticks);
+    PV_SEEK_COPY(trackon);
+    PV_SEEK_COPY(runningStatus);
+    PV_SEEK_COPY(omniModeOn);
+    PV_SEEK_COPY(velocityCurveType);
+    PV_SEEK_COPY(firstNoteOnChannel);
+    PV_SEEK_COPY(firstChannelBank);
+    PV_SEEK_COPY(firstChannelProgram);
+    PV_SEEK_COPY(channelWhichParameter);
+    PV_SEEK_COPY(channelRegisteredParameterLSB);
+    PV_SEEK_COPY(channelRegisteredParameterMSB);
+    PV_SEEK_COPY(channelNonRegisteredParameterLSB);
+    PV_SEEK_COPY(channelNonRegisteredParameterMSB);
+    PV_SEEK_COPY(channelBankMode);
+    PV_SEEK_COPY(channelSustain);
+    PV_SEEK_COPY(channelVolume);
+    PV_SEEK_COPY(channelExpression);
+    PV_SEEK_COPY(channelPitchBendRange);
+#if DISABLE_NOKIA_PATCH != TRUE
+    PV_SEEK_COPY(isNokiaVibrationChannel);
+#endif
+#if REVERB_USED != REVERB_DISABLED
+    PV_SEEK_COPY(channelReverb);
+    PV_SEEK_COPY(channelChorus);
+#endif
+    PV_SEEK_COPY(channelModWheel);
+    PV_SEEK_COPY(channelLowPassAmount);
+    PV_SEEK_COPY(channelResonanceFilterAmount);
+    PV_SEEK_COPY(channelFrequencyFilterAmount);
+    PV_SEEK_COPY(channelMonoMode);
+    PV_SEEK_COPY(channelBend);
+    PV_SEEK_COPY(channelProgram);
+    PV_SEEK_COPY(channelRawBank);
+    PV_SEEK_COPY(channelLSB);
+    PV_SEEK_COPY(channelBank);
+    PV_SEEK_COPY(channelStereoPosition);
+#if USE_SF2_SUPPORT == TRUE
+    PV_SEEK_COPY(channelType);
+    PV_SEEK_COPY(channelBankMSB);
+    PV_SEEK_COPY(channelBankLSB);
+#if DISABLE_BEATNIK_SF2_NRPN != TRUE
+    PV_SEEK_COPY(lastThreeControl);
+#endif
+#endif
+#undef PV_SEEK_COPY
+
+    // track pointers are kept as offsets so the checkpoint does not depend on where
+    // the song structure lives
+    pStart = (XBYTE *)pSong->sequenceData;
+    for (count = 0; count < MAX_TRACKS; count++)
+    {
+        if (save)
+        {
+            pCheck->trackOffset[count] = (pSong->ptrack[count]) ?
+                (XDWORD)(pSong->ptrack[count] - pStart) : SEEK_TRACK_UNUSED;
+        }
+        else
+        {
+            pSong->ptrack[count] = (pCheck->trackOffset[count] != SEEK_TRACK_UNUSED) ?
+                pStart + pCheck->trackOffset[count] : NULL;
+        }
+    }
+}
+
+// Called by the sequencer at the end of each SCAN_DETERMINE_LENGTH slice
+void PV_RecordSeekCheckpoint(GM_Song *pSong)
+{
+    GM_SeekIndex *pIndex;
+    GM_SeekCheckpoint *pNew;
+    int32_t newCount;
+
+    pIndex = (GM_SeekIndex *)pSong->seekIndex;
+    if ((pIndex == NULL) || (pSong->SomeTrackIsAlive == FALSE) ||
+        (pIndex->sequenceData != pSong->sequenceData))
+    {
+        return;
+    }
+    if (pIndex->count)
+    {
+        if (pSong->songMicroseconds <
+            pIndex->pCheckpoints[pIndex->count - 1].songMicroseconds + (UFLOAT)SEEK_CHECKPOINT_INTERVAL)
+        {
+            return;
+        }
+    }
+    else if (pSong->songMicroseconds < (UFLOAT)SEEK_CHECKPOINT_INTERVAL)
+    {
+        return;
+    }
+    if (pIndex->count >= pIndex->maxCount)
+    {
+        newCount = pIndex->maxCount + SEEK_CHECKPOINT_GROW;
+        if (pIndex->pCheckpoints)
+        {
+            pNew = (GM_SeekCheckpoint *)XResizePtr((XPTR)pIndex->pCheckpoints,
+                                                   newCount * (int32_t)sizeof(GM_SeekCheckpoint));
+        }
+        else
+        {
+            pNew = (GM_SeekCheckpoint *)XNewTaggedPtr(newCount * (int32_t)sizeof(GM_SeekCheckpoint), X_MEMORY_SONGS);
+        }
+        if (pNew == NULL)
+        {
+            return; // keep what we have
+        }
+        pIndex->pCheckpoints = pNew;
+        pIndex->maxCount = newCount;
+    }
+    PV_CopySeekCheckpoint(pSong, &pIndex->pCheckpoints[pIndex->count], TRUE);
+    pIndex->count++;
+}
+
+// Move a freshly configured song (PV_ConfigureMusic) to the last checkpoint at or before
+// the target position. If useTicks is TRUE target is in midi ticks, otherwise in
+// microseconds. Returns TRUE if the song was moved.
+static XBOOL PV_RestoreSeekCheckpoint(GM_Song *pSong, UFLOAT target, XBOOL useTicks)
+{
+    GM_SeekIndex *pIndex;
+    GM_SeekCheckpoint *pCheck;
+    int32_t low, high, mid, found;
+    XSWORD saveProgram[MAX_CHANNELS];
+    XBYTE saveRawBank[MAX_CHANNELS];
+    GM_ProgramBankCallbackPtr pb;
+    int16_t count;
+    UFLOAT value;
+
+    pIndex = (GM_SeekIndex *)pSong->seekIndex;
+    if ((pIndex == NULL) || (pIndex->count == 0) || (pIndex->sequenceData != pSong->sequenceData))
+    {
+        return FALSE;
+    }
+    // these see every event as it is scanned, so skipping ahead would change what they report
+    if (pSong->metaEventCallbackPtr || pSong->lyricCallbackPtr ||
+        pSong->midiEventCallbackPtr || pSong->controllerCallback)
+    {
+        return FALSE;
+    }
+#if USE_SF2_SUPPORT == TRUE && _USING_FLUIDSYNTH == TRUE
+    // FluidSynth keeps its own channel state which is only updated by replaying events
+    if (GM_IsSF2Song(pSong))
+    {
+        return FALSE;
+    }
+#if USE_XMF_SUPPORT == TRUE
+    if (GM_SF2_HasXmfEmbeddedBank())
+    {
+        return FALSE;
+    }
+#endif
+#endif
+
+    // binary search for the last checkpoint that isn't past the target
+    found = -1;
+    low = 0;
+    high = pIndex->count - 1;
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        pCheck = &pIndex->pCheckpoints[mid];
+        value = (useTicks) ? pCheck->CurrentMidiClock : pCheck->songMicroseconds;
+        if (value <= target)
+        {
+            found = mid;
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    if (found < 0)
+    {
+        return FALSE;
+    }
+
+    XBlockMove(pSong->channelProgram, saveProgram, sizeof(saveProgram));
+    XBlockMove(pSong->channelRawBank, saveRawBank, sizeof(saveRawBank));
+    PV_CopySeekCheckpoint(pSong, &pIndex->pCheckpoints[found], FALSE);
+
+    // the skipped program changes would have been reported while scanning
+    pb = pSong->programBankCallbackPtr;
+    if (pb)
+    {
+        for (count = 0; count < 16; count++)
+        {
+            if ((pSong->channelProgram[count] != saveProgram[count]) ||
+                (pSong->channelRawBank[count] != saveRawBank[count]))
+            {
+                (*pb)(NULL, pSong, (uint8_t)count, (uint8_t)GM_PROGRAM_BANK_EVENT_BANK_MSB,
+                      (uint8_t)(pSong->channelRawBank[count] & 0x7F), (uint32_t)pSong->songMicroseconds,
+                      pSong->programBankCallbackReference);
+                (*pb)(NULL, pSong, (uint8_t)count, (uint8_t)GM_PROGRAM_BANK_EVENT_PROGRAM,
+                      (uint8_t)(pSong->channelProgram[count] & 0x7F), (uint32_t)pSong->songMicroseconds,
+                      pSong->programBankCallbackReference);
+            }
+        }
+    }
+    return TRUE;
+}
+
 // Given a song pointer, this will attempt to free all memory related to the song: midi
 // data, instruments, samples, etc. It can fail and will return STILL_PLAYING if
 // midi data is still being accessed, or samples, or instruments.
@@ -1237,6 +1623,8 @@ OPErr GM_FreeSong(void *threadContext, GM_Song *pSong)
             GM_PauseSong(pSong, TRUE);
             // remove any events associated with this song
             GM_KillSongEventsFromQueue(pSong);
+            // and any instruments still waiting to load into it
+            GM_CancelSongInstrumentRequests(pSong);
 
             midiData = (XPTR)pSong->sequenceData; // save midi pointer now
             pSong->sequenceData = NULL;           // and disable midi decoder now, just
@@ -1251,6 +1639,8 @@ OPErr GM_FreeSong(void *threadContext, GM_Song *pSong)
                     XDisposePtr(midiData);
                 }
                 XDisposePtr((XPTR)pSong->controllerCallback);
+                PV_FreeSeekIndex(pSong);
+                PV_FreeEventStream(pSong);
 
 #if 0 && USE_CREATION_API == TRUE
                 if (pSong->pPatchInfo)
@@ -1300,7 +1690,8 @@ UINT32 GM_GetSongTickLength(GM_Song *pSong, OPErr *pErr)
     }
     if (pSong->songMidiTickLength == (UFLOAT)0)
     {
-        theSong = (GM_Song *)XNewPtr(sizeof(GM_Song));
+        PV_GetSeekIndex(pSong); // record checkpoints while we scan
+        theSong = (GM_Song *)XNewTaggedPtr(sizeof(GM_Song), X_MEMORY_SONGS);
         if (theSong)
         {
             *theSong = *pSong;
@@ -1355,6 +1746,8 @@ UINT32 GM_GetSongTickLength(GM_Song *pSong, OPErr *pErr)
                     tickLength = 0;
                 }
             }
+            theSong->seekIndex = NULL; // owned by pSong
+            theSong->eventStream = NULL;
             // don't need a thread context here because we don't callback
             GM_FreeSong(NULL, theSong); // we ignore the error codes, because it should be ok to dispose
                                         // since this song was never engaged
@@ -1390,7 +1783,7 @@ void PV_TrackNameCallback(void *threadContext, GM_Song *pSong, char markerType,
     { // track name
         if (currentTrack != -1)
         {
-            str = (XBYTE *)XNewPtr(metaTextLength + 1);
+            str = (XBYTE *)XNewTaggedPtr(metaTextLength + 1, X_MEMORY_SONGS);
             if (str)
             {
                 XBlockMove(pMetaText, str + 1, metaTextLength);
@@ -1430,7 +1823,7 @@ OPErr GM_GetSongInstrumentChanges(void *theSongResource, GM_Song **outSong, XBYT
     // first pass: count the program changes, so we know how big to make our
     if (err == NO_ERR)
     {
-        theSong->pPatchInfo = (PatchInfo *)XNewPtr(sizeof(PatchInfo));
+        theSong->pPatchInfo = (PatchInfo *)XNewTaggedPtr(sizeof(PatchInfo), X_MEMORY_SONGS);
         if (theSong->pPatchInfo)
         {
             saveScan = theSong->AnalyzeMode;
@@ -1466,7 +1859,7 @@ OPErr GM_GetSongInstrumentChanges(void *theSongResource, GM_Song **outSong, XBYT
     if (err == NO_ERR)
     {
         // expand the ptr enough to accomodate bank messages (4 bytes each)
-        newMidiData = XNewPtr(XGetPtrSize(theSong->midiData) + theSong->pPatchInfo->instrCount * 4);
+        newMidiData = XNewTaggedPtr(XGetPtrSize(theSong->midiData) + theSong->pPatchInfo->instrCount * 4, X_MEMORY_SONGS);
         XBlockMove(theSong->midiData,newMidiData,XGetPtrSize(theSong->midiData));
         XDisposePtr(theSong->midiData);
         theSong->midiData = newMidiData;
@@ -1530,7 +1923,8 @@ OPErr GM_SetSongTickPosition(GM_Song *pSong, UINT32 songTickPosition)
         return NOT_SETUP;
     }
     theErr = NO_ERR;
-    theSong = (GM_Song *)XNewPtr(sizeof(GM_Song));
+    PV_GetSeekIndex(pSong);
+    theSong = (GM_Song *)XNewTaggedPtr(sizeof(GM_Song), X_MEMORY_SONGS);
     if (theSong)
     {
         *theSong = *pSong;
@@ -1550,6 +1944,7 @@ OPErr GM_SetSongTickPosition(GM_Song *pSong, UINT32 songTickPosition)
                 songPaused = TRUE;
             }
             GM_PauseSong(pSong, TRUE);
+            PV_RestoreSeekCheckpoint(theSong, (UFLOAT)songTickPosition, TRUE);
             while (theSong->SomeTrackIsAlive)
             {
                 // don't need a thread context here because we don't callback
@@ -1591,6 +1986,8 @@ OPErr GM_SetSongTickPosition(GM_Song *pSong, UINT32 songTickPosition)
             theSong->metaEventCallbackPtr = NULL;
             theSong->controllerCallback = NULL;
         }
+        theSong->seekIndex = NULL; // owned by pSong
+        theSong->eventStream = NULL;
         // don't need a thread context here because we don't callback
         GM_FreeSong(NULL, theSong); // we ignore the error codes, because it should be ok to dispose
                                     // since this song was never engaged
@@ -1610,19 +2007,24 @@ UINT32 GM_SongTicks(GM_Song *pSong)
     return 0L;
 }
 
-UINT32 GM_SongMicroseconds(GM_Song *pSong)
+uint64_t GM_SongMicroseconds64(GM_Song *pSong)
 {
     if (pSong)
     {
         if (GM_IsSongDone(pSong) == FALSE)
         {
-            // XXX - callers should check for overflow
-            return (UINT32)pSong->songMicroseconds;
+            return (uint64_t)pSong->songMicroseconds;
         }
     }
     return 0L;
 }
 
+// 32 bit position. Wraps for songs that have been playing longer than about 71 minutes.
+UINT32 GM_SongMicroseconds(GM_Song *pSong)
+{
+    return (UINT32)GM_SongMicroseconds64(pSong);
+}
+
 UINT32 GM_GetSongMicrosecondLength(GM_Song *pSong, OPErr *pErr)
 {
     UINT32 ms;
@@ -1645,6 +2047,380 @@ UINT32 GM_GetSongMicrosecondLength(GM_Song *pSong, OPErr *pErr)
     return ms;
 }
 
+// Fast length scan. See GM_ScanMidiLength
+
+struct PV_ScanTrack
+{
+    XBYTE       *pStream;       // next delta time or event
+    XBYTE       *pEnd;          // end of track data
+    uint64_t    nextTick;       // file tick of the next event
+    XBYTE       runningStatus;
+    XBOOL       alive;
+};
+typedef struct PV_ScanTrack PV_ScanTrack;
+
+// read a variable length number without walking past pEnd
+static XBOOL PV_ScanReadVariableLength(XBYTE **ppStream, XBYTE *pEnd, XDWORD *pValue)
+{
+    XBYTE *pStream;
+    XDWORD value;
+    int16_t count;
+
+    pStream = *ppStream;
+    value = 0;
+    for (count = 0; count < 4; count++)
+    {
+        if (pStream >= pEnd)
+        {
+            return FALSE;
+        }
+        value = (value << 7) | (*pStream & 0x7F);
+        if ((*pStream++ & 0x80) == 0)
+        {
+            *ppStream = pStream;
+            *pValue = value;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// read the next delta time of a track, or retire the track if it has run out of data
+static void PV_ScanNextDelta(PV_ScanTrack *pTrack)
+{
+    XDWORD delta;
+
+    if (PV_ScanReadVariableLength(&pTrack->pStream, pTrack->pEnd, &delta))
+    {
+        pTrack->nextTick += delta;
+    }
+    else
+    {
+        pTrack->alive = FALSE;
+    }
+}
+
+// Work out how song time advances at a tempo: microseconds = ticks * mult * XFIXED_1 / scale.
+// When a mixer is open this follows the arithmetic of GM_SetSongTempo & PV_ScaleDivision, so the
+// length matches what the sequencer actually plays, otherwise the exact midi timing is used.
+static XBOOL PV_ScanSetTempo(XDWORD tempo, XDWORD division, XDWORD masterTempo, uint64_t *pMult, uint64_t *pScale)
+{
+    XDWORD sliceTime;
+    UFLOAT midiTempo, midiDivision;
+
+    sliceTime = (MusicGlobals) ? BAE_GetSliceTimeInMicroseconds() : 0;
+    if (sliceTime)
+    {
+        midiTempo = (UFLOAT)tempo / (UFLOAT)sliceTime;
+        midiDivision = 0;
+        if (midiTempo)
+        {
+            midiDivision = ((UFLOAT)division * (UFLOAT)64) / midiTempo;
+            midiDivision = (midiDivision * (UFLOAT)masterTempo) / 0x10000L;
+        }
+        *pMult = (uint64_t)64 * sliceTime;
+#if USE_FLOAT == FALSE
+        *pScale = (uint64_t)midiDivision << 16;
+#else
+        *pScale = (uint64_t)(midiDivision * XFIXED_1);
+#endif
+    }
+    else
+    {
+        *pMult = tempo;
+        *pScale = (uint64_t)division * masterTempo;
+    }
+    return (*pScale) ? TRUE : FALSE;
+}
+
+// Return the play length of standard midi file data without creating a song or running the
+// sequencer. Loop markers are handled as PV_ProcessMetaMarkerEvents does, except that endless
+// loops are only counted once.
+OPErr GM_ScanMidiLength(void *theExternalSong, void const *pMidiData, int32_t midiSize,
+                        XDWORD *pTicks, XDWORD *pMicroseconds)
+{
+    PV_ScanTrack *pTracks, *pSaveTracks, *pTrack;
+    XBYTE *pStream, *pEnd, *pData;
+    XDWORD length, value;
+    int32_t count, size;
+    int16_t trackCount, current;
+    XBYTE status;
+    XDWORD division, tempo, masterTempo;
+    uint64_t currentTick, saveTick, totalTicks, totalMicroseconds;
+    uint64_t scaled, scale, mult;
+    XBOOL loopSaved;
+    XSBYTE loopCount;
+    OPErr theErr;
+
+    if ((pMidiData == NULL) || (midiSize < 22))
+    {
+        return PARAM_ERR;
+    }
+    masterTempo = XFIXED_1;
+    if (theExternalSong)
+    {
+        switch (XGetSongResourceObjectType((SongResource *)theExternalSong))
+        {
+        case SONG_TYPE_SMS:
+            masterTempo = (XDWORD)PV_TranslateSongTempo(XGetShort(&((SongResource_SMS *)theExternalSong)->songTempo));
+            break;
+        case SONG_TYPE_RMF:
+            masterTempo = (XDWORD)PV_TranslateSongTempo(XGetShort(&((SongResource_RMF *)theExternalSong)->songTempo));
+            break;
+        default:
+            break;
+        }
+    }
+
+    // find the header the same way PV_ConfigureMusic does, which also skips RMI wrappers
+    pStream = (XBYTE *)pMidiData;
+    pEnd = pStream + midiSize;
+    size = (midiSize < 3000 - (int32_t)sizeof(long)) ? midiSize : 3000 - (int32_t)sizeof(long);
+    for (count = 0; count < size; count++)
+    {
+        if (XGetLong(pStream) == ID_MTHD)
+        {
+            break;
+        }
+        pStream++;
+    }
+    if ((count == size) || (pStream + 14 > pEnd) || (XGetShort(&pStream[8]) > 1))
+    {
+        return BAD_MIDI_DATA;
+    }
+    division = XGetShort(&pStream[12]);
+    if (division == 0)
+    {
+        return BAD_MIDI_DATA;
+    }
+    length = XGetLong(&pStream[4]);
+    if (length > (XDWORD)(pEnd - pStream) - 8)
+    {
+        return BAD_MIDI_DATA;
+    }
+    pStream += 8 + length;
+
+    pTracks = (PV_ScanTrack *)XNewTaggedPtr((int32_t)sizeof(PV_ScanTrack) * MAX_TRACKS * 2, X_MEMORY_SONGS);
+    if (pTracks == NULL)
+    {
+        return MEMORY_ERR;
+    }
+    pSaveTracks = pTracks + MAX_TRACKS;
+
+    // locate tracks. Unknown chunks are skipped
+    trackCount = 0;
+    while ((pStream + 8 <= pEnd) && (trackCount < MAX_TRACKS))
+    {
+        length = XGetLong(&pStream[4]);
+        pData = pStream + 8;
+        if (length > (XDWORD)(pEnd - pData))
+        {
+            length = (XDWORD)(pEnd - pData); // truncated file, take what is there
+        }
+        if (XGetLong(pStream) == ID_MTRK)
+        {
+            pTrack = &pTracks[trackCount++];
+            pTrack->pStream = pData;
+            pTrack->pEnd = pData + length;
+            pTrack->nextTick = 0;
+            pTrack->runningStatus = 0;
+            pTrack->alive = TRUE;
+            PV_ScanNextDelta(pTrack);
+        }
+        pStream = pData + length;
+    }
+
+    theErr = NO_ERR;
+    tempo = 500000; // default midi tempo in microseconds per quarter note
+    PV_ScanSetTempo(tempo, division, masterTempo, &mult, &scale);
+    currentTick = 0;
+    saveTick = 0;
+    totalTicks = 0;
+    totalMicroseconds = 0;
+    loopSaved = FALSE;
+    loopCount = 0;
+    while (theErr == NO_ERR)
+    {
+        // next event in time. Ties go to the lowest track, like the sequencer
+        pTrack = NULL;
+        for (current = 0; current < trackCount; current++)
+        {
+            if (pTracks[current].alive)
+            {
+                if ((pTrack == NULL) || (pTracks[current].nextTick < pTrack->nextTick))
+                {
+                    pTrack = &pTracks[current];
+                }
+            }
+        }
+        if (pTrack == NULL)
+        {
+            break; // all tracks have ended
+        }
+        if (pTrack->nextTick > currentTick)
+        {
+            if (scale == 0)
+            {
+                theErr = OUT_OF_RANGE; // tempo too fast for the slice time, the sequencer would stall
+                break;
+            }
+            // split so it can't overflow
+            totalTicks += pTrack->nextTick - currentTick;
+            scaled = (pTrack->nextTick - currentTick) * mult;
+            totalMicroseconds += (scaled / scale) * XFIXED_1 + ((scaled % scale) * XFIXED_1) / scale;
+            currentTick = pTrack->nextTick;
+            if (totalMicroseconds >= 3600000000u)
+            {
+                theErr = OUT_OF_RANGE; // same limit as GM_GetSongTickLength
+                break;
+            }
+        }
+
+        pStream = pTrack->pStream;
+        pEnd = pTrack->pEnd;
+        if (pStream >= pEnd)
+        {
+            pTrack->alive = FALSE;
+            continue;
+        }
+        status = *pStream;
+        if (status & 0x80)
+        {
+            pStream++;
+            if (status < 0xF0)
+            {
+                pTrack->runningStatus = status;
+            }
+        }
+        else
+        {
+            status = pTrack->runningStatus;
+            if (status == 0)
+            {
+                theErr = BAD_MIDI_DATA;
+                break;
+            }
+        }
+
+        if (status == 0xFF)
+        {
+            XBYTE type;
+
+            if (pStream >= pEnd)
+            {
+                pTrack->alive = FALSE;
+                continue;
+            }
+            type = *pStream++;
+            if (PV_ScanReadVariableLength(&pStream, pEnd, &length) == FALSE ||
+                (length > (XDWORD)(pEnd - pStream)))
+            {
+                pTrack->alive = FALSE;
+                continue;
+            }
+            if (type == 0x2F) // end of track
+            {
+                pTrack->alive = FALSE;
+                continue;
+            }
+            if ((type == 0x51) && (length >= 3)) // tempo
+            {
+                value = ((XDWORD)pStream[0] << 16) | ((XDWORD)pStream[1] << 8) | pStream[2];
+                if (value)
+                {
+                    tempo = value;
+                    PV_ScanSetTempo(tempo, division, masterTempo, &mult, &scale);
+                }
+            }
+            else if ((type == 0x06) && (length >= 1)) // marker
+            {
+                char *pText = (char *)pStream;
+
+                if (((length >= 9) && (XLStrnCmp("loopstart", pText, 9) == 0)) ||
+                    ((length >= 5) && (XLStrnCmp("start", pText, 5) == 0)) ||
+                    (XLStrnCmp("[", pText, 1) == 0))
+                {
+                    if (loopSaved == FALSE) // only allow one save
+                    {
+                        count = -1; // loop forever
+                        if ((length >= 10) && (XLStrnCmp("loopstart=", pText, 10) == 0))
+                        {
+                            count = XStrnToLong(&pText[10], (int32_t)length - 10);
+                        }
+                        loopCount = (XSBYTE)count;
+                        loopSaved = TRUE;
+                        pTrack->pStream = pStream + length;
+                        PV_ScanNextDelta(pTrack);
+                        XBlockMove(pTracks, pSaveTracks, (int32_t)sizeof(PV_ScanTrack) * trackCount);
+                        saveTick = currentTick;
+                        continue;
+                    }
+                }
+                else if (((length >= 7) && (XLStrnCmp("loopend", pText, 7) == 0)) ||
+                         ((length >= 3) && (XLStrnCmp("end", pText, 3) == 0)) ||
+                         (XLStrnCmp("]", pText, 1) == 0))
+                {
+                    // endless loops (negative or 100 and above) are counted as one pass
+                    if (loopSaved && (loopCount > 0) && (loopCount < 100))
+                    {
+                        loopCount--;
+                        if (loopCount)
+                        {
+                            XBlockMove(pSaveTracks, pTracks, (int32_t)sizeof(PV_ScanTrack) * trackCount);
+                            currentTick = saveTick;
+                            continue;
+                        }
+                    }
+                }
+            }
+            pStream += length;
+        }
+        else if ((status == 0xF0) || (status == 0xF7)) // sysex
+        {
+            if (PV_ScanReadVariableLength(&pStream, pEnd, &length) == FALSE ||
+                (length > (XDWORD)(pEnd - pStream)))
+            {
+                pTrack->alive = FALSE;
+                continue;
+            }
+            pStream += length;
+        }
+        else if (status < 0xF0)
+        {
+            switch (status & 0xF0)
+            {
+            case 0xC0: // program change
+            case 0xD0: // channel pressure
+                pStream += 1;
+                break;
+            default:
+                pStream += 2;
+                break;
+            }
+        }
+        pTrack->pStream = pStream;
+        PV_ScanNextDelta(pTrack);
+    }
+    XDisposePtr((XPTR)pTracks);
+
+    if (theErr == NO_ERR)
+    {
+        if (trackCount == 0)
+        {
+            theErr = BAD_MIDI_DATA;
+        }
+    }
+    if (pTicks)
+    {
+        *pTicks = (theErr == NO_ERR) ? (XDWORD)totalTicks : 0;
+    }
+    if (pMicroseconds)
+    {
+        *pMicroseconds = (theErr == NO_ERR) ? (XDWORD)totalMicroseconds : 0;
+    }
+    return theErr;
+}
+
 // Set the song position in microseconds
 // $$kk: 08.12.98 merge: changed this method
 OPErr GM_SetSongMicrosecondPosition(GM_Song *pSong, UINT32 songMicrosecondPosition)
@@ -1666,7 +2442,8 @@ OPErr GM_SetSongMicrosecondPosition(GM_Song *pSong, UINT32 songMicrosecondPositi
         return NOT_SETUP;
     }
     theErr = NO_ERR;
-    theSong = (GM_Song *)XNewPtr(sizeof(GM_Song));
+    PV_GetSeekIndex(pSong);
+    theSong = (GM_Song *)XNewTaggedPtr(sizeof(GM_Song), X_MEMORY_SONGS);
     if (theSong)
     {
         *theSong = *pSong;
@@ -1688,6 +2465,7 @@ OPErr GM_SetSongMicrosecondPosition(GM_Song *pSong, UINT32 songMicrosecondPositi
                 songPaused = TRUE;
             }
             GM_PauseSong(pSong, TRUE);
+            PV_RestoreSeekCheckpoint(theSong, (UFLOAT)songMicrosecondPosition, FALSE);
             while (theSong->SomeTrackIsAlive)
             {
                 // don't need a thread context here because we don't callback
@@ -1726,7 +2504,12 @@ OPErr GM_SetSongMicrosecondPosition(GM_Song *pSong, UINT32 songMicrosecondPositi
             theSong->sequenceData = NULL;
             theSong->songEndCallbackPtr = NULL;
             theSong->disposeSongDataWhenDone = FALSE;
+            theSong->songTimeCallbackPtr = NULL;
+            theSong->metaEventCallbackPtr = NULL;
+            theSong->controllerCallback = NULL; // now owned by pSong, don't free it twice
         }
+        theSong->seekIndex = NULL; // owned by pSong
+        theSong->eventStream = NULL;
         // don't need a thread context here because we don't callback
         GM_FreeSong(NULL, theSong); // we ignore the error codes, because it should be ok to dispose
                                     // since this song was never engaged
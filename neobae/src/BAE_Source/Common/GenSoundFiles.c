@@ -1368,7 +1368,7 @@ static OPErr PV_ReadWAVEAndDecompressIMA(XFILE fileReference, uint32_t sourceLen
     customBlockBuffer = FALSE;
     if (pBlockBuffer == NULL)
     {
-        pBlockBuffer = XNewPtr(blockSize);
+        pBlockBuffer = XNewTaggedPtr(blockSize, X_MEMORY_DECODERS);
         customBlockBuffer = TRUE;
     }
     if (pBlockBuffer)
@@ -1438,13 +1438,13 @@ static GM_Waveform* PV_ReadIntoMemoryWaveFile(XFILE file, XBOOL decodeData,
     BAE_ASSERT(pError);
     wave = NULL;
 
-    pIFF = (X_IFF*)XNewPtr(sizeof(X_IFF));
+    pIFF = (X_IFF*)XNewTaggedPtr(sizeof(X_IFF), X_MEMORY_DECODERS);
     if (pIFF)
     {
         IFF_SetFormType(pIFF, X_RIFF);
         pIFF->fileReference = file;
 
-        wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+        wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
         if (wave)
         {
         XWaveHeaderIMA      waveHeader;
@@ -1498,7 +1498,7 @@ static GM_Waveform* PV_ReadIntoMemoryWaveFile(XFILE file, XBOOL decodeData,
                     }
                     else    // if (decodeData) // for now
                     {
-                        wave->theWaveform = (SBYTE *)XNewPtr(size);
+                        wave->theWaveform = (SBYTE *)XNewTaggedPtr(size, X_MEMORY_SAMPLES);
                         if (wave->theWaveform)
                         {
                             switch(waveHeader.wfx.wFormatTag)
@@ -2472,13 +2472,13 @@ X_IFF               *pIFF;
 
     wave = NULL;
     
-    pIFF = (X_IFF*)XNewPtr(sizeof(X_IFF));
+    pIFF = (X_IFF*)XNewTaggedPtr(sizeof(X_IFF), X_MEMORY_DECODERS);
     if (pIFF)
     {
         IFF_SetFormType(pIFF, X_FORM);
         pIFF->fileReference = file;
 
-        wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+        wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
         if (wave)
         {
         int32_t                type;
@@ -2548,7 +2548,7 @@ X_IFF               *pIFF;
                         switch (aiffHeader.compressionType)
                         {
                         case X_NONE:
-                            wave->theWaveform = (SBYTE*)XNewPtr(size);
+                            wave->theWaveform = (SBYTE*)XNewTaggedPtr(size, X_MEMORY_SAMPLES);
                             if (wave->theWaveform)
                             {
                                 if (XFileRead(pIFF->fileReference, wave->theWaveform, size) != -1)
@@ -2575,7 +2575,7 @@ X_IFF               *pIFF;
                         case X_IMA4:
                             if (decodeData)
                             {
-                                wave->theWaveform = (SBYTE*)XNewPtr(size);
+                                wave->theWaveform = (SBYTE*)XNewTaggedPtr(size, X_MEMORY_SAMPLES);
                                 if (wave->theWaveform)
                                 {
                                 int16_t       predictorCache[2];
@@ -2605,7 +2605,7 @@ X_IFF               *pIFF;
                                 
                                 wave->waveSize = imaBlocks * wave->channels * AIFF_IMA_BLOCK_BYTES;
                                 BAE_ASSERT(wave->waveSize > 0);
-                                wave->theWaveform = (SBYTE*)XNewPtr(wave->waveSize);
+                                wave->theWaveform = (SBYTE*)XNewTaggedPtr(wave->waveSize, X_MEMORY_SAMPLES);
                                 if (wave->theWaveform)
                                 {
                                     if (XFileRead(file, wave->theWaveform, wave->waveSize))
@@ -2729,7 +2729,7 @@ SunAudioFileHeader  sunHeader;
 
             if (err == NO_ERR)
             {
-                wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+                wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
                 if (wave)
                 {
                     wave->channels = (UBYTE)XGetLong(&sunHeader.channels);
@@ -2758,7 +2758,7 @@ SunAudioFileHeader  sunHeader;
                     }
                     else    // if (decodeData) // for now
                     {
-                        wave->theWaveform = (SBYTE*)XNewPtr(wave->waveSize);
+                        wave->theWaveform = (SBYTE*)XNewTaggedPtr(wave->waveSize, X_MEMORY_SAMPLES);
                         if (wave->theWaveform)
                         {
                             err = PV_ReadSunAUFile(encoding, file,
@@ -2832,7 +2832,7 @@ XMPEGDecodedData*   stream;
     stream = XOpenMPEGStreamFromXFILE(file, &err);
     if (stream && (err == NO_ERR))
     {
-        wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+        wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
         if (wave)
         {
             wave->channels = (UBYTE)stream->channels;
@@ -2865,7 +2865,7 @@ XMPEGDecodedData*   stream;
             UINT32      const decodingBytes = stream->maxFrameBuffers * stream->frameBufferSize;
             
                 BAE_ASSERT(wave->waveSize <= decodingBytes);
-                wave->theWaveform = (SBYTE*)XNewPtr(decodingBytes);
+                wave->theWaveform = (SBYTE*)XNewTaggedPtr(decodingBytes, X_MEMORY_SAMPLES);
                 if (wave->theWaveform)
                 {
                     // now decode the mpeg sample and store into the resulting buffer
@@ -2910,7 +2910,7 @@ XMPEGDecodedData*   stream;
             UINT32      const encodedBytes = XFileGetLength(file);
             
                 wave->waveSize = encodedBytes;
-                wave->theWaveform = (SBYTE*)XNewPtr(encodedBytes);
+                wave->theWaveform = (SBYTE*)XNewTaggedPtr(encodedBytes, X_MEMORY_SAMPLES);
                 if (wave->theWaveform)
                 {
                     if (XFileSetPosition(file, 0) ||
@@ -3211,7 +3211,7 @@ static GM_Waveform* PV_ReadIntoMemoryFLACFile(XFILE file, XBOOL decodeData,
     }
     
     // Allocate memory for the entire file
-    XBYTE* fileBuffer = (XBYTE*)XNewPtr(fileSize);
+    XBYTE* fileBuffer = (XBYTE*)XNewTaggedPtr(fileSize, X_MEMORY_DECODERS);
     if (!fileBuffer) {
         err = MEMORY_ERR;
         goto cleanup;
@@ -3245,7 +3245,7 @@ static GM_Waveform* PV_ReadIntoMemoryFLACFile(XFILE file, XBOOL decodeData,
     
     
     // Allocate waveform structure
-    wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+    wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
     if (!wave) {
         err = MEMORY_ERR;
         goto cleanup;
@@ -3260,7 +3260,7 @@ static GM_Waveform* PV_ReadIntoMemoryFLACFile(XFILE file, XBOOL decodeData,
     
     if (decodeData) {
         // For now, just allocate some space but don't decode
-        wave->theWaveform = (SBYTE*)XNewPtr(1024); // Small test allocation
+        wave->theWaveform = (SBYTE*)XNewTaggedPtr(1024, X_MEMORY_SAMPLES); // Small test allocation
         if (!wave->theWaveform) {
             err = MEMORY_ERR;
             goto cleanup;
@@ -3314,7 +3314,7 @@ static GM_Waveform* PV_ReadIntoMemoryFLACFile(XFILE file, XBOOL decodeData,
     // correctly.
     uint32_t outBytesPerSample = 2; // 16-bit output
     uint32_t outSize = (uint32_t)wave->waveFrames * (uint32_t)wave->channels * outBytesPerSample;
-    state.sampleData = (SBYTE*)XNewPtr(outSize);
+    state.sampleData = (SBYTE*)XNewTaggedPtr(outSize, X_MEMORY_SAMPLES);
         if (!state.sampleData) {
             err = MEMORY_ERR;
             goto cleanup;
@@ -3432,7 +3432,7 @@ OPErr XExpandVorbis(GM_Waveform const* src, UINT32 startFrame, GM_Waveform* dst)
             const uint32_t requestedBytes = availableFrames * bytesPerFrame;
             
             // Allocate memory for decoded audio data
-            dst->theWaveform = (SBYTE*)XNewPtr(requestedBytes);
+            dst->theWaveform = (SBYTE*)XNewTaggedPtr(requestedBytes, X_MEMORY_SAMPLES);
             if (!dst->theWaveform)
             {
                 GM_FreeWaveform(decoded);
@@ -3527,7 +3527,7 @@ static GM_Waveform* PV_ReadIntoMemoryVorbisFile(XFILE file, XBOOL decodeData,
     channels = vi->channels;
     
     // Allocate waveform structure
-    wave = (GM_Waveform*)XNewPtr(sizeof(GM_Waveform));
+    wave = (GM_Waveform*)XNewTaggedPtr(sizeof(GM_Waveform), X_MEMORY_SAMPLES);
     if (wave == NULL) {
         ov_clear(&vf);
         *pError = MEMORY_ERR;
@@ -3556,7 +3556,7 @@ static GM_Waveform* PV_ReadIntoMemoryVorbisFile(XFILE file, XBOOL decodeData,
         const uint32_t readChunk = 16 * 1024;
 
         capacity = minChunk;
-        wave->theWaveform = (SBYTE*)XNewPtr(capacity);
+        wave->theWaveform = (SBYTE*)XNewTaggedPtr(capacity, X_MEMORY_SAMPLES);
         if (wave->theWaveform == NULL) {
             ov_clear(&vf);
             XDisposePtr(wave);
@@ -4063,7 +4063,7 @@ static GM_Waveform *PV_ReadFileInformationFLACFile(XFILE file,
         }
     }
 
-    wave = (GM_Waveform *)XNewPtr((int32_t)sizeof(GM_Waveform));
+    wave = (GM_Waveform *)XNewTaggedPtr((int32_t)sizeof(GM_Waveform), X_MEMORY_SAMPLES);
     if (!wave)
     {
         *pError = MEMORY_ERR;
@@ -4120,7 +4120,7 @@ void * GM_CreateFileState(AudioFileType fileType)
     switch (fileType)
     {
         case FILE_AU_TYPE:
-            state = (void *)XNewPtr(sizeof(SunDecodeState));
+            state = (void *)XNewTaggedPtr(sizeof(SunDecodeState), X_MEMORY_DECODERS);
             if (state)
             {
                 g72x_init_state(&((SunDecodeState *)state)->state);
@@ -4131,7 +4131,7 @@ void * GM_CreateFileState(AudioFileType fileType)
 
 #if USE_VORBIS_DECODER != FALSE
         case FILE_VORBIS_TYPE:
-            state = (void *)XNewPtr(sizeof(VorbisStreamState));
+            state = (void *)XNewTaggedPtr(sizeof(VorbisStreamState), X_MEMORY_DECODERS);
             if (state)
             {
                 XSetMemory(state, (int32_t)sizeof(VorbisStreamState), 0);
@@ -4141,7 +4141,7 @@ void * GM_CreateFileState(AudioFileType fileType)
 
 #if USE_FLAC_DECODER != FALSE
         case FILE_FLAC_TYPE:
-            state = (void *)XNewPtr(sizeof(FLACStreamState));
+            state = (void *)XNewTaggedPtr(sizeof(FLACStreamState), X_MEMORY_DECODERS);
             if (state)
             {
                 XSetMemory(state, (int32_t)sizeof(FLACStreamState), 0);
@@ -4196,7 +4196,7 @@ OPErr XExpandFLAC(GM_Waveform const* src, UINT32 startFrame, GM_Waveform* dst)
         uint32_t copyBytes = framesToCopy * bytesPerFrame;
 
         // Allocate buffer for dst waveform
-        dst->theWaveform = (XPTR)XNewPtr(copyBytes);
+        dst->theWaveform = (XPTR)XNewTaggedPtr(copyBytes, X_MEMORY_SAMPLES);
         if (!dst->theWaveform)
         {
             // cleanup
@@ -5476,7 +5476,7 @@ GM_Waveform * GM_ReadRawAudioIntoMemoryFromMemory(void * sampleData,
         if (pWave)
         {
             size = frames * (bitSize / 8) * channels;
-            copySampleData = XNewPtr(size);
+            copySampleData = XNewTaggedPtr(size, X_MEMORY_SAMPLES);
             if (copySampleData != NULL)
             {
                 XBlockMove(sampleData, copySampleData, size);
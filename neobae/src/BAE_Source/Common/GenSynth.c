@@ -2057,31 +2057,37 @@ static void PV_ServeThisInstrument(GM_Voice *pVoice)
     PV_UnlockInstrumentAndVoice(pVoice); // done processing
 }
 
-#ifdef BAE_COMPLETE
-static void PV_ClearReverbBuffer()
+#if defined(BAE_COMPLETE) && (REVERB_USED != REVERB_DISABLED)
+// TRUE if the current reverb unit reads songBufferReverb. The old fixed reverbs
+// read and modify songBufferDry in place instead.
+static XBOOL PV_ReverbUsesSendBuffer(void)
 {
-#if REVERB_USED != REVERB_DISABLED
-    // songBufferReverb is a per-slice send buffer. It MUST be cleared, otherwise
-    // old content keeps re-feeding the reverb every slice and notes "stack" forever.
-    // Historically only the variable reverb path cleared it; Neo reverb modes also
-    // consume songBufferReverb even though they're configured as "fixed".
-    XBOOL shouldClear = FALSE;
-
 #if REVERB_USED == VARIABLE_REVERB
     if (GM_IsReverbFixed() == FALSE)
     {
-        shouldClear = TRUE;
+        return TRUE;
     }
 #endif
-
 #if USE_NEO_EFFECTS == TRUE
     if (MusicGlobals->reverbUnitType >= REVERB_TYPE_12)
     {
-        shouldClear = TRUE;
+        return TRUE;
     }
+#endif
+    return FALSE;
+}
 #endif
 
-    if (shouldClear)
+#ifdef BAE_COMPLETE
+static void PV_ClearReverbBuffer()
+{
+#if REVERB_USED != REVERB_DISABLED
+    // songBufferReverb is a per-slice send buffer. It MUST be cleared, otherwise
+    // old content keeps re-feeding the reverb every slice and notes "stack" forever.
+    // Historically only the variable reverb path cleared it; Neo reverb modes also
+    // consume songBufferReverb even though they're configured as "fixed".
+    // Skipped when nothing was sent to it last slice.
+    if (PV_ReverbUsesSendBuffer() && (MusicGlobals->reverbSendIsClear == FALSE))
     {
         register INT32 *destL = &MusicGlobals->songBufferReverb[0];
         register LOOPCOUNT count, four_loop = MusicGlobals->Four_Loop;
@@ -2106,6 +2112,10 @@ static void PV_ClearChorusBuffer()
     register INT32 *destL = &MusicGlobals->songBufferChorus[0];
     register LOOPCOUNT count, four_loop = MusicGlobals->Four_Loop;
 
+    if (MusicGlobals->chorusSendIsClear)
+    {
+        return;
+    }
     for (count = 0; count < four_loop; count++)
     {
         destL[0] = 0;
@@ -2163,6 +2173,325 @@ INLINE static void PV_ClearMixBuffers(XBOOL doStereo)
 }
 #endif
 
+#if defined(BAE_COMPLETE) && (REVERB_USED != REVERB_DISABLED)
+// An effect whose bus has been silent, and whose output has stayed below one output
+// LSB, for this long is bypassed until something is sent to it again. The hold spans
+// the longest gap between echoes of the Neo tap and comb reverbs.
+#define PV_EFFECT_TAIL_HOLD_US      1000000L
+#define PV_EFFECT_TAIL_FLOOR        (1L << OUTPUT_SCALAR)
+
+typedef void (*PV_EffectProc)(INT32 *pSend, INT32 *pDest);
+
+#if USE_NEW_EFFECTS
+static void PV_RunChorusUnit(INT32 *pSend, INT32 *pDest)
+{
+    RunChorus(pSend, pDest, MusicGlobals->One_Loop);
+}
+
+static void PV_SkipChorusUnit(INT32 *pSend, INT32 *pDest)
+{
+    SkipChorus(MusicGlobals->One_Loop);
+}
+#endif
+
+static void PV_RunReverbUnit(INT32 *pSend, INT32 *pDest)
+{
+    GM_ProcessReverbBuses(pSend, pDest);
+}
+
+// Returns TRUE if count samples starting at pBus are all zero
+static XBOOL PV_IsBusClear(INT32 const *pBus, LOOPCOUNT count)
+{
+    while (count--)
+    {
+        if (*pBus++)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// Run effectProc, whose input this slice is inputCount samples at pInput and which mixes
+// into pDest. While the input is silent, measure how much the effect changes pDest; once
+// that has stayed under PV_EFFECT_TAIL_FLOOR for PV_EFFECT_TAIL_HOLD_US the effect is
+// skipped, calling skipProc instead if there is one. Any input resumes it on the same slice.
+// Returns TRUE if the input was silent.
+static XBOOL PV_RunEffectUnit(PV_EffectProc effectProc, PV_EffectProc skipProc,
+                              INT32 *pInput, LOOPCOUNT inputCount, INT32 *pDest,
+                              XDWORD *pQuietSlices)
+{
+    GM_Mixer    *pMixer;
+    INT32       before[(MAX_CHUNK_SIZE+64)*2];
+    INT32       delta, peak;
+    LOOPCOUNT   count, samples;
+
+    pMixer = MusicGlobals;
+    if (PV_IsBusClear(pInput, inputCount) == FALSE)
+    {
+        *pQuietSlices = 0;
+        (*effectProc)(pInput, pDest);
+        return FALSE;
+    }
+    if (*pQuietSlices >= (XDWORD)(PV_EFFECT_TAIL_HOLD_US / BAE_GetSliceTimeInMicroseconds()))
+    {
+        if (skipProc)
+        {
+            (*skipProc)(pInput, pDest);  // tail has died away
+        }
+        return TRUE;
+    }
+
+    samples = pMixer->One_Loop * (pMixer->generateStereoOutput ? 2 : 1);
+    XBlockMove(pDest, before, samples * (LOOPCOUNT)sizeof(INT32));
+    (*effectProc)(pInput, pDest);
+    peak = 0;
+    for (count = 0; count < samples; count++)
+    {
+        delta = pDest[count] - before[count];
+        if (delta < 0)
+        {
+            delta = -delta;
+        }
+        if (delta > peak)
+        {
+            peak = delta;
+        }
+    }
+    if (peak < PV_EFFECT_TAIL_FLOOR)
+    {
+        (*pQuietSlices)++;
+    }
+    else
+    {
+        *pQuietSlices = 0;
+    }
+    return TRUE;
+}
+
+// Run the chorus and reverb units from the send buses into pDest, bypassing any whose
+// tail has finished. Sets *pReverbSendIsClear and *pChorusSendIsClear to whether the
+// send buses were silent.
+static void PV_RunEffectUnits(INT32 *pReverbSend, INT32 *pChorusSend, INT32 *pDest,
+                              XBOOL *pReverbSendIsClear, XBOOL *pChorusSendIsClear)
+{
+    GM_Mixer    *pMixer;
+
+    pMixer = MusicGlobals;
+#if USE_NEW_EFFECTS
+    *pChorusSendIsClear = PV_RunEffectUnit(PV_RunChorusUnit, PV_SkipChorusUnit,
+                                           pChorusSend, pMixer->One_Loop, pDest,
+                                           &pMixer->chorusQuietSlices);
+#endif
+    if (PV_ReverbUsesSendBuffer())
+    {
+        *pReverbSendIsClear = PV_RunEffectUnit(PV_RunReverbUnit, NULL,
+                                               pReverbSend, pMixer->One_Loop, pDest,
+                                               &pMixer->reverbQuietSlices);
+    }
+    else
+    {
+        PV_RunEffectUnit(PV_RunReverbUnit, NULL, pDest,
+                         pMixer->One_Loop * (pMixer->generateStereoOutput ? 2 : 1), pDest,
+                         &pMixer->reverbQuietSlices);
+        *pReverbSendIsClear = FALSE;
+    }
+}
+
+// Run the effects on this slice's send buses, mixing into the dry bus
+static void PV_RunMixerEffectUnits(void)
+{
+    GM_Mixer    *pMixer;
+
+    pMixer = MusicGlobals;
+    PV_RunEffectUnits(pMixer->songBufferReverb, pMixer->songBufferChorus, pMixer->songBufferDry,
+                      &pMixer->reverbSendIsClear, &pMixer->chorusSendIsClear);
+}
+
+// Pipelined effects. With the effects thread enabled, the send buses of each slice are
+// copied to the worker at the end of voice mixing. The worker runs the effects on them
+// while the audio thread mixes the voices of the next slice, and the wet result is added
+// to that next slice, so the effects come out one slice late. The worker only runs while
+// the audio thread is inside BAE_BuildMixerSlice, so anything that waits for
+// insideAudioInterrupt to drop also knows the effects are idle.
+static void PV_RunEffectsJob(GM_EffectsThread *pEffects)
+{
+    XBOOL   reverbClear, chorusClear;
+
+    XSetMemory(pEffects->wet, (int32_t)sizeof(pEffects->wet), 0);
+    PV_RunEffectUnits(pEffects->reverbSend, pEffects->chorusSend, pEffects->wet,
+                      &reverbClear, &chorusClear);
+}
+
+static void PV_EffectsThreadProc(void *context)
+{
+    GM_EffectsThread    *pEffects;
+
+    pEffects = (GM_EffectsThread *)context;
+    while (1)
+    {
+        BAE_WaitEvent(pEffects->startEvent);
+        if (pEffects->quit)
+        {
+            break;
+        }
+        PV_RunEffectsJob(pEffects);
+        BAE_SignalEvent(pEffects->doneEvent);
+    }
+}
+
+// Called before the voices are mixed. Starts the worker on the sends held from the last
+// slice. Returns the effects thread if this slice is pipelined.
+static GM_EffectsThread * PV_StartEffectsThread(void)
+{
+    GM_EffectsThread    *pEffects;
+
+    pEffects = MusicGlobals->pEffectsThread;
+    if (pEffects && pEffects->pending)
+    {
+        pEffects->pending = FALSE;
+        pEffects->running = TRUE;
+        BAE_SignalEvent(pEffects->startEvent);
+    }
+    return pEffects;
+}
+
+// Called after the voices are mixed. Adds the wet result of the last slice to the dry bus,
+// and holds this slice's sends for the worker.
+static void PV_FinishEffectsThread(GM_EffectsThread *pEffects)
+{
+    GM_Mixer    *pMixer;
+    INT32       *pDry, *pWet;
+    LOOPCOUNT   count, samples;
+
+    pMixer = MusicGlobals;
+    if (pEffects->running)
+    {
+        BAE_WaitEvent(pEffects->doneEvent);
+        pEffects->running = FALSE;
+
+        // the chorus writes stereo pairs even for mono output, like it does to songBufferDry
+        pDry = pMixer->songBufferDry;
+        pWet = pEffects->wet;
+        samples = pMixer->One_Loop * 2;
+        for (count = 0; count < samples; count++)
+        {
+            pDry[count] += pWet[count];
+        }
+    }
+    XBlockMove(pMixer->songBufferReverb, pEffects->reverbSend, pMixer->One_Loop * (int32_t)sizeof(INT32));
+    XBlockMove(pMixer->songBufferChorus, pEffects->chorusSend, pMixer->One_Loop * (int32_t)sizeof(INT32));
+    pMixer->reverbSendIsClear = PV_IsBusClear(pMixer->songBufferReverb, pMixer->One_Loop);
+    pMixer->chorusSendIsClear = PV_IsBusClear(pMixer->songBufferChorus, pMixer->One_Loop);
+    pEffects->pending = TRUE;
+}
+
+// Slices that aren't pipelined drop any sends held from the last one. This only happens
+// when switching to a fixed verb, which restarts the effects anyway.
+static void PV_DropEffectsThreadJob(void)
+{
+    GM_EffectsThread    *pEffects;
+
+    pEffects = MusicGlobals->pEffectsThread;
+    if (pEffects)
+    {
+        pEffects->pending = FALSE;
+    }
+}
+
+static void PV_FreeEffectsThread(GM_EffectsThread *pEffects)
+{
+    if (pEffects->startEvent)
+    {
+        BAE_DestroyEvent(pEffects->startEvent);
+    }
+    if (pEffects->doneEvent)
+    {
+        BAE_DestroyEvent(pEffects->doneEvent);
+    }
+    XDisposePtr((XPTR)pEffects);
+}
+
+// Enable or disable the effects thread. Fails with NOT_SETUP if the platform can't start
+// threads, in which case the effects stay on the audio thread. Do not call at interrupt time.
+OPErr GM_SetEffectsThreadEnabled(XBOOL enabled)
+{
+    GM_Mixer            *pMixer;
+    GM_EffectsThread    *pEffects;
+
+    pMixer = MusicGlobals;
+    if (pMixer == NULL)
+    {
+        return NOT_SETUP;
+    }
+    if (enabled)
+    {
+        if (pMixer->pEffectsThread == NULL)
+        {
+            pEffects = (GM_EffectsThread *)XNewTaggedPtr((int32_t)sizeof(GM_EffectsThread), X_MEMORY_EFFECTS);
+            if (pEffects == NULL)
+            {
+                return MEMORY_ERR;
+            }
+            if ((BAE_NewEvent(&pEffects->startEvent) == 0) ||
+                (BAE_NewEvent(&pEffects->doneEvent) == 0) ||
+                (BAE_NewWorkerThread(&pEffects->thread, PV_EffectsThreadProc, pEffects) == 0))
+            {
+                PV_FreeEffectsThread(pEffects);
+                return NOT_SETUP;
+            }
+            pMixer->pEffectsThread = pEffects;
+        }
+    }
+    else
+    {
+        pEffects = pMixer->pEffectsThread;
+        if (pEffects)
+        {
+            pMixer->pEffectsThread = NULL;
+            while (pMixer->insideAudioInterrupt)
+            {
+                XWaitMicroseconds(BAE_GetSliceTimeInMicroseconds());
+            }
+            pEffects->quit = TRUE;
+            BAE_SignalEvent(pEffects->startEvent);
+            BAE_JoinWorkerThread(pEffects->thread);
+            PV_FreeEffectsThread(pEffects);
+        }
+    }
+    return NO_ERR;
+}
+
+XBOOL GM_IsEffectsThreadEnabled(void)
+{
+    if (MusicGlobals)
+    {
+        return (MusicGlobals->pEffectsThread != NULL) ? TRUE : FALSE;
+    }
+    return FALSE;
+}
+
+// Extra delay of the reverb and chorus, in output sample frames, when they run on the
+// effects thread. 0 when they don't. Fixed verbs always run in line.
+XDWORD GM_GetEffectsThreadLatency(void)
+{
+    GM_Mixer    *pMixer;
+    XDWORD      frames;
+
+    pMixer = MusicGlobals;
+    frames = 0;
+    if (pMixer && pMixer->pEffectsThread && (GM_IsReverbFixed() == FALSE))
+    {
+        frames = (XDWORD)pMixer->One_Loop;
+        if ((pMixer->outputRate == Q_RATE_11K_TERP_22K) || (pMixer->outputRate == Q_RATE_22K_TERP_44K))
+        {
+            frames *= 2;
+        }
+    }
+    return frames;
+}
+#endif
+
 #if REVERB_USED == DISABLE_REVERB
 // Process active sample voices
 INLINE static void PV_ServeInstruments(void)
@@ -2190,7 +2519,7 @@ INLINE static void PV_ServeInstruments(void)
     // Reverb disabled: mix SF2 output directly into dry buffer (no effects)
     {
         int si;
-        for (si = 0; si < MAX_SONGS; ++si)
+        for (si = 0; si < pMixer->songSlotCount; ++si)
         {
             GM_Song *song = pMixer->pSongsToPlay[si];
             if (song && (GM_IsSF2Song(song) || GM_SF2_HasXmfEmbeddedBank()))
@@ -2208,11 +2537,16 @@ INLINE static void PV_ServeInstruments(void)
     register GM_Mixer *pMixer;
     register LOOPCOUNT count;
     register GM_Voice *pVoice;
+#if REVERB_USED == VARIABLE_REVERB
+    GM_EffectsThread *pEffects;
+#endif
 
     pMixer = MusicGlobals;
 #if REVERB_USED == VARIABLE_REVERB
     if (GM_IsReverbFixed() == FALSE)
     {
+        pEffects = PV_StartEffectsThread();
+
         // Process all active voices in the full-featured variable reverb case.
         for (count = 0; count < (pMixer->MaxNotes + pMixer->MaxEffects); count++)
         {
@@ -2226,7 +2560,7 @@ INLINE static void PV_ServeInstruments(void)
         // Mix SF2 voices before chorus/reverb so they get processed by effects
         {
             int si;
-            for (si = 0; si < MAX_SONGS; ++si)
+            for (si = 0; si < pMixer->songSlotCount; ++si)
             {
                 GM_Song *song = pMixer->pSongsToPlay[si];
                 if (song && (GM_IsSF2Song(song) || GM_SF2_HasXmfEmbeddedBank()))
@@ -2239,14 +2573,20 @@ INLINE static void PV_ServeInstruments(void)
             }
         }
 #endif
-#if USE_NEW_EFFECTS
-        RunChorus(pMixer->songBufferChorus, pMixer->songBufferDry, pMixer->One_Loop);
-#endif
-        GM_ProcessReverb();
+        if (pEffects)
+        {
+            PV_FinishEffectsThread(pEffects);
+        }
+        else
+        {
+            PV_RunMixerEffectUnits();
+        }
     }
     else
 #endif
     {
+        PV_DropEffectsThreadJob();
+
         // Process active voices for the inexpensive reverb cases:
         // Notes with reverb on are processed first, then the reverb unit, then the dry notes.
         for (count = 0; count < (pMixer->MaxNotes + pMixer->MaxEffects); count++)
@@ -2264,7 +2604,7 @@ INLINE static void PV_ServeInstruments(void)
         // Mix SF2 output with reverb-enabled voices before reverb stage
         {
             int si;
-            for (si = 0; si < MAX_SONGS; ++si)
+            for (si = 0; si < pMixer->songSlotCount; ++si)
             {
                 GM_Song *song = pMixer->pSongsToPlay[si];
                 if (song && (GM_IsSF2Song(song) || GM_SF2_HasXmfEmbeddedBank()))
@@ -2277,10 +2617,7 @@ INLINE static void PV_ServeInstruments(void)
             }
         }
 #endif
-#if USE_NEW_EFFECTS
-        RunChorus(pMixer->songBufferChorus, pMixer->songBufferDry, pMixer->One_Loop);
-#endif
-        GM_ProcessReverb();
+        PV_RunMixerEffectUnits();
 
         for (count = 0; count < (pMixer->MaxNotes + pMixer->MaxEffects); count++)
         {
@@ -2370,13 +2707,13 @@ void GM_TestTone(XBOOL toneStatus)
 void BAE_BuildMCUSlice(void *threadContext, XDWORD dspTime)
 {
     GM_Mixer *pMixer;
-    uint32_t delta, end;
+    uint64_t delta, end;
     OPErr err;
 
     pMixer = GM_GetCurrentMixer();
     if (pMixer)
     {
-        delta = XMicroseconds(); // get current time
+        delta = XMicroseconds64(); // get current time
 
         pMixer->insideAudioInterrupt = 1; // busy
 
@@ -2403,15 +2740,8 @@ void BAE_BuildMCUSlice(void *threadContext, XDWORD dspTime)
         GM_UpdateSamplesPlayed(BAE_GetDeviceSamplesPlayedPosition());
         pMixer->insideAudioInterrupt = 0; // free
 
-        end = XMicroseconds();
-        if (end < delta)
-        { // we wrapped
-            pMixer->timeSliceDifference = delta - end;
-        }
-        else
-        {
-            pMixer->timeSliceDifference = end - delta;
-        }
+        end = XMicroseconds64();
+        pMixer->timeSliceDifference = (XDWORD)(end - delta);
     }
 }
 #endif
@@ -2432,12 +2762,12 @@ void BAE_BuildMixerSlice(void *threadContext, void *pAudioBuffer, int32_t buffer
                          int32_t sampleFrames)
 {
     GM_Mixer *pMixer;
-    uint32_t delta, end;
+    uint64_t delta, end;
 
     pMixer = MusicGlobals;
     if (pMixer && pAudioBuffer && bufferByteLength && sampleFrames)
     {
-        delta = XMicroseconds(); // get current time
+        delta = XMicroseconds64(); // get current time
 
         pMixer->insideAudioInterrupt = 1; // busy
 
@@ -2472,15 +2802,8 @@ void BAE_BuildMixerSlice(void *threadContext, void *pAudioBuffer, int32_t buffer
         GM_UpdateSamplesPlayed(BAE_GetDeviceSamplesPlayedPosition());
         pMixer->insideAudioInterrupt = 0; // free
 
-        end = XMicroseconds();
-        if (end < delta)
-        { // we wrapped
-            pMixer->timeSliceDifference = delta - end;
-        }
-        else
-        {
-            pMixer->timeSliceDifference = end - delta;
-        }
+        end = XMicroseconds64();
+        pMixer->timeSliceDifference = (XDWORD)(end - delta);
     }
 }
 #endif
@@ -2538,7 +2861,7 @@ static void PV_ProcessSyncronizedVoiceStart(void)
     GM_Voice *pVoice;
     void *syncReference;
     LOOPCOUNT count, max;
-    uint32_t time;
+    uint64_t time;
 
     pMixer = GM_GetCurrentMixer();
 
@@ -2563,7 +2886,7 @@ static void PV_ProcessSyncronizedVoiceStart(void)
             }
         }
     }
-    time = XMicroseconds();
+    time = XMicroseconds64();
     // ok, now we have a list of voices that want to be started
     for (count = 0; count < max; count++)
     {
@@ -2928,13 +3251,31 @@ void PV_ProcessSampleFrame(void *threadContext, void *destinationSamples)
             if (pMixer->generateStereoOutput)
             {
 #if (USE_16_BIT_OUTPUT == TRUE) && (USE_STEREO_OUTPUT == TRUE)
-                PV_Generate16outputStereo((OUTSAMPLE16 *)destinationSamples);
+#if USE_NEO_EFFECTS == TRUE
+                if (pMixer->master.eqEnabled || pMixer->master.limiterEnabled)
+                {
+                    PV_GenerateMaster16outputStereo((OUTSAMPLE16 *)destinationSamples);
+                }
+                else
+#endif
+                {
+                    PV_Generate16outputStereo((OUTSAMPLE16 *)destinationSamples);
+                }
 #endif
             }
             else
             {
 #if (USE_16_BIT_OUTPUT == TRUE) && (USE_MONO_OUTPUT == TRUE)
-                PV_Generate16outputMono((OUTSAMPLE16 *)destinationSamples);
+#if USE_NEO_EFFECTS == TRUE
+                if (pMixer->master.eqEnabled || pMixer->master.limiterEnabled)
+                {
+                    PV_GenerateMaster16outputMono((OUTSAMPLE16 *)destinationSamples);
+                }
+                else
+#endif
+                {
+                    PV_Generate16outputMono((OUTSAMPLE16 *)destinationSamples);
+                }
 #endif
             }
         }
@@ -2978,7 +3319,7 @@ static GM_Voice *PV_FindFreeVoice(GM_Mixer *pMixer,
     XFIXED bestLevel;
     XSWORD priority;
     XSDWORD volume32;
-    XDWORD timeStamp;
+    uint64_t timeStamp;
 
     // get synth priority to determine note stealing
     priority = pSong->songPriority;
@@ -3071,7 +3412,7 @@ static GM_Voice *PV_FindFreeVoice(GM_Mixer *pMixer,
 
 #if 1
     // Now kill the oldest note that is in sustain pedal mode
-    timeStamp = 0x7fffffff;
+    timeStamp = UINT64_MAX;
     for (count = 0; count < pMixer->MaxNotes; count++)
     {
         pVoice = &pMixer->NoteEntry[count];
@@ -3130,7 +3471,7 @@ static GM_Voice *PV_FindFreeVoice(GM_Mixer *pMixer,
     // OK now we're really mad.  Kill the oldest note, period.    (Added 6/7/01 for limited voice case).
 
     the_entry = NULL; // reset to try again
-    timeStamp = 0x7fffffff;
+    timeStamp = UINT64_MAX;
     for (count = 0; count < pMixer->MaxNotes; count++)
     {
         pVoice = &pMixer->NoteEntry[count];
@@ -3191,8 +3532,9 @@ void PV_StartMIDINote(GM_Song *pSong, INT16 the_instrument,
     register GM_Instrument *theI;
     register GM_Instrument *pInstrument;
     register GM_KeymapSplit *k;
+    GM_Instrument *pKeymap;
     register INT32 count;
-    INT16 newPitch, playPitch;
+    INT16 newPitch, playPitch, fallback;
     UINT16 splitCount;
     UINT32 loopstart, loopend;
     register INT32 i, j;
@@ -3215,6 +3557,20 @@ void PV_StartMIDINote(GM_Song *pSong, INT16 the_instrument,
     pInstrument = NULL;
     sampleNumber = 0;
     theI = pSong->instrumentData[pSong->remapArray[the_instrument]];
+    if ((theI == NULL) && GM_IsSongInstrumentPending(pSong, the_instrument))
+    {
+        // Still on the instrument loader. Until it's in, play the GM instrument of the
+        // same program from bank 0, or bank 1 for percussion banks.
+        fallback = (INT16)((((the_instrument / 128) & 1) * 128) + (the_instrument % 128));
+        if (fallback != the_instrument)
+        {
+            theI = pSong->instrumentData[pSong->remapArray[fallback]];
+            if (theI)
+            {
+                the_instrument = fallback;
+            }
+        }
+    }
     if (theI)
     {
         /*
@@ -3247,6 +3603,7 @@ void PV_StartMIDINote(GM_Song *pSong, INT16 the_instrument,
         // keysplit?
         if (theI->doKeymapSplit)
         { // yes, find an instrument
+            pKeymap = theI;
             splitCount = theI->u.k.KeymapSplitCount;
             k = theI->u.k.keySplits;
             for (count = 0; count < splitCount; count++)
@@ -3254,6 +3611,25 @@ void PV_StartMIDINote(GM_Song *pSong, INT16 the_instrument,
                 if ((playPitch >= k->lowMidi) && (playPitch <= k->highMidi))
                 {
                     theI = k->pSplitInstrument;
+                    if ((theI == NULL) && k->lazyDecode)
+                    {
+                        // not decoded yet. Ask the loader for it, and meanwhile play the
+                        // nearest split that is
+                        if (k->decodeQueued == FALSE)
+                        {
+                            if (PV_RequestLazySplit(pSong, pSong->remapArray[the_instrument], (INT16)count) == NO_ERR)
+                            {
+                                k->decodeQueued = TRUE;
+                            }
+                        }
+                        i = PV_GetNearestSplit(pKeymap, playPitch, TRUE);
+                        if (i >= 0)
+                        {
+                            k = &pKeymap->u.k.keySplits[i];
+                            theI = k->pSplitInstrument;
+                            sampleNumber = i;
+                        }
+                    }
                     if (theI)
                     {
                         pInstrument = theI;
@@ -3686,7 +4062,7 @@ void PV_StartMIDINote(GM_Song *pSong, INT16 the_instrument,
         }
 
         // This step is performed last.
-        the_entry->voiceStartTimeStamp = XMicroseconds();
+        the_entry->voiceStartTimeStamp = XMicroseconds64();
 #ifdef BAE_MCU
         if (GM_InitVoiceOnDSP(the_entry) == NO_ERR)
         {
@@ -3716,7 +4092,7 @@ void PV_StopMIDINote(GM_Song *pSong, XSWORD the_instrument, XSWORD the_channel,
     register XSWORD decay;
     register GM_Voice *pNote;
     XSWORD realNote, compareNote;
-    XDWORD youngestTime;
+    uint64_t youngestTime;
     GM_Voice *pNoteToKill;
 
     pMixer = GM_GetCurrentMixer();
@@ -4101,7 +4477,7 @@ void GM_DisplayVoiceData(void)
         {
             BAE_PRINTF("### Voice %d\n", count);
             BAE_PRINTF("    voiceMode %d\n", pVoice->voiceMode);
-            BAE_PRINTF("    voiceStartTimeStamp %d\n", pVoice->voiceStartTimeStamp);
+            BAE_PRINTF("    voiceStartTimeStamp %lu\n", (unsigned long)pVoice->voiceStartTimeStamp);
             BAE_PRINTF("    pSong %p\n", pVoice->pSong);
             BAE_PRINTF("    pInstrument %p\n", pVoice->pInstrument);
             BAE_PRINTF("    NoteChannel %d\n", pVoice->NoteChannel);
@@ -379,7 +379,7 @@ static XBOOL PV_ParseXMF1Node(const unsigned char *bytes, uint32_t len, uint32_t
             else
             {
                 // Try decrypt+inflate as last resort
-                unsigned char *cpy = (unsigned char *)XNewPtr(contentLen);
+                unsigned char *cpy = (unsigned char *)XNewTaggedPtr(contentLen, X_MEMORY_SONGS);
                 if (cpy)
                 {
                     XBlockMove(content, cpy, contentLen);
@@ -462,7 +462,7 @@ static XBOOL PV_ParseXMF1Node(const unsigned char *bytes, uint32_t len, uint32_t
         {
             if (outMidi && outMidiLen && !*outMidi)
             {
-                unsigned char *cpy = (unsigned char *)XNewPtr(smfRMIDLen);
+                unsigned char *cpy = (unsigned char *)XNewTaggedPtr(smfRMIDLen, X_MEMORY_SONGS);
                 if (cpy) { XBlockMove(smfRMID, cpy, smfRMIDLen); *outMidi = cpy; *outMidiLen = smfRMIDLen; }
             }
         }
@@ -472,7 +472,7 @@ static XBOOL PV_ParseXMF1Node(const unsigned char *bytes, uint32_t len, uint32_t
             if (moff >= 0 && outMidi && outMidiLen && !*outMidi)
             {
                 uint32_t copyLen = payloadLen - (uint32_t)moff;
-                unsigned char *cpy = (unsigned char *)XNewPtr(copyLen);
+                unsigned char *cpy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                 if (cpy) { XBlockMove(payload + moff, cpy, copyLen); *outMidi = cpy; *outMidiLen = copyLen; }
             }
             else
@@ -481,7 +481,7 @@ static XBOOL PV_ParseXMF1Node(const unsigned char *bytes, uint32_t len, uint32_t
                 if (roff >= 0 && outRmf && outRmfLen && !*outRmf)
                 {
                     uint32_t copyLen = payloadLen - (uint32_t)roff;
-                    unsigned char *cpy = (unsigned char *)XNewPtr(copyLen);
+                    unsigned char *cpy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                     if (cpy) { XBlockMove(payload + roff, cpy, copyLen); *outRmf = cpy; *outRmfLen = copyLen; }
                 }
             }
@@ -561,7 +561,7 @@ static XBOOL PV_InflateFromOffset(const unsigned char *buf, uint32_t len, uint32
 
     const uint32_t kChunk = 64 * 1024;
     uint32_t cap = kChunk;
-    unsigned char *dst = (unsigned char *)XNewPtr(cap);
+    unsigned char *dst = (unsigned char *)XNewTaggedPtr(cap, X_MEMORY_SONGS);
     if (!dst)
     {
         inflateEnd(&zs);
@@ -589,7 +589,7 @@ static XBOOL PV_InflateFromOffset(const unsigned char *buf, uint32_t len, uint32
             {
                 uint32_t used = (uint32_t)((char *)zs.next_out - (char *)dst);
                 uint32_t ncap = cap + kChunk;
-                unsigned char *ndst = (unsigned char *)XNewPtr(ncap);
+                unsigned char *ndst = (unsigned char *)XNewTaggedPtr(ncap, X_MEMORY_SONGS);
                 if (!ndst)
                 {
                     ok = FALSE;
@@ -649,7 +649,7 @@ static XBOOL PV_InflateRawFromOffset(const unsigned char *buf, uint32_t len, uin
 
     const uint32_t kChunk = 64 * 1024;
     uint32_t cap = kChunk;
-    unsigned char *dst = (unsigned char *)XNewPtr(cap);
+    unsigned char *dst = (unsigned char *)XNewTaggedPtr(cap, X_MEMORY_SONGS);
     if (!dst)
     {
         inflateEnd(&zs);
@@ -676,7 +676,7 @@ static XBOOL PV_InflateRawFromOffset(const unsigned char *buf, uint32_t len, uin
             {
                 uint32_t used = (uint32_t)((char *)zs.next_out - (char *)dst);
                 uint32_t ncap = cap + kChunk;
-                unsigned char *ndst = (unsigned char *)XNewPtr(ncap);
+                unsigned char *ndst = (unsigned char *)XNewTaggedPtr(ncap, X_MEMORY_SONGS);
                 if (!ndst)
                 {
                     ok = FALSE;
@@ -759,7 +759,7 @@ static XBOOL PV_ProbeLZSS(const unsigned char *bytes, uint32_t ulen, uint32_t of
     uint32_t cap = inLen * 8u;
     if (cap < 256*1024u) cap = 256*1024u;
     if (cap > (8u<<20)) cap = (8u<<20);
-    unsigned char *dst = (unsigned char *)XNewPtr(cap);
+    unsigned char *dst = (unsigned char *)XNewTaggedPtr(cap, X_MEMORY_SONGS);
     if (!dst) return FALSE;
     // Decompress; LZSSUncompress doesn't report size; we scan the buffer
     LZSSUncompress((unsigned char *)(bytes + offset), inLen, dst, cap);
@@ -767,7 +767,7 @@ static XBOOL PV_ProbeLZSS(const unsigned char *bytes, uint32_t ulen, uint32_t of
     const unsigned char *rmidSmf=NULL; uint32_t rmidLen=0;
     if (PV_ExtractRMIDToSMF(dst, cap, &rmidSmf, &rmidLen))
     {
-        unsigned char *cpy = (unsigned char *)XNewPtr(rmidLen);
+        unsigned char *cpy = (unsigned char *)XNewTaggedPtr(rmidLen, X_MEMORY_SONGS);
         if (cpy) { XBlockMove(rmidSmf, cpy, rmidLen); if (outMidi) *outMidi = cpy; if (outMidiLen) *outMidiLen = rmidLen; }
         XDisposePtr(dst);
         return TRUE;
@@ -778,7 +778,7 @@ static XBOOL PV_ProbeLZSS(const unsigned char *bytes, uint32_t ulen, uint32_t of
     {
         uint32_t need = PV_ComputeSMFLen(dst + off, cap - (uint32_t)off);
         if (need == 0) need = cap - (uint32_t)off;
-        unsigned char *cpy = (unsigned char *)XNewPtr(need);
+        unsigned char *cpy = (unsigned char *)XNewTaggedPtr(need, X_MEMORY_SONGS);
         if (cpy)
         {
             XBlockMove(dst + off, cpy, need);
@@ -793,7 +793,7 @@ static XBOOL PV_ProbeLZSS(const unsigned char *bytes, uint32_t ulen, uint32_t of
     if (roff >= 0)
     {
         uint32_t copyLen = cap - (uint32_t)roff;
-        unsigned char *cpy = (unsigned char *)XNewPtr(copyLen);
+        unsigned char *cpy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
         if (cpy) { XBlockMove(dst + roff, cpy, copyLen); if (outRmf) *outRmf = cpy; if (outRmfLen) *outRmfLen = copyLen; }
         XDisposePtr(dst);
         return TRUE;
@@ -862,7 +862,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
             if (off >= 0 && !foundMidi)
             {
                 uint32_t copyLen = outLen - (uint32_t)off;
-                unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                 if (!copy) { XDisposePtr(out); return FALSE; }
                 XBlockMove(out + off, copy, copyLen);
                 XDisposePtr(out);
@@ -878,7 +878,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
             if (roff >= 0 && !foundRmf)
             {
                 uint32_t copyLen = outLen - (uint32_t)roff;
-                unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                 if (!copy) { XDisposePtr(out); return FALSE; }
                 XBlockMove(out + roff, copy, copyLen);
                 XDisposePtr(out);
@@ -894,7 +894,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
             {
                 if (!foundMidi)
                 {
-                    unsigned char *copy = (unsigned char *)XNewPtr(rmidLen);
+                    unsigned char *copy = (unsigned char *)XNewTaggedPtr(rmidLen, X_MEMORY_SONGS);
                     if (!copy) { XDisposePtr(out); return FALSE; }
                     XBlockMove(rmidSmf, copy, rmidLen);
                     XDisposePtr(out);
@@ -914,7 +914,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
             // Try decrypting a window then inflating
             uint32_t win = (ulen - i);
             if (win > (8u<<20)) win = (8u<<20); // limit to 8MB window
-            unsigned char *cpy = (unsigned char *)XNewPtr(win);
+            unsigned char *cpy = (unsigned char *)XNewTaggedPtr(win, X_MEMORY_SONGS);
             if (!cpy) continue;
             XBlockMove(bytes + i, cpy, win);
             XDecryptData(cpy, win);
@@ -937,7 +937,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
                 if (off >= 0 && !foundMidi)
                 {
                     uint32_t copyLen = dlen - (uint32_t)off;
-                    unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                    unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                     if (!copy) { XDisposePtr(dout); XDisposePtr(cpy); return FALSE; }
                     XBlockMove(dout + off, copy, copyLen);
                     XDisposePtr(dout);
@@ -952,7 +952,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
                 if (roff >= 0 && !foundRmf)
                 {
                     uint32_t copyLen = dlen - (uint32_t)roff;
-                    unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                    unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                     if (!copy) { XDisposePtr(dout); XDisposePtr(cpy); return FALSE; }
                     XBlockMove(dout + roff, copy, copyLen);
                     XDisposePtr(dout);
@@ -968,7 +968,7 @@ static XBOOL PV_TryExtractFromPackedMXMF(const unsigned char *bytes, uint32_t ul
                 {
                     if (!foundMidi)
                     {
-                        unsigned char *copy = (unsigned char *)XNewPtr(rmidLen);
+                        unsigned char *copy = (unsigned char *)XNewTaggedPtr(rmidLen, X_MEMORY_SONGS);
                         if (!copy) { XDisposePtr(dout); XDisposePtr(cpy); return FALSE; }
                         XBlockMove(rmidSmf, copy, rmidLen);
                         XDisposePtr(dout);
@@ -1013,7 +1013,7 @@ done_scan:
                 if (off >= 0 && !foundMidi)
                 {
                     uint32_t copyLen = rdlen - (uint32_t)off;
-                    unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                    unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                     if (!copy) { XDisposePtr(rdout); break; }
                     XBlockMove(rdout + off, copy, copyLen);
                     XDisposePtr(rdout);
@@ -1026,7 +1026,7 @@ done_scan:
                 if (roff2 >= 0 && !foundRmf)
                 {
                     uint32_t copyLen = rdlen - (uint32_t)roff2;
-                    unsigned char *copy = (unsigned char *)XNewPtr(copyLen);
+                    unsigned char *copy = (unsigned char *)XNewTaggedPtr(copyLen, X_MEMORY_SONGS);
                     if (!copy) { XDisposePtr(rdout); break; }
                     XBlockMove(rdout + roff2, copy, copyLen);
                     XDisposePtr(rdout);
@@ -1261,7 +1261,7 @@ BAEResult BAESong_LoadXmfFromMemory(BAESong song, const void *data, uint32_t ule
                 return lerr2;
             }
             // Try on decrypted copy as well
-            unsigned char *decAll = (unsigned char *)XNewPtr(ulen);
+            unsigned char *decAll = (unsigned char *)XNewTaggedPtr(ulen, X_MEMORY_SONGS);
             if (decAll)
             {
                 XBlockMove(bytes, decAll, ulen);
@@ -1408,7 +1408,7 @@ BAEResult BAESong_LoadXmfFromMemory(BAESong song, const void *data, uint32_t ule
             }
 
             // Region-only decrypt fallback: some XMF v1 encrypt only the payloads
-            unsigned char *mcpy = (unsigned char *)XNewPtr(mlen);
+            unsigned char *mcpy = (unsigned char *)XNewTaggedPtr(mlen, X_MEMORY_SONGS);
             if (mcpy)
             {
                 XBlockMove(m, mcpy, mlen);
@@ -1464,7 +1464,7 @@ BAEResult BAESong_LoadXmfFromMemory(BAESong song, const void *data, uint32_t ule
                     for (uint32_t so = 0; so < maxTry; ++so)
                     {
                         uint32_t dlen = mlen - so;
-                        unsigned char *dwin = (unsigned char *)XNewPtr(dlen);
+                        unsigned char *dwin = (unsigned char *)XNewTaggedPtr(dlen, X_MEMORY_SONGS);
                         if (!dwin) break;
                         XBlockMove(m + so, dwin, dlen);
                         XDecryptData(dwin, dlen);
@@ -1651,7 +1651,7 @@ BAEResult BAESong_LoadXmfFromMemory(BAESong song, const void *data, uint32_t ule
     // If we fall through to here, try a whole-file decrypt fallback (XMF v1 encrypted files)
     // We'll decrypt a copy of the container and re-run the same heuristics.
     BAE_PRINTF("[XMF] Plain scan failed; attempting XMF v1 decrypt fallback...\n");
-    unsigned char *dec = (unsigned char *)XNewPtr(ulen);
+    unsigned char *dec = (unsigned char *)XNewTaggedPtr(ulen, X_MEMORY_SONGS);
     if (dec)
     {
         XBlockMove(bytes, dec, ulen);
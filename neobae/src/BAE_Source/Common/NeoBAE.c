@@ -155,6 +155,7 @@
 #include "X_API.h"
 #include "GenSnd.h"
 #include "GenPriv.h"
+#include "GenCache.h"
 #include "GenRMI.h"
 #include "X_Formats.h"
 #include "BAE_API.h"
@@ -248,7 +249,7 @@ static SongResource *PV_FallbackFindSongInRMFMemory(const void *data, uint32_t t
                     *outID = rawID;
                 if (outSize)
                     *outSize = (int32_t)rawResLen;
-                SongResource *copy = (SongResource *)XNewPtr((int32_t)rawResLen);
+                SongResource *copy = (SongResource *)XNewTaggedPtr((int32_t)rawResLen, X_MEMORY_SONGS);
                 if (copy)
                 {
                     XBlockMove(ub + dataStart, copy, (int32_t)rawResLen);
@@ -748,6 +749,59 @@ static const char *PV_FindBankFriendly(BAEBankToken token)
     return NULL;
 }
 
+// sha1 of a loaded bank as 40 hex digits, or NULL if it wasn't hashed
+static const char *PV_FindBankSha1(BAEBankToken token)
+{
+    for (int i = 0; i < g_bankFriendlyCacheCount; i++)
+    {
+        if (g_bankFriendlyCache[i].token == token)
+        {
+            return g_bankFriendlyCache[i].sha1;
+        }
+    }
+    return NULL;
+}
+
+// Banks with the same digest hold the same samples, so let them share decoded ones
+static void PV_SetBankContentKey(XFILE bankFile, const unsigned char *digest)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        key = (key << 8) | digest[i];
+    }
+    XFileSetContentKey(bankFile, key);
+}
+
+static void PV_HashBankContents(void *context, XPTR pData, uint32_t length)
+{
+    sha1mini_update((SHA1_CTX_MINI *)context, (const unsigned char *)pData, length);
+}
+
+// Hash a newly opened bank as it sits, in memory, mapped or on disk, and record the digest
+// for its friendly name and its content key. Nothing is recorded if it can't be read.
+static void PV_IdentifyBank(XFILE bankFile)
+{
+    SHA1_CTX_MINI ctx;
+    unsigned char digest[20];
+    char hex[41];
+    static const char *hexmap = "0123456789abcdef";
+
+    sha1mini_init(&ctx);
+    if (XFileReadContents(bankFile, PV_HashBankContents, &ctx) == 0)
+    {
+        sha1mini_final(digest, &ctx);
+        for (int i = 0; i < 20; i++)
+        {
+            hex[i * 2] = hexmap[digest[i] >> 4];
+            hex[i * 2 + 1] = hexmap[digest[i] & 15];
+        }
+        hex[40] = '\0';
+        PV_RegisterBankFriendly((BAEBankToken)bankFile, hex);
+        PV_SetBankContentKey(bankFile, digest);
+    }
+}
+
 // Remove a bank's friendly name cache entry when the bank is unloaded so a
 // subsequently loaded bank that reuses the same underlying XFILE pointer
 // value doesn't inherit the prior bank's friendly name (stale display bug).
@@ -903,7 +957,8 @@ static const ReverbMode translateInternal[] = {
     REVERB_TYPE_15,
     REVERB_TYPE_16,
     REVERB_TYPE_17,
-    REVERB_TYPE_18};
+    REVERB_TYPE_18,
+    REVERB_TYPE_19};
 static const BAEReverbType translateExternal[] = {
     BAE_REVERB_NO_CHANGE,
     BAE_REVERB_TYPE_1,
@@ -923,7 +978,8 @@ static const BAEReverbType translateExternal[] = {
     BAE_REVERB_TYPE_15,
     BAE_REVERB_TYPE_16,
     BAE_REVERB_TYPE_17,
-    BAE_REVERB_TYPE_18};
+    BAE_REVERB_TYPE_18,
+    BAE_REVERB_TYPE_19};
 // translate reverb types from BAEReverbType to ReverbMode
 ReverbMode BAE_TranslateFromBAEReverb(BAEReverbType igorVerb)
 {
@@ -1315,6 +1371,83 @@ BAEResult BAEMixer_GetMemoryUsed(BAEMixer mixer, uint32_t *pOutResult)
     return BAE_NO_ERROR;
 }
 
+// BAEMixer_GetMemoryUsage()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_GetMemoryUsage(BAEMixer mixer, BAEMemoryCategory category,
+                                  uint32_t *pOutCurrent, uint32_t *pOutPeak)
+{
+    if (((int)category < 0) || (category >= BAE_MEMORY_CATEGORY_COUNT))
+    {
+        return BAE_PARAM_ERR;
+    }
+    // BAEMemoryCategory matches XMemoryTag
+    XGetMemoryTagUsage((XMemoryTag)category, pOutCurrent, pOutPeak);
+    return BAE_NO_ERROR;
+}
+
+// BAEMixer_SetSampleCacheBudget()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetSampleCacheBudget(BAEMixer mixer, uint32_t budgetBytes)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            GMCache_SetSampleCacheBudget(mixer->pMixer, budgetBytes);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_GetSampleCacheStats()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_GetSampleCacheStats(BAEMixer mixer, BAESampleCacheStats *pOutStats)
+{
+    GM_SampleCacheStats stats;
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer && pOutStats)
+    {
+        if (mixer->pMixer)
+        {
+            GMCache_GetSampleCacheStats(mixer->pMixer, &stats);
+            pOutStats->hits = stats.hits;
+            pOutStats->misses = stats.misses;
+            pOutStats->evictions = stats.evictions;
+            pOutStats->bytes = stats.bytes;
+            pOutStats->idleBytes = stats.idleBytes;
+            pOutStats->budget = stats.budget;
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = (mixer) ? PARAM_ERR : NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 #if TRACKING
 // PV_BAEMixer_AddObject()
 // ------------------------------------
@@ -1653,6 +1786,439 @@ BAEResult BAEMixer_GetDefaultReverb(BAEMixer mixer, BAEReverbType *pOutResult)
 #endif
 }
 
+// BAEMixer_SetReverbImpulseFromFile()
+// --------------------------------------
+// Loads the impulse response for the convolution reverb
+//
+BAEResult BAEMixer_SetReverbImpulseFromFile(BAEMixer mixer, BAEPathName filePath, BAEFileType fileType)
+{
+#if USE_HIGHLEVEL_FILE_API && (REVERB_USED != REVERB_DISABLED) && (USE_NEO_EFFECTS == TRUE)
+    XFILENAME theFile;
+    GM_Waveform *pWave;
+    AudioFileType type;
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer == NULL)
+        {
+            err = NOT_SETUP;
+        }
+        else if (filePath == NULL)
+        {
+            err = GM_SetReverbImpulse(NULL);
+        }
+        else
+        {
+            type = BAE_TranslateBAEFileType(fileType);
+            if ((type == FILE_WAVE_TYPE) || (type == FILE_AIFF_TYPE))
+            {
+                XConvertPathToXFILENAME(filePath, &theFile);
+                pWave = GM_ReadFileIntoMemory(&theFile, type, TRUE, &err);
+                if (pWave)
+                {
+                    err = GM_SetReverbImpulse(pWave);
+                    GM_FreeWaveform(pWave);
+                }
+                else if (err == NO_ERR)
+                {
+                    err = BAD_FILE;
+                }
+            }
+            else
+            {
+                err = BAD_FILE_TYPE;
+            }
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+#else
+    mixer;
+    filePath;
+    fileType;
+    return BAE_NOT_SETUP;
+#endif
+}
+
+// BAEMixer_SetMasterEqBand()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetMasterEqBand(BAEMixer mixer, int16_t band, BAEMasterEqType type,
+                                   uint32_t frequency, BAE_FIXED gain, BAE_UNSIGNED_FIXED q)
+{
+#if USE_NEO_EFFECTS == TRUE
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            if ((type >= BAE_MASTER_EQ_OFF) && (type < BAE_MASTER_EQ_TYPE_COUNT))
+            {
+                err = GM_SetMasterEqBand(band, (MasterEqType)type, (XDWORD)frequency,
+                                         (XSDWORD)gain, (XFIXED)q);
+            }
+            else
+            {
+                err = PARAM_ERR;
+            }
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+#else
+    mixer;
+    band;
+    type;
+    frequency;
+    gain;
+    q;
+    return BAE_NOT_SETUP;
+#endif
+}
+
+// BAEMixer_SetMasterEqEnabled()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetMasterEqEnabled(BAEMixer mixer, BAE_BOOL enabled)
+{
+#if USE_NEO_EFFECTS == TRUE
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            GM_SetMasterEqEnabled((XBOOL)enabled);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+#else
+    mixer;
+    enabled;
+    return BAE_NOT_SETUP;
+#endif
+}
+
+// BAEMixer_SetMasterLimiterEnabled()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetMasterLimiterEnabled(BAEMixer mixer, BAE_BOOL enabled)
+{
+#if USE_NEO_EFFECTS == TRUE
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            GM_SetMasterLimiterEnabled((XBOOL)enabled);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+#else
+    mixer;
+    enabled;
+    return BAE_NOT_SETUP;
+#endif
+}
+
+// BAEMixer_SetEffectsThreadEnabled()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetEffectsThreadEnabled(BAEMixer mixer, BAE_BOOL enabled)
+{
+#if REVERB_USED != REVERB_DISABLED
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            err = GM_SetEffectsThreadEnabled((XBOOL)enabled);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+#else
+    mixer;
+    enabled;
+    return BAE_NOT_SETUP;
+#endif
+}
+
+// BAEMixer_GetEffectsLatency()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_GetEffectsLatency(BAEMixer mixer, uint32_t *outFrames)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (outFrames)
+    {
+        *outFrames = 0;
+        if (mixer)
+        {
+            if (mixer->pMixer)
+            {
+#if REVERB_USED != REVERB_DISABLED
+                *outFrames = GM_GetEffectsThreadLatency();
+#endif
+            }
+            else
+            {
+                err = NOT_SETUP;
+            }
+        }
+        else
+        {
+            err = NULL_OBJECT;
+        }
+    }
+    else
+    {
+        err = PARAM_ERR;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_SetInstrumentLoaderEnabled()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_SetInstrumentLoaderEnabled(BAEMixer mixer, BAE_BOOL enabled)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            err = GM_SetInstrumentLoaderEnabled((XBOOL)enabled);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_IsInstrumentLoaderEnabled()
+// --------------------------------------
+//
+//
+BAEResult BAEMixer_IsInstrumentLoaderEnabled(BAEMixer mixer, BAE_BOOL *outEnabled)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (outEnabled)
+    {
+        *outEnabled = FALSE;
+        if (mixer)
+        {
+            if (mixer->pMixer)
+            {
+                *outEnabled = (BAE_BOOL)GM_IsInstrumentLoaderEnabled();
+            }
+            else
+            {
+                err = NOT_SETUP;
+            }
+        }
+        else
+        {
+            err = NULL_OBJECT;
+        }
+    }
+    else
+    {
+        err = PARAM_ERR;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_SetLazySampleDecoding()
+// -----------------------------------
+//
+//
+BAEResult BAEMixer_SetLazySampleDecoding(BAEMixer mixer, BAE_BOOL enabled)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            GM_SetLazySplitDecoding((XBOOL)enabled);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_IsLazySampleDecoding()
+// -----------------------------------
+//
+//
+BAEResult BAEMixer_IsLazySampleDecoding(BAEMixer mixer, BAE_BOOL *outEnabled)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (outEnabled)
+    {
+        *outEnabled = FALSE;
+        if (mixer)
+        {
+            if (mixer->pMixer)
+            {
+                *outEnabled = (BAE_BOOL)GM_IsLazySplitDecoding();
+            }
+            else
+            {
+                err = NOT_SETUP;
+            }
+        }
+        else
+        {
+            err = NULL_OBJECT;
+        }
+    }
+    else
+    {
+        err = PARAM_ERR;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_SetStreamReadAhead()
+// -----------------------------------
+//
+//
+BAEResult BAEMixer_SetStreamReadAhead(BAEMixer mixer, uint32_t milliseconds)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+#if USE_HIGHLEVEL_FILE_API == TRUE
+            err = GM_SetStreamReadAhead((XDWORD)milliseconds);
+#else
+            err = NOT_SETUP;
+#endif
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_GetStreamReadAhead()
+// -----------------------------------
+//
+//
+BAEResult BAEMixer_GetStreamReadAhead(BAEMixer mixer, uint32_t *outMilliseconds)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (outMilliseconds)
+    {
+        *outMilliseconds = 0;
+        if (mixer)
+        {
+            if (mixer->pMixer)
+            {
+#if USE_HIGHLEVEL_FILE_API == TRUE
+                *outMilliseconds = (uint32_t)GM_GetStreamReadAhead();
+#endif
+            }
+            else
+            {
+                err = NOT_SETUP;
+            }
+        }
+        else
+        {
+            err = NULL_OBJECT;
+        }
+    }
+    else
+    {
+        err = PARAM_ERR;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 // BAEMixer_IsOpen()
 // ------------------------------------
 //
@@ -2003,9 +2569,61 @@ BAEResult BAEMixer_GetMixerVersion(BAEMixer mixer, int16_t *pVersionMajor, int16
     }
     else
     {
-        err = NULL_OBJECT;
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// The instrument loader thread searches the open resource files while it loads, so every
+// open, close and reorder of that list made here happens under its lock.
+static XFILE PV_OpenResourceFile(XFILENAME *pFile, XBOOL readOnly)
+{
+    XFILE file;
+
+    PV_AcquireInstrumentLoadLock();
+    file = XFileOpenResource(pFile, readOnly);
+    PV_ReleaseInstrumentLoadLock();
+    return file;
+}
+
+static XFILE PV_OpenResourceFileFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL allowCopy)
+{
+    XFILE file;
+
+    PV_AcquireInstrumentLoadLock();
+    file = XFileOpenResourceFromMemory(pResource, resourceLength, allowCopy);
+    PV_ReleaseInstrumentLoadLock();
+    return file;
+}
+
+// A snapshot is opened already out of the search list, so nothing ever finds its samples
+// through it before they're attached to their bank
+static XFILE PV_OpenSnapshotFile(XFILENAME *pFile, XBOOL readOnly)
+{
+    XFILE file;
+
+    PV_AcquireInstrumentLoadLock();
+    file = XFileOpenResource(pFile, readOnly);
+    if (file)
+    {
+        XFileExcludeFromSearch(file);
     }
-    return BAE_TranslateOPErr(err);
+    PV_ReleaseInstrumentLoadLock();
+    return file;
+}
+
+static void PV_CloseResourceFile(XFILE file)
+{
+    PV_AcquireInstrumentLoadLock();
+    XFileClose(file);
+    PV_ReleaseInstrumentLoadLock();
+}
+
+static void PV_UseResourceFile(XFILE file)
+{
+    PV_AcquireInstrumentLoadLock();
+    XFileUseThisResourceFile(file);
+    PV_ReleaseInstrumentLoadLock();
 }
 
 // PV_BAEMixer_AddBank()
@@ -2034,7 +2652,7 @@ static BAEResult PV_BAEMixer_AddBank(BAEMixer mixer, XFILE newPatchFile)
             mixer->pPatchFiles = newList;
             mixer->numPatchFiles++;
 
-            XFileUseThisResourceFile(newPatchFile);            
+            PV_UseResourceFile(newPatchFile);            
         }
         else
         {
@@ -2061,7 +2679,7 @@ BAEResult BAEMixer_AddBankFromMemory(BAEMixer mixer, void *pAudioFile, uint32_t
     theErr = BAE_NO_ERROR;
     if (mixer)
     {
-        newPatchFile = XFileOpenResourceFromMemory(pAudioFile, fileSize, FALSE);
+        newPatchFile = PV_OpenResourceFileFromMemory(pAudioFile, fileSize, FALSE);
         if (newPatchFile)
         {
             theErr = PV_BAEMixer_AddBank(mixer, newPatchFile);
@@ -2072,17 +2690,7 @@ BAEResult BAEMixer_AddBankFromMemory(BAEMixer mixer, void *pAudioFile, uint32_t
             // Compute sha1 of memory bank for friendly name cache
             if (theErr == BAE_NO_ERROR)
             {
-                unsigned char digest[20];
-                char hex[41];
-                sha1mini((const unsigned char *)pAudioFile, fileSize, digest);
-                static const char *hexmap = "0123456789abcdef";
-                for (int i = 0; i < 20; i++)
-                {
-                    hex[i * 2] = hexmap[digest[i] >> 4];
-                    hex[i * 2 + 1] = hexmap[digest[i] & 15];
-                }
-                hex[40] = '\0';
-                PV_RegisterBankFriendly((BAEBankToken)newPatchFile, hex);
+                PV_IdentifyBank(newPatchFile);
             }
         }
         else
@@ -2124,7 +2732,7 @@ BAEResult BAEMixer_AddBankFromFile(BAEMixer mixer, BAEPathName pAudioPathName, B
     if (mixer)
     {
         XConvertPathToXFILENAME(pAudioPathName, &theFile);
-        newPatchFile = XFileOpenResource(&theFile, TRUE);
+        newPatchFile = PV_OpenResourceFile(&theFile, TRUE);
         if (newPatchFile)
         {
             theErr = PV_BAEMixer_AddBank(mixer, newPatchFile);
@@ -2132,42 +2740,11 @@ BAEResult BAEMixer_AddBankFromFile(BAEMixer mixer, BAEPathName pAudioPathName, B
             {
                 *outToken = (BAEBankToken)newPatchFile;
             }
-            // After loading from file, read its bytes to compute sha1
+            // Hash the file for its friendly name and content key. A mapped bank is hashed
+            // where it lies, any other is streamed, so no copy of the whole file is made.
             if (theErr == BAE_NO_ERROR)
             {
-                // Use XFile routines: open resource already returns handle; need raw data pointer & size
-                // Simplest: reopen file normally and read bytes.
-                FILE *f = fopen(pAudioPathName, "rb");
-                if (f)
-                {
-                    fseek(f, 0, SEEK_END);
-                    long sz = ftell(f);
-                    if (sz > 0 && sz < (32 * 1024 * 1024))
-                    {
-                        fseek(f, 0, SEEK_SET);
-                        unsigned char *buf = (unsigned char *)malloc(sz);
-                        if (buf)
-                        {
-                            size_t rd = fread(buf, 1, sz, f);
-                            if (rd == (size_t)sz)
-                            {
-                                unsigned char dg[20];
-                                char hx[41];
-                                sha1mini(buf, sz, dg);
-                                static const char *hm = "0123456789abcdef";
-                                for (int i = 0; i < 20; i++)
-                                {
-                                    hx[i * 2] = hm[dg[i] >> 4];
-                                    hx[i * 2 + 1] = hm[dg[i] & 15];
-                                }
-                                hx[40] = '\0';
-                                PV_RegisterBankFriendly((BAEBankToken)newPatchFile, hx);
-                            }
-                            free(buf);
-                        }
-                    }
-                    fclose(f);
-                }
+                PV_IdentifyBank(newPatchFile);
             }
         }
         else
@@ -2182,6 +2759,119 @@ BAEResult BAEMixer_AddBankFromFile(BAEMixer mixer, BAEPathName pAudioPathName, B
     return theErr;
 }
 
+// Decode a bank's samples into a new snapshot file, then reopen it read only so it is mapped.
+// The samples are written under a temporary name and only renamed over pSnapshotPath once
+// they check out, so a crash mid write never leaves a torn snapshot where the next run looks.
+static XFILE PV_CreateBankSnapshot(XFILE bankFile, BAEPathName pSnapshotPath, const char *key)
+{
+    XFILENAME snapshotName;
+    XFILENAME tempName;
+    char tempPath[FILE_NAME_LENGTH];
+    XFILE snapshot;
+    XERR err;
+
+    if ((XStrLen(pSnapshotPath) + 4) >= FILE_NAME_LENGTH)
+    {
+        return NULL;
+    }
+    XStrCpy(tempPath, pSnapshotPath);
+    XStrCat(tempPath, ".tmp");
+    XConvertPathToXFILENAME(pSnapshotPath, &snapshotName);
+    XConvertPathToXFILENAME((BAEPathName)tempPath, &tempName);
+
+    XFileDelete(&tempName);
+    snapshot = PV_OpenSnapshotFile(&tempName, FALSE); // creates it
+    if (snapshot == NULL)
+    {
+        return NULL;
+    }
+    err = XCreateSoundSnapshot(bankFile, snapshot, key);
+    PV_CloseResourceFile(snapshot);
+    snapshot = NULL;
+    if (err == 0)
+    {
+        snapshot = PV_OpenSnapshotFile(&tempName, TRUE);
+        if (snapshot)
+        {
+            err = (XIsSoundSnapshotCurrent(snapshot, key) == FALSE) ? -1 : 0;
+            PV_CloseResourceFile(snapshot);
+            snapshot = NULL;
+        }
+        else
+        {
+            err = -1;
+        }
+    }
+    if (err == 0)
+    {
+        err = XFileRename(&tempName, &snapshotName);
+    }
+    if (err == 0)
+    {
+        snapshot = PV_OpenSnapshotFile(&snapshotName, TRUE);
+        if (snapshot && (XIsSoundSnapshotCurrent(snapshot, key) == FALSE))
+        {
+            PV_CloseResourceFile(snapshot);
+            snapshot = NULL;
+        }
+    }
+    else
+    {
+        XFileDelete(&tempName);
+    }
+    return snapshot;
+}
+
+// BAEMixer_AddBankFromFileWithSnapshot()
+// ------------------------------------
+//
+//
+BAEResult BAEMixer_AddBankFromFileWithSnapshot(BAEMixer mixer, BAEPathName pAudioPathName,
+                                               BAEPathName pSnapshotPathName, BAEBankToken *outToken)
+{
+    BAEResult theErr;
+    BAEBankToken token;
+    XFILENAME snapshotName;
+    XFILE snapshot;
+    const char *key;
+
+    token = NULL;
+    theErr = BAEMixer_AddBankFromFile(mixer, pAudioPathName, &token);
+    if (outToken)
+    {
+        *outToken = token;
+    }
+    if ((theErr == BAE_NO_ERROR) && pSnapshotPathName)
+    {
+        // the snapshot is only a cache; without a hash to check it against, or if it
+        // can't be written, the bank simply decodes its samples as usual
+        key = PV_FindBankSha1(token);
+        if (key)
+        {
+            XConvertPathToXFILENAME(pSnapshotPathName, &snapshotName);
+            snapshot = PV_OpenSnapshotFile(&snapshotName, TRUE);
+            if (snapshot && (XIsSoundSnapshotCurrent(snapshot, key) == FALSE))
+            {
+                PV_CloseResourceFile(snapshot);
+                snapshot = NULL;
+            }
+            if (snapshot == NULL)
+            {
+                snapshot = PV_CreateBankSnapshot((XFILE)token, pSnapshotPathName, key);
+            }
+            if (snapshot)
+            {
+                BAE_AcquireMutex(mixer->mLock);
+                PV_AcquireInstrumentLoadLock();
+                XFileSetSnapshot((XFILE)token, snapshot);
+                PV_ReleaseInstrumentLoadLock();
+                BAE_ReleaseMutex(mixer->mLock);
+            }
+        }
+    }
+    return theErr;
+}
+
 // BAEMixer_UnloadBank()
 // ------------------------------------
 //
@@ -2211,7 +2901,7 @@ BAEResult BAEMixer_UnloadBank(BAEMixer mixer, BAEBankToken token)
                 // Invalidate friendly name cache entry BEFORE closing to avoid
                 // potential pointer reuse mapping to stale friendly string.
                 PV_UnregisterBankFriendly(token);
-                XFileClose(patchFile);
+                PV_CloseResourceFile(patchFile);
 
                 // compact the array.
                 // This will leave a unused slot on the end, but that's ok.
@@ -2305,7 +2995,7 @@ BAEResult BAEMixer_BringBankToFront(BAEMixer mixer, BAEBankToken token)
                     pPatchFiles[j - 1] = pPatchFiles[j];
                 }
                 pPatchFiles[numPatchFiles - 1] = file;
-                XFileUseThisResourceFile(file);
+                PV_UseResourceFile(file);
                 break;
             }
         }
@@ -2385,10 +3075,12 @@ static void PV_BAEMixer_SubmitBankOrder(BAEMixer mixer)
 {
     int i;
 
+    PV_AcquireInstrumentLoadLock();
     for (i = 0; i < mixer->numPatchFiles; i++)
     {
         XFileUseThisResourceFile(mixer->pPatchFiles[i]);
     }
+    PV_ReleaseInstrumentLoadLock();
 }
 
 // BAEMixer_GetBankVersion()
@@ -2415,6 +3107,8 @@ BAEResult BAEMixer_GetBankVersion(BAEMixer mixer, BAEBankToken token, int16_t *p
             if (mixer->pPatchFiles[i] == file)
             {
                 foundBank = TRUE;
+                // hold the loader off from bringing this bank forward until the order is back
+                PV_AcquireInstrumentLoadLock();
                 XFileUseThisResourceFile(file);
 
                 if (pVersionMajor && pVersionMinor && pVersionSubMinor)
@@ -2439,6 +3133,7 @@ BAEResult BAEMixer_GetBankVersion(BAEMixer mixer, BAEBankToken token, int16_t *p
                     err = PARAM_ERR;
                 }
                 PV_BAEMixer_SubmitBankOrder(mixer); // restore the bank order;
+                PV_ReleaseInstrumentLoadLock();
                 break;
             }
         }
@@ -2590,6 +3285,67 @@ BAEResult BAEMixer_ChangeSystemVoices(BAEMixer mixer, int16_t maxSongVoices, int
     return BAE_TranslateOPErr(err);
 }
 
+// BAEMixer_SetMaxSongs()
+// ------------------------------------
+//
+//
+BAEResult BAEMixer_SetMaxSongs(BAEMixer mixer, int16_t maxSongs)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (mixer->pMixer)
+        {
+            err = GM_SetMaxSongs(maxSongs);
+        }
+        else
+        {
+            err = NOT_SETUP;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
+// BAEMixer_GetMaxSongs()
+// ------------------------------------
+//
+//
+BAEResult BAEMixer_GetMaxSongs(BAEMixer mixer, int16_t *outMaxSongs)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer)
+    {
+        if (outMaxSongs)
+        {
+            if (mixer->pMixer)
+            {
+                *outMaxSongs = GM_GetMaxSongs();
+            }
+            else
+            {
+                err = NOT_SETUP;
+            }
+        }
+        else
+        {
+            err = PARAM_ERR;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 // BAEMixer_GetTick()
 // ------------------------------------
 //
@@ -2610,6 +3366,26 @@ BAEResult BAEMixer_GetTick(BAEMixer mixer, uint32_t *outTick)
     return BAE_TranslateOPErr(err);
 }
 
+// BAEMixer_GetTick64()
+// ------------------------------------
+//
+//
+BAEResult BAEMixer_GetTick64(BAEMixer mixer, uint64_t *outTick)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (mixer && outTick)
+    {
+        *outTick = GM_GetSyncTimeStamp64();
+    }
+    else
+    {
+        err = (mixer) ? PARAM_ERR : NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 // BAEMixer_SetAudioLatency()
 // ------------------------------------
 //
@@ -4166,7 +4942,7 @@ BAESound BAESound_New(BAEMixer mixer)
 
     if (mixer)
     {
-        sound = (BAESound)XNewPtr(sizeof(struct sBAESound));
+        sound = (BAESound)XNewTaggedPtr(sizeof(struct sBAESound), X_MEMORY_SAMPLES);
         if (sound)
         {
             if (BAE_NewMutex(&sound->mLock, "bae", "snd", __LINE__))
@@ -4394,7 +5170,7 @@ BAEResult BAESound_LoadEmptySample(BAESound sound,
         if (pWave)
         {
             size = frames * (bitSize / 8) * channels;
-            sampleData = XNewPtr(size);
+            sampleData = XNewTaggedPtr(size, X_MEMORY_SAMPLES);
             if (sampleData != NULL)
             {
                 pWave->waveSize = size;
@@ -5701,7 +6477,7 @@ BAEStream BAEStream_New(BAEMixer mixer)
 
     if (mixer)
     {
-        stream = (BAEStream)XNewPtr(sizeof(struct sBAEStream));
+        stream = (BAEStream)XNewTaggedPtr(sizeof(struct sBAEStream), X_MEMORY_STREAMS);
         if (stream)
         {
             if (BAE_NewMutex(&stream->mLock, "bae", "str", __LINE__))
@@ -5986,6 +6762,45 @@ BAEResult BAEStream_GetLoopFlag(BAEStream stream, BAE_BOOL *outLoop)
     return BAE_TranslateOPErr(err);
 }
 
+// BAEStream_GetReadAheadStats()
+// --------------------------------------
+//
+//
+BAEResult BAEStream_GetReadAheadStats(BAEStream stream,
+                                      BAEStreamReadAheadStats *outStats)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if (stream)
+    {
+        if (outStats)
+        {
+            XSetMemory(outStats, (int32_t)sizeof(BAEStreamReadAheadStats), 0);
+            err = NOT_SETUP;
+#if USE_HIGHLEVEL_FILE_API == TRUE
+            if (stream->mSoundStreamVoiceReference != DEAD_STREAM)
+            {
+                err = GM_AudioStreamGetReadAheadStats(stream->mSoundStreamVoiceReference,
+                                                        &outStats->underruns,
+                                                        &outStats->missingFrames,
+                                                        &outStats->bufferedFrames,
+                                                        &outStats->capacityFrames);
+            }
+#endif
+        }
+        else
+        {
+            err = PARAM_ERR;
+        }
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 // BAEStream_GetInfo()
 // --------------------------------------
 // Upon return, the BAESampleInfo pointed to by parameter outInfo will contain a
@@ -6666,7 +7481,7 @@ BAESong BAESong_New(BAEMixer mixer)
     song = NULL;
     if (mixer)
     {
-        song = (BAESong)XNewPtr(sizeof(struct sBAESong));
+        song = (BAESong)XNewTaggedPtr(sizeof(struct sBAESong), X_MEMORY_SONGS);
         if (song)
         {
             if (BAE_NewMutex(&song->mLock, "bae", "seq", __LINE__))
@@ -7224,7 +8039,7 @@ BAEResult BAESong_LoadMidiFromMemory(BAESong song, void const *pMidiData, uint32
 
                         if (pSong->titleOffset)
                         {
-                            title = XNewPtr(pSong->titleLength + 1);
+                            title = XNewTaggedPtr(pSong->titleLength + 1, X_MEMORY_SONGS);
                             if (title)
                             {
                                 XBlockMove(((XBYTE *)pSong->sequenceData) + pSong->titleOffset,
@@ -7360,6 +8175,7 @@ BAEResult BAESong_LoadRmiFromFile(BAESong song, BAEPathName filePath, BAE_BOOL i
         BAE_AcquireMutex(song->mLock);
         XConvertPathToXFILENAME(filePath, &name);
         pMidiData = PV_GetFileAsData(&name, &midiSize);
+        XSetPtrTag(pMidiData, X_MEMORY_SONGS);
         
         if (pMidiData)
         {
@@ -7444,6 +8260,7 @@ BAEResult BAESong_LoadMidiFromFile(BAESong song, BAEPathName filePath, BAE_BOOL
         BAE_AcquireMutex(song->mLock);
         XConvertPathToXFILENAME(filePath, &name);
         pMidiData = PV_GetFileAsData(&name, &midiSize);
+        XSetPtrTag(pMidiData, X_MEMORY_SONGS);
         
         if (pMidiData)
         {
@@ -7544,7 +8361,7 @@ BAEResult BAESong_LoadRmfFromMemory(BAESong song, void const *pRMFData, uint32_t
         BAE_AcquireMutex(song->mLock);
         if (pRMFData && rmfSize)
         {
-            fileRef = XFileOpenResourceFromMemory((XPTR)pRMFData, rmfSize, TRUE);
+            fileRef = PV_OpenResourceFileFromMemory((XPTR)pRMFData, rmfSize, TRUE);
             if (fileRef)
             {
                 {
@@ -7686,7 +8503,7 @@ BAEResult BAESong_LoadRmfFromMemory(BAESong song, void const *pRMFData, uint32_t
                         XDisposePtr(pXSong); // free fallback copy
                     }
                 }
-                XFileClose(fileRef);
+                PV_CloseResourceFile(fileRef);
             }
             else
             {
@@ -7768,7 +8585,7 @@ BAEResult BAESong_LoadRmfFromFile(BAESong song, BAEPathName filePath, int16_t so
 #endif        
         BAE_AcquireMutex(song->mLock);
         XConvertPathToXFILENAME(filePath, &name);
-        fileRef = XFileOpenResource(&name, TRUE);
+        fileRef = PV_OpenResourceFile(&name, TRUE);
         if (fileRef)
         {
             pXSong = (SongResource *)XGetIndexedFileResource(fileRef, ID_SONG, &theID, songIndex, NULL, &size);
@@ -7847,7 +8664,7 @@ BAEResult BAESong_LoadRmfFromFile(BAESong song, BAEPathName filePath, int16_t so
             {
                 theErr = RESOURCE_NOT_FOUND;
             }
-            XFileClose(fileRef);
+            PV_CloseResourceFile(fileRef);
         }
         else
         {
@@ -8632,6 +9449,25 @@ BAEResult BAESong_ControlChange(BAESong song,
     return BAE_TranslateOPErr(err);
 }
 
+// With the instrument loader running, start loading the instrument a program change
+// selects when it's queued rather than when it plays. Called with song->mLock held.
+static void PV_BAESong_RequestProgramInstrument(BAESong song,
+                                                unsigned char channel,
+                                                int16_t bank,
+                                                unsigned char programNumber)
+{
+    XLongResourceID instrument;
+
+    if (song->pSong && GM_IsInstrumentLoaderEnabled())
+    {
+        instrument = GM_GetProgramInstrument(song->pSong, (INT16)channel, (INT16)bank, (INT16)programNumber);
+        if ((instrument >= 0) && (GM_IsSongInstrumentLoaded(song->pSong, instrument) == FALSE))
+        {
+            GM_RequestSongInstrument(song->pSong, instrument, CreateBankToken());
+        }
+    }
+}
+
 // BAESong_ProgramBankChange()
 // --------------------------------------
 //
@@ -8653,6 +9489,7 @@ BAEResult BAESong_ProgramBankChange(BAESong song,
             time = GM_GetSyncTimeStamp();
         }
 
+        PV_BAESong_RequestProgramInstrument(song, channel, (int16_t)bankNumber, programNumber);
         QGM_Controller(song->pSong, time, channel, 0, bankNumber);
         QGM_ProgramChange(song->pSong, time, channel, programNumber);
         BAE_ReleaseMutex(song->mLock);
@@ -8684,6 +9521,7 @@ BAEResult BAESong_ProgramChange(BAESong song,
             time = GM_GetSyncTimeStamp();
         }
 
+        PV_BAESong_RequestProgramInstrument(song, channel, -1, programNumber);
         QGM_ProgramChange(song->pSong, time, channel, programNumber);
         BAE_ReleaseMutex(song->mLock);
     }
@@ -9656,6 +10494,35 @@ BAEResult BAESong_GetMicrosecondPosition(BAESong song, uint32_t *outTicks)
     return BAE_TranslateOPErr(err);
 }
 
+// BAESong_GetMicrosecondPosition64()
+// --------------------------------------
+//
+//
+BAEResult BAESong_GetMicrosecondPosition64(BAESong song, uint64_t *outTicks)
+{
+    OPErr err;
+
+    err = NO_ERR;
+    if ((song) && (song->mID == OBJECT_ID))
+    {
+        BAE_AcquireMutex(song->mLock);
+        if (outTicks)
+        {
+            *outTicks = GM_SongMicroseconds64(song->pSong);
+        }
+        else
+        {
+            err = PARAM_ERR;
+        }
+        BAE_ReleaseMutex(song->mLock);
+    }
+    else
+    {
+        err = NULL_OBJECT;
+    }
+    return BAE_TranslateOPErr(err);
+}
+
 // BAESong_IsDone()
 // --------------------------------------
 //
@@ -10038,7 +10905,7 @@ static OPErr PV_GetRmfSongResource(void *pRMFData, uint32_t rmfSize, int16_t ind
     err = NO_ERR;
     if (pRMFData && rmfSize && ppOutResource && pOutResourceSize)
     {
-        fileRef = XFileOpenResourceFromMemory((XPTR)pRMFData, rmfSize, FALSE);
+        fileRef = PV_OpenResourceFileFromMemory((XPTR)pRMFData, rmfSize, FALSE);
         if (fileRef)
         {
             *ppOutResource = (SongResource *)XGetIndexedResource(ID_SONG, &theID, index, NULL, pOutResourceSize);
@@ -10050,7 +10917,7 @@ static OPErr PV_GetRmfSongResource(void *pRMFData, uint32_t rmfSize, int16_t ind
             {
                 err = PARAM_ERR;
             }
-            XFileClose(fileRef);
+            PV_CloseResourceFile(fileRef);
         }
         else
         {
@@ -10065,6 +10932,95 @@ static OPErr PV_GetRmfSongResource(void *pRMFData, uint32_t rmfSize, int16_t ind
 }
 #endif // #if USE_FULL_RMF_SUPPORT == TRUE
 
+// BAEUtil_GetMidiDuration()
+// --------------------------------------
+//
+//
+BAEResult BAEUtil_GetMidiDuration(void const *pMidiData, uint32_t midiSize,
+                                  uint32_t *pOutTicks, uint32_t *pOutMicroseconds)
+{
+    if ((pMidiData == NULL) || ((pOutTicks == NULL) && (pOutMicroseconds == NULL)))
+    {
+        return BAE_PARAM_ERR;
+    }
+    return BAE_TranslateOPErr(GM_ScanMidiLength(NULL, pMidiData, (int32_t)midiSize,
+                                                pOutTicks, pOutMicroseconds));
+}
+
+// BAEUtil_GetSongDurationFromFile()
+// --------------------------------------
+//
+//
+BAEResult BAEUtil_GetSongDurationFromFile(BAEPathName filePath, int16_t songIndex,
+                                          uint32_t *pOutTicks, uint32_t *pOutMicroseconds)
+{
+    XFILENAME name;
+    XPTR pMidiData;
+    int32_t midiSize;
+    OPErr theErr;
+
+    if ((filePath == NULL) || ((pOutTicks == NULL) && (pOutMicroseconds == NULL)))
+    {
+        return BAE_PARAM_ERR;
+    }
+    if (pOutTicks)
+    {
+        *pOutTicks = 0;
+    }
+    if (pOutMicroseconds)
+    {
+        *pOutMicroseconds = 0;
+    }
+    theErr = NO_ERR;
+    XConvertPathToXFILENAME(filePath, &name);
+    switch (X_DetermineFileType((const char *)filePath))
+    {
+    case BAE_MIDI_TYPE:
+    case BAE_RMI:
+        pMidiData = PV_GetFileAsData(&name, &midiSize);
+        if (pMidiData == NULL)
+        {
+            return BAE_FILE_NOT_FOUND;
+        }
+        theErr = GM_ScanMidiLength(NULL, pMidiData, midiSize, pOutTicks, pOutMicroseconds);
+        XDisposePtr(pMidiData);
+        break;
+#if USE_FULL_RMF_SUPPORT == TRUE
+    case BAE_RMF:
+    {
+        XFILE fileRef;
+        SongResource *pSongRes;
+        XLongResourceID theID;
+        int32_t songResSize;
+
+        fileRef = PV_OpenResourceFile(&name, TRUE);
+        if (fileRef == NULL)
+        {
+            return BAE_FILE_NOT_FOUND;
+        }
+        theErr = RESOURCE_NOT_FOUND;
+        pSongRes = (SongResource *)XGetIndexedFileResource(fileRef, ID_SONG, &theID, songIndex, NULL, &songResSize);
+        if (pSongRes)
+        {
+            // handles compressed and encrypted midi data
+            pMidiData = XGetMidiData((XLongResourceID)XGetSongResourceObjectID(pSongRes), &midiSize, NULL);
+            if (pMidiData)
+            {
+                theErr = GM_ScanMidiLength((void *)pSongRes, pMidiData, midiSize, pOutTicks, pOutMicroseconds);
+                XDisposePtr(pMidiData);
+            }
+            XDisposePtr((XPTR)pSongRes);
+        }
+        PV_CloseResourceFile(fileRef);
+        break;
+    }
+#endif
+    default:
+        return BAE_BAD_FILE_TYPE;
+    }
+    return BAE_TranslateOPErr(theErr);
+}
+
 // BAEUtil_GetInfoSizeFromFile()
 // --------------------------------------
 // If the file at filePath contains a song with index
@@ -10096,7 +11052,7 @@ BAEResult BAEUtil_GetInfoSizeFromFile(BAEPathName filePath,
         theErr = BAE_NO_ERROR;
         *pOutResourceSize = 0;
         XConvertPathToXFILENAME(filePath, &name);
-        fileRef = XFileOpenResource(&name, TRUE);
+        fileRef = PV_OpenResourceFile(&name, TRUE);
         if (fileRef)
         {
             pSongRes = (SongResource *)XGetIndexedFileResource(fileRef, ID_SONG, &theID, songIndex, NULL, &songResSize);
@@ -10105,7 +11061,7 @@ BAEResult BAEUtil_GetInfoSizeFromFile(BAEPathName filePath,
                 *pOutResourceSize = XGetSongInformationSize(pSongRes, songResSize, info);
             }
             XDisposePtr((XPTR)pSongRes);
-            XFileClose(fileRef);
+            PV_CloseResourceFile(fileRef);
         }
     }
     else
@@ -10144,7 +11100,7 @@ BAEResult BAEUtil_GetRmfSongInfoFromFile(BAEPathName filePath, int16_t songIndex
 
         theErr = BAE_NO_ERROR;
         XConvertPathToXFILENAME(filePath, &name);
-        fileRef = XFileOpenResource(&name, TRUE);
+        fileRef = PV_OpenResourceFile(&name, TRUE);
         if (fileRef)
         {
             pSongRes = (SongResource *)XGetIndexedFileResource(fileRef, ID_SONG, &theID, songIndex, NULL, &songResSize);
@@ -10162,7 +11118,7 @@ BAEResult BAEUtil_GetRmfSongInfoFromFile(BAEPathName filePath, int16_t songIndex
 #endif
             }
             XDisposePtr((XPTR)pSongRes);
-            XFileClose(fileRef);
+            PV_CloseResourceFile(fileRef);
         }
     }
     else
@@ -10392,7 +11348,7 @@ BAEResult BAEUtil_GetRmfVersion(void *pRMFData, uint32_t rmfSize,
 
     if (pRMFData && rmfSize && pVersionMajor && pVersionMinor && pVersionSubMinor)
     {
-        fileRef = XFileOpenResourceFromMemory((XPTR)pRMFData, rmfSize, FALSE);
+        fileRef = PV_OpenResourceFileFromMemory((XPTR)pRMFData, rmfSize, FALSE);
         if (fileRef)
         {
             XGetVersionNumber(&vers);
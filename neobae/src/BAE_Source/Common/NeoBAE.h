@@ -165,9 +165,35 @@ extern "C"
         BAE_REVERB_TYPE_16,    // Neo Reserved (Neo reverb)
         BAE_REVERB_TYPE_17,    // Neo Tap Delay (Neo reverb)
         BAE_REVERB_TYPE_18,    // Custom (Neo reverb)
+        BAE_REVERB_TYPE_19,    // Convolution, see BAEMixer_SetReverbImpulseFromFile
         BAE_REVERB_TYPE_COUNT
     } BAEReverbType;
 
+    // filter shapes for BAEMixer_SetMasterEqBand
+    typedef enum
+    {
+        BAE_MASTER_EQ_OFF = 0,
+        BAE_MASTER_EQ_PEAK,
+        BAE_MASTER_EQ_LOW_SHELF,
+        BAE_MASTER_EQ_HIGH_SHELF,
+        BAE_MASTER_EQ_TYPE_COUNT
+    } BAEMasterEqType;
+
+    // what memory is used for, see BAEMixer_GetMemoryUsage
+    typedef enum
+    {
+        BAE_MEMORY_OTHER = 0,   // everything not below
+        BAE_MEMORY_SAMPLES,     // sample data and the sample cache
+        BAE_MEMORY_INSTRUMENTS, // instruments
+        BAE_MEMORY_SONGS,       // songs, sequence and MIDI data
+        BAE_MEMORY_EFFECTS,     // reverb and chorus delay lines
+        BAE_MEMORY_STREAMS,     // audio stream buffers
+        BAE_MEMORY_DECODERS,    // audio file decoder state
+        BAE_MEMORY_SOUNDFONTS,  // SF2 and FluidSynth support
+        BAE_MEMORY_RESOURCES,   // open resource files and their caches
+        BAE_MEMORY_CATEGORY_COUNT
+    } BAEMemoryCategory;
+
     // used by the BAEExporter code
     typedef enum
     {
@@ -442,6 +468,26 @@ extern "C"
     };
     typedef struct BAESampleInfo BAESampleInfo;
 
+    struct BAESampleCacheStats
+    {
+        uint32_t hits;      // sample loads served by a sample already in the cache
+        uint32_t misses;    // sample loads that had to read and decode the sample
+        uint32_t evictions; // unused samples freed to stay within the budget
+        uint32_t bytes;     // sample bytes held by the cache, in use or not
+        uint32_t idleBytes; // the part of bytes no loaded instrument is using
+        uint32_t budget;    // see BAEMixer_SetSampleCacheBudget
+    };
+    typedef struct BAESampleCacheStats BAESampleCacheStats;
+
+    struct BAEStreamReadAheadStats
+    {
+        uint32_t underruns;         // buffers the mixer asked for before they were decoded
+        uint32_t missingFrames;     // frames those buffers came up short
+        uint32_t bufferedFrames;    // frames decoded and waiting now
+        uint32_t capacityFrames;    // most frames the stream decodes ahead
+    };
+    typedef struct BAEStreamReadAheadStats BAEStreamReadAheadStats;
+
     typedef struct sBAESong *BAESong;
     typedef struct sBAEMixer *BAEMixer;
     typedef struct sBAESound *BAESound;
@@ -592,6 +638,32 @@ extern "C"
     //
     BAEResult BAEMixer_GetMemoryUsed(BAEMixer mixer, uint32_t *pOutResult);
 
+    // BAEMixer_GetMemoryUsage()
+    // --------------------------------------
+    // Bytes of memory currently allocated by the engine for category, and the
+    // most there has been at once. These are counted for the whole process, not
+    // for one mixer. Either result pointer may be NULL.
+    //
+    BAEResult BAEMixer_GetMemoryUsage(BAEMixer mixer, BAEMemoryCategory category,
+                                      uint32_t *pOutCurrent, uint32_t *pOutPeak);
+
+    // BAEMixer_SetSampleCacheBudget()
+    // --------------------------------------
+    // Samples no loaded song or sound needs any more are kept in the mixer's
+    // sample cache until it holds more than budgetBytes of sample data, then
+    // freed least recently used first. Samples in use are never freed, so the
+    // cache can still go over budget. The default budget of 0 frees samples as
+    // soon as they are unused. Only valid once the mixer is open; reopening
+    // the mixer resets it.
+    //
+    BAEResult BAEMixer_SetSampleCacheBudget(BAEMixer mixer, uint32_t budgetBytes);
+
+    // BAEMixer_GetSampleCacheStats()
+    // --------------------------------------
+    // Counters for the mixer's sample cache since it was opened.
+    //
+    BAEResult BAEMixer_GetSampleCacheStats(BAEMixer mixer, BAESampleCacheStats *pOutStats);
+
     // BAEMixer_GetMixerVersion()
     // ------------------------------------
     // Upon return, parameters pVersionMajor, pVersionMinor, and pVersionSubMinor will
@@ -660,6 +732,89 @@ extern "C"
     BAEResult BAEMixer_SetDefaultReverb(BAEMixer mixer, BAEReverbType verb);
     BAEResult BAEMixer_GetDefaultReverb(BAEMixer mixer, BAEReverbType *pOutResult);
 
+    // BAEMixer_SetReverbImpulseFromFile()
+    // --------------------------------------
+    // Loads a WAV or AIFF impulse response for BAE_REVERB_TYPE_19, the
+    // convolution reverb. Mono or stereo, any sample rate, up to 10 seconds.
+    // Pass a NULL filePath to release the current impulse. Only valid once the
+    // mixer is open.
+    //
+    BAEResult BAEMixer_SetReverbImpulseFromFile(BAEMixer mixer,
+                                                BAEPathName filePath,
+                                                BAEFileType fileType);
+
+    // BAEMixer_SetMasterEqBand()
+    // BAEMixer_SetMasterEqEnabled()
+    // BAEMixer_SetMasterLimiterEnabled()
+    // --------------------------------------
+    // Master bus processing for 16 bit output. The EQ has five bands, numbered
+    // 0 to 4, each a peak, low shelf or high shelf filter at frequency Hz with
+    // gain in dB (-24 to 24) and a q of 0.1 to 20. The limiter uses about 2 ms
+    // of lookahead to keep peaks just under full scale instead of clipping them.
+    // Both are off by default. Only valid once the mixer is open.
+    //
+    BAEResult BAEMixer_SetMasterEqBand(BAEMixer mixer,
+                                       int16_t band,
+                                       BAEMasterEqType type,
+                                       uint32_t frequency,
+                                       BAE_FIXED gain,
+                                       BAE_UNSIGNED_FIXED q);
+    BAEResult BAEMixer_SetMasterEqEnabled(BAEMixer mixer, BAE_BOOL enabled);
+    BAEResult BAEMixer_SetMasterLimiterEnabled(BAEMixer mixer, BAE_BOOL enabled);
+
+    // BAEMixer_SetEffectsThreadEnabled()
+    // BAEMixer_GetEffectsLatency()
+    // --------------------------------------
+    // On machines with more than one processor, runs the reverb and chorus on a
+    // thread of their own while the next slice's voices are mixed. The variable
+    // and Neo reverbs and the chorus then come out one slice late; outFrames is
+    // that delay in sample frames, or 0 when the effects run in line. Returns
+    // BAE_NOT_SETUP if the platform can't start threads. Only valid once the mixer
+    // is open.
+    //
+    BAEResult BAEMixer_SetEffectsThreadEnabled(BAEMixer mixer, BAE_BOOL enabled);
+    BAEResult BAEMixer_GetEffectsLatency(BAEMixer mixer, uint32_t *outFrames);
+
+    // BAEMixer_SetInstrumentLoaderEnabled()
+    // BAEMixer_IsInstrumentLoaderEnabled()
+    // --------------------------------------
+    // Loads instruments on a thread of their own. While it is enabled, each
+    // BAESong_ProgramChange and BAESong_ProgramBankChange starts loading the
+    // instrument it selects as soon as it is called, so a change sent with a
+    // future time stamp has its instrument in place by the time it plays. Notes
+    // that arrive first play on the General MIDI instrument of the same program,
+    // if that is loaded. Returns BAE_NOT_SETUP if the platform can't start
+    // threads. Only valid once the mixer is open.
+    //
+    BAEResult BAEMixer_SetInstrumentLoaderEnabled(BAEMixer mixer, BAE_BOOL enabled);
+    BAEResult BAEMixer_IsInstrumentLoaderEnabled(BAEMixer mixer, BAE_BOOL *outEnabled);
+
+    // BAEMixer_SetLazySampleDecoding()
+    // BAEMixer_IsLazySampleDecoding()
+    // --------------------------------------
+    // Decodes the samples of a keymapped instrument only as notes need them.
+    // Splits a loaded song is known to play are decoded with it, the rest on the
+    // instrument loader the first time a note lands on them, while the nearest
+    // decoded split of the instrument plays in their place. Only takes effect
+    // while the instrument loader is enabled, for instruments loaded afterwards.
+    // Only valid once the mixer is open.
+    //
+    BAEResult BAEMixer_SetLazySampleDecoding(BAEMixer mixer, BAE_BOOL enabled);
+    BAEResult BAEMixer_IsLazySampleDecoding(BAEMixer mixer, BAE_BOOL *outEnabled);
+
+    // BAEMixer_SetStreamReadAhead()
+    // BAEMixer_GetStreamReadAhead()
+    // --------------------------------------
+    // Decodes file streams on a thread of their own, keeping each one the given
+    // number of milliseconds (at most 10000) ahead of the mixer, so a slow disk or
+    // a costly frame never holds up the audio task. Applies to streams set up
+    // afterwards; 0 stops the thread and streams decode as the mixer asks again.
+    // Returns BAE_NOT_SETUP if the platform can't start threads. Only valid once
+    // the mixer is open.
+    //
+    BAEResult BAEMixer_SetStreamReadAhead(BAEMixer mixer, uint32_t milliseconds);
+    BAEResult BAEMixer_GetStreamReadAhead(BAEMixer mixer, uint32_t *outMilliseconds);
+
     // BAEMixer_IsOpen()
     // ------------------------------------
     // Upon return, parameter outIsOpen will point to a BAE_BOOL indicating whether
@@ -798,6 +953,22 @@ extern "C"
                                        BAEPathName pAudioPathName,
                                        BAEBankToken *outToken);
 
+    // BAEMixer_AddBankFromFileWithSnapshot()
+    // ------------------------------------
+    // Same as BAEMixer_AddBankFromFile, but also keeps a snapshot of the bank's samples
+    // at pSnapshotPathName, already decoded into raw pcm for this machine. If the snapshot
+    // exists and was made from this exact bank it is mapped and its samples are played in
+    // place, so compressed samples are never decoded again. Otherwise it is rebuilt first.
+    // The snapshot is only a cache: if it can't be read or written, the bank still loads.
+    // ------------------------------------
+    // BAEResult codes:
+    //           BAE_BAD_FILE  -- Bad file or path spec
+    // ------------------------------------
+    BAEResult BAEMixer_AddBankFromFileWithSnapshot(BAEMixer mixer,
+                                                   BAEPathName pAudioPathName,
+                                                   BAEPathName pSnapshotPathName,
+                                                   BAEBankToken *outToken);
+
 
 #if _BUILT_IN_PATCHES == TRUE
     BAEResult BAEMixer_LoadBuiltinBank(BAEMixer mixer, BAEBankToken *outToken);
@@ -947,6 +1118,23 @@ extern "C"
                                           int16_t maxSoundVoices,
                                           int16_t mixLevel);
 
+    // BAEMixer_SetMaxSongs()
+    // ------------------------------------
+    // Sets how many BAESong objects may be playing on the indicated BAEMixer at
+    // once. The default is 16. Lowering the limit below the number of songs
+    // started on the mixer returns BAE_PARAM_ERR. Only valid once the mixer is open.
+    //
+    BAEResult BAEMixer_SetMaxSongs(BAEMixer mixer,
+                                   int16_t maxSongs);
+
+    // BAEMixer_GetMaxSongs()
+    // ------------------------------------
+    // Upon return, parameter outMaxSongs will point to the number of songs that
+    // can play at once on the indicated BAEMixer.
+    //
+    BAEResult BAEMixer_GetMaxSongs(BAEMixer mixer,
+                                   int16_t *outMaxSongs);
+
     // BAEMixer_GetMidiVoices()
     // ------------------------------------
     // Upon return, parameter outNumMidiVoices will point to a int16_t containing
@@ -982,6 +1170,14 @@ extern "C"
     BAEResult BAEMixer_GetTick(BAEMixer mixer,
                                uint32_t *outTick);
 
+    // BAEMixer_GetTick64()
+    // ------------------------------------
+    // Same as BAEMixer_GetTick, as a 64 bit count. BAEMixer_GetTick wraps about
+    // every 71 minutes; use this one for anything that runs longer.
+    //
+    BAEResult BAEMixer_GetTick64(BAEMixer mixer,
+                                 uint64_t *outTick);
+
     // BAEMixer_SetAudioLatency()
     // ------------------------------------
     // Reconfigures the current BAE output device buffers to achieve the requested
@@ -1186,6 +1382,18 @@ extern "C"
     BAEResult BAEStream_SetLoopFlag(BAEStream stream, BAE_BOOL loop);
     BAEResult BAEStream_GetLoopFlag(BAEStream stream, BAE_BOOL *outLoop);
 
+    // BAEStream_GetReadAheadStats()
+    // --------------------------------------
+    // Upon return, the BAEStreamReadAheadStats pointed to by parameter outStats
+    // will hold the underrun counts and fill level of a stream decoded ahead.
+    // See BAEMixer_SetStreamReadAhead.
+    // ------------------------------------
+    // BAEResult codes:
+    //           BAE_NOT_SETUP -- The stream isn't decoded ahead
+    // ------------------------------------
+    BAEResult BAEStream_GetReadAheadStats(BAEStream stream,
+                                          BAEStreamReadAheadStats *outStats);
+
     // BAEStream_GetInfo()
     // --------------------------------------
     // Upon return, the BAESampleInfo pointed to by parameter outInfo will contain a
@@ -2474,6 +2682,13 @@ extern "C"
     BAEResult BAESong_GetMicrosecondPosition(BAESong song,
                                              uint32_t *outTicks);
 
+    // BAESong_GetMicrosecondPosition64()
+    // ------------------------------------
+    // Same as BAESong_GetMicrosecondPosition, as a 64 bit count.
+    //
+    BAEResult BAESong_GetMicrosecondPosition64(BAESong song,
+                                               uint64_t *outTicks);
+
     // BAESong_GetMicrosecondLength()
     // ------------------------------------
     // Upon return, parameter outLength will point to an uint32_t containing the
@@ -2634,6 +2849,38 @@ extern "C"
     BAEResult BAEUtil_GetRmfSongInfoFromFile(BAEPathName filePath, int16_t songIndex,
                                              BAEInfoType infoType, char *targetBuffer, uint32_t bufferBytes);
 
+    // BAEUtil_GetSongDurationFromFile()
+    // --------------------------------------
+    // Returns the play length of the Standard MIDI, RMI or RMF file at filePath
+    // without loading instruments or running the sequencer, which makes it
+    // suitable for scanning large libraries. songIndex selects the song in an
+    // RMF file and is ignored otherwise. Upon return pOutTicks (MIDI ticks of
+    // the file division) and pOutMicroseconds hold the length; either may be
+    // NULL. Tempo changes, the RMF song tempo and finite loopstart=n/loopend
+    // markers are honoured as they play once looping is enabled with
+    // BAESong_SetLoops(); endless loops are counted once. Results may differ
+    // from BAESong_GetMicrosecondLength() by a few mixer slices.
+    // --------------------------------------
+    // BAEResult codes:
+    //           BAE_BAD_FILE_TYPE -- Not a MIDI, RMI or RMF file
+    //           BAE_BAD_MIDI_DATA -- Corrupt MIDI data
+    //           BAE_GENERAL_ERR   -- Longer than one hour
+    // --------------------------------------
+    BAEResult BAEUtil_GetSongDurationFromFile(BAEPathName filePath,
+                                              int16_t songIndex,
+                                              uint32_t *pOutTicks,
+                                              uint32_t *pOutMicroseconds);
+
+    // BAEUtil_GetMidiDuration()
+    // --------------------------------------
+    // Same as BAEUtil_GetSongDurationFromFile() for Standard MIDI File (or RMI)
+    // data already in memory. You must supply the size in bytes of the data.
+    //
+    BAEResult BAEUtil_GetMidiDuration(void const *pMidiData,
+                                      uint32_t midiSize,
+                                      uint32_t *pOutTicks,
+                                      uint32_t *pOutMicroseconds);
+
     // BAEUtil_GetInfoSizeFromFile()
     // --------------------------------------
     // If the file at filePath contains a song with index
@@ -522,7 +522,7 @@ UINT32          const decodingBytes = decodingFrames * bytesPerFrame;
     case C_IMA4_WAV:// IMA 4:1 - WAV-file flavor
     case C_ALAW:    // ALAW 2:1
     case C_ULAW:    // ULAW 2:1
-        dst->theWaveform = XNewPtr(decodingBytes);
+        dst->theWaveform = XNewTaggedPtr(decodingBytes, X_MEMORY_SAMPLES);
         if (!dst->theWaveform)
         {
             return MEMORY_ERR;
@@ -598,7 +598,7 @@ UINT32          const decodingBytes = decodingFrames * bytesPerFrame;
                                                          : XExpandMace1to6;
         maceFrames = decodingFrames / 6;
         
-        dst->theWaveform = XNewPtr(dst->waveSize);
+        dst->theWaveform = XNewTaggedPtr(dst->waveSize, X_MEMORY_SAMPLES);
         if (!dst->theWaveform)
         {
             return MEMORY_ERR;
@@ -615,7 +615,7 @@ UINT32          const decodingBytes = decodingFrames * bytesPerFrame;
         XBYTE*      pRight;
         XDWORD      i;
         
-            rightData = XNewPtr(dst->waveSize / 2);
+            rightData = XNewTaggedPtr(dst->waveSize / 2, X_MEMORY_SAMPLES);
             if (!rightData)
             {
                 XDisposePtr(dst->theWaveform);
@@ -857,6 +857,102 @@ XERR XGetSampleInfoFromSnd(XPTR pResource, SampleDataInfo *pOutInfo)
 }
 #endif  // USE_CREATION_API == TRUE
 
+// Create a ID_SND resource holding raw pcm, as described by *pInfo, in the native byte order.
+// The samples land at an even offset from the start of the resource.
+XPTR XCreateRawSoundObject(SampleDataInfo const* pInfo, XPTRC pSampleData)
+{
+    XPTR                pRes;
+    XSoundHeader3       *header3;
+
+    pRes = NULL;
+    if (pInfo && pSampleData && pInfo->size)
+    {
+        pRes = XNewTaggedPtr(XRAW_SOUND_HEADER_SIZE + (int32_t)pInfo->size, X_MEMORY_SAMPLES);
+        if (pRes)
+        {
+            XPutShort(pRes, XThirdSoundFormat);
+            header3 = (XSoundHeader3 *)((char *)pRes + sizeof(int16_t));
+            XPutLong(&header3->subType, C_NONE);
+            XPutLong(&header3->sampleRate, pInfo->rate);
+            XPutLong(&header3->decodedBytes, pInfo->size);
+            XPutLong(&header3->frameCount, pInfo->frames);
+            XPutLong(&header3->encodedBytes, pInfo->size);
+            XPutLong(&header3->loopStart[0], pInfo->loopStart);
+            XPutLong(&header3->loopEnd[0], pInfo->loopEnd);
+            XPutLong(&header3->nameResourceType, ID_NULL);
+            header3->baseKey = (XBYTE)pInfo->baseKey;
+            header3->channels = (XBYTE)pInfo->channels;
+            header3->bitSize = (XBYTE)pInfo->bitSize;
+            header3->isSampleIntelOrder = (X_WORD_ORDER != FALSE);
+            XBlockMove(pSampleData, header3->sampleArea, (int32_t)pInfo->size);
+        }
+    }
+    return pRes;
+}
+
+// Given a ID_SND resource, return TRUE if XGetSamplePtrFromSnd will hand back a pointer
+// into pRes without writing to it: raw pcm, already in the native byte order and, for 16
+// bit data, aligned. Such a resource can be played from shared memory like a mapped file.
+XBOOL XIsSndUsableInPlace(XPTR pRes)
+{
+    XSoundHeader        *header;
+    XExtSoundHeader     *headerExt;
+    XSoundHeader3       *header3;
+    int16_t             headerType;
+    XBYTE               *encodedData;
+    int16_t             bitSize;
+    XBYTE               intelOrder;
+
+    header = (XSoundHeader *)PV_GetSoundHeaderPtr(pRes, &headerType);
+    if (header == NULL)
+    {
+        return FALSE;
+    }
+    switch (headerType)
+    {
+        case XStandardHeader:   // always 8 bit
+            return TRUE;
+        case XExtendedHeader:
+            headerExt = (XExtSoundHeader *)header;
+            encodedData = (XBYTE *)headerExt->sampleArea;
+            if (XGetLong(&headerExt->samplePtr))
+            {
+                encodedData = (XBYTE *)header + (uintptr_t)XGetLong(&headerExt->samplePtr);
+            }
+            bitSize = XGetShort(&headerExt->sampleSize);
+            intelOrder = (XBYTE)headerExt->sampleIsIntelOrder;
+            break;
+        case XType3Header:
+            header3 = (XSoundHeader3 *)header;
+            if (XGetLong(&header3->subType) != C_NONE)
+            {
+                return FALSE;
+            }
+            encodedData = (XBYTE *)header3->sampleArea;
+            bitSize = header3->bitSize;
+            intelOrder = header3->isSampleIntelOrder;
+            break;
+        default:                // compressed
+            return FALSE;
+    }
+    if (bitSize == 16)
+    {
+#if X_WORD_ORDER != FALSE
+        if (intelOrder == FALSE)
+        {
+            return FALSE;       // would be swapped in place
+        }
+#else
+        (void)intelOrder;
+#endif
+        if ((uintptr_t)encodedData & 1)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
 // Given a ID_SND resource, parse through and return in *pInfo the information
 // about the sample resource. The pMasterPtr will be set to the resource passed in (pRes).
 //
@@ -1094,7 +1190,7 @@ XBYTE               order = X_WORD_ORDER;
             {
                 // since we are reading from ROM, we need to copy the data
                 // before we can swap it.
-                sampleData = XNewPtr(info->size);  // 09.30.00 tl. this was XNewPtr(encodedBytes);
+                sampleData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);  // 09.30.00 tl. this was XNewPtr(encodedBytes);
                 if (!sampleData)
                 {
                     return NULL;
@@ -1223,7 +1319,7 @@ char                        *pLeft, *pRight;
                     {
                         // since we are reading from ROM, we need to copy the data
                         // before we can swap it.
-                        decodedData = XNewPtr(info->size);
+                        decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
                         info->pMasterPtr = decodedData;
                         if (decodedData)
                         {
@@ -1311,7 +1407,7 @@ char                        *pLeft, *pRight;
                 {
                     // since we are reading from ROM, we need to copy the data
                     // before we can swap it.
-                    decodedData = XNewPtr(info->size);
+                    decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
                     info->pMasterPtr = decodedData;
                     if (decodedData)
                     {
@@ -1369,7 +1465,7 @@ char                        *pLeft, *pRight;
                 // do a 8 bit decompression. As we decompress the IMA we build a 8 bit sample
                     info->bitSize = 8;          // must change to final output size
                 }
-                decodedData = XNewPtr(info->size);
+                decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
                 if (decodedData)
                 {
                     XExpandAiffIma((XBYTE const*)sampleData, AIFF_IMA_BLOCK_BYTES,
@@ -1380,7 +1476,7 @@ char                        *pLeft, *pRight;
             case C_ALAW:    // alaw 2 : 1
                 info->bitSize = 16;                             // must change, its stored as 8 bit
                 info->size = info->frames * info->channels * 2; // always 16 bit
-                decodedData = XNewPtr(info->size);
+                decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
                 if (decodedData)
                 {
                     XExpandALawto16BitLinear((XBYTE*)sampleData,
@@ -1391,7 +1487,7 @@ char                        *pLeft, *pRight;
             case C_ULAW:    // ulaw 2 : 1
                 info->bitSize = 16;                             // must change, its stored as 8 bit
                 info->size = info->frames * info->channels * 2; // always 16 bit
-                decodedData = XNewPtr(info->size);
+                decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
                 if (decodedData)
                 {
                     XExpandULawto16BitLinear((XBYTE*)sampleData,
@@ -1411,7 +1507,7 @@ char                        *pLeft, *pRight;
             info->frames *= 6;          // adjust the frame count to equal the real frames
             info->size = info->frames * (info->channels) * (info->bitSize / 8);
             // 2 bytes at 3:1 is 6 bytes for a packet, 1 byte at 6:1 is 6 bytes too
-            decodedData = XNewPtr(info->size);
+            decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
             if (decodedData)
             {
                 if (info->channels == 1)
@@ -1421,7 +1517,7 @@ char                        *pLeft, *pRight;
                 }
                 else
                 {
-                    rightData = XNewPtr(info->size / 2);
+                    rightData = XNewTaggedPtr(info->size / 2, X_MEMORY_SAMPLES);
                     if (rightData)
                     {
                         XExpandMace1to3(sampleData, decodedData, info->frames, NULL, NULL, info->channels, 1);
@@ -1454,7 +1550,7 @@ char                        *pLeft, *pRight;
             info->frames *= 6;          // adjust the frame count to equal the real frames
             info->size = info->frames * (info->channels) * (info->bitSize / 8);
             // 2 bytes at 3:1 is 6 bytes for a packet, 1 byte at 6:1 is 6 bytes too
-            decodedData = XNewPtr(info->size);
+            decodedData = XNewTaggedPtr(info->size, X_MEMORY_SAMPLES);
             if (decodedData)
             {
                 if (info->channels == 1)
@@ -1463,7 +1559,7 @@ char                        *pLeft, *pRight;
                 }
                 else
                 {
-                    rightData = XNewPtr(info->size / 2);
+                    rightData = XNewTaggedPtr(info->size / 2, X_MEMORY_SAMPLES);
                     if (rightData)
                     {
                         XExpandMace1to6(sampleData, decodedData, info->frames, NULL, NULL, info->channels, 1);
@@ -1543,7 +1639,7 @@ XWORD * XConvert8BitTo16Bit(XBYTE * p8BitPCMData, uint32_t frames, uint32_t chan
     int16_t        sample;
 
     ccount = frames * channels;
-    newData = (XWORD *)XNewPtr(ccount * sizeof(int16_t));
+    newData = (XWORD *)XNewTaggedPtr(ccount * sizeof(int16_t), X_MEMORY_SAMPLES);
     if (newData)
     {
         for (count = 0; count < ccount; count++)
@@ -1570,7 +1666,7 @@ XBYTE * XConvert16BitTo8Bit(XWORD * p16BitPCMData, uint32_t frames, uint32_t cha
     if (p16BitPCMData)
     {
         ccount = frames * channels;
-        newData = (XBYTE *)XNewPtr(ccount * sizeof(char));
+        newData = (XBYTE *)XNewTaggedPtr(ccount * sizeof(char), X_MEMORY_SAMPLES);
         if (newData)
         {
             for (count = 0; count < ccount; count++)
@@ -198,7 +198,7 @@ void* XOpenVorbisFile(XFILE file)
     
     if (file == NULL) return NULL;
     
-    decoder = (XVorbisDecoder*)XNewPtr(sizeof(XVorbisDecoder));
+    decoder = (XVorbisDecoder*)XNewTaggedPtr(sizeof(XVorbisDecoder), X_MEMORY_DECODERS);
     if (decoder == NULL) return NULL;
     
     decoder->is_open = FALSE;
@@ -406,6 +406,7 @@
 
 #define DEBUG_PRINT_RESOURCE        0
 #define USE_FILE_CACHE              0   // if 1, then file cache is enabled
+#define USE_FILE_MAPPING            1   // if 1, read only resource files are mapped where the platform can
 
 // Buffer size used for intra-file copy/compaction operations when cleaning
 // resource files. Original code referenced XFER_BUFFER_SIZE without a local
@@ -415,10 +416,35 @@
 #endif
 
 // Structures
+#if USE_FILE_MAPPING != 0
+// A mapped resource file. The XFILE holds one reference, and every pointer handed out by
+// XGetMappedResource holds another, so samples can keep using the pages after XFileClose.
+struct XFILEMAPPING
+{
+    struct XFILEMAPPING *pNext;
+    XBYTE               *pBase;
+    uint32_t            length;
+    int32_t             references;
+};
+typedef struct XFILEMAPPING XFILEMAPPING;
+#endif
 
 // Variables
 static int16_t    g_resourceFileCount = 0;                // number of open resource files
 static XFILE        g_openResourceFiles[MAX_OPEN_XFILES];
+#if USE_FILE_MAPPING != 0
+static XFILEMAPPING *g_fileMappings = NULL;                 // live mappings, including closed files
+static BAE_Mutex    g_fileMappingLock = NULL;               // guards g_fileMappings and every reference count
+#endif
+static uint32_t     g_fileContentSerial = 0;              // source of keys for files nobody has hashed
+
+// Until someone hashes a file's contents, it gets a key no other open file will share. These
+// have the top bit set so they can't collide with keys made from a digest.
+static uint64_t PV_NewFileContentKey(void)
+{
+    g_fileContentSerial++;
+    return XFILE_UNIQUE_CONTENT_KEY | (uint64_t)g_fileContentSerial;
+}
 
 // Private functions
 
@@ -651,6 +677,61 @@ XPI_Memblock * XIsOurMemoryPtr(XPTR data)
     return pBlockReturn;
 }
 
+// Bytes allocated under each XMemoryTag, now and at most
+static uint32_t g_memoryTagUsed[X_MEMORY_TAG_COUNT];
+static uint32_t g_memoryTagPeak[X_MEMORY_TAG_COUNT];
+static BAE_Mutex g_memoryTagLock = NULL;        // keeps the counts whole when worker threads allocate
+
+// Called as each mixer is set up, before it starts any worker threads. Never freed.
+void XInitMemoryTagLock(void)
+{
+    if (g_memoryTagLock == NULL)
+    {
+        if (BAE_NewMutex(&g_memoryTagLock, "bae", "tags", __LINE__) == 0)
+        {
+            g_memoryTagLock = NULL;
+        }
+    }
+}
+
+static void PV_AddTaggedMemory(int32_t tag, int32_t size)
+{
+    if ((tag < 0) || (tag >= X_MEMORY_TAG_COUNT))
+    {
+        tag = X_MEMORY_OTHER;
+    }
+    if (g_memoryTagLock)
+    {
+        BAE_AcquireMutex(g_memoryTagLock);
+    }
+    g_memoryTagUsed[tag] += (uint32_t)size;
+    if (g_memoryTagUsed[tag] > g_memoryTagPeak[tag])
+    {
+        g_memoryTagPeak[tag] = g_memoryTagUsed[tag];
+    }
+    if (g_memoryTagLock)
+    {
+        BAE_ReleaseMutex(g_memoryTagLock);
+    }
+}
+
+static void PV_RemoveTaggedMemory(int32_t tag, int32_t size)
+{
+    if ((tag < 0) || (tag >= X_MEMORY_TAG_COUNT))
+    {
+        tag = X_MEMORY_OTHER;
+    }
+    if (g_memoryTagLock)
+    {
+        BAE_AcquireMutex(g_memoryTagLock);
+    }
+    g_memoryTagUsed[tag] -= (uint32_t)size;
+    if (g_memoryTagLock)
+    {
+        BAE_ReleaseMutex(g_memoryTagLock);
+    }
+}
+
 // This function re-allocates a memory block
 // ptr may be NULL, in which case the functionality is the same as XNewPtr()
 // If allocation fails, ptr is unaffected (It's still allocated.)
@@ -664,6 +745,7 @@ int32_t        const currentSize = ptr ? XGetPtrSize(ptr) : 0;
     if (size != currentSize)
     {
     XPTR        newPtr;
+    XPI_Memblock*       odata;
 
 #if TRUE    // disable when these is an BAE_ResizePointer()
         if ((size < currentSize) &&
@@ -676,7 +758,8 @@ int32_t        const currentSize = ptr ? XGetPtrSize(ptr) : 0;
         else
 #endif
         {
-            newPtr = XNewPtr(size);
+            odata = ptr ? XIsOurMemoryPtr(ptr) : NULL;
+            newPtr = XNewTaggedPtr(size, odata ? (XMemoryTag)odata->blockTag : X_MEMORY_OTHER);
         }
 
         if (newPtr && ptr)
@@ -693,11 +776,10 @@ int32_t        const currentSize = ptr ? XGetPtrSize(ptr) : 0;
         }
         else if (ptr && (size < currentSize))
         {
-        XPI_Memblock*       odata;
-
             odata = (XPI_Memblock*)XIsOurMemoryPtr(ptr);
             if (odata)
             {
+                PV_RemoveTaggedMemory(odata->blockTag, odata->blockSize - size);
                 odata->blockSize = size;
                 return ptr;
             }
@@ -709,6 +791,12 @@ int32_t        const currentSize = ptr ? XGetPtrSize(ptr) : 0;
 
 // Allocates a block of ZEROED!!!! memory and locks it down
 XPTR XNewPtr(int32_t size)
+{
+    return XNewTaggedPtr(size, X_MEMORY_OTHER);
+}
+
+// Same as XNewPtr, and counts the block under tag
+XPTR XNewTaggedPtr(int32_t size, XMemoryTag tag)
 {
     char            *data;
     XPI_Memblock    *pBlock;
@@ -726,10 +814,46 @@ XPTR XNewPtr(int32_t size)
         XPutLong(&pBlock->blockID_two, XPI_BLOCK_2_ID);
         data += sizeof(XPI_Memblock);
         pBlock->blockSize = size - sizeof(XPI_Memblock);
+        pBlock->blockTag = (int32_t)tag;
+        PV_AddTaggedMemory(pBlock->blockTag, pBlock->blockSize);
     }
     return (XPTR)data;
 }
 
+void XSetPtrTag(XPTR data, XMemoryTag tag)
+{
+    XPI_Memblock    *pBlock;
+
+    pBlock = XIsOurMemoryPtr(data);
+    if (pBlock && (pBlock->blockTag != (int32_t)tag))
+    {
+        PV_RemoveTaggedMemory(pBlock->blockTag, pBlock->blockSize);
+        pBlock->blockTag = (int32_t)tag;
+        PV_AddTaggedMemory(pBlock->blockTag, pBlock->blockSize);
+    }
+}
+
+void XGetMemoryTagUsage(XMemoryTag tag, uint32_t *pCurrent, uint32_t *pPeak)
+{
+    uint32_t    current, peak;
+
+    current = 0;
+    peak = 0;
+    if (((int)tag >= 0) && (tag < X_MEMORY_TAG_COUNT))
+    {
+        current = g_memoryTagUsed[tag];
+        peak = g_memoryTagPeak[tag];
+    }
+    if (pCurrent)
+    {
+        *pCurrent = current;
+    }
+    if (pPeak)
+    {
+        *pPeak = peak;
+    }
+}
+
 void XDisposePtr(XPTR data)
 {
     XPTR            osAllocatedData;
@@ -741,6 +865,7 @@ void XDisposePtr(XPTR data)
         XGetPtrSize(data);   // need to get the size before we translate the pointer
 
         pBlock = (XPI_Memblock *)osAllocatedData;
+        PV_RemoveTaggedMemory(pBlock->blockTag, pBlock->blockSize);
         XPutLong(&pBlock->blockID_one, (uint32_t)XPI_DEAD_ID);         // set our ID for this block
         XPutLong(&pBlock->blockID_two, (uint32_t)XPI_DEAD_ID);         // to be dead. Used for tracking
         BAE_Deallocate(osAllocatedData);
@@ -881,6 +1006,13 @@ uint32_t XMicroseconds(void)
     return BAE_Microseconds();
 }
 
+// Returns microseconds since boot as a 64 bit count that does not wrap. Use this
+// for anything that gets compared or subtracted over long runs.
+uint64_t XMicroseconds64(void)
+{
+    return BAE_Microseconds64();
+}
+
 // Does sound hardware support 16 bit output
 XBOOL XIs16BitSupported(void)
 {
@@ -1261,7 +1393,7 @@ XERR XGetFileAsData(XFILENAME *pResourceName, XPTR *ppData, int32_t *pSize)
         if (ref)
         {
             size = XFileGetLength(ref);
-            pData = XNewPtr(size);
+            pData = XNewTaggedPtr(size, X_MEMORY_RESOURCES);
             if (pData)
             {
                 if (XFileRead(ref, pData, size) != 0)
@@ -1356,6 +1488,330 @@ XERR XGetTempXFILENAME(XFILENAME* xfilename)
 }
 #endif
 
+// Hash index over a resource file's access cache. It is built when the cache is built, so
+// looking up a resource by type and ID, or by type and name, neither walks the map nor
+// touches the file. Tables hold cache item + 1, 0 is empty. Items are inserted in file
+// order, so when a type and ID appear twice the first one in the file still wins.
+// Tables are kept at most half full. Resources added later go into them in place, and
+// they're rebuilt twice the size from the pooled names once they'd be fuller than that.
+struct XFILERESOURCEINDEX
+{
+    int32_t             tableMask;      // table size - 1, table size is a power of two
+    int32_t             *pIDTable;      // keyed on type and ID
+    int32_t             *pNameTable;    // keyed on type and name, only items with a name
+    int32_t             *pNameOffset;   // per item offset of its pascal name in pNames, room for half the table size
+    char                *pNames;        // pascal names of every item, in item order
+    int32_t             namesUsed;      // bytes used in pNames
+    int32_t             namesAllocated; // bytes allocated for pNames
+};
+typedef struct XFILERESOURCEINDEX   XFILERESOURCEINDEX;
+
+// names collected while the cache is built
+struct XFILERESOURCENAMES
+{
+    char                *pNames;
+    int32_t             size;           // number of names
+    int32_t             used;           // bytes used in pNames
+    int32_t             allocated;      // bytes allocated for pNames
+};
+typedef struct XFILERESOURCENAMES   XFILERESOURCENAMES;
+
+static uint32_t PV_HashResourceID(XResourceType resourceType, XLongResourceID resourceID)
+{
+    uint64_t    key;
+
+    key = ((uint64_t)(uint32_t)resourceType << 32) | (uint32_t)resourceID;
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+// pName is a C string
+static uint32_t PV_HashResourceName(XResourceType resourceType, char const *pName)
+{
+    uint32_t    hash;
+
+    hash = 2166136261UL ^ (uint32_t)resourceType;
+    hash *= 16777619UL;
+    while (*pName)
+    {
+        hash ^= (XBYTE)*pName++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// append pascal name to the collection. On allocation failure the name is dropped, which
+// callers notice by size not matching the item count.
+static void PV_AddResourceName(XFILERESOURCENAMES *pNames, char const *pPascalName)
+{
+    int32_t     length;
+    char        *pNew;
+
+    length = (XBYTE)pPascalName[0] + 1;
+    if (pNames->used + length > pNames->allocated)
+    {
+        int32_t newSize = (pNames->allocated) ? pNames->allocated * 2 : 4096;
+        while (newSize < pNames->used + length)
+        {
+            newSize *= 2;
+        }
+        if (pNames->pNames)
+        {
+            pNew = (char *)XResizePtr(pNames->pNames, newSize);
+        }
+        else
+        {
+            pNew = (char *)XNewTaggedPtr(newSize, X_MEMORY_RESOURCES);
+        }
+        if (pNew == NULL)
+        {
+            return;
+        }
+        pNames->pNames = pNew;
+        pNames->allocated = newSize;
+    }
+    XBlockMove(pPascalName, pNames->pNames + pNames->used, length);
+    pNames->used += length;
+    pNames->size++;
+}
+
+// Put cache item number count, whose pascal name is at offset in pIndex->pNames, in the tables
+static void PV_IndexResource(XFILERESOURCEINDEX *pIndex, XFILE_CACHED_ITEM *pItem, int32_t count, int32_t offset)
+{
+    uint32_t            slot;
+    char                name[256];
+
+    pIndex->pNameOffset[count] = offset;
+
+    slot = PV_HashResourceID(pItem->resourceType, pItem->resourceID) & pIndex->tableMask;
+    while (pIndex->pIDTable[slot])
+    {
+        slot = (slot + 1) & pIndex->tableMask;
+    }
+    pIndex->pIDTable[slot] = count + 1;
+
+    if (pIndex->pNames[offset])
+    {
+        XBlockMove(&pIndex->pNames[offset], name, (XBYTE)pIndex->pNames[offset] + 1);
+        XPtoCstr(name);
+        slot = PV_HashResourceName(pItem->resourceType, name) & pIndex->tableMask;
+        while (pIndex->pNameTable[slot])
+        {
+            slot = (slot + 1) & pIndex->tableMask;
+        }
+        pIndex->pNameTable[slot] = count + 1;
+    }
+}
+
+static void PV_FreeResourceIndex(XFILENAME *pReference)
+{
+    if (pReference->pIndex)
+    {
+        XDisposePtr(pReference->pIndex->pNames);
+        XDisposePtr(pReference->pIndex);
+        pReference->pIndex = NULL;
+    }
+}
+
+// Build the index for pReference->pCache. pNamePool holds the pascal names of every item in
+// item order and is taken over by the index; pass NULL to read the names back from the file.
+// If anything fails there is simply no index, and lookups scan the cache as before.
+static void PV_BuildResourceIndex(XFILENAME *pReference, char *pNamePool)
+{
+    XFILERESOURCECACHE  *pCache;
+    XFILERESOURCEINDEX  *pIndex;
+    int32_t             count, total, tableSize, offset, savePos;
+    char                name[256];
+
+    PV_FreeResourceIndex(pReference);
+    pCache = pReference->pCache;
+    if (pCache == NULL || pCache->totalResources <= 0)
+    {
+        XDisposePtr(pNamePool);
+        return;
+    }
+    total = pCache->totalResources;
+
+    if (pNamePool == NULL)
+    {
+        XFILERESOURCENAMES  names;
+
+        names.pNames = NULL;
+        names.size = 0;
+        names.used = 0;
+        names.allocated = 0;
+        savePos = XFileGetPosition(pReference);
+        for (count = 0; count < total; count++)
+        {
+            name[0] = 0;
+            if ((XFileSetPosition(pReference, pCache->cached[count].fileOffsetName) != 0) ||
+                (XFileRead(pReference, &name[0], 1L) != 0) ||
+                (name[0] && XFileRead(pReference, &name[1], (XBYTE)name[0]) != 0))
+            {
+                break;
+            }
+            PV_AddResourceName(&names, name);
+        }
+        XFileSetPosition(pReference, savePos);
+        if (names.size != total)
+        {
+            XDisposePtr(names.pNames);
+            return;
+        }
+        pNamePool = names.pNames;
+    }
+
+    tableSize = 16;
+    while (tableSize < total * 2)
+    {
+        tableSize *= 2;
+    }
+    pIndex = (XFILERESOURCEINDEX *)XNewTaggedPtr((int32_t)sizeof(XFILERESOURCEINDEX) +
+                                                 (int32_t)sizeof(int32_t) * (tableSize * 2 + tableSize / 2),
+                                                 X_MEMORY_RESOURCES);
+    if (pIndex == NULL)
+    {
+        XDisposePtr(pNamePool);
+        return;
+    }
+    pIndex->tableMask = tableSize - 1;
+    pIndex->pIDTable = (int32_t *)(pIndex + 1);
+    pIndex->pNameTable = pIndex->pIDTable + tableSize;
+    pIndex->pNameOffset = pIndex->pNameTable + tableSize;
+    pIndex->pNames = pNamePool;
+
+    offset = 0;
+    for (count = 0; count < total; count++)
+    {
+        PV_IndexResource(pIndex, &pCache->cached[count], count, offset);
+        offset += (XBYTE)pNamePool[offset] + 1;
+    }
+    // the pool may be bigger, but this is all that's known to be there
+    pIndex->namesUsed = offset;
+    pIndex->namesAllocated = offset;
+    pReference->pIndex = pIndex;
+}
+
+#if USE_CREATION_API == TRUE
+// Index the item just appended to pReference->pCache, whose name is the pascal string
+// pPascalName, or none if that's NULL.
+static void PV_AddToResourceIndex(XFILENAME *pReference, char const *pPascalName)
+{
+    XFILERESOURCEINDEX  *pIndex;
+    XFILERESOURCENAMES  names;
+    int32_t             total, offset;
+    char                noName;
+
+    pIndex = pReference->pIndex;
+    if (pIndex == NULL)
+    {
+        PV_BuildResourceIndex(pReference, NULL);
+        return;
+    }
+    total = pReference->pCache->totalResources;
+    noName = 0;
+    offset = pIndex->namesUsed;
+    names.pNames = pIndex->pNames;
+    names.size = total - 1;
+    names.used = pIndex->namesUsed;
+    names.allocated = pIndex->namesAllocated;
+    PV_AddResourceName(&names, pPascalName ? pPascalName : &noName);
+    pIndex->pNames = names.pNames;
+    pIndex->namesUsed = names.used;
+    pIndex->namesAllocated = names.allocated;
+    if (names.size != total)
+    {
+        PV_FreeResourceIndex(pReference);    // no memory for the name, so go without
+    }
+    else if (total * 2 > pIndex->tableMask + 1)
+    {
+        // the pool moves to the new index
+        pIndex->pNames = NULL;
+        PV_BuildResourceIndex(pReference, names.pNames);
+    }
+    else
+    {
+        PV_IndexResource(pIndex, &pReference->pCache->cached[total - 1], total - 1, offset);
+    }
+}
+#endif  // USE_CREATION_API == TRUE
+
+static XFILE_CACHED_ITEM * PV_FindIndexedResource(XFILENAME *pReference, XResourceType resourceType,
+                                                  XLongResourceID resourceID)
+{
+    XFILERESOURCEINDEX  *pIndex;
+    XFILE_CACHED_ITEM   *pItem;
+    uint32_t            slot;
+    int32_t             entry;
+
+    pIndex = pReference->pIndex;
+    slot = PV_HashResourceID(resourceType, resourceID) & pIndex->tableMask;
+    while ((entry = pIndex->pIDTable[slot]) != 0)
+    {
+        pItem = &pReference->pCache->cached[entry - 1];
+        if (pItem->resourceType == resourceType && pItem->resourceID == resourceID)
+        {
+            return pItem;
+        }
+        slot = (slot + 1) & pIndex->tableMask;
+    }
+    return NULL;
+}
+
+// cName is a C string
+static XFILE_CACHED_ITEM * PV_FindIndexedNamedResource(XFILENAME *pReference, XResourceType resourceType,
+                                                       char const *cName)
+{
+    XFILERESOURCEINDEX  *pIndex;
+    XFILE_CACHED_ITEM   *pItem;
+    uint32_t            slot;
+    int32_t             entry;
+    char const          *pName;
+
+    pIndex = pReference->pIndex;
+    slot = PV_HashResourceName(resourceType, cName) & pIndex->tableMask;
+    while ((entry = pIndex->pNameTable[slot]) != 0)
+    {
+        pItem = &pReference->pCache->cached[entry - 1];
+        if (pItem->resourceType == resourceType)
+        {
+            pName = &pIndex->pNames[pIndex->pNameOffset[entry - 1]];
+            if ((XBYTE)pName[0] == XStrLen(cName) &&
+                XMemCmp(pName + 1, cName, (XBYTE)pName[0]) == 0)
+            {
+                return pItem;
+            }
+        }
+        slot = (slot + 1) & pIndex->tableMask;
+    }
+    return NULL;
+}
+
+// Get the pascal name of a cached item, from the index when there is one.
+static XERR PV_GetCachedResourceName(XFILENAME *pReference, XFILE_CACHED_ITEM *pItem, char *pPascalName)
+{
+    XERR        err;
+    char const  *pName;
+
+    if (pReference->pIndex)
+    {
+        pName = &pReference->pIndex->pNames[pReference->pIndex->pNameOffset[pItem - pReference->pCache->cached]];
+        XBlockMove(pName, pPascalName, (XBYTE)pName[0] + 1);
+        return 0;
+    }
+    XFileSetPosition(pReference, pItem->fileOffsetName);
+    err = XFileRead(pReference, &pPascalName[0], 1L);       // get name
+    if (pPascalName[0])
+    {
+        err = XFileRead(pReference, &pPascalName[1], (int32_t)pPascalName[0]);
+    }
+    return err;
+}
+
 // Given an open file, return TRUE if this is a valid resource file.
 XBOOL XFileIsValidResource(XFILE file)
 {
@@ -1398,6 +1854,120 @@ XBOOL XFileIsValidResourceFromName(XFILENAME *file)
 }
 
 
+// Called as each mixer is set up, before it starts any worker threads. Never freed.
+void XInitFileMappingLock(void)
+{
+#if USE_FILE_MAPPING != 0
+    if (g_fileMappingLock == NULL)
+    {
+        if (BAE_NewMutex(&g_fileMappingLock, "bae", "fmap", __LINE__) == 0)
+        {
+            g_fileMappingLock = NULL;
+        }
+    }
+#endif
+}
+
+#if USE_FILE_MAPPING != 0
+// Samples hand their mapped pointers back from whichever thread frees them, while others
+// are still taking new ones
+static void PV_LockFileMappings(void)
+{
+    if (g_fileMappingLock)
+    {
+        BAE_AcquireMutex(g_fileMappingLock);
+    }
+}
+
+static void PV_UnlockFileMappings(void)
+{
+    if (g_fileMappingLock)
+    {
+        BAE_ReleaseMutex(g_fileMappingLock);
+    }
+}
+
+// Map a read only resource file. On success the file reads like a memory resource from here
+// on, without any system calls, and its pages are shared with anyone else mapping it.
+static XBOOL PV_MapResourceFile(XFILENAME *pReference)
+{
+    XFILEMAPPING    *pMapping;
+    XPTR            pBase;
+    uint32_t        length;
+
+    pBase = BAE_FileMapForRead((void *)&pReference->theFile, &length);
+    if (pBase)
+    {
+        pMapping = (XFILEMAPPING *)XNewTaggedPtr((int32_t)sizeof(XFILEMAPPING), X_MEMORY_RESOURCES);
+        if (pMapping)
+        {
+            pMapping->pBase = (XBYTE *)pBase;
+            pMapping->length = length;
+            pMapping->references = 1;
+            PV_LockFileMappings();
+            pMapping->pNext = g_fileMappings;
+            g_fileMappings = pMapping;
+            PV_UnlockFileMappings();
+
+            pReference->pMapping = pMapping;
+            pReference->pResourceData = pBase;
+            pReference->resMemLength = (int32_t)length;
+            pReference->resMemOffset = 0;
+            pReference->fileReference = 0;
+            return TRUE;
+        }
+        BAE_FileUnmap(pBase, length);
+    }
+    return FALSE;
+}
+
+static void PV_ReleaseMapping(XFILEMAPPING *pMapping)
+{
+    XFILEMAPPING    **ppLink;
+    XBOOL           unmap;
+
+    PV_LockFileMappings();
+    pMapping->references--;
+    unmap = (pMapping->references <= 0);
+    if (unmap)
+    {
+        for (ppLink = &g_fileMappings; *ppLink; ppLink = &(*ppLink)->pNext)
+        {
+            if (*ppLink == pMapping)
+            {
+                *ppLink = pMapping->pNext;
+                break;
+            }
+        }
+    }
+    PV_UnlockFileMappings();
+    if (unmap)
+    {
+        BAE_FileUnmap(pMapping->pBase, pMapping->length);
+        XDisposePtr(pMapping);
+    }
+}
+#endif
+
+// Let go of whatever backs an open resource file, its handle or its mapping
+static void PV_CloseResourceFileAccess(XFILENAME *pReference)
+{
+#if USE_FILE_MAPPING != 0
+    if (pReference->pMapping)
+    {
+        PV_ReleaseMapping(pReference->pMapping);
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->pResourceData = NULL;
+        return;
+    }
+#endif
+    if (pReference->pResourceData == NULL)
+    {
+        BAE_FileClose(pReference->fileReference);
+    }
+}
+
 XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL allowCopy)
 {
     XFILENAME           *pReference;
@@ -1405,7 +1975,7 @@ XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL
     int16_t           err;
 
     err = 0;
-    pReference = (XFILENAME *)XNewPtr((int32_t)sizeof(XFILENAME));
+    pReference = (XFILENAME *)XNewTaggedPtr((int32_t)sizeof(XFILENAME), X_MEMORY_RESOURCES);
     if (pReference)
     {
         pReference->pResourceData = pResource;
@@ -1421,6 +1991,10 @@ XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL
         pReference->fileValidID = XPI_BLOCK_3_ID;
         pReference->fileReference = 0;  // Initialize file reference for memory-based resources
         pReference->pCache = NULL;      // Initialize cache pointer
+        pReference->pIndex = NULL;
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->contentKey = PV_NewFileContentKey();
         pReference->readOnly = TRUE;    // Memory-based resources are read-only
         XSetMemory(&pReference->memoryCacheEntry, sizeof(XFILE_CACHED_ITEM), 0);  // Zero cache entry
         if (pReference)
@@ -1431,8 +2005,6 @@ XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL
             }
             else
             {
-                // since we are pointer based, we don't care about caching.
-
                 // validate resource file
                 XFileSetPosition(pReference, 0L);        // at start
                 if (XFileRead(pReference, &map, (int32_t)sizeof(XFILERESOURCEMAP)) == 0)
@@ -1441,6 +2013,12 @@ XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL
                     {
                         err = 2;
                     }
+                    else
+                    {
+                        // even though we are pointer based, walking the map for every lookup
+                        // adds up on large banks, so index it once here
+                        XCreateAccessCache(pReference);
+                    }
                 }
                 else
                 {
@@ -1450,6 +2028,7 @@ XFILE XFileOpenResourceFromMemory(XPTR pResource, uint32_t resourceLength, XBOOL
         }
         if (err)
         {
+            XFileFreeResourceCache(pReference);
             PV_RemoveResourceFileFromOpenFiles(pReference);  // make sure we remove it from the list
             XDisposePtr(pReference);
             pReference = NULL;
@@ -1465,7 +2044,7 @@ XFILE XFileOpenResource(XFILENAME *file, XBOOL readOnly)
     XERR                err;
 
     err = 0;
-    pReference = (XFILENAME *)XNewPtr((int32_t)sizeof(XFILENAME));
+    pReference = (XFILENAME *)XNewTaggedPtr((int32_t)sizeof(XFILENAME), X_MEMORY_RESOURCES);
     if (pReference)
     {
         *pReference = *file;
@@ -1474,14 +2053,24 @@ XFILE XFileOpenResource(XFILENAME *file, XBOOL readOnly)
         pReference->pResourceData = NULL;
         pReference->allowMemCopy = TRUE;
         pReference->readOnly = readOnly;
+        pReference->pCache = NULL;
+        pReference->pIndex = NULL;
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->contentKey = PV_NewFileContentKey();
 
         if (readOnly)
         {
-            pReference->fileReference = BAE_FileOpenForRead((void *)&pReference->theFile);
-            if (pReference->fileReference == (intptr_t)-1)
+#if USE_FILE_MAPPING != 0
+            if (PV_MapResourceFile(pReference) == FALSE)
+#endif
             {
-                XDisposePtr(pReference);
-                pReference = NULL;
+                pReference->fileReference = BAE_FileOpenForRead((void *)&pReference->theFile);
+                if (pReference->fileReference == (intptr_t)-1)
+                {
+                    XDisposePtr(pReference);
+                    pReference = NULL;
+                }
             }
         }
         else
@@ -1514,7 +2103,7 @@ XFILE XFileOpenResource(XFILENAME *file, XBOOL readOnly)
             // success
             if (PV_AddResourceFileToOpenFiles(pReference))
             {   // can't open any more files
-                BAE_FileClose(pReference->fileReference);       // jsc 3/29/00
+                PV_CloseResourceFileAccess(pReference);         // jsc 3/29/00
                 XDisposePtr(pReference);
                 pReference = NULL;
             }
@@ -1545,6 +2134,15 @@ XFILE XFileOpenResource(XFILENAME *file, XBOOL readOnly)
                     {
                         err = -1;
                     }
+                    else if (pReference->pCache == NULL)
+                    {
+                        // parse the map once, so lookups don't walk the file
+                        XCreateAccessCache(pReference);
+                    }
+                    else if (pReference->pIndex == NULL)
+                    {
+                        PV_BuildResourceIndex(pReference, NULL);
+                    }
                 }
                 else
                 {
@@ -1553,9 +2151,9 @@ XFILE XFileOpenResource(XFILENAME *file, XBOOL readOnly)
             }
             if (err)
             {
-                XDisposePtr(pReference->pCache);
+                XFileFreeResourceCache(pReference);
                 PV_RemoveResourceFileFromOpenFiles(pReference);  // make sure we remove it from the list
-                BAE_FileClose(pReference->fileReference);               // jsc 3/29/00
+                PV_CloseResourceFileAccess(pReference);                 // jsc 3/29/00
                 XDisposePtr(pReference);
                 pReference = NULL;
             }
@@ -1568,7 +2166,7 @@ XFILE XFileOpenForReadFromMemory(XPTR pMemoryBlock, uint32_t memoryBlockSize)
 {
     XFILENAME   *pReference;
 
-    pReference = (XFILENAME *)XNewPtr((int32_t)sizeof(XFILENAME));
+    pReference = (XFILENAME *)XNewTaggedPtr((int32_t)sizeof(XFILENAME), X_MEMORY_RESOURCES);
     if (pReference)
     {
         pReference->pResourceData = pMemoryBlock;
@@ -1578,6 +2176,10 @@ XFILE XFileOpenForReadFromMemory(XPTR pMemoryBlock, uint32_t memoryBlockSize)
         pReference->allowMemCopy = TRUE;
         pReference->fileValidID = XPI_BLOCK_3_ID;
         pReference->pCache = NULL;
+        pReference->pIndex = NULL;
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->contentKey = PV_NewFileContentKey();
         pReference->fileReference = 0;
     }
     return pReference;
@@ -1587,7 +2189,7 @@ XFILE XFileOpenForRead(XFILENAME *file)
 {
     XFILENAME   *pReference;
 
-    pReference = (XFILENAME *)XNewPtr((int32_t)sizeof(XFILENAME));
+    pReference = (XFILENAME *)XNewTaggedPtr((int32_t)sizeof(XFILENAME), X_MEMORY_RESOURCES);
     if (pReference)
     {
         *pReference = *file;
@@ -1596,6 +2198,10 @@ XFILE XFileOpenForRead(XFILENAME *file)
         pReference->pResourceData = NULL;
         pReference->allowMemCopy = TRUE;
         pReference->pCache = NULL;
+        pReference->pIndex = NULL;
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->contentKey = PV_NewFileContentKey();
 
         pReference->fileReference = BAE_FileOpenForRead((void *)&pReference->theFile);
     if (pReference->fileReference == (intptr_t)-1)
@@ -1612,7 +2218,7 @@ XFILE XFileOpenForWrite(XFILENAME *file, XBOOL create)
 {
     XFILENAME   *pReference;
 
-    pReference = (XFILENAME *)XNewPtr((int32_t)sizeof(XFILENAME));
+    pReference = (XFILENAME *)XNewTaggedPtr((int32_t)sizeof(XFILENAME), X_MEMORY_RESOURCES);
     if (pReference)
     {
         *pReference = *file;
@@ -1621,6 +2227,10 @@ XFILE XFileOpenForWrite(XFILENAME *file, XBOOL create)
         pReference->pResourceData = NULL;
         pReference->allowMemCopy = TRUE;
         pReference->pCache = NULL;
+        pReference->pIndex = NULL;
+        pReference->pMapping = NULL;
+        pReference->pSnapshot = NULL;
+        pReference->contentKey = PV_NewFileContentKey();
 
         if (create)
         {
@@ -1646,6 +2256,12 @@ XERR XFileDelete(XFILENAME *file)
     return BAE_FileDelete(dest);
 }
 
+// rename file, replacing any file already named 'to'. 0 is ok, -1 for failure
+XERR XFileRename(XFILENAME *from, XFILENAME *to)
+{
+    return BAE_FileRename((void *)&from->theFile, (void *)&to->theFile);
+}
+
 void XFileClose(XFILE fileRef)
 {
     XFILENAME   *pReference;
@@ -1654,15 +2270,14 @@ void XFileClose(XFILE fileRef)
     if (PV_XFileValid(fileRef))
     {
         XFileFreeResourceCache(fileRef);
-        pReference->fileValidID = (int32_t)XPI_DEAD_ID;
-        if (pReference->pResourceData)
-        {
-            pReference->pResourceData = NULL;   // clear memory file access
-        }
-        else
+        if (pReference->pSnapshot)
         {
-            BAE_FileClose(pReference->fileReference);
+            XFileClose(pReference->pSnapshot);
+            pReference->pSnapshot = NULL;
         }
+        pReference->fileValidID = (int32_t)XPI_DEAD_ID;
+        PV_CloseResourceFileAccess(pReference);
+        pReference->pResourceData = NULL;   // clear memory file access
         PV_RemoveResourceFileFromOpenFiles(fileRef);
         XDisposePtr(pReference);
     }
@@ -1849,7 +2464,11 @@ static XFILE_CACHED_ITEM * PV_XGetCacheEntry(XFILE fileRef, XResourceType resour
     if (PV_XFileValid(fileRef))
     {
         pCache = pReference->pCache;
-        if (pCache)
+        if (pCache && pReference->pIndex)
+        {
+            pItem = PV_FindIndexedResource(pReference, resourceType, resourceID);
+        }
+        else if (pCache)
         {
             total = pCache->totalResources;
             for (count = 0; count < total; count++)
@@ -1948,6 +2567,10 @@ static XFILE_CACHED_ITEM * PV_XGetNamedCacheEntry(XFILE fileRef, XResourceType r
             }
         
         }
+        else if (pReference->pCache && pReference->pIndex)
+        {
+            pItem = PV_FindIndexedNamedResource(pReference, resourceType, (char const *)cName);
+        }
         else
         {
             savePos = XFileGetPosition(fileRef);
@@ -2016,11 +2639,9 @@ char *  XGetResourceNameOnly(XFILE fileRef, XResourceType resourceType, XLongRes
                 // get name
                 if (pResourceName)
                 {
-                    XFileSetPosition(fileRef, pCacheItem->fileOffsetName);
-                    err = XFileRead(fileRef, &tempPascalName[0], 1L);       // get name
+                    err = PV_GetCachedResourceName(pReference, pCacheItem, tempPascalName);
                     if (tempPascalName[0])
                     {
-                        err = XFileRead(fileRef, &tempPascalName[1], (int32_t)tempPascalName[0]);
                         XBlockMove(tempPascalName, pResourceName, (int32_t)tempPascalName[0] + 1);
                     }
                 }
@@ -2145,15 +2766,10 @@ XERR XReadPartialFileResource(XFILE fileRef, XResourceType resourceType, XLongRe
                 // get name
                 if (pResourceName)
                 {
-                    XFileSetPosition(fileRef, pCacheItem->fileOffsetName);
-                    err = XFileRead(fileRef, &tempPascalName[0], 1L);       // get name
+                    err = PV_GetCachedResourceName(pReference, pCacheItem, tempPascalName);
                     if (tempPascalName[0])
                     {
-                        err = XFileRead(fileRef, &tempPascalName[1], (int32_t)tempPascalName[0]);
-                        if (pResourceName)
-                        {
-                            XBlockMove(tempPascalName, pResourceName, (int32_t)tempPascalName[0] + 1);
-                        }
+                        XBlockMove(tempPascalName, pResourceName, (int32_t)tempPascalName[0] + 1);
                     }
                 }
                 // get data
@@ -2171,7 +2787,7 @@ XERR XReadPartialFileResource(XFILE fileRef, XResourceType resourceType, XLongRe
                 }
                 else
                 {
-                    pData = XNewPtr(bytesToReadAndAllocate);
+                    pData = XNewTaggedPtr(bytesToReadAndAllocate, X_MEMORY_RESOURCES);
                     if (pData)
                     {
                         err = XFileRead(fileRef, pData, bytesToReadAndAllocate);
@@ -2242,7 +2858,7 @@ XERR XReadPartialFileResource(XFILE fileRef, XResourceType resourceType, XLongRe
                                         }
                                         else
                                         {
-                                            pData = XNewPtr(bytesToReadAndAllocate);
+                                            pData = XNewTaggedPtr(bytesToReadAndAllocate, X_MEMORY_RESOURCES);
                                             if (pData)
                                             {
                                                 err = XFileRead(fileRef, pData, bytesToReadAndAllocate);
@@ -2326,15 +2942,10 @@ XPTR XGetFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID
                 // get name
                 if (pResourceName)
                 {
-                    XFileSetPosition(fileRef, pCacheItem->fileOffsetName);
-                    err = XFileRead(fileRef, &tempPascalName[0], 1L);       // get name
+                    err = PV_GetCachedResourceName(pReference, pCacheItem, tempPascalName);
                     if (tempPascalName[0])
                     {
-                        err = XFileRead(fileRef, &tempPascalName[1], (int32_t)tempPascalName[0]);
-                        if (pResourceName)
-                        {
-                            XBlockMove(tempPascalName, pResourceName, (int32_t)tempPascalName[0] + 1);
-                        }
+                        XBlockMove(tempPascalName, pResourceName, (int32_t)tempPascalName[0] + 1);
                     }
                 }
                 // get data
@@ -2359,7 +2970,7 @@ XPTR XGetFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID
                 }
                 else
                 {
-                    pData = XNewPtr(pCacheItem->resourceLength);
+                    pData = XNewTaggedPtr(pCacheItem->resourceLength, X_MEMORY_RESOURCES);
                     if (pData)
                     {
                         err = XFileRead(fileRef, pData, pCacheItem->resourceLength);
@@ -2441,7 +3052,7 @@ XPTR XGetFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID
                                         }
                                         else
                                         {
-                                            pData = XNewPtr(data);
+                                            pData = XNewTaggedPtr(data, X_MEMORY_RESOURCES);
                                             if (pData)
                                             {
                                                 err = XFileRead(fileRef, pData, data);
@@ -2489,10 +3100,14 @@ XPTR XGetFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID
 void XFileFreeResourceCache(XFILE fileRef)
 {
     XFILENAME *pReference = (XFILENAME *)fileRef;
-    if (PV_XFileValid(fileRef) && pReference->pCache)
+    if (PV_XFileValid(fileRef))
     {
-        XDisposePtr(pReference->pCache);
-        pReference->pCache = NULL;
+        PV_FreeResourceIndex(pReference);
+        if (pReference->pCache)
+        {
+            XDisposePtr(pReference->pCache);
+            pReference->pCache = NULL;
+        }
     }
 }
 
@@ -2593,7 +3208,7 @@ XBankToken CreateBankTokenFromInputs(XTOKEN tok1, XTOKEN tok2)
 //  Adds another cache entry to end of cache.
 
 #if USE_CREATION_API == TRUE
-static XBOOL PV_AddToAccessCache(XFILE fileRef, XFILE_CACHED_ITEM *cacheItemPtr )
+static XBOOL PV_AddToAccessCache(XFILE fileRef, XFILE_CACHED_ITEM *cacheItemPtr, void const *pResourceName)
 {
     XFILENAME           *pReference;
     XFILERESOURCECACHE  *pCache,*newCache;
@@ -2607,12 +3222,13 @@ static XBOOL PV_AddToAccessCache(XFILE fileRef, XFILE_CACHED_ITEM *cacheItemPtr
         if (pCache)
         {
             resCount = pCache->totalResources + 1;
-            newCache = (XFILERESOURCECACHE *)XNewPtr((int32_t)sizeof(XFILERESOURCECACHE) + 
-                                                    ((int32_t)sizeof(XFILE_CACHED_ITEM) * resCount));
+            // XFILERESOURCECACHE holds the first item itself
+            newCache = (XFILERESOURCECACHE *)XNewTaggedPtr((int32_t)sizeof(XFILERESOURCECACHE) + 
+                                                    ((int32_t)sizeof(XFILE_CACHED_ITEM) * (resCount - 1)), X_MEMORY_RESOURCES);
             if (newCache)
             {
                 XBlockMove(pCache, newCache, (int32_t)sizeof(XFILERESOURCECACHE) + 
-                                                ((int32_t)sizeof(XFILE_CACHED_ITEM) * (resCount - 1)));
+                                                ((int32_t)sizeof(XFILE_CACHED_ITEM) * (resCount - 2)));
 
                 XDisposePtr(pCache);
                 pReference->pCache = newCache;
@@ -2620,6 +3236,7 @@ static XBOOL PV_AddToAccessCache(XFILE fileRef, XFILE_CACHED_ITEM *cacheItemPtr
                 pItem = &newCache->cached[resCount - 1];
                 // copy cache item
                 *pItem = *cacheItemPtr;
+                PV_AddToResourceIndex(pReference, (char const *)pResourceName);
                 return TRUE;
             }
         }
@@ -2640,11 +3257,16 @@ XFILERESOURCECACHE * XCreateAccessCache(XFILE fileRef)
     int32_t total;
     int32_t err;
     XFILERESOURCECACHE *newCache = NULL;
+    XFILERESOURCENAMES names;
 
     if (!PV_XFileValid(fileRef))
     {
         return NULL;
     }
+    names.pNames = NULL;
+    names.size = 0;
+    names.used = 0;
+    names.allocated = 0;
     err = XFileSetPosition(fileRef, 0L);
     if (err != 0) { return NULL; }
     if (XFileRead(fileRef, &map, (int32_t)sizeof(XFILERESOURCEMAP)) != 0)
@@ -2660,8 +3282,8 @@ XFILERESOURCECACHE * XCreateAccessCache(XFILE fileRef)
     {
         return NULL; // nothing to cache
     }
-    newCache = (XFILERESOURCECACHE *)XNewPtr((int32_t)sizeof(XFILERESOURCECACHE) +
-                                             (int32_t)sizeof(XFILE_CACHED_ITEM) * (total - 1));
+    newCache = (XFILERESOURCECACHE *)XNewTaggedPtr((int32_t)sizeof(XFILERESOURCECACHE) +
+                                             (int32_t)sizeof(XFILE_CACHED_ITEM) * (total - 1), X_MEMORY_RESOURCES);
     if (!newCache)
     {
         return NULL;
@@ -2673,42 +3295,50 @@ XFILERESOURCECACHE * XCreateAccessCache(XFILE fileRef)
         XFILE_CACHED_ITEM *item = &newCache->cached[count];
         int32_t headerNext;
         err = XFileSetPosition(fileRef, next);
-        if (err != 0) { XDisposePtr(newCache); return NULL; }
+        if (err != 0) { XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; }
         err = XFileRead(fileRef, &headerNext, (int32_t)sizeof(int32_t)); // next pointer
-        if (err != 0) { XDisposePtr(newCache); return NULL; }
+        if (err != 0) { XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; }
         headerNext = (int32_t)XGetLong(&headerNext);
         if (headerNext == -1L)
         {
             // corrupt entry list – bail
+            XDisposePtr(names.pNames);
             XDisposePtr(newCache);
             return NULL;
         }
         int32_t data;
         // type
-        if (XFileRead(fileRef, &data, (int32_t)sizeof(int32_t)) != 0) { XDisposePtr(newCache); return NULL; }
+        if (XFileRead(fileRef, &data, (int32_t)sizeof(int32_t)) != 0) { XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; }
         item->resourceType = (int32_t)XGetLong(&data);
         // id
-        if (XFileRead(fileRef, &data, (int32_t)sizeof(int32_t)) != 0) { XDisposePtr(newCache); return NULL; }
+        if (XFileRead(fileRef, &data, (int32_t)sizeof(int32_t)) != 0) { XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; }
         item->resourceID = (int32_t)XGetLong(&data);
         // name length (pascal)
         int32_t namePos = XFileGetPosition(fileRef);
         unsigned char nameLen = 0;
         if (XFileRead(fileRef, &nameLen, 1) != 0) { 
             BAE_PRINTF("[XCreateAccessCache] FAIL: XFileRead(nameLen) failed at resource %d\n", count+1);
-            XDisposePtr(newCache); return NULL; 
+            XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; 
         }
         if (nameLen > 0)
         {
-            // skip remainder of name
-            if (XFileSetPositionRelative(fileRef, nameLen) != 0) { 
-                BAE_PRINTF("[XCreateAccessCache] FAIL: XFileSetPositionRelative(nameLen=%d) failed at resource %d\n", nameLen, count+1);
-                XDisposePtr(newCache); return NULL; 
+            // keep the name for the index, it's read from the file anyway
+            char nameBuffer[256];
+            if (XFileRead(fileRef, nameBuffer + 1, nameLen) != 0) { 
+                BAE_PRINTF("[XCreateAccessCache] FAIL: XFileRead(name, nameLen=%d) failed at resource %d\n", nameLen, count+1);
+                XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; 
             }
+            nameBuffer[0] = (char)nameLen;
+            PV_AddResourceName(&names, nameBuffer);
+        }
+        else
+        {
+            PV_AddResourceName(&names, "");
         }
         // length
         if (XFileRead(fileRef, &data, (int32_t)sizeof(int32_t)) != 0) { 
             BAE_PRINTF("[XCreateAccessCache] FAIL: XFileRead(resourceLength) failed at resource %d\n", count+1);
-            XDisposePtr(newCache); return NULL; 
+            XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; 
         }
         item->resourceLength = (int32_t)XGetLong(&data);
         item->fileOffsetName = namePos;
@@ -2718,17 +3348,20 @@ XFILERESOURCECACHE * XCreateAccessCache(XFILE fileRef)
         {
             if (XFileSetPositionRelative(fileRef, item->resourceLength) != 0) { 
                 BAE_PRINTF("[XCreateAccessCache] FAIL: XFileSetPositionRelative(resourceLength=%d) failed at resource %d\n", item->resourceLength, count+1);
-                XDisposePtr(newCache); return NULL; 
+                XDisposePtr(names.pNames); XDisposePtr(newCache); return NULL; 
             }
         }
         next = headerNext;
     }
     // Replace any existing cache
-    if (pReference->pCache)
-    {
-        XDisposePtr(pReference->pCache);
-    }
+    XFileFreeResourceCache(fileRef);
     pReference->pCache = newCache;
+    if (names.size != total)
+    {   // ran out of memory collecting names, read them back from the file instead
+        XDisposePtr(names.pNames);
+        names.pNames = NULL;
+    }
+    PV_BuildResourceIndex(pReference, names.pNames);
     BAE_PRINTF("[XCreateAccessCache] SUCCESS: Cache created with %d resources\n", total);
     return newCache;
 }
@@ -2773,6 +3406,7 @@ XBOOL XDeleteFileResource(XFILE fileRef, XResourceType resourceType, XLongResour
             {
                 pCachedItem->resourceType = XFILETRASH_ID;
                 pCachedItem->resourceID = 0;
+                PV_BuildResourceIndex(pReference, NULL);
                 whereType = pCachedItem->fileOffsetName;
                 whereType -= ( sizeof(resourceType) + sizeof(resourceID) );
                 err = XFileSetPosition(fileRef, whereType );
@@ -3022,7 +3656,7 @@ XPTR XGetIndexedResource(XResourceType resourceType, XLongResourceID *pReturnedI
             {
                 *pReturnedResourceSize = total;
             }
-            pData = XNewPtr(total);
+            pData = XNewTaggedPtr(total, X_MEMORY_RESOURCES);
             if (pData)
             {
                 HLock(data);
@@ -3434,7 +4068,7 @@ XERR XAddFileResource(XFILE fileRef, XResourceType resourceType,
                                                 // Now we add this to the native RAM cache
                                                 if (pReference->pCache)
                                                 {
-                                                    PV_AddToAccessCache(fileRef, &cacheItem );
+                                                    PV_AddToAccessCache(fileRef, &cacheItem, pResourceName);
                                                 }
                                             }
                                         }
@@ -3502,7 +4136,7 @@ XPTR XGetNamedResource(XResourceType resourceType, void *cName, int32_t *pReturn
             if (theData)
             {
                 size = GetHandleSize(theData);
-                pData = XNewPtr(size);
+                pData = XNewTaggedPtr(size, X_MEMORY_RESOURCES);
                 if (pData)
                 {
                     HLock(theData);
@@ -3714,10 +4348,10 @@ XPTR XGetAndDetachResource(XResourceType resourceType, XLongResourceID resourceI
             {
                 fileRef = g_openResourceFiles[count];
                 pReference = fileRef;
-                if (pReference->pResourceData && (pReference->allowMemCopy) )
+                if (pReference->pResourceData && (pReference->allowMemCopy == FALSE) )
                 {
                     //In the case of a memory file, we have to create a new block to return.
-                    pNewData = XNewPtr(size);
+                    pNewData = XNewTaggedPtr(size, X_MEMORY_RESOURCES);
                     if (pNewData)
                     {
                         XBlockMove(pData, pNewData, size);
@@ -3744,7 +4378,7 @@ XPTR XGetAndDetachResource(XResourceType resourceType, XLongResourceID resourceI
         if (theData)
         {
             size = GetHandleSize(theData);
-            pData = XNewPtr(size);
+            pData = XNewTaggedPtr(size, X_MEMORY_RESOURCES);
             if (pData)
             {
                 HLock(theData);
@@ -3776,10 +4410,10 @@ XPTR XGetAndDetachResource(XResourceType resourceType, XLongResourceID resourceI
         {
             fileRef = g_openResourceFiles[count];
             pReference = fileRef;
-            if (pReference->pResourceData && (pReference->allowMemCopy) )
+            if (pReference->pResourceData && (pReference->allowMemCopy == FALSE) )
             {
                 //In the case of a memory file, we have to create a new block to return.
-                pNewData = XNewPtr( lSize );
+                pNewData = XNewTaggedPtr(lSize, X_MEMORY_RESOURCES);
                 if (pNewData)
                 {
                     XBlockMove(pData, pNewData, lSize );
@@ -3803,6 +4437,250 @@ XPTR XGetAndDetachResource(XResourceType resourceType, XLongResourceID resourceI
 #endif  //  X_PLATFORM == X_MACINTOSH_9
 }
 
+XPTR XGetAndDetachFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize)
+{
+    XFILENAME   *pReference;
+    XPTR        pData;
+    XPTR        pNewData;
+    int32_t     size;
+
+    size = 0;
+    pData = XGetFileResource(fileRef, resourceType, resourceID, NULL, &size);
+    if (pData)
+    {
+        pReference = fileRef;
+        if (pReference->pResourceData && (pReference->allowMemCopy == FALSE))
+        {
+            //In the case of a memory file, we have to create a new block to return.
+            pNewData = XNewTaggedPtr(size, X_MEMORY_RESOURCES);
+            if (pNewData)
+            {
+                XBlockMove(pData, pNewData, size);
+            }
+            pData = pNewData;
+        }
+    }
+    if (pReturnedResourceSize)
+    {
+        *pReturnedResourceSize = pData ? size : 0;
+    }
+    return pData;
+}
+
+XBOOL XFileIsOpenResource(XFILE fileRef)
+{
+    return (fileRef && (PV_FindResourceFileReferenceIndex(fileRef) != -1)) ? TRUE : FALSE;
+}
+
+#if USE_FILE_MAPPING != 0
+// If pReference is mapped and holds the item, take a reference and return it in place
+static XPTR PV_GetMappedItem(XFILENAME *pReference, XFILE_CACHED_ITEM *pCacheItem, int32_t *pReturnedResourceSize)
+{
+    // the first bytes of the file can't pass for a sample, and keeping clear of them
+    // means XIsOurMemoryPtr never looks in front of the mapping
+    if (pReference->pMapping &&
+        (pCacheItem->fileOffsetData >= (int32_t)sizeof(XPI_Memblock)) &&
+        ((uint32_t)pCacheItem->fileOffsetData + (uint32_t)pCacheItem->resourceLength <= pReference->pMapping->length))
+    {
+        PV_LockFileMappings();
+        pReference->pMapping->references++;
+        PV_UnlockFileMappings();
+        if (pReturnedResourceSize)
+        {
+            *pReturnedResourceSize = pCacheItem->resourceLength;
+        }
+        return pReference->pMapping->pBase + pCacheItem->fileOffsetData;
+    }
+    return NULL;
+}
+#endif
+
+XPTR XGetMappedResource(XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize)
+{
+    XFILE       fileRef;
+
+    // same search order as XGetAndDetachResource, so we hand out the same resource it would
+    fileRef = XFindResourceFile(resourceType, resourceID);
+    if (fileRef)
+    {
+        return XGetMappedFileResource(fileRef, resourceType, resourceID, pReturnedResourceSize);
+    }
+    if (pReturnedResourceSize)
+    {
+        *pReturnedResourceSize = 0;
+    }
+    return NULL;
+}
+
+XPTR XGetMappedFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize)
+{
+#if USE_FILE_MAPPING != 0
+    XFILE_CACHED_ITEM   *pCacheItem;
+#endif
+
+    if (pReturnedResourceSize)
+    {
+        *pReturnedResourceSize = 0;
+    }
+#if USE_FILE_MAPPING != 0
+    if (PV_XFileValid(fileRef) && fileRef->pMapping && fileRef->pCache)
+    {
+        pCacheItem = PV_XGetCacheEntry(fileRef, resourceType, resourceID);
+        if (pCacheItem)
+        {
+            return PV_GetMappedItem(fileRef, pCacheItem, pReturnedResourceSize);
+        }
+    }
+#else
+    (void)fileRef;
+    (void)resourceType;
+    (void)resourceID;
+#endif
+    return NULL;
+}
+
+// Return the first open resource file that holds the resource, which is the one
+// XGetAndDetachResource would read it from
+XFILE XFindResourceFile(XResourceType resourceType, XLongResourceID resourceID)
+{
+    int16_t     count;
+
+    for (count = 0; count < g_resourceFileCount; count++)
+    {
+        if (XExistsFileResource(g_openResourceFiles[count], resourceType, resourceID))
+        {
+            return g_openResourceFiles[count];
+        }
+    }
+    return NULL;
+}
+
+// Attach a companion resource file to fileRef. The companion is taken off the search list,
+// so it is only ever read through fileRef, and is closed along with it.
+void XFileSetSnapshot(XFILE fileRef, XFILE snapshotRef)
+{
+    if (PV_XFileValid(fileRef) && (fileRef != snapshotRef))
+    {
+        if (fileRef->pSnapshot)
+        {
+            XFileClose(fileRef->pSnapshot);
+        }
+        XFileExcludeFromSearch(snapshotRef);
+        fileRef->pSnapshot = snapshotRef;
+    }
+}
+
+// Take an open resource file off the list the XGetResource family searches. It can still be
+// read directly through its XFILE.
+void XFileExcludeFromSearch(XFILE fileRef)
+{
+    if (fileRef)
+    {
+        PV_RemoveResourceFileFromOpenFiles(fileRef);
+    }
+}
+
+XFILE XFileGetSnapshot(XFILE fileRef)
+{
+    if (PV_XFileValid(fileRef))
+    {
+        return fileRef->pSnapshot;
+    }
+    return NULL;
+}
+
+// Tag fileRef with a key derived from its contents, so two opens of the same bank are
+// recognized as one. The top bit is reserved for keys made by XFileOpenResource.
+void XFileSetContentKey(XFILE fileRef, uint64_t key)
+{
+    if (PV_XFileValid(fileRef))
+    {
+        fileRef->contentKey = key & ~XFILE_UNIQUE_CONTENT_KEY;
+    }
+}
+
+uint64_t XFileGetContentKey(XFILE fileRef)
+{
+    if (PV_XFileValid(fileRef))
+    {
+        return fileRef->contentKey;
+    }
+    return 0;
+}
+
+#define XFILE_CONTENTS_BUFFER_SIZE  65536
+
+XERR XFileReadContents(XFILE fileRef, XFileContentsProc proc, void *context)
+{
+    intptr_t    fileReference;
+    XPTR        pBuffer;
+    int32_t     length;
+    uint32_t    remaining;
+    XERR        err;
+
+    if ((PV_XFileValid(fileRef) == FALSE) || (proc == NULL))
+    {
+        return -1;
+    }
+    if (fileRef->pResourceData)
+    {
+        (*proc)(context, fileRef->pResourceData, (uint32_t)fileRef->resMemLength);
+        return 0;
+    }
+    err = -1;
+    fileReference = BAE_FileOpenForRead((void *)&fileRef->theFile);
+    if (fileReference != (intptr_t)-1)
+    {
+        pBuffer = XNewTaggedPtr(XFILE_CONTENTS_BUFFER_SIZE, X_MEMORY_RESOURCES);
+        if (pBuffer)
+        {
+            // some platforms report the end of the file as an error, so the length decides
+            remaining = BAE_GetFileLength(fileReference);
+            while (remaining)
+            {
+                length = BAE_ReadFile(fileReference, pBuffer,
+                                      (remaining < XFILE_CONTENTS_BUFFER_SIZE) ? (int32_t)remaining : XFILE_CONTENTS_BUFFER_SIZE);
+                if (length <= 0)
+                {
+                    break;
+                }
+                (*proc)(context, pBuffer, (uint32_t)length);
+                remaining -= (uint32_t)length;
+            }
+            XDisposePtr(pBuffer);
+            err = remaining ? -1 : 0;
+        }
+        BAE_FileClose(fileReference);
+    }
+    return err;
+}
+
+XBOOL XReleaseMappedPtr(XPTR pData)
+{
+#if USE_FILE_MAPPING != 0
+    XFILEMAPPING    *pMapping;
+
+    if (pData)
+    {
+        // the lock is recursive, so the mapping found can't go away before it's released
+        PV_LockFileMappings();
+        for (pMapping = g_fileMappings; pMapping; pMapping = pMapping->pNext)
+        {
+            if (((XBYTE *)pData >= pMapping->pBase) && ((XBYTE *)pData < pMapping->pBase + pMapping->length))
+            {
+                PV_ReleaseMapping(pMapping);
+                PV_UnlockFileMappings();
+                return TRUE;
+            }
+        }
+        PV_UnlockFileMappings();
+    }
+#else
+    (void)pData;
+#endif
+    return FALSE;
+}
+
 // get current most recently opened resource file, or NULL if nothing is open
 XFILE XFileGetCurrentResourceFile(void)
 {
@@ -608,12 +608,29 @@ struct XPI_Memblock
     int32_t    blockID_one;        // ID that this is our block. part 1
     int32_t    blockSize;          // block size
     int32_t    blockID_two;        // ID that this is our block. part 2
-#if (X_PLATFORM == X_SOLARIS)
-    int32_t    alignment8;         // used for alignment to 8 byte boundries
-#endif
+    int32_t    blockTag;           // XMemoryTag this block is counted under. Also keeps
+                                   // the data aligned to 8 byte boundries
 };
 typedef struct XPI_Memblock XPI_Memblock;
 
+// What a block of memory is used for. XNewPtr counts blocks as X_MEMORY_OTHER; code that
+// allocates or takes ownership of data for one of these uses tags it, so the memory used
+// for each can be reported with XGetMemoryTagUsage. The BAEMemoryCategory values in
+// NeoBAE.h match these.
+typedef enum
+{
+    X_MEMORY_OTHER = 0,
+    X_MEMORY_SAMPLES,               // sample data and the sample cache
+    X_MEMORY_INSTRUMENTS,           // GM_Instrument structures
+    X_MEMORY_SONGS,                 // songs, sequence and MIDI data
+    X_MEMORY_EFFECTS,               // reverb and chorus delay lines, convolution kernels
+    X_MEMORY_STREAMS,               // audio stream buffers
+    X_MEMORY_DECODERS,              // file decoder state
+    X_MEMORY_SOUNDFONTS,            // SF2 and FluidSynth support
+    X_MEMORY_RESOURCES,             // resource files, their caches and resource data
+    X_MEMORY_TAG_COUNT
+} XMemoryTag;
+
 #define XPI_BLOCK_1_ID      FOUR_CHAR('I','G','O','R')      //  'IGOR'
 #define XPI_BLOCK_2_ID      FOUR_CHAR('G','S','N','D')      //  'GSND'
 #define XPI_BLOCK_3_ID      FOUR_CHAR('F','L','A','T')      //  'FLAT'
@@ -625,8 +642,15 @@ typedef struct XPI_Memblock XPI_Memblock;
 XPI_Memblock * XIsOurMemoryPtr(XPTR data);
 
 XPTR    XNewPtr(int32_t size);
+XPTR    XNewTaggedPtr(int32_t size, XMemoryTag tag);
 void    XDisposePtr(XPTR data);
 int32_t    XGetPtrSize(XPTR data);
+// Count an existing block under tag, for data handed from one part of the engine to another
+void    XSetPtrTag(XPTR data, XMemoryTag tag);
+// Bytes currently allocated under tag, and the most there has been at once
+void    XGetMemoryTagUsage(XMemoryTag tag, uint32_t *pCurrent, uint32_t *pPeak);
+// Make the tag counts safe to update from more than one thread. Call before starting any
+void    XInitMemoryTagLock(void);
 // This function re-allocates a memory block
 // ptr may be NULL, in which case the functionality is the same as XNewPtr()
 // If allocation fails, ptr is unaffected (It's still allocated.)
@@ -641,6 +665,7 @@ void    XClearBit(void *pBitArray, uint32_t whichbit);
 XBOOL   XTestBit(void *pBitArray, uint32_t whichbit);
 
 uint32_t XMicroseconds(void);
+uint64_t XMicroseconds64(void);
 void XWaitMicroseconds(uint32_t waitAmount);
 
 
@@ -692,6 +717,10 @@ struct XFILENAME
                                         // file
     XFILE_CACHED_ITEM   memoryCacheEntry;
     XFILERESOURCECACHE  *pCache;        // if file has been cached this will point to it
+    struct XFILERESOURCEINDEX *pIndex;  // hash index over pCache by type/ID and type/name
+    struct XFILEMAPPING *pMapping;      // if a read only file is mapped, pResourceData points into this
+    struct XFILENAME    *pSnapshot;     // companion file of decoded samples, see XFileSetSnapshot
+    uint64_t            contentKey;     // identifies the bytes behind this file, see XFileSetContentKey
 };
 typedef struct XFILENAME    XFILENAME;
 // XFILE was historically a 32-bit integer used to hold a pointer. This broke on 64-bit builds.
@@ -769,6 +798,7 @@ XFILE   XFileGetCurrentResourceFile(void);
 
 // delete file. 0 is ok, -1 for failure
 XERR XFileDelete(XFILENAME *file);
+XERR XFileRename(XFILENAME *from, XFILENAME *to);
 
 // Read a file into memory and return an allocated pointer.
 // 0 is ok, -1 failed to open, -2 failed to read, -3 failed memory
@@ -787,11 +817,50 @@ XERR XFileCreateResourceCache(XFILE fileRef);
 // Free cache of a resource file
 void XFileFreeResourceCache(XFILE fileRef);
 
+// Attach a companion resource file to fileRef, or NULL to drop it. The companion comes off
+// the search list, is only reached through XFileGetSnapshot, and is closed with fileRef.
+void XFileSetSnapshot(XFILE fileRef, XFILE snapshotRef);
+XFILE XFileGetSnapshot(XFILE fileRef);
+// Take an open resource file off the list searched by XGetAndDetachResource and friends.
+// It can still be read directly, and is closed with XFileClose as usual.
+void XFileExcludeFromSearch(XFILE fileRef);
+// Key identifying what a file holds rather than which open it is. Every open starts with a
+// unique key (XFILE_UNIQUE_CONTENT_KEY set); callers that hash the contents can replace it, so
+// the same bank opened twice shares one key.
+#define XFILE_UNIQUE_CONTENT_KEY    ((uint64_t)1 << 63)
+void XFileSetContentKey(XFILE fileRef, uint64_t key);
+uint64_t XFileGetContentKey(XFILE fileRef);
+// Pass every byte of fileRef, in order, to proc. A memory based or mapped file goes in one
+// piece straight from memory. Any other is read in pieces through a handle of its own, so
+// the file's position and the resource code using it aren't disturbed and no copy of the
+// whole file is made.
+typedef void    (*XFileContentsProc)(void *context, XPTR pData, uint32_t length);
+XERR    XFileReadContents(XFILE fileRef, XFileContentsProc proc, void *context);
+
 // search through open resource files
 XBOOL   XExistsResource(XResourceType resourceType, XLongResourceID resourceID);
+// the first open resource file holding the resource, or NULL
+XFILE   XFindResourceFile(XResourceType resourceType, XLongResourceID resourceID);
 XBOOL   XGetResourceName(XResourceType resourceType, XLongResourceID resourceID, char *cName);
 XPTR    XGetNamedResource(XResourceType resourceType, void *cName, int32_t *pReturnedResourceSize);
 XPTR    XGetAndDetachResource(XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize);
+// Like XGetAndDetachResource, but only reads fileRef
+XPTR    XGetAndDetachFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize);
+// TRUE while fileRef is on the search list. Only the pointer is compared, so it's safe to ask
+// about a file that may have been closed since.
+XBOOL   XFileIsOpenResource(XFILE fileRef);
+// Like XGetAndDetachResource, but returns a pointer straight into the file if it is mapped,
+// rather than a copy. Returns NULL if the resource lives in a file that isn't mapped. The
+// mapping stays valid until the pointer is given back with XReleaseMappedPtr, even if the
+// file is closed first. The data must be treated as read only.
+XPTR    XGetMappedResource(XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize);
+XPTR    XGetMappedFileResource(XFILE fileRef, XResourceType resourceType, XLongResourceID resourceID, int32_t *pReturnedResourceSize);
+// Give back a pointer from XGetMappedResource. Returns FALSE if pData isn't in a mapped file,
+// in which case it is left alone.
+XBOOL   XReleaseMappedPtr(XPTR pData);
+// Make taking and giving back mapped pointers safe from more than one thread. Call before
+// starting any worker threads.
+void    XInitFileMappingLock(void);
 XPTR    XGetIndexedResource(XResourceType resourceType, XLongResourceID *pReturnedID, int32_t resourceIndex, 
                                 void *pResourceName, int32_t *pReturnedResourceSize);
 
@@ -200,6 +200,7 @@
 #include "X_PackStructures.h"
 
 #include <stdint.h>
+#include <stddef.h>
 /* Instrument and Song structures
 */
 typedef struct X_PACKBY1
@@ -232,6 +233,7 @@ enum
  
     ID_VERS     =   FOUR_CHAR('V','E','R','S'), //  'VERS'      // version ID
     ID_TEXT     =   FOUR_CHAR('T','E','X','T'), //  'TEXT'      // text
+    ID_SNAP     =   FOUR_CHAR('S','N','A','P'), //  'SNAP'      // stamp of a decoded sample snapshot
  
     ID_MTHD     =   FOUR_CHAR('M','T','h','d'), //  'MThd'      // midi header ID
     ID_MTRK     =   FOUR_CHAR('M','T','r','k')  //  'MTrk'      // midi track ID
@@ -690,6 +692,21 @@ typedef struct X_PACKBY1
     XBYTE               sampleArea[1];      // space for when samples follow directly
 } XSoundHeader3;
 
+// A sample snapshot is a resource file of 'snd ' resources already decoded into raw pcm in
+// the byte order of the machine that wrote it, so they can be played straight out of a mapped
+// file. It is stamped with one ID_SNAP resource, and only used if the stamp still matches.
+#define XSNAPSHOT_VERSION       1
+// bytes in front of the samples of a 'snd ' made by XCreateRawSoundObject
+#define XRAW_SOUND_HEADER_SIZE  ((int32_t)(sizeof(int16_t) + offsetof(XSoundHeader3, sampleArea)))
+#define XSNAPSHOT_KEY_LENGTH    64
+
+typedef struct X_PACKBY1
+{
+    XDWORD              version;            // XSNAPSHOT_VERSION
+    XDWORD              wordOrder;          // X_WORD_ORDER of the writer
+    char                key[XSNAPSHOT_KEY_LENGTH];  // identifies the bank it was made from, zero padded
+} XSnapshotHeader;
+
 
 // NOTE: The original Beatnik 'snd ' resource headers were defined in a 32-bit
 // environment. Using native pointer types here breaks the on-disk layout on
@@ -972,6 +989,26 @@ void XDisposeSongPtr(SongResource *theSong);
 void XGetKeySplitFromPtr(InstrumentResource *theX, int16_t entry, KeySplit *keysplit);
 
 XPTR XGetSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize);
+// Write every sample of bankFile that has to be decoded or swapped before it can play into
+// snapshotFile, an empty resource file open for writing, and stamp it with key.
+XERR XCreateSoundSnapshot(XFILE bankFile, XFILE snapshotFile, char const* key);
+// TRUE if snapshotFile was written by XCreateSoundSnapshot with key on a machine like this one
+XBOOL XIsSoundSnapshotCurrent(XFILE snapshotFile, char const* key);
+// The open resource file XGetSoundResourceByID would take this sound from, or NULL
+XFILE XFindSoundResourceFile(XLongResourceID theID);
+// Get a sound resource from the snapshot attached to the file it would normally come from.
+// Returns NULL if there is no snapshot or the sound isn't in it. The data must be treated as
+// read only; give it back with XReleaseMappedPtr, or XDisposePtr if that returns FALSE.
+XPTR XGetSnapshotSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize);
+// Get an uncompressed sound resource without copying it out of a mapped resource file.
+// Returns NULL if the sound needs decoding or swapping, or its file isn't mapped; fall back
+// to XGetSoundResourceByID. Give the pointer back with XReleaseMappedPtr.
+XPTR XGetMappedSoundResourceByID(XLongResourceID theID, int32_t *pReturnedSize);
+// The three above, reading the sound from fileRef rather than the first open resource file
+// that has it
+XPTR XGetFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize);
+XPTR XGetSnapshotFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize);
+XPTR XGetMappedFileSoundResourceByID(XFILE fileRef, XLongResourceID theID, int32_t *pReturnedSize);
 XPTR XGetSoundResourceByName(void *cName, int32_t *pReturnedSize);
 // Get sound resource and detach from resource manager but don't decompress.
 XPTR XGetRawSoundResourceByID(XLongResourceID theID, XResourceType *pReturnedType, int32_t *pReturnedSize);
@@ -987,6 +1024,14 @@ XPTR XGetMidiData(XLongResourceID theID, int32_t *pReturnedSize, XResourceType *
 //              Deallocate this pointer with XDisposePtr.
 XPTR XGetSamplePtrFromSnd(XPTR pRes, SampleDataInfo *pInfo);
 
+// Create a ID_SND resource holding raw pcm, as described by *pInfo, in the native byte order.
+// Deallocate with XDisposePtr.
+XPTR XCreateRawSoundObject(SampleDataInfo const* pInfo, XPTRC pSampleData);
+
+// Given a ID_SND resource, return TRUE if XGetSamplePtrFromSnd will point into it without
+// writing to it, so the resource can be used in place from shared memory.
+XBOOL XIsSndUsableInPlace(XPTR pRes);
+
 // Given a ID_SND resource, parse through and return in *pOutInfo the information
 // about the sample resource. The pMasterPtr will be NULL.
 //
@@ -198,7 +198,11 @@ void BAE_SetHardwareBalance(int16_t balance);
 
 // **** Timing services
 // return microseconds, preferably quantized better than 1000 microseconds, but can live
-// with it being as bad as 11000 microseconds.
+// with it being as bad as 11000 microseconds. This is a monotonic 64 bit count from the
+// first call and is what the engine uses for its time base.
+uint64_t BAE_Microseconds64(void);
+
+// same as BAE_Microseconds64, truncated to 32 bits. Wraps about every 71 minutes.
 uint32_t BAE_Microseconds(void);
 
 // wait or sleep this thread for this many microseconds
@@ -221,6 +225,10 @@ int32_t BAE_FileCreate(void *fileName);
 // Delete a file. Returns -1 if there's an error, or 0 if ok.
 int32_t BAE_FileDelete(void *fileName);
 
+// Rename a file, replacing toName in one step if it exists, so nothing ever sees it
+// missing or half written. Returns -1 if there's an error, or 0 if ok.
+int32_t BAE_FileRename(void *fromName, void *toName);
+
 // Open a file
 // Return -1 if error, otherwise file handle (pointer-sized to avoid truncation on 64-bit)
 intptr_t BAE_FileOpenForRead(void *fileName);
@@ -230,6 +238,15 @@ intptr_t BAE_FileOpenForReadWrite(void *fileName);
 // Close a file
 void BAE_FileClose(intptr_t fileReference);
 
+// Map a whole file into memory for reading. The mapping is private and copy on write,
+// so pages that are never written stay shared with every other process mapping the same
+// file. Returns the base address and sets *pLength, or NULL if the file can't be mapped
+// or the platform doesn't support it, in which case the caller should read the file.
+void * BAE_FileMapForRead(void *fileName, uint32_t *pLength);
+
+// Release a mapping returned from BAE_FileMapForRead
+void BAE_FileUnmap(void *pMapping, uint32_t length);
+
 // Read a block of memory from a file
 // Return -1 if error, otherwise length of data read.
 int32_t BAE_ReadFile(intptr_t fileReference, void *pBuffer, int32_t bufferLength);
@@ -416,6 +433,29 @@ void BAE_AcquireMutex(BAE_Mutex mutex);
 void BAE_ReleaseMutex(BAE_Mutex mutex);
 void BAE_DestroyMutex(BAE_Mutex mutex);
 
+// WORKER THREADS
+
+// Optional. A platform that can't run extra threads returns 0 from BAE_NewWorkerThread
+// and BAE_NewEvent, and the engine keeps that work on the calling thread.
+typedef void* BAE_WorkerThread;
+typedef void* BAE_Event;
+typedef void (*BAE_WorkerThreadProc)(void *context);
+
+// Start proc(context) on a new thread. Returns 1 if ok.
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context);
+// Wait for the thread's proc to return, then release the thread.
+void BAE_JoinWorkerThread(BAE_WorkerThread thread);
+
+// Auto reset event. BAE_WaitEvent blocks until the event is signaled, then clears it.
+// Returns 1 if ok.
+int BAE_NewEvent(BAE_Event *pEvent);
+void BAE_SignalEvent(BAE_Event event);
+void BAE_WaitEvent(BAE_Event event);
+void BAE_DestroyEvent(BAE_Event event);
+
+// Number of processors this process can run on, 1 if unknown
+int BAE_GetProcessorCount(void);
+
 //CLS:  THREADING API:
 
 // the type of function called by the frame thread
@@ -546,6 +586,7 @@ uint32_t BAE_GetDeviceSamplesCapturedPosition();
 #define HAE_CopyFileNameNative              BAE_CopyFileNameNative
 #define HAE_FileCreate                      BAE_FileCreate
 #define HAE_FileDelete                      BAE_FileDelete
+#define HAE_FileRename                      BAE_FileRename
 #define HAE_FileOpenForRead                 BAE_FileOpenForRead
 #define HAE_FileOpenForWrite                BAE_FileOpenForWrite
 #define HAE_FileOpenForReadWrite            BAE_FileOpenForReadWrite
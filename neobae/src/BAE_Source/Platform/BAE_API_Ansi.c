@@ -38,6 +38,7 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include <pthread.h>
 #include <assert.h>
 #include <string.h>
@@ -69,6 +70,16 @@
 	#include <fcntl.h>
 #endif
 
+// files are mapped with mmap where it's available, otherwise they are read
+#if !USE_WINDOWS_IO && !defined(_WIN32) && !defined(WASM)
+	#define USE_FILE_MAPPING	TRUE
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#else
+	#define USE_FILE_MAPPING	FALSE
+#endif
+
 static uint32_t		g_memory_buoy = 0;		// amount of memory allocated at this moment
 static uint32_t		g_memory_buoy_max = 0;
 
@@ -251,34 +262,36 @@ void BAE_SetHardwareVolume(int16_t newVolume)
 
 
 // **** Timing services
-// return microseconds
-uint32_t BAE_Microseconds(void)
+// return microseconds since the first call. This never wraps in practice.
+uint64_t BAE_Microseconds64(void)
 {
 #if USE_WINDOWS_IO
-	static uint32_t	starttick = 0;
+	static uint64_t			starttick = 0;
 	static char				firstTime = TRUE;
 	static char				QPClockSupport = FALSE;
-	static uint32_t	clockpusu = 0;	// clocks per microsecond
-	uint32_t			time;
+	static uint64_t			clockFrequency = 0;
+	uint64_t				time;
 	LARGE_INTEGER			p;
 
 	if (firstTime)
 	{
-		if (QueryPerformanceFrequency(&p))
+		if (QueryPerformanceFrequency(&p) && p.QuadPart)
 		{
 			QPClockSupport = TRUE;
-			clockpusu = (uint32_t)(p.QuadPart / 1000000L);
+			clockFrequency = (uint64_t)p.QuadPart;
 		}
 		firstTime = FALSE;
 	}
 	if (QPClockSupport)
 	{
 		QueryPerformanceCounter(&p);
-		time = (uint32_t)(p.QuadPart / clockpusu);
+		// split the divide so the multiply can't overflow on fast counters
+		time = ((uint64_t)p.QuadPart / clockFrequency) * 1000000ULL +
+				(((uint64_t)p.QuadPart % clockFrequency) * 1000000ULL) / clockFrequency;
 	}
 	else
 	{
-		time = timeGetTime() * 1000L;
+		time = (uint64_t)timeGetTime() * 1000ULL;
 	}
 
 	if (starttick == 0)
@@ -286,32 +299,52 @@ uint32_t BAE_Microseconds(void)
 		starttick = time;
 	}
 	return (time - starttick);
+#elif defined(CLOCK_MONOTONIC)
+	static int			firstTime = TRUE;
+	static uint64_t		offset    = 0;
+	struct timespec		ts;
+	uint64_t			now;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	now = ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000ULL);
+	if (firstTime)
+	{
+		offset    = now;
+		firstTime = FALSE;
+	}
+	return now - offset;
 #else
-   static int           firstTime = TRUE;
-   static uint32_t offset    = 0;
-   struct timeval       tv;
+	static int			firstTime = TRUE;
+	static uint64_t		offset    = 0;
+	struct timeval		tv;
 
-   if (firstTime)
-   {
-      gettimeofday(&tv, NULL);
-      offset    = tv.tv_sec;
-      firstTime = FALSE;
-   }
-   gettimeofday(&tv, NULL);
-   return(((tv.tv_sec - offset) * 1000000UL) + tv.tv_usec);
+	if (firstTime)
+	{
+		gettimeofday(&tv, NULL);
+		offset    = (uint64_t)tv.tv_sec;
+		firstTime = FALSE;
+	}
+	gettimeofday(&tv, NULL);
+	return (((uint64_t)tv.tv_sec - offset) * 1000000ULL) + (uint64_t)tv.tv_usec;
 #endif
 }
 
+// return microseconds, wrapping every 71 minutes
+uint32_t BAE_Microseconds(void)
+{
+	return (uint32_t)BAE_Microseconds64();
+}
+
 // wait or sleep this thread for this many microseconds
 // CLS??: If this function is called from within the frame thread and
 // JAVA_THREAD is non-zero, we'll probably crash.
 void BAE_WaitMicroseconds(uint32_t waitAmount)
 {
 #if USE_WINDOWS_IO
-	uint32_t	ticks;
+	uint64_t	ticks;
 
-	ticks = BAE_Microseconds() + waitAmount;
-	while (BAE_Microseconds() < ticks)
+	ticks = BAE_Microseconds64() + waitAmount;
+	while (BAE_Microseconds64() < ticks)
 	{
 		Sleep(0);	// Give up the rest of this time slice to other threads
 	}
@@ -415,6 +448,26 @@ int32_t BAE_FileDelete(void *fileName)
 	return -1;
 }
 
+// Rename a file, replacing toName if it exists. Return -1 if error, 0 if ok
+int32_t BAE_FileRename(void *fromName, void *toName)
+{
+	if (fromName && toName)
+	{
+#if USE_ANSI_IO
+		if (rename((char *)fromName, (char *)toName) == 0)
+		{
+			return 0;
+		}
+#elif USE_WINDOWS_IO
+		if (MoveFileEx((char *)fromName, (char *)toName, MOVEFILE_REPLACE_EXISTING))
+		{
+			return 0;
+		}
+#endif
+	}
+	return -1;
+}
+
 
 // Open a file
 // Return -1 if error, otherwise file handle
@@ -427,7 +480,7 @@ intptr_t BAE_FileOpenForRead(void *fileName)
 	   return _open((char *)fileName, _O_RDONLY | _O_BINARY);
 #elif USE_ANSI_IO
        FILE *fp = fopen((char *)fileName, "rb");
-       return (intptr_t)fp;
+       return fp ? (intptr_t)fp : -1;
 #elif USE_WINDOWS_IO
 		HANDLE	file;
 
@@ -458,7 +511,7 @@ intptr_t BAE_FileOpenForWrite(void *fileName)
 		return _open((char *)fileName, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY);
 #elif USE_ANSI_IO
 		FILE *fp = fopen((char *)fileName, "wb");
-		return (intptr_t)fp;;
+		return fp ? (intptr_t)fp : -1;
 #elif USE_WINDOWS_IO
 		HANDLE	file;
 
@@ -485,7 +538,7 @@ intptr_t BAE_FileOpenForReadWrite(void *fileName)
 		return _open((char *)fileName, _O_RDWR | _O_BINARY);
 #elif USE_ANSI_IO
 		FILE *fp = fopen((char *)fileName, "r+b" /*"arb"*/ /*"wrb"*/);
-		return (intptr_t)fp;
+		return fp ? (intptr_t)fp : -1;
 #elif USE_WINDOWS_IO
 		HANDLE	file;
 
@@ -519,6 +572,59 @@ void BAE_FileClose(intptr_t fileReference)
 #endif
 }
 
+// Map a whole file into memory for reading. Pages are private and copy on write, so
+// the ones never written stay shared with every other process mapping the same file.
+// Return NULL if the file can't be mapped.
+void * BAE_FileMapForRead(void *fileName, uint32_t *pLength)
+{
+#if USE_FILE_MAPPING
+	struct stat	fileInfo;
+	void		*pMapping;
+	int			fd;
+
+	pMapping = NULL;
+	if (fileName && pLength)
+	{
+		*pLength = 0;
+		fd = open((char *)fileName, O_RDONLY);
+		if (fd != -1)
+		{
+			if ((fstat(fd, &fileInfo) == 0) && (fileInfo.st_size > 0) && (fileInfo.st_size <= 0x7FFFFFFF))
+			{
+				pMapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				if (pMapping == MAP_FAILED)
+				{
+					pMapping = NULL;
+				}
+				else
+				{
+					*pLength = (uint32_t)fileInfo.st_size;
+				}
+			}
+			close(fd);	// the mapping keeps its own reference to the file
+		}
+	}
+	return pMapping;
+#else
+	if (pLength)
+	{
+		*pLength = 0;
+	}
+	return NULL;
+#endif
+}
+
+// Release a mapping returned from BAE_FileMapForRead
+void BAE_FileUnmap(void *pMapping, uint32_t length)
+{
+#if USE_FILE_MAPPING
+	if (pMapping && length)
+	{
+		munmap(pMapping, (size_t)length);
+	}
+#endif
+}
+
 // Read a block of memory from a file.
 // Return -1 if error, otherwise length of data read.
 int32_t BAE_ReadFile(intptr_t fileReference, void *pBuffer, int32_t bufferLength)
@@ -767,6 +873,117 @@ void BAE_DestroyMutex(BAE_Mutex lock)
     BAE_Deallocate(pMutex);
 }
 
+// WORKER THREADS
+
+typedef struct
+{
+    pthread_t               thread;
+    BAE_WorkerThreadProc    proc;
+    void                    *context;
+} PThreadWorker;
+
+typedef struct
+{
+    pthread_mutex_t         mutex;
+    pthread_cond_t          cond;
+    int                     signaled;
+} PThreadEvent;
+
+static void * PV_WorkerThreadMain(void *arg)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)arg;
+
+    (*pWorker->proc)(pWorker->context);
+    return NULL;
+}
+
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)BAE_Allocate(sizeof(PThreadWorker));
+
+    if (pWorker == NULL)
+    {
+        return 0;
+    }
+    pWorker->proc = proc;
+    pWorker->context = context;
+    if (pthread_create(&pWorker->thread, NULL, PV_WorkerThreadMain, pWorker) != 0)
+    {
+        BAE_Deallocate(pWorker);
+        return 0;
+    }
+    *pThread = (BAE_WorkerThread)pWorker;
+    return 1;
+}
+
+void BAE_JoinWorkerThread(BAE_WorkerThread thread)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)thread;
+
+    if (pWorker)
+    {
+        pthread_join(pWorker->thread, NULL);
+        BAE_Deallocate(pWorker);
+    }
+}
+
+int BAE_NewEvent(BAE_Event *pEvent)
+{
+    PThreadEvent *pE = (PThreadEvent *)BAE_Allocate(sizeof(PThreadEvent));
+
+    if (pE == NULL)
+    {
+        return 0;
+    }
+    pthread_mutex_init(&pE->mutex, NULL);
+    pthread_cond_init(&pE->cond, NULL);
+    pE->signaled = 0;
+    *pEvent = (BAE_Event)pE;
+    return 1;
+}
+
+void BAE_SignalEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    pthread_mutex_lock(&pE->mutex);
+    pE->signaled = 1;
+    pthread_cond_signal(&pE->cond);
+    pthread_mutex_unlock(&pE->mutex);
+}
+
+void BAE_WaitEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    pthread_mutex_lock(&pE->mutex);
+    while (pE->signaled == 0)
+    {
+        pthread_cond_wait(&pE->cond, &pE->mutex);
+    }
+    pE->signaled = 0;
+    pthread_mutex_unlock(&pE->mutex);
+}
+
+void BAE_DestroyEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    if (pE)
+    {
+        pthread_cond_destroy(&pE->cond);
+        pthread_mutex_destroy(&pE->mutex);
+        BAE_Deallocate(pE);
+    }
+}
+
+int BAE_GetProcessorCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+}
+
 // Mute/unmute audio. Shutdown amps, etc.
 // return 0 if ok, -1 if failed
 int BAE_Mute(void)
@@ -112,9 +112,12 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include <pthread.h>
 #include <assert.h>
 
@@ -339,20 +342,42 @@ void BAE_SetHardwareVolume(int16_t newVolume)
 
 // **** Timing services
 // return microseconds
-uint32_t BAE_Microseconds(void)
+uint64_t BAE_Microseconds64(void)
 {
+#ifdef CLOCK_MONOTONIC
    static int           firstTime = TRUE;
-   static uint32_t offset    = 0;
+   static uint64_t      offset    = 0;
+   struct timespec      ts;
+   uint64_t             now;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   now = ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000ULL);
+   if (firstTime)
+   {
+      offset    = now;
+      firstTime = FALSE;
+   }
+   return now - offset;
+#else
+   static int           firstTime = TRUE;
+   static uint64_t      offset    = 0;
    struct timeval       tv;
 
    if (firstTime)
    {
       gettimeofday(&tv, NULL);
-      offset    = tv.tv_sec;
+      offset    = (uint64_t)tv.tv_sec;
       firstTime = FALSE;
    }
    gettimeofday(&tv, NULL);
-   return(((tv.tv_sec - offset) * 1000000UL) + tv.tv_usec);
+   return (((uint64_t)tv.tv_sec - offset) * 1000000ULL) + (uint64_t)tv.tv_usec;
+#endif
+}
+
+// return microseconds, wrapping every 71 minutes
+uint32_t BAE_Microseconds(void)
+{
+   return (uint32_t)BAE_Microseconds64();
 }
 
 // wait or sleep this thread for this many microseconds
@@ -393,6 +418,117 @@ void BAE_DestroyMutex(BAE_Mutex lock)
     BAE_Deallocate(pMutex);
 }
 
+// WORKER THREADS
+
+typedef struct
+{
+    pthread_t               thread;
+    BAE_WorkerThreadProc    proc;
+    void                    *context;
+} PThreadWorker;
+
+typedef struct
+{
+    pthread_mutex_t         mutex;
+    pthread_cond_t          cond;
+    int                     signaled;
+} PThreadEvent;
+
+static void * PV_WorkerThreadMain(void *arg)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)arg;
+
+    (*pWorker->proc)(pWorker->context);
+    return NULL;
+}
+
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)BAE_Allocate(sizeof(PThreadWorker));
+
+    if (pWorker == NULL)
+    {
+        return 0;
+    }
+    pWorker->proc = proc;
+    pWorker->context = context;
+    if (pthread_create(&pWorker->thread, NULL, PV_WorkerThreadMain, pWorker) != 0)
+    {
+        BAE_Deallocate(pWorker);
+        return 0;
+    }
+    *pThread = (BAE_WorkerThread)pWorker;
+    return 1;
+}
+
+void BAE_JoinWorkerThread(BAE_WorkerThread thread)
+{
+    PThreadWorker *pWorker = (PThreadWorker *)thread;
+
+    if (pWorker)
+    {
+        pthread_join(pWorker->thread, NULL);
+        BAE_Deallocate(pWorker);
+    }
+}
+
+int BAE_NewEvent(BAE_Event *pEvent)
+{
+    PThreadEvent *pE = (PThreadEvent *)BAE_Allocate(sizeof(PThreadEvent));
+
+    if (pE == NULL)
+    {
+        return 0;
+    }
+    pthread_mutex_init(&pE->mutex, NULL);
+    pthread_cond_init(&pE->cond, NULL);
+    pE->signaled = 0;
+    *pEvent = (BAE_Event)pE;
+    return 1;
+}
+
+void BAE_SignalEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    pthread_mutex_lock(&pE->mutex);
+    pE->signaled = 1;
+    pthread_cond_signal(&pE->cond);
+    pthread_mutex_unlock(&pE->mutex);
+}
+
+void BAE_WaitEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    pthread_mutex_lock(&pE->mutex);
+    while (pE->signaled == 0)
+    {
+        pthread_cond_wait(&pE->cond, &pE->mutex);
+    }
+    pE->signaled = 0;
+    pthread_mutex_unlock(&pE->mutex);
+}
+
+void BAE_DestroyEvent(BAE_Event event)
+{
+    PThreadEvent *pE = (PThreadEvent *)event;
+
+    if (pE)
+    {
+        pthread_cond_destroy(&pE->cond);
+        pthread_mutex_destroy(&pE->mutex);
+        BAE_Deallocate(pE);
+    }
+}
+
+int BAE_GetProcessorCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+}
+
 
 // If no thread support, this will be called during idle times. Used for host
 // rendering without threads.
@@ -455,6 +591,19 @@ int32_t BAE_FileDelete(void *fileName)
     return(-1);
 }
 
+// Rename a file, replacing toName if it exists. Return -1 if error, 0 if ok
+int32_t BAE_FileRename(void *fromName, void *toName)
+{
+    if (fromName && toName)
+    {
+        if (rename((char *)fromName, (char *)toName) == 0)
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
 
 // Open a file
 // Return -1 if error, otherwise file handle
@@ -491,6 +640,49 @@ void BAE_FileClose(intptr_t fileReference)
     close(fileReference);
 }
 
+// Map a whole file into memory for reading. Pages are private and copy on write, so
+// the ones never written stay shared with every other process mapping the same file.
+// Return NULL if the file can't be mapped.
+void * BAE_FileMapForRead(void *fileName, uint32_t *pLength)
+{
+    struct stat fileInfo;
+    void        *pMapping;
+    int         fd;
+
+    pMapping = NULL;
+    if (fileName && pLength)
+    {
+        *pLength = 0;
+        fd = open((char *)fileName, O_RDONLY);
+        if (fd != -1)
+        {
+            if ((fstat(fd, &fileInfo) == 0) && (fileInfo.st_size > 0) && (fileInfo.st_size <= 0x7FFFFFFF))
+            {
+                pMapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (pMapping == MAP_FAILED)
+                {
+                    pMapping = NULL;
+                }
+                else
+                {
+                    *pLength = (uint32_t)fileInfo.st_size;
+                }
+            }
+            close(fd);  // the mapping keeps its own reference to the file
+        }
+    }
+    return pMapping;
+}
+
+// Release a mapping returned from BAE_FileMapForRead
+void BAE_FileUnmap(void *pMapping, uint32_t length)
+{
+    if (pMapping && length)
+    {
+        munmap(pMapping, (size_t)length);
+    }
+}
+
 // Read a block of memory from a file.
 // Return -1 if error, otherwise length of data read.
 int32_t BAE_ReadFile(intptr_t fileReference, void *pBuffer, int32_t bufferLength)
@@ -12,10 +12,14 @@
 #include <X_API.h>
 #include <X_Assert.h>
 #ifdef _WIN32
+#include <windows.h> // for MoveFileExA
 #include <io.h> // for _chsize / _chsize_s / _fileno
 #else
 #include <unistd.h> // for ftruncate
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
 static SDL_AudioDeviceID g_audioDevice = 0;
@@ -604,7 +608,7 @@ void BAE_SetHardwareBalance(int16_t balance)
 }
 
 // ---- Timing ----
-uint32_t BAE_Microseconds(void)
+uint64_t BAE_Microseconds64(void)
 {
     if (!g_perfFreq)
     {
@@ -613,9 +617,10 @@ uint32_t BAE_Microseconds(void)
     }
     Uint64 now = SDL_GetPerformanceCounter();
     Uint64 delta = now - g_startTicks;
-    double us = (double)delta * 1000000.0 / (double)g_perfFreq;
-    return (uint32_t)us;
+    // split the divide so we keep full precision without overflowing
+    return (uint64_t)((delta / g_perfFreq) * 1000000ULL + ((delta % g_perfFreq) * 1000000ULL) / g_perfFreq);
 }
+uint32_t BAE_Microseconds(void) { return (uint32_t)BAE_Microseconds64(); }
 void BAE_WaitMicroseconds(uint32_t wait) { SDL_Delay((wait + 999) / 1000); }
 
 // ---- File helpers - Fixed for 64-bit compatibility ----
@@ -674,6 +679,16 @@ int32_t BAE_FileCreate(void *fileName)
 }
 int32_t BAE_FileDelete(void *fileName) { return remove((char *)fileName) == 0 ? 0 : -1; }
 
+// replaces toName if it exists
+int32_t BAE_FileRename(void *fromName, void *toName)
+{
+#ifdef _WIN32
+    return MoveFileExA((char *)fromName, (char *)toName, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    return rename((char *)fromName, (char *)toName) == 0 ? 0 : -1;
+#endif
+}
+
 intptr_t BAE_FileOpenForRead(void *fileName)
 {
     FILE *f = fopen((char *)fileName, "rb");
@@ -704,6 +719,46 @@ void BAE_FileClose(intptr_t ref)
     }
 }
 
+// Map a whole file copy on write, so untouched pages stay shared between processes.
+// Returns NULL where mmap isn't available; callers then read the file instead.
+void *BAE_FileMapForRead(void *fileName, uint32_t *pLength)
+{
+    void *pMapping = NULL;
+
+    if (!fileName || !pLength)
+        return NULL;
+    *pLength = 0;
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    {
+        struct stat fileInfo;
+        int fd = open((char *)fileName, O_RDONLY);
+        if (fd == -1)
+            return NULL;
+        if (fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0 && fileInfo.st_size <= 0x7FFFFFFF)
+        {
+            pMapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (pMapping == MAP_FAILED)
+                pMapping = NULL;
+            else
+                *pLength = (uint32_t)fileInfo.st_size;
+        }
+        close(fd);
+    }
+#endif
+    return pMapping;
+}
+
+void BAE_FileUnmap(void *pMapping, uint32_t length)
+{
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    if (pMapping && length)
+        munmap(pMapping, (size_t)length);
+#else
+    (void)pMapping;
+    (void)length;
+#endif
+}
+
 int32_t BAE_ReadFile(intptr_t ref, void *pBuf, int32_t len)
 {
     FILE *f = PV_GetFileFromHandle(ref);
@@ -987,6 +1042,103 @@ void BAE_DestroyMutex(BAE_Mutex lock)
     BAE_Deallocate(m);
 }
 
+// ---- Worker threads ----
+typedef struct
+{
+    SDL_Thread *thread;
+    BAE_WorkerThreadProc proc;
+    void *context;
+} sSDLWorker;
+
+typedef struct
+{
+    SDL_mutex *mtx;
+    SDL_cond *cond;
+    int signaled;
+} sSDLEvent;
+
+static int SDLCALL PV_WorkerThreadMain(void *arg)
+{
+    sSDLWorker *w = (sSDLWorker *)arg;
+    w->proc(w->context);
+    return 0;
+}
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context)
+{
+    sSDLWorker *w = (sSDLWorker *)BAE_Allocate(sizeof(sSDLWorker));
+    if (!w)
+        return 0;
+    w->proc = proc;
+    w->context = context;
+    w->thread = SDL_CreateThread(PV_WorkerThreadMain, "BAEWorker", w);
+    if (!w->thread)
+    {
+        BAE_Deallocate(w);
+        return 0;
+    }
+    *pThread = (BAE_WorkerThread)w;
+    return 1;
+}
+void BAE_JoinWorkerThread(BAE_WorkerThread thread)
+{
+    if (!thread)
+        return;
+    sSDLWorker *w = (sSDLWorker *)thread;
+    SDL_WaitThread(w->thread, NULL);
+    BAE_Deallocate(w);
+}
+int BAE_NewEvent(BAE_Event *pEvent)
+{
+    sSDLEvent *e = (sSDLEvent *)BAE_Allocate(sizeof(sSDLEvent));
+    if (!e)
+        return 0;
+    e->mtx = SDL_CreateMutex();
+    e->cond = SDL_CreateCond();
+    if (!e->mtx || !e->cond)
+    {
+        if (e->mtx)
+            SDL_DestroyMutex(e->mtx);
+        if (e->cond)
+            SDL_DestroyCond(e->cond);
+        BAE_Deallocate(e);
+        return 0;
+    }
+    e->signaled = 0;
+    *pEvent = (BAE_Event)e;
+    return 1;
+}
+void BAE_SignalEvent(BAE_Event event)
+{
+    sSDLEvent *e = (sSDLEvent *)event;
+    SDL_LockMutex(e->mtx);
+    e->signaled = 1;
+    SDL_CondSignal(e->cond);
+    SDL_UnlockMutex(e->mtx);
+}
+void BAE_WaitEvent(BAE_Event event)
+{
+    sSDLEvent *e = (sSDLEvent *)event;
+    SDL_LockMutex(e->mtx);
+    while (!e->signaled)
+        SDL_CondWait(e->cond, e->mtx);
+    e->signaled = 0;
+    SDL_UnlockMutex(e->mtx);
+}
+void BAE_DestroyEvent(BAE_Event event)
+{
+    if (!event)
+        return;
+    sSDLEvent *e = (sSDLEvent *)event;
+    SDL_DestroyCond(e->cond);
+    SDL_DestroyMutex(e->mtx);
+    BAE_Deallocate(e);
+}
+int BAE_GetProcessorCount(void)
+{
+    int count = SDL_GetCPUCount();
+    return (count > 0) ? count : 1;
+}
+
 // ---- Capture stubs (not implemented) ----
 int BAE_AcquireAudioCapture(void *threadContext, uint32_t sampleRate, uint32_t channels, uint32_t bits, uint32_t *pCaptureHandle)
 {
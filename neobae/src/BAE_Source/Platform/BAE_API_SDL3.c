@@ -15,10 +15,14 @@
 #include <X_API.h>
 #include <X_Assert.h>
 #ifdef _WIN32
+#include <windows.h>
 #include <io.h>
 #else
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #endif
 
 // SDL3 objects
@@ -247,7 +251,8 @@ int16_t BAE_GetHardwareBalance(void){ return g_balance; }
 void BAE_SetHardwareBalance(int16_t b){ if(b<-256)b=-256; if(b>256)b=256; g_balance=b; }
 
 // ---- Timing ----
-uint32_t BAE_Microseconds(void){ if(!g_perfFreq){ g_perfFreq = SDL_GetPerformanceFrequency(); g_startTicks = SDL_GetPerformanceCounter(); } Uint64 now = SDL_GetPerformanceCounter(); Uint64 delta = now - g_startTicks; double us = (double)delta * 1000000.0 / (double)g_perfFreq; return (uint32_t)us; }
+uint64_t BAE_Microseconds64(void){ if(!g_perfFreq){ g_perfFreq = SDL_GetPerformanceFrequency(); g_startTicks = SDL_GetPerformanceCounter(); } Uint64 delta = SDL_GetPerformanceCounter() - g_startTicks; return (uint64_t)((delta / g_perfFreq) * 1000000ULL + ((delta % g_perfFreq) * 1000000ULL) / g_perfFreq); }
+uint32_t BAE_Microseconds(void){ return (uint32_t)BAE_Microseconds64(); }
 void BAE_WaitMicroseconds(uint32_t wait){ SDL_Delay((wait + 999)/1000); }
 
 // ---- File helpers (duplicate from SDL2 backend) ----
@@ -259,10 +264,37 @@ static void PV_FreeFileHandle(intptr_t handle){ if(handle>0 && handle<MAX_OPEN_F
 void BAE_CopyFileNameNative(void *src, void *dst){ if(src && dst) strcpy((char*)dst,(char*)src); }
 int32_t BAE_FileCreate(void *fileName){ FILE *f=fopen((char*)fileName,"wb"); if(!f) return -1; fclose(f); return 0; }
 int32_t BAE_FileDelete(void *fileName){ return remove((char*)fileName)==0?0:-1; }
+// replaces toName if it exists
+int32_t BAE_FileRename(void *fromName, void *toName){
+#ifdef _WIN32
+    return MoveFileExA((char*)fromName,(char*)toName,MOVEFILE_REPLACE_EXISTING)?0:-1;
+#else
+    return rename((char*)fromName,(char*)toName)==0?0:-1;
+#endif
+}
 intptr_t BAE_FileOpenForRead(void *fileName){ FILE *f=fopen((char*)fileName,"rb"); return f?PV_AllocateFileHandle(f):-1; }
 intptr_t BAE_FileOpenForWrite(void *fileName){ FILE *f=fopen((char*)fileName,"wb"); return f?PV_AllocateFileHandle(f):-1; }
 intptr_t BAE_FileOpenForReadWrite(void *fileName){ FILE *f=fopen((char*)fileName,"rb+"); if(!f) f=fopen((char*)fileName,"wb+"); return f?PV_AllocateFileHandle(f):-1; }
 void BAE_FileClose(intptr_t ref){ FILE *f=PV_GetFileFromHandle(ref); if(f){ fclose(f); PV_FreeFileHandle(ref);} }
+// whole file, copy on write, so untouched pages stay shared between processes; NULL means read the file instead
+void *BAE_FileMapForRead(void *fileName, uint32_t *pLength){
+    void *p=NULL;
+    if(!fileName || !pLength) return NULL;
+    *pLength=0;
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    { struct stat st; int fd=open((char*)fileName,O_RDONLY); if(fd==-1) return NULL;
+      if(fstat(fd,&st)==0 && st.st_size>0 && st.st_size<=0x7FFFFFFF){ p=mmap(NULL,(size_t)st.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0); if(p==MAP_FAILED) p=NULL; else *pLength=(uint32_t)st.st_size; }
+      close(fd); }
+#endif
+    return p;
+}
+void BAE_FileUnmap(void *pMapping, uint32_t length){
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    if(pMapping && length) munmap(pMapping,(size_t)length);
+#else
+    (void)pMapping; (void)length;
+#endif
+}
 int32_t BAE_ReadFile(intptr_t ref, void *pBuf, int32_t len){ FILE *f=PV_GetFileFromHandle(ref); if(!f) return -1; size_t r=fread(pBuf,1,(size_t)len,f); return (r==0 && ferror(f))?-1:(int32_t)r; }
 int32_t BAE_WriteFile(intptr_t ref, void *pBuf, int32_t len){ FILE *f=PV_GetFileFromHandle(ref); if(!f) return -1; size_t w=fwrite(pBuf,1,(size_t)len,f); fflush(f); return (w==0 && ferror(f))?-1:(int32_t)w; }
 int32_t BAE_SetFilePosition(intptr_t ref, uint32_t pos){ FILE *f=PV_GetFileFromHandle(ref); if(!f) return -1; return fseek(f,(int32_t)pos,SEEK_SET)==0?0:-1; }
@@ -385,6 +417,18 @@ void BAE_AcquireMutex(BAE_Mutex lock){ if(!lock) return; sSDLMutex *m = (sSDLMut
 void BAE_ReleaseMutex(BAE_Mutex lock){ if(!lock) return; sSDLMutex *m = (sSDLMutex*)lock; SDL_UnlockMutex(m->mtx); }
 void BAE_DestroyMutex(BAE_Mutex lock){ if(!lock) return; sSDLMutex *m=(sSDLMutex*)lock; if(m->mtx) SDL_DestroyMutex(m->mtx); BAE_Deallocate(m); }
 
+// ---- Worker threads ----
+typedef struct { SDL_Thread *thread; BAE_WorkerThreadProc proc; void *context; } sSDLWorker;
+typedef struct { SDL_Mutex *mtx; SDL_Condition *cond; int signaled; } sSDLEvent;
+static int SDLCALL PV_WorkerThreadMain(void *arg){ sSDLWorker *w = (sSDLWorker*)arg; w->proc(w->context); return 0; }
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context){ sSDLWorker *w = (sSDLWorker*)BAE_Allocate(sizeof(sSDLWorker)); if(!w) return 0; w->proc = proc; w->context = context; w->thread = SDL_CreateThread(PV_WorkerThreadMain, "BAEWorker", w); if(!w->thread){ BAE_Deallocate(w); return 0; } *pThread = (BAE_WorkerThread)w; return 1; }
+void BAE_JoinWorkerThread(BAE_WorkerThread thread){ if(!thread) return; sSDLWorker *w = (sSDLWorker*)thread; SDL_WaitThread(w->thread, NULL); BAE_Deallocate(w); }
+int BAE_NewEvent(BAE_Event *pEvent){ sSDLEvent *e = (sSDLEvent*)BAE_Allocate(sizeof(sSDLEvent)); if(!e) return 0; e->mtx = SDL_CreateMutex(); e->cond = SDL_CreateCondition(); if(!e->mtx || !e->cond){ if(e->mtx) SDL_DestroyMutex(e->mtx); if(e->cond) SDL_DestroyCondition(e->cond); BAE_Deallocate(e); return 0; } e->signaled = 0; *pEvent = (BAE_Event)e; return 1; }
+void BAE_SignalEvent(BAE_Event event){ sSDLEvent *e = (sSDLEvent*)event; SDL_LockMutex(e->mtx); e->signaled = 1; SDL_SignalCondition(e->cond); SDL_UnlockMutex(e->mtx); }
+void BAE_WaitEvent(BAE_Event event){ sSDLEvent *e = (sSDLEvent*)event; SDL_LockMutex(e->mtx); while(!e->signaled) SDL_WaitCondition(e->cond, e->mtx); e->signaled = 0; SDL_UnlockMutex(e->mtx); }
+void BAE_DestroyEvent(BAE_Event event){ if(!event) return; sSDLEvent *e = (sSDLEvent*)event; SDL_DestroyCondition(e->cond); SDL_DestroyMutex(e->mtx); BAE_Deallocate(e); }
+int BAE_GetProcessorCount(void){ int count = SDL_GetNumLogicalCPUCores(); return (count > 0) ? count : 1; }
+
 // ---- Capture stubs (not implemented) ----
 int BAE_AcquireAudioCapture(void *threadContext, uint32_t sampleRate, uint32_t channels, uint32_t bits, uint32_t *pCaptureHandle){ (void)threadContext; (void)sampleRate; (void)channels; (void)bits; (void)pCaptureHandle; return -1; }
 int BAE_ReleaseAudioCapture(void *threadContext){ (void)threadContext; return -1; }
@@ -70,6 +70,42 @@ void BAE_ReleaseMutex(BAE_Mutex mutex) {
     (void)mutex;
 }
 
+// ============================================
+// Worker threads (not available, callers fall back to doing the work inline)
+// ============================================
+
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context) {
+    (void)pThread;
+    (void)proc;
+    (void)context;
+    return 0;
+}
+
+void BAE_JoinWorkerThread(BAE_WorkerThread thread) {
+    (void)thread;
+}
+
+int BAE_NewEvent(BAE_Event *pEvent) {
+    (void)pEvent;
+    return 0;
+}
+
+void BAE_SignalEvent(BAE_Event event) {
+    (void)event;
+}
+
+void BAE_WaitEvent(BAE_Event event) {
+    (void)event;
+}
+
+void BAE_DestroyEvent(BAE_Event event) {
+    (void)event;
+}
+
+int BAE_GetProcessorCount(void) {
+    return 1;
+}
+
 // ============================================
 // Audio Hardware (stubs - we use JS audio)
 // ============================================
@@ -117,7 +153,7 @@ void BAE_ProcessRouteBus(int currentRoute, int32_t *pChannels, int count) {
 // Time Functions
 // ============================================
 
-uint32_t BAE_GetMicroseconds(void) {
+uint64_t BAE_Microseconds64(void) {
     static double startMs = 0.0;
     double nowMs = emscripten_get_now();
     if (startMs == 0.0) {
@@ -127,7 +163,11 @@ uint32_t BAE_GetMicroseconds(void) {
     if (deltaUs < 0) {
         deltaUs = 0;
     }
-    return (uint32_t)deltaUs;
+    return (uint64_t)deltaUs;
+}
+
+uint32_t BAE_GetMicroseconds(void) {
+    return (uint32_t)BAE_Microseconds64();
 }
 
 void BAE_WaitMicroseconds(uint32_t wait) {
@@ -148,6 +188,12 @@ int32_t BAE_FileDelete(void* fileName) {
     return -1;
 }
 
+int32_t BAE_FileRename(void* fromName, void* toName) {
+    (void)fromName;
+    (void)toName;
+    return -1;
+}
+
 intptr_t BAE_FileOpen(void* fileName, int32_t mode) {
     (void)fileName;
     (void)mode;
@@ -174,6 +220,19 @@ void BAE_FileClose(intptr_t fileRef) {
     (void)fileRef;
 }
 
+void* BAE_FileMapForRead(void* fileName, uint32_t* pLength) {
+    (void)fileName;
+    if (pLength) {
+        *pLength = 0;
+    }
+    return NULL;
+}
+
+void BAE_FileUnmap(void* pMapping, uint32_t length) {
+    (void)pMapping;
+    (void)length;
+}
+
 int32_t BAE_ReadFile(intptr_t fileRef, void* buffer, int32_t size) {
     (void)fileRef;
     (void)buffer;
@@ -40,7 +40,7 @@ static BAESong gEffectSong = NULL;  // Second song for sound effects (plays on t
 typedef void (*JSLyricCallback)(const char* lyric, uint32_t timeUs);
 static JSLyricCallback gJSLyricCallback = NULL;
 static int gSuppressLyrics = 1;  // Start suppressed (1 = suppress during preroll, 0 = allow)
-static uint32_t gLyricUnsuppressTime = 0;  // Time when lyrics should be unsuppressed (0 = inactive)
+static uint64_t gLyricUnsuppressTime = 0;  // Time when lyrics should be unsuppressed (0 = inactive)
 #endif
 
 // Audio buffer for JS interop
@@ -424,7 +424,7 @@ int BAE_WASM_Play(void) {
         BAE_PRINTF("[BAE] Play: Lyric callback installed\n");
     }
     // Schedule lyric unsuppression for 550ms from now (non-blocking)
-    gLyricUnsuppressTime = BAE_GetMicroseconds() + 550000;
+    gLyricUnsuppressTime = BAE_Microseconds64() + 550000;
 #endif
     GM_ResumeGeneralSound(NULL);
     BAEResult err = BAESong_Start(gCurrentSong, 0);
@@ -712,7 +712,7 @@ int16_t* BAE_WASM_GenerateAudio(int frames) {
 
 #ifdef SUPPORT_KARAOKE
     // Check if it's time to unsuppress lyrics (non-blocking)
-    if (gLyricUnsuppressTime > 0 && BAE_GetMicroseconds() >= gLyricUnsuppressTime) {
+    if (gLyricUnsuppressTime > 0 && BAE_Microseconds64() >= gLyricUnsuppressTime) {
         gSuppressLyrics = 0;
         gLyricUnsuppressTime = 0;  // Clear the timer
         BAE_PRINTF("[BAE] GenerateAudio: Lyrics unsuppressed\n");
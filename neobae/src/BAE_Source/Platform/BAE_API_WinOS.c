@@ -800,33 +800,35 @@ void BAE_SetHardwareVolume(int16_t newVolume)
 }
 
 // **** Timing services
-// return microseconds
-uint32_t BAE_Microseconds(void)
+// return microseconds since the first call. This never wraps in practice.
+uint64_t BAE_Microseconds64(void)
 {
-    static uint32_t    starttick = 0;
+    static uint64_t         starttick = 0;
     static char             firstTime = TRUE;
     static char             QPClockSupport = FALSE;
-    static uint32_t    clockpusu = 0;  // clocks per microsecond
-    uint32_t           time;
+    static uint64_t         clockFrequency = 0;
+    uint64_t                time;
     LARGE_INTEGER           p;
 
     if (firstTime)
     {
-        if (QueryPerformanceFrequency(&p))
+        if (QueryPerformanceFrequency(&p) && p.QuadPart)
         {
             QPClockSupport = TRUE;
-            clockpusu = (uint32_t)(p.QuadPart / 1000000L);
+            clockFrequency = (uint64_t)p.QuadPart;
         }
         firstTime = FALSE;
     }
     if (QPClockSupport)
     {
         QueryPerformanceCounter(&p);
-        time = (uint32_t)(p.QuadPart / clockpusu);
+        // split the divide so the multiply can't overflow on fast counters
+        time = ((uint64_t)p.QuadPart / clockFrequency) * 1000000ULL +
+                (((uint64_t)p.QuadPart % clockFrequency) * 1000000ULL) / clockFrequency;
     }
     else
     {
-        time = timeGetTime() * 1000L;
+        time = (uint64_t)timeGetTime() * 1000ULL;
     }
 
     if (starttick == 0)
@@ -836,15 +838,21 @@ uint32_t BAE_Microseconds(void)
     return (time - starttick);
 }
 
+// return microseconds, wrapping every 71 minutes
+uint32_t BAE_Microseconds(void)
+{
+    return (uint32_t)BAE_Microseconds64();
+}
+
 // wait or sleep this thread for this many microseconds
 // CLS??: If this function is called from within the frame thread and
 // JAVA_THREAD is non-zero, we'll probably crash.
 void BAE_WaitMicroseconds(uint32_t waitAmount)
 {
-    uint32_t   ticks;
+    uint64_t   ticks;
 
-    ticks = BAE_Microseconds() + waitAmount;
-    while (BAE_Microseconds() < ticks) 
+    ticks = BAE_Microseconds64() + waitAmount;
+    while (BAE_Microseconds64() < ticks) 
     {
         Sleep(0);   // Give up the rest of this time slice to other threads
     }
@@ -927,6 +935,19 @@ int32_t BAE_FileDelete(void *fileName)
     return -1;
 }
 
+// Rename a file, replacing toName if it exists. Return -1 if error, 0 if ok
+int32_t BAE_FileRename(void *fromName, void *toName)
+{
+    if (fromName && toName)
+    {
+        if (MoveFileEx((LPCTSTR)fromName, (LPCTSTR)toName, MOVEFILE_REPLACE_EXISTING))
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
 
 // Open a file
 // Return -1 if error, otherwise file handle
@@ -1016,6 +1037,52 @@ void BAE_FileClose(intptr_t fileReference)
 #endif
 }
 
+// Map a whole file into memory for reading. The view is copy on write, so the pages
+// that are never written stay shared with every other process mapping the same file.
+// Return NULL if the file can't be mapped.
+void * BAE_FileMapForRead(void *fileName, uint32_t *pLength)
+{
+    HANDLE  file, mapping;
+    DWORD   sizeHigh, sizeLow;
+    void    *pMapping;
+
+    pMapping = NULL;
+    if (fileName && pLength)
+    {
+        *pLength = 0;
+        file = CreateFile((LPCTSTR)fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_READONLY, NULL);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            sizeLow = GetFileSize(file, &sizeHigh);
+            if ((sizeLow != INVALID_FILE_SIZE) && (sizeHigh == 0) && sizeLow && (sizeLow <= 0x7FFFFFFF))
+            {
+                mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+                if (mapping)
+                {
+                    pMapping = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+                    if (pMapping)
+                    {
+                        *pLength = (uint32_t)sizeLow;
+                    }
+                    CloseHandle(mapping);   // the view keeps the mapping alive
+                }
+            }
+            CloseHandle(file);
+        }
+    }
+    return pMapping;
+}
+
+// Release a mapping returned from BAE_FileMapForRead
+void BAE_FileUnmap(void *pMapping, uint32_t length)
+{
+    if (pMapping && length)
+    {
+        UnmapViewOfFile(pMapping);
+    }
+}
+
 // Read a block of memory from a file.
 // Return -1 if error, otherwise length of data read.
 int32_t BAE_ReadFile(intptr_t fileReference, void *pBuffer, int32_t bufferLength)
@@ -2439,6 +2506,93 @@ void BAE_DestroyMutex(BAE_Mutex lock)
 */
 }
 
+// WORKER THREADS
+
+typedef struct
+{
+    HANDLE                  thread;
+    BAE_WorkerThreadProc    proc;
+    void                    *context;
+} WinWorkerThread;
+
+static DWORD WINAPI PV_WorkerThreadMain(LPVOID arg)
+{
+    WinWorkerThread *pWorker = (WinWorkerThread *)arg;
+
+    (*pWorker->proc)(pWorker->context);
+    return 0;
+}
+
+int BAE_NewWorkerThread(BAE_WorkerThread *pThread, BAE_WorkerThreadProc proc, void *context)
+{
+    WinWorkerThread *pWorker = (WinWorkerThread *)BAE_Allocate(sizeof(WinWorkerThread));
+
+    if (pWorker == NULL)
+    {
+        return 0;
+    }
+    pWorker->proc = proc;
+    pWorker->context = context;
+    pWorker->thread = CreateThread(NULL, 0, PV_WorkerThreadMain, pWorker, 0, NULL);
+    if (pWorker->thread == NULL)
+    {
+        BAE_Deallocate(pWorker);
+        return 0;
+    }
+    *pThread = (BAE_WorkerThread)pWorker;
+    return 1;
+}
+
+void BAE_JoinWorkerThread(BAE_WorkerThread thread)
+{
+    WinWorkerThread *pWorker = (WinWorkerThread *)thread;
+
+    if (pWorker)
+    {
+        WaitForSingleObject(pWorker->thread, INFINITE);
+        CloseHandle(pWorker->thread);
+        BAE_Deallocate(pWorker);
+    }
+}
+
+int BAE_NewEvent(BAE_Event *pEvent)
+{
+    HANDLE event = CreateEvent(NULL, FALSE, FALSE, NULL);   // auto reset
+
+    if (event == NULL)
+    {
+        return 0;
+    }
+    *pEvent = (BAE_Event)event;
+    return 1;
+}
+
+void BAE_SignalEvent(BAE_Event event)
+{
+    SetEvent((HANDLE)event);
+}
+
+void BAE_WaitEvent(BAE_Event event)
+{
+    WaitForSingleObject((HANDLE)event, INFINITE);
+}
+
+void BAE_DestroyEvent(BAE_Event event)
+{
+    if (event)
+    {
+        CloseHandle((HANDLE)event);
+    }
+}
+
+int BAE_GetProcessorCount(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (int)info.dwNumberOfProcessors : 1;
+}
+
 // Mute/unmute audio. Shutdown amps, etc.
 // return 0 if ok, -1 if failed
 int BAE_Mute(void)
@@ -73,6 +73,8 @@ LOCAL_SRC_FILES	:= \
 			Common/GenReverb.c \
 			Common/GenReverbNew.c \
 			Common/GenReverbNeo.c \
+			Common/GenReverbConv.c \
+			Common/GenMaster.c \
 			Common/GenSample.c \
 			Common/GenSeq.c \
 			Common/GenSeqTools.c \
@@ -1167,8 +1167,9 @@ void bae_set_reverb(int idx)
     {
         if (idx < 0)
             idx = 0;
-        if (idx >= BAE_REVERB_TYPE_COUNT)
-            idx = BAE_REVERB_TYPE_COUNT - 1;
+        // UI indexes past the built-in list are custom Neo presets
+        if (idx > BAE_REVERB_TYPE_18)
+            idx = BAE_REVERB_TYPE_18;
         BAEMixer_SetDefaultReverb(g_bae.mixer, (BAEReverbType)idx);
     }
 }
@@ -445,6 +445,10 @@ char const usageStringExtra[] =
         "                 -mv {max voices (default: 64)}\n"
         "                 -cl {list velocity curves}\n"
         "                 -rl {display reverb definitions}\n"
+        "                 -ir {WAV/AIF impulse response, selects convolution reverb}\n"
+        "                 -lm {master limiter instead of hard clipping}\n"
+        "                 -et {run reverb and chorus on their own thread}\n"
+        "                 -mu {print memory use by category when done}\n"
         "                 -sw {Stream a WAV file}\n"
         "                 -sa {Stream a AIF file}\n"
         "                 -a  {Play a AIF file}\n"
@@ -559,6 +563,27 @@ static int PV_ParseCommands(int argc, char *argv[], char *command, int getResult
    return (0);
 }
 
+// Print the engine's memory use, now and at its peak, for each category
+static void PV_PrintMemoryUsage(BAEMixer theMixer)
+{
+   static char const *names[BAE_MEMORY_CATEGORY_COUNT] =
+   {
+      "other", "samples", "instruments", "songs", "effects",
+      "streams", "decoders", "soundfonts", "resources"
+   };
+   uint32_t current, peak;
+   int category;
+
+   playbae_printf("Memory use       current        peak\n");
+   for (category = 0; category < BAE_MEMORY_CATEGORY_COUNT; category++)
+   {
+      if (BAEMixer_GetMemoryUsage(theMixer, (BAEMemoryCategory)category, &current, &peak) == BAE_NO_ERROR)
+      {
+         playbae_printf("  %-12s %11lu %11lu\n", names[category], (unsigned long)current, (unsigned long)peak);
+      }
+   }
+}
+
 BAE_UNSIGNED_FIXED calculateVolume(BAE_UNSIGNED_FIXED volume, BAE_BOOL multiply)
 {
    BAE_UNSIGNED_FIXED temp = 0;
@@ -1873,6 +1898,37 @@ int main(int argc, char *argv[])
                reverbType = 7;
             }
          }
+         if (PV_ParseCommands(argc, argv, "-ir", TRUE, parmFile))
+         {
+            const char *ext = strrchr(parmFile, '.');
+            BAEFileType irType = BAE_WAVE_TYPE;
+
+            if (ext && (strcasecmp(ext, ".aif") == 0 || strcasecmp(ext, ".aiff") == 0))
+            {
+               irType = BAE_AIFF_TYPE;
+            }
+            err = BAEMixer_SetReverbImpulseFromFile(theMixer, (BAEPathName)parmFile, irType);
+            if (err == BAE_NO_ERROR)
+            {
+               reverbType = BAE_REVERB_TYPE_19;
+            }
+            else
+            {
+               playbae_printf("Error %d loading impulse response %s. Ignored.\n", err, parmFile);
+            }
+         }
+         if (PV_ParseCommands(argc, argv, "-lm", FALSE, NULL))
+         {
+            BAEMixer_SetMasterLimiterEnabled(theMixer, TRUE);
+         }
+         if (PV_ParseCommands(argc, argv, "-et", FALSE, NULL))
+         {
+            err = BAEMixer_SetEffectsThreadEnabled(theMixer, TRUE);
+            if (err != BAE_NO_ERROR)
+            {
+               playbae_printf("Effects thread not available (%d). Ignored.\n", err);
+            }
+         }
          playbae_dprintf("BAE memory used during idle prior to SetBankToFile: %ld bytes\n\n", BAE_GetSizeOfMemoryUsed());
 
          if (PV_ParseCommands(argc, argv, "-p", TRUE, parmFile))
@@ -2199,6 +2255,10 @@ int main(int argc, char *argv[])
       playbae_printf(usageStringFmt, playFileString);
    }
 
+   if (PV_ParseCommands(argc, argv, "-mu", FALSE, NULL))
+   {
+      PV_PrintMemoryUsage(theMixer);
+   }
    BAE_WaitMicroseconds(160000);
    BAEMixer_Delete(theMixer);
    return (0);